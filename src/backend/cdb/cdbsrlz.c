@@ -16,6 +16,7 @@
 #include "postgres.h"
 
 #include "cdb/cdbsrlz.h"
+#include "cdb/cdbvars.h"
 #include "nodes/nodes.h"
 #include "utils/memaccounting.h"
 #include "utils/memutils.h"
@@ -31,6 +32,43 @@ static char *uncompress_string(const char *src, int size, int *uncompressed_size
 /* zstandard compression level to use. */
 #define COMPRESS_LEVEL 3
 
+/*
+ * Cache of recently compressed serializations.
+ *
+ * Every execution of a prepared statement dispatches the same plan again, and
+ * for a plan over a table with many partitions compressing it costs far more
+ * than producing the uncompressed bytes.  So we remember the last few large
+ * serializations together with their compressed form, and reuse the latter
+ * when the same bytes come along again.  Plans that changed in any way, e.g.
+ * because they were re-planned or had different parameter values folded in,
+ * simply miss the cache.
+ *
+ * The cache lives for the whole session, so the total size of the entries,
+ * both forms included, is bounded by gp_plan_compress_cache_size.  Setting
+ * it to 0 disables the cache and releases its memory.
+ */
+#define COMPRESS_CACHE_SIZE			4
+
+/* Smaller strings are cheap enough to compress every time */
+#define COMPRESS_CACHE_MIN_SIZE		(64 * 1024)
+
+typedef struct CompressCacheEntry
+{
+	char	   *uncompressed;
+	int			uncompressed_size;
+	char	   *compressed;
+	int			compressed_size;
+} CompressCacheEntry;
+
+static CompressCacheEntry compressCache[COMPRESS_CACHE_SIZE];
+static int	compressCacheNext = 0;
+static Size compressCacheBytes = 0;
+static MemoryContext compressCacheContext = NULL;
+
+static char *compress_string_cached(const char *src, int uncompressed_size, int *compressed_size_p);
+static void compress_cache_trim(Size limit);
+static void compress_cache_evict(CompressCacheEntry *entry);
+
 #endif			/* HAVE_LIBZSTD */
 
 /*
@@ -54,7 +92,7 @@ serializeNode(Node *node, int *size, int *uncompressed_size_out)
 
 		/* If we have been compiled with libzstd, use it to compress it */
 #ifdef HAVE_LIBZSTD
-		sNode = compress_string(pszNode, uncompressed_size, size);
+		sNode = compress_string_cached(pszNode, uncompressed_size, size);
 		pfree(pszNode);
 #else
 		sNode = pszNode;
@@ -138,6 +176,114 @@ compress_string(const char *src, int uncompressed_size, int *size)
 	return (char *) result;
 }
 
+/*
+ * Like compress_string(), but reuse the result of an earlier call with the
+ * same input if we still have it.
+ */
+static char *
+compress_string_cached(const char *src, int uncompressed_size, int *size)
+{
+	CompressCacheEntry *entry;
+	char	   *result;
+	Size		limit = (Size) gp_plan_compress_cache_size * 1024;
+	Size		entry_bytes;
+	int			i;
+
+	if (limit == 0)
+	{
+		/* The cache was disabled, give back what it holds */
+		if (compressCacheContext != NULL)
+		{
+			MemoryContextDelete(compressCacheContext);
+			compressCacheContext = NULL;
+			MemSet(compressCache, 0, sizeof(compressCache));
+			compressCacheNext = 0;
+			compressCacheBytes = 0;
+		}
+		return compress_string(src, uncompressed_size, size);
+	}
+
+	/* The limit may have been lowered since the entries were added */
+	compress_cache_trim(limit);
+
+	if (uncompressed_size < COMPRESS_CACHE_MIN_SIZE ||
+		uncompressed_size > limit)
+		return compress_string(src, uncompressed_size, size);
+
+	for (i = 0; i < COMPRESS_CACHE_SIZE; i++)
+	{
+		entry = &compressCache[i];
+
+		if (entry->uncompressed != NULL &&
+			entry->uncompressed_size == uncompressed_size &&
+			memcmp(entry->uncompressed, src, uncompressed_size) == 0)
+		{
+			result = palloc(entry->compressed_size);
+			memcpy(result, entry->compressed, entry->compressed_size);
+			*size = entry->compressed_size;
+			return result;
+		}
+	}
+
+	result = compress_string(src, uncompressed_size, size);
+
+	entry_bytes = (Size) uncompressed_size + *size;
+	if (entry_bytes > limit)
+		return result;
+
+	if (compressCacheContext == NULL)
+		compressCacheContext = AllocSetContextCreate(TopMemoryContext,
+													 "Serialization Compress Cache",
+													 ALLOCSET_DEFAULT_MINSIZE,
+													 ALLOCSET_DEFAULT_INITSIZE,
+													 ALLOCSET_DEFAULT_MAXSIZE);
+
+	/* Replace the oldest entry, and evict more if needed to make room */
+	entry = &compressCache[compressCacheNext];
+	compressCacheNext = (compressCacheNext + 1) % COMPRESS_CACHE_SIZE;
+	compress_cache_evict(entry);
+	compress_cache_trim(limit - entry_bytes);
+
+	entry->compressed = MemoryContextAlloc(compressCacheContext, *size);
+	memcpy(entry->compressed, result, *size);
+	entry->compressed_size = *size;
+	entry->uncompressed = MemoryContextAlloc(compressCacheContext, uncompressed_size);
+	memcpy(entry->uncompressed, src, uncompressed_size);
+	entry->uncompressed_size = uncompressed_size;
+	compressCacheBytes += entry_bytes;
+
+	return result;
+}
+
+/*
+ * Evict entries from the compression cache, oldest first, until it holds at
+ * most 'limit' bytes.
+ */
+static void
+compress_cache_trim(Size limit)
+{
+	int			i;
+
+	for (i = 0; i < COMPRESS_CACHE_SIZE && compressCacheBytes > limit; i++)
+		compress_cache_evict(&compressCache[(compressCacheNext + i) % COMPRESS_CACHE_SIZE]);
+}
+
+/*
+ * Remove an entry from the compression cache, if it is in use.
+ */
+static void
+compress_cache_evict(CompressCacheEntry *entry)
+{
+	if (entry->uncompressed == NULL)
+		return;
+
+	compressCacheBytes -= (Size) entry->uncompressed_size + entry->compressed_size;
+	pfree(entry->uncompressed);
+	pfree(entry->compressed);
+	entry->uncompressed = NULL;
+	entry->compressed = NULL;
+}
+
 /*
  * Uncompress the binary string
  */
@@ -214,6 +214,9 @@ int 		Gp_interconnect_address_type = INTERCONNECT_ADDRESS_TYPE_UNICAST;
 bool		gp_interconnect_aggressive_retry = true;	/* fast-track app-level
 														 * retry */
 
+bool		gp_interconnect_tcp_local_socket = false;	/* host-local routes
+														 * over AF_UNIX */
+
 bool		gp_interconnect_full_crc = false;	/* sanity check UDP data. */
 
 bool		gp_interconnect_log_stats = false;	/* emit stats at log-level */
@@ -267,7 +270,11 @@ double		gp_selectivity_damping_factor = 1;
 bool		gp_selectivity_damping_sigsort = true;
 
 int			gp_hashjoin_tuples_per_bucket = 5;
+bool		gp_enable_runtime_filter = false;
+int			gp_runtime_filter_wait_time = 500;
 int			gp_hashagg_groups_per_bucket = 5;
+int			gp_hashagg_passthrough_sample = 100000;
+double		gp_hashagg_passthrough_ratio = 0.9;
 
 /* Analyzing aid */
 int			gp_motion_slice_noop = 0;
@@ -295,6 +302,9 @@ int			gp_segworker_relative_priority = PRIO_MAX;
 /* Max size of dispatched plans; 0 if no limit */
 int			gp_max_plan_size = 0;
 
+/* Memory for recently compressed plans, in kB; 0 disables the cache */
+int			gp_plan_compress_cache_size = 16384;
+
 /* Disable setting of tuple hints while reading */
 bool		gp_disable_tuple_hints = false;
 
@@ -312,6 +322,9 @@ int			gp_workfile_limit_per_query = 0;
 /* Maximum number of workfiles to be created by a query */
 int			gp_workfile_limit_files_per_query = 0;
 
+/* Largest cross-slice shared input kept in shared memory, in kilobytes */
+int			gp_shareinput_shmem_max_size = 4096;
+
 /* Gpmon */
 bool		gp_enable_gpperfmon = false;
 int			gp_gpperfmon_send_interval = 1;
@@ -323,6 +336,9 @@ bool		gp_enable_fast_sri = true;
 /* Enable single-mirror pair dispatch. */
 bool		gp_enable_direct_dispatch = true;
 
+/* Let QEs cache dispatched plans ? */
+bool		gp_enable_qe_plan_cache = false;
+
 /* Force core dump on memory context error */
 bool		coredump_on_memerror = false;
 
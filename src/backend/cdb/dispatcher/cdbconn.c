@@ -465,7 +465,11 @@ cdbconn_signalQE(SegmentDatabaseDescriptor *segdbDesc,
 		return false;
 
 	if (isCancel)
+	{
+		/* A canceled QE may not have stored the plan it was sent. */
+		cdbdisp_segdbForgetCachedPlans(segdbDesc);
 		ret = PQcancel(cn, errbuf, 256);
+	}
 	else
 		ret = PQrequestFinish(cn, errbuf, 256);
 
@@ -307,6 +307,8 @@ cdbdisp_dispatchToGang_async(struct CdbDispatcherState *ds,
 	for (i = 0; i < gp->size; i++)
 	{
 		CdbDispatchResult *qeResult;
+		const char *queryText;
+		int			queryTextLen;
 
 		SegmentDatabaseDescriptor *segdbDesc = gp->db_descriptors[i];
 
@@ -322,7 +324,11 @@ cdbdisp_dispatchToGang_async(struct CdbDispatcherState *ds,
 		}
 		pParms->dispatchResultPtrArray[pParms->dispatchCount++] = qeResult;
 
-		dispatchCommand(qeResult, pParms->query_text, pParms->query_text_len);
+		queryText = cdbdisp_selectPlanQueryText(ds, segdbDesc,
+												pParms->query_text,
+												pParms->query_text_len,
+												&queryTextLen);
+		dispatchCommand(qeResult, queryText, queryTextLen);
 	}
 }
 
@@ -1168,6 +1174,9 @@ processResults(CdbDispatchResult *dispatchResult)
 			if (sqlstate && strlen(sqlstate) == 5)
 				errcode = sqlstate_to_errcode(sqlstate);
 
+			/* The QE may have failed before storing a dispatched plan. */
+			cdbdisp_segdbForgetCachedPlans(segdbDesc);
+
 			/*
 			 * Save first error code and the index of its PGresult buffer
 			 * entry.
@@ -0,0 +1,222 @@
+/*-------------------------------------------------------------------------
+ *
+ * cdbdisp_plancache.c
+ *	  Cache dispatched plans on the QEs, so that a plan which was already
+ *	  sent over a QD-QE connection need not be sent again.
+ *
+ * Every QE keeps the last few serialized plans it received in a small array
+ * of slots.  The QD decides which slot a plan goes into, and mirrors the
+ * contents of each QE's slots in its SegmentDatabaseDescriptor.  When a QE
+ * already holds the plan, the QD dispatches a message with the plan id and
+ * slot only; otherwise it sends the full plan and asks the QE to store it.
+ *
+ * Plans are identified by a 64-bit digest of their serialized form, so a
+ * cached plan can never become stale: a plan invalidated by catalog changes
+ * is re-planned on the QD, serializes differently and gets a new id.
+ *
+ * Whenever the QD sees a QE fail, it forgets what that QE holds and the next
+ * dispatch sends the full plan again.  This also covers a QE that errored
+ * out before it could store a plan.
+ *
+ * Copyright (c) 2020-Present Pivotal Software, Inc.
+ *
+ *
+ * IDENTIFICATION
+ *	    src/backend/cdb/dispatcher/cdbdisp_plancache.c
+ *
+ *-------------------------------------------------------------------------
+ */
+
+#include "postgres.h"
+
+#include "access/hash.h"
+#include "libpq-fe.h"
+#include "port/pg_crc32c.h"
+#include "utils/memutils.h"
+
+#include "cdb/cdbconn.h"
+#include "cdb/cdbdisp.h"
+#include "cdb/cdbdisp_plancache.h"
+
+/*
+ * QD: the plan id currently assigned to each slot, shared by all QEs of the
+ * session so that a dispatch message is the same for every QE of a gang.
+ */
+static uint64 qdPlanSlots[DISPATCH_PLAN_CACHE_SIZE];
+static int	qdNextPlanSlot = 0;
+
+/* QE: the cached plans themselves */
+typedef struct QEPlanCacheEntry
+{
+	uint64		planId;
+	char	   *splan;
+	int			splan_len;
+} QEPlanCacheEntry;
+
+static QEPlanCacheEntry qePlanCache[DISPATCH_PLAN_CACHE_SIZE];
+
+/*
+ * Compute the id of a serialized plan.
+ *
+ * Two independent 32-bit hashes make an accidental collision between the
+ * handful of cached plans practically impossible.
+ */
+uint64
+cdbdisp_getPlanId(const char *splan, int splan_len)
+{
+	pg_crc32c	crc;
+	uint32		hash;
+	uint64		planId;
+
+	INIT_CRC32C(crc);
+	COMP_CRC32C(crc, splan, splan_len);
+	FIN_CRC32C(crc);
+
+	hash = DatumGetUInt32(hash_any((const unsigned char *) splan, splan_len));
+
+	planId = ((uint64) hash << 32) | (uint64) crc;
+	if (planId == InvalidDispatchPlanId)
+		planId = 1;
+
+	return planId;
+}
+
+/*
+ * Return the slot for the given plan, assigning one if the plan has not been
+ * dispatched recently.  Slots are recycled round-robin.
+ */
+int
+cdbdisp_assignPlanCacheSlot(uint64 planId)
+{
+	int			slot;
+
+	Assert(planId != InvalidDispatchPlanId);
+
+	for (slot = 0; slot < DISPATCH_PLAN_CACHE_SIZE; slot++)
+	{
+		if (qdPlanSlots[slot] == planId)
+			return slot;
+	}
+
+	slot = qdNextPlanSlot;
+	qdPlanSlots[slot] = planId;
+	qdNextPlanSlot = (qdNextPlanSlot + 1) % DISPATCH_PLAN_CACHE_SIZE;
+
+	return slot;
+}
+
+/*
+ * Does the QE behind segdbDesc hold the plan in the given slot?
+ */
+bool
+cdbdisp_segdbHasCachedPlan(SegmentDatabaseDescriptor *segdbDesc,
+						   int slot, uint64 planId)
+{
+	Assert(slot >= 0 && slot < DISPATCH_PLAN_CACHE_SIZE);
+
+	return segdbDesc->cachedPlanIds[slot] == planId;
+}
+
+/*
+ * Remember that a full plan was sent to the QE with a request to store it.
+ */
+void
+cdbdisp_segdbAddCachedPlan(SegmentDatabaseDescriptor *segdbDesc,
+						   int slot, uint64 planId)
+{
+	Assert(slot >= 0 && slot < DISPATCH_PLAN_CACHE_SIZE);
+
+	segdbDesc->cachedPlanIds[slot] = planId;
+}
+
+/*
+ * Assume nothing about what the QE holds, e.g. after it reported an error.
+ */
+void
+cdbdisp_segdbForgetCachedPlans(SegmentDatabaseDescriptor *segdbDesc)
+{
+	MemSet(segdbDesc->cachedPlanIds, 0, sizeof(segdbDesc->cachedPlanIds));
+}
+
+/*
+ * Choose the message to dispatch to the QE behind segdbDesc.
+ *
+ * QEs which hold the plan already get the message without it.  The others
+ * get the full message, queryText, which asks them to cache the plan.
+ */
+const char *
+cdbdisp_selectPlanQueryText(CdbDispatcherState *ds,
+							SegmentDatabaseDescriptor *segdbDesc,
+							const char *queryText, int queryTextLen,
+							int *len)
+{
+	if (ds->cachedPlanQueryText == NULL)
+	{
+		*len = queryTextLen;
+		return queryText;
+	}
+
+	if (cdbdisp_segdbHasCachedPlan(segdbDesc, ds->cachedPlanSlot,
+								   ds->cachedPlanId))
+	{
+		*len = ds->cachedPlanQueryTextLen;
+		return ds->cachedPlanQueryText;
+	}
+
+	cdbdisp_segdbAddCachedPlan(segdbDesc, ds->cachedPlanSlot, ds->cachedPlanId);
+	*len = queryTextLen;
+	return queryText;
+}
+
+/*
+ * QE: store a serialized plan received from the QD.
+ */
+void
+cdbdisp_storeCachedPlan(int slot, uint64 planId,
+						const char *splan, int splan_len)
+{
+	QEPlanCacheEntry *entry;
+	char	   *copy;
+
+	if (slot < 0 || slot >= DISPATCH_PLAN_CACHE_SIZE)
+		ereport(ERROR,
+				(errcode(ERRCODE_PROTOCOL_VIOLATION),
+				 errmsg("invalid dispatched plan cache slot %d", slot)));
+
+	copy = MemoryContextAlloc(TopMemoryContext, splan_len);
+	memcpy(copy, splan, splan_len);
+
+	entry = &qePlanCache[slot];
+	if (entry->splan)
+		pfree(entry->splan);
+	entry->planId = planId;
+	entry->splan = copy;
+	entry->splan_len = splan_len;
+}
+
+/*
+ * QE: fetch a plan the QD believes we have cached.
+ *
+ * The returned bytes stay valid until the slot is overwritten by a later
+ * dispatch.
+ */
+const char *
+cdbdisp_lookupCachedPlan(int slot, uint64 planId, int *splan_len)
+{
+	QEPlanCacheEntry *entry;
+
+	if (slot < 0 || slot >= DISPATCH_PLAN_CACHE_SIZE)
+		ereport(ERROR,
+				(errcode(ERRCODE_PROTOCOL_VIOLATION),
+				 errmsg("invalid dispatched plan cache slot %d", slot)));
+
+	entry = &qePlanCache[slot];
+	if (entry->splan == NULL || entry->planId != planId)
+		ereport(ERROR,
+				(errcode(ERRCODE_INTERNAL_ERROR),
+				 errmsg("dispatched plan " UINT64_FORMAT " is not cached in slot %d",
+						planId, slot)));
+
+	*splan_len = entry->splan_len;
+	return entry->splan;
+}
@@ -45,6 +45,7 @@
 #include "cdb/cdbdisp.h"
 #include "cdb/cdbdisp_query.h"
 #include "cdb/cdbdisp_dtx.h"	/* for qdSerializeDtxContextInfo() */
+#include "cdb/cdbdisp_plancache.h"
 #include "cdb/cdbdispatchresult.h"
 #include "cdb/cdbcopy.h"
 #include "executor/execUtils.h"
@@ -95,6 +96,13 @@ typedef struct DispatchCommandQueryParms
 	 */
 	char	   *serializedDtxContextInfo;
 	int			serializedDtxContextInfolen;
+
+	/*
+	 * Id and cache slot of the plan on the QEs, see cdbdisp_plancache.c.
+	 * planId is InvalidDispatchPlanId if the plan is not cached.
+	 */
+	uint64		planId;
+	int			planSlot;
 } DispatchCommandQueryParms;
 
 static int fillSliceVector(SliceTable *sliceTable,
@@ -635,6 +643,12 @@ cdbdisp_buildPlanQueryParms(struct QueryDesc *queryDesc,
 
 	Assert(splan != NULL && splan_len > 0 && splan_len_uncompressed > 0);
 
+	if (gp_enable_qe_plan_cache && splan_len <= DISPATCH_PLAN_CACHE_MAX_PLAN_SIZE)
+	{
+		pQueryParms->planId = cdbdisp_getPlanId(splan, splan_len);
+		pQueryParms->planSlot = cdbdisp_assignPlanCacheSlot(pQueryParms->planId);
+	}
+
 	if (queryDesc->params != NULL && queryDesc->params->numParams > 0)
 	{
 		sparams = serializeParamListInfo(queryDesc->params, &sparams_len);
@@ -857,6 +871,8 @@ buildGpQueryString(DispatchCommandQueryParms *pQueryParms,
 	int			sddesc_len = pQueryParms->serializedQueryDispatchDesclen;
 	const char *dtxContextInfo = pQueryParms->serializedDtxContextInfo;
 	int			dtxContextInfo_len = pQueryParms->serializedDtxContextInfolen;
+	uint64		planId = pQueryParms->planId;
+	int			planSlot = pQueryParms->planSlot;
 	int64		currentStatementStartTimestamp = GetCurrentStatementStartTimestamp();
 	Oid			sessionUserId = GetSessionUserId();
 	Oid			outerUserId = GetOuterUserId();
@@ -890,7 +906,8 @@ buildGpQueryString(DispatchCommandQueryParms *pQueryParms,
 	 * character.
 	 */
 	command_len = strlen(command) + 1;
-	if ((querytree || plantree) && command_len > QUERY_STRING_TRUNCATE_SIZE)
+	if ((querytree || plantree || planId != InvalidDispatchPlanId) &&
+		command_len > QUERY_STRING_TRUNCATE_SIZE)
 		command_len = pg_mbcliplen(command, command_len,
 								   QUERY_STRING_TRUNCATE_SIZE-1) + 1;
 
@@ -911,6 +928,8 @@ buildGpQueryString(DispatchCommandQueryParms *pQueryParms,
 		sizeof(params_len) +
 		sizeof(sddesc_len) +
 		sizeof(dtxContextInfo_len) +
+		sizeof(n32) * 2 /* planId */ +
+		sizeof(planSlot) +
 		dtxContextInfo_len +
 		command_len +
 		querytree_len +
@@ -988,6 +1007,20 @@ buildGpQueryString(DispatchCommandQueryParms *pQueryParms,
 	memcpy(pos, &tmp, sizeof(tmp));
 	pos += sizeof(tmp);
 
+	n32 = (uint32) (planId >> 32);
+	n32 = htonl(n32);
+	memcpy(pos, &n32, sizeof(n32));
+	pos += sizeof(n32);
+
+	n32 = (uint32) planId;
+	n32 = htonl(n32);
+	memcpy(pos, &n32, sizeof(n32));
+	pos += sizeof(n32);
+
+	tmp = htonl(planSlot);
+	memcpy(pos, &tmp, sizeof(planSlot));
+	pos += sizeof(planSlot);
+
 	if (dtxContextInfo_len > 0)
 	{
 		memcpy(pos, dtxContextInfo, dtxContextInfo_len);
@@ -1125,6 +1158,21 @@ cdbdisp_dispatchX(QueryDesc* queryDesc,
 	pQueryParms = cdbdisp_buildPlanQueryParms(queryDesc, planRequiresTxn);
 	queryText = buildGpQueryString(pQueryParms, &queryTextLength);
 
+	/*
+	 * If the plan is cacheable, also build the message for QEs which hold it
+	 * already; it is identical except that the plan is left out.
+	 */
+	if (pQueryParms->planId != InvalidDispatchPlanId)
+	{
+		pQueryParms->serializedPlantree = NULL;
+		pQueryParms->serializedPlantreelen = 0;
+
+		ds->cachedPlanQueryText = buildGpQueryString(pQueryParms,
+													 &ds->cachedPlanQueryTextLen);
+		ds->cachedPlanId = pQueryParms->planId;
+		ds->cachedPlanSlot = pQueryParms->planSlot;
+	}
+
 	/*
 	 * Allocate result array with enough slots for QEs of primary gangs.
 	 */
@@ -0,0 +1,152 @@
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include "cmockery.h"
+
+#include "../cdbdisp_plancache.c"
+
+/*
+ * A plan keeps its slot while it is dispatched repeatedly, and slots are
+ * recycled round-robin for new plans.
+ */
+static void
+test__cdbdisp_assignPlanCacheSlot__reuses_and_recycles(void **state)
+{
+	int			slot;
+	int			i;
+
+	slot = cdbdisp_assignPlanCacheSlot(100);
+	assert_int_equal(cdbdisp_assignPlanCacheSlot(100), slot);
+
+	for (i = 1; i < DISPATCH_PLAN_CACHE_SIZE; i++)
+		assert_int_not_equal(cdbdisp_assignPlanCacheSlot(100 + i), slot);
+
+	/* the cache is full, the oldest plan loses its slot */
+	assert_int_equal(cdbdisp_assignPlanCacheSlot(1000), slot);
+	assert_int_not_equal(cdbdisp_assignPlanCacheSlot(100), slot);
+}
+
+/*
+ * The QD forgets everything a QE holds, e.g. after the QE failed.
+ */
+static void
+test__cdbdisp_segdbForgetCachedPlans(void **state)
+{
+	SegmentDatabaseDescriptor *segdbDesc = palloc0(sizeof(SegmentDatabaseDescriptor));
+
+	assert_false(cdbdisp_segdbHasCachedPlan(segdbDesc, 3, 42));
+	cdbdisp_segdbAddCachedPlan(segdbDesc, 3, 42);
+	assert_true(cdbdisp_segdbHasCachedPlan(segdbDesc, 3, 42));
+	assert_false(cdbdisp_segdbHasCachedPlan(segdbDesc, 4, 42));
+
+	cdbdisp_segdbForgetCachedPlans(segdbDesc);
+	assert_false(cdbdisp_segdbHasCachedPlan(segdbDesc, 3, 42));
+}
+
+/*
+ * A QE returns the stored bytes, and errors out if the slot holds a
+ * different plan.
+ */
+static void
+test__cdbdisp_lookupCachedPlan(void **state)
+{
+	const char *splan = "serialized plan";
+	const char *cached;
+	int			len = 0;
+	bool		errored = false;
+
+	cdbdisp_storeCachedPlan(2, 7, splan, strlen(splan) + 1);
+
+	cached = cdbdisp_lookupCachedPlan(2, 7, &len);
+	assert_int_equal(len, strlen(splan) + 1);
+	assert_string_equal(cached, splan);
+
+	PG_TRY();
+	{
+		cdbdisp_lookupCachedPlan(2, 8, &len);
+	}
+	PG_CATCH();
+	{
+		FlushErrorState();
+		errored = true;
+	}
+	PG_END_TRY();
+
+	assert_true(errored);
+}
+
+/*
+ * Dispatch the same plan twice to one QE.  The first dispatch sends the full
+ * message and the QE stores the plan; the second one finds the plan in the
+ * same slot, sends the message without it, and the QE reads the stored plan.
+ */
+static void
+test__cdbdisp_selectPlanQueryText__repeated_dispatch_hits(void **state)
+{
+	const char *splan = "serialized plan dispatched twice";
+	int			splan_len = strlen(splan) + 1;
+	char	   *fullText = "message with the plan";
+	char	   *cachedText = "message without the plan";
+	SegmentDatabaseDescriptor *segdbDesc = palloc0(sizeof(SegmentDatabaseDescriptor));
+	CdbDispatcherState ds;
+	const char *text;
+	const char *cached;
+	uint64		planId;
+	int			slot;
+	int			len;
+
+	/* first dispatch: the QE does not hold the plan */
+	planId = cdbdisp_getPlanId(splan, splan_len);
+	slot = cdbdisp_assignPlanCacheSlot(planId);
+
+	MemSet(&ds, 0, sizeof(ds));
+	ds.cachedPlanQueryText = cachedText;
+	ds.cachedPlanQueryTextLen = strlen(cachedText) + 1;
+	ds.cachedPlanId = planId;
+	ds.cachedPlanSlot = slot;
+
+	text = cdbdisp_selectPlanQueryText(&ds, segdbDesc,
+									   fullText, strlen(fullText) + 1, &len);
+	assert_true(text == fullText);
+	assert_int_equal(len, strlen(fullText) + 1);
+	assert_true(cdbdisp_segdbHasCachedPlan(segdbDesc, slot, planId));
+
+	cdbdisp_storeCachedPlan(slot, planId, splan, splan_len);
+
+	/* second dispatch of the same plan: a hit */
+	assert_int_equal(cdbdisp_getPlanId(splan, splan_len), planId);
+	assert_int_equal(cdbdisp_assignPlanCacheSlot(planId), slot);
+
+	text = cdbdisp_selectPlanQueryText(&ds, segdbDesc,
+									   fullText, strlen(fullText) + 1, &len);
+	assert_true(text == cachedText);
+	assert_int_equal(len, strlen(cachedText) + 1);
+
+	cached = cdbdisp_lookupCachedPlan(slot, planId, &len);
+	assert_int_equal(len, splan_len);
+	assert_string_equal(cached, splan);
+
+	/* after the QE failed, the plan is sent in full again */
+	cdbdisp_segdbForgetCachedPlans(segdbDesc);
+	text = cdbdisp_selectPlanQueryText(&ds, segdbDesc,
+									   fullText, strlen(fullText) + 1, &len);
+	assert_true(text == fullText);
+}
+
+int
+main(int argc, char *argv[])
+{
+	cmockery_parse_arguments(argc, argv);
+
+	const		UnitTest tests[] =
+	{
+		unit_test(test__cdbdisp_assignPlanCacheSlot__reuses_and_recycles),
+		unit_test(test__cdbdisp_segdbForgetCachedPlans),
+		unit_test(test__cdbdisp_lookupCachedPlan),
+		unit_test(test__cdbdisp_selectPlanQueryText__repeated_dispatch_hits)
+	};
+
+	MemoryContextInit();
+
+	return run_tests(tests);
+}
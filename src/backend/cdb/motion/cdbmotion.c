@@ -350,6 +350,42 @@ SendStopMessage(MotionLayerState *mlStates,
 		transportStates->doSendStopMessage(transportStates, motNodeID);
 }
 
+/*
+ * Send a runtime filter to all the senders of the motion node.
+ *
+ * Returns false if the interconnect cannot send it.
+ */
+bool
+SendRuntimeFilter(ChunkTransportState *transportStates,
+				  int16 motNodeID,
+				  const char *data, int len)
+{
+	if (transportStates == NULL || transportStates->doSendRuntimeFilter == NULL)
+		return false;
+
+	transportStates->doSendRuntimeFilter(transportStates, motNodeID, data, len);
+	return true;
+}
+
+/*
+ * Wait up to timeout_ms for the runtime filters of all the receivers of the
+ * motion node, passing each one to the callback as it arrives.
+ *
+ * Returns true if every receiver has either sent its filter or stopped, false
+ * on timeout or if the interconnect cannot receive filters.
+ */
+bool
+RecvRuntimeFilters(ChunkTransportState *transportStates,
+				   int16 motNodeID, int timeout_ms,
+				   RuntimeFilterCallback callback, void *arg)
+{
+	if (transportStates == NULL || transportStates->doRecvRuntimeFilters == NULL)
+		return false;
+
+	return transportStates->doRecvRuntimeFilters(transportStates, motNodeID,
+												 timeout_ms, callback, arg);
+}
+
 void
 CheckAndSendRecordCache(MotionLayerState *mlStates,
 						ChunkTransportState *transportStates,
@@ -462,13 +462,20 @@ ic_proxy_client_blessed_lookup(uv_loop_t *loop, const ICProxyKey *key)
 static void
 ic_proxy_client_route_c2p_data(void *opaque, const void *data, uint16 size)
 {
-	const ICProxyPkt *pkt = data;
+	const ICProxyPkt *pkt PG_USED_FOR_ASSERTS_ONLY = data;
 	ICProxyClient *client = opaque;
 
 	Assert(ic_proxy_pkt_is_from_client(pkt, &client->key));
 	Assert(ic_proxy_pkt_is_live(pkt, &client->key));
+	Assert(data == client->obuf.buf);
 
-	ic_proxy_router_route(client->pipe.loop, ic_proxy_pkt_dup(pkt), NULL, NULL);
+	/*
+	 * The packet is the obuf's buffer, pass it on directly instead of
+	 * duplicating it, the obuf gets a new buffer.
+	 */
+	ic_proxy_router_route(client->pipe.loop,
+						  ic_proxy_obuf_steal_buffer(&client->obuf),
+						  NULL, NULL);
 }
 
 /*
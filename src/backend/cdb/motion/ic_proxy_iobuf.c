@@ -364,6 +364,30 @@ ic_proxy_obuf_push(ICProxyOBuf *obuf,
 	}
 }
 
+/*
+ * Take over the buffer of the obuf.
+ *
+ * This can only be called from the obuf callback, the returned buffer is the
+ * packet that was just fed to the callback, and the caller owns it from now
+ * on.  A new buffer, with the same header, is installed in the obuf, so it can
+ * keep on collecting data.
+ *
+ * This saves a full packet copy when the packet is passed on as is, only the
+ * header is copied.
+ */
+void *
+ic_proxy_obuf_steal_buffer(ICProxyOBuf *obuf)
+{
+	char	   *buf = obuf->buf;
+
+	Assert(buf != NULL);
+
+	obuf->buf = ic_proxy_pkt_cache_alloc(NULL);
+	memcpy(obuf->buf, buf, obuf->header_size);
+
+	return buf;
+}
+
 /*
  * Set the packet size of a b2c one.
  *
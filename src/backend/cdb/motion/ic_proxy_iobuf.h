@@ -51,6 +51,7 @@ extern void ic_proxy_obuf_init_b2c(ICProxyOBuf *obuf);
 extern void ic_proxy_obuf_init_p2p(ICProxyOBuf *obuf);
 extern void ic_proxy_obuf_uninit(ICProxyOBuf *obuf);
 extern void *ic_proxy_obuf_ensure_buffer(ICProxyOBuf *obuf);
+extern void *ic_proxy_obuf_steal_buffer(ICProxyOBuf *obuf);
 extern void ic_proxy_obuf_push(ICProxyOBuf *obuf,
 							   const char *data, uint16 size,
 							   ic_proxy_iobuf_data_callback callback,
@@ -297,6 +297,12 @@ ic_proxy_peer_on_data_pkt(void *opaque, const void *data, uint16 size)
 		return;
 	}
 
+	if (peer->stats)
+	{
+		peer->stats->recvPkts++;
+		peer->stats->recvBytes += size;
+	}
+
 	ic_proxy_router_route(peer->tcp.loop, ic_proxy_pkt_dup(pkt), NULL, NULL);
 }
 
@@ -333,6 +339,32 @@ ic_proxy_peer_on_data(uv_stream_t *stream, ssize_t nread, const uv_buf_t *buf)
 		return;
 	}
 
+	/*
+	 * Fast path: the buffer holds exactly one complete packet, and nothing is
+	 * pending in the ibuf.  This is the common case for full-sized DATA
+	 * packets.  The buffer comes from the packet cache, so route it as is
+	 * instead of copying the packet out of it.
+	 */
+	if (ic_proxy_ibuf_empty(&peer->ibuf) &&
+		nread >= sizeof(ICProxyPkt) &&
+		((const ICProxyPkt *) buf->base)->len == nread &&
+		(peer->state & IC_PROXY_PEER_STATE_READY_FOR_DATA))
+	{
+		ICProxyPkt *pkt = (ICProxyPkt *) buf->base;
+
+		elogif(gp_log_interconnect >= GPVARS_VERBOSITY_DEBUG, DEBUG5,
+			   "ic-proxy: %s: received %s", peer->name, ic_proxy_pkt_to_str(pkt));
+
+		if (peer->stats)
+		{
+			peer->stats->recvPkts++;
+			peer->stats->recvBytes += nread;
+		}
+
+		ic_proxy_router_route(peer->tcp.loop, pkt, NULL, NULL);
+		return;
+	}
+
 	ic_proxy_ibuf_push(&peer->ibuf, buf->base, nread,
 					   ic_proxy_peer_on_data_pkt, peer);
 	ic_proxy_pkt_cache_free(buf->base);
@@ -351,6 +383,7 @@ ic_proxy_peer_new(uv_loop_t *loop, int16 content, uint16 dbid)
 	peer->dbid = dbid;
 	peer->state = 0;
 	peer->reqs = NIL;
+	peer->stats = NULL;
 
 	ic_proxy_ibuf_init_p2p(&peer->ibuf);
 
@@ -500,6 +533,7 @@ ic_proxy_peer_on_sent_hello_ack(void *opaque, const ICProxyPkt *pkt, int status)
 	}
 
 	peer->state |= IC_PROXY_PEER_STATE_SENT_HELLO_ACK;
+	peer->stats = ic_proxy_stats_get_route(peer->content, peer->dbid);
 
 	elogif(gp_log_interconnect >= GPVARS_VERBOSITY_DEBUG, DEBUG3,
 		   "ic-proxy: %s: start receiving DATA", peer->name);
@@ -668,6 +702,7 @@ ic_proxy_peer_on_hello_ack_pkt(void *opaque, const void *data, uint16 size)
 		   "ic-proxy: %s: received %s", peer->name, ic_proxy_pkt_to_str(pkt));
 
 	peer->state |= IC_PROXY_PEER_STATE_RECEIVED_HELLO_ACK;
+	peer->stats = ic_proxy_stats_get_route(peer->content, peer->dbid);
 
 	/* do not clear the ibuf, it could already contain incoming DATA */
 
@@ -855,7 +890,8 @@ ic_proxy_peer_route_data(ICProxyPeer *peer, ICProxyPkt *pkt,
 		return;
 	}
 
-	ic_proxy_router_write((uv_stream_t *) &peer->tcp, pkt, 0, callback, opaque);
+	ic_proxy_router_write_extended((uv_stream_t *) &peer->tcp, pkt, 0,
+								   peer->stats, callback, opaque);
 }
 
 /*
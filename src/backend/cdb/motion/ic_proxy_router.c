@@ -38,6 +38,9 @@ struct ICProxyWriteReq
 
 	ic_proxy_sent_cb callback;	/* the callback */
 	void	   *opaque;			/* the callback data */
+
+	ICProxyRouteStats *stats;	/* the route stats to update, or NULL */
+	uint64		startTime;		/* when the write was issued, in ns */
 };
 
 /*
@@ -267,6 +270,17 @@ ic_proxy_router_on_write(uv_write_t *req, int status)
 					 ic_proxy_pkt_to_str(pkt));
 	}
 
+	if (wreq->stats && status >= 0)
+	{
+		uint64		usecs = (uv_hrtime() - wreq->startTime) / 1000;
+
+		wreq->stats->sentPkts++;
+		wreq->stats->sentBytes += pkt->len;
+		wreq->stats->writeTimeUs += usecs;
+		if (usecs > wreq->stats->maxWriteTimeUs)
+			wreq->stats->maxWriteTimeUs = usecs;
+	}
+
 	if (wreq->callback)
 		wreq->callback(wreq->opaque, pkt, status);
 
@@ -295,6 +309,21 @@ ic_proxy_router_on_write(uv_write_t *req, int status)
 void
 ic_proxy_router_write(uv_stream_t *stream, ICProxyPkt *pkt, int32 offset,
 					  ic_proxy_sent_cb callback, void *opaque)
+{
+	ic_proxy_router_write_extended(stream, pkt, offset, NULL,
+								   callback, opaque);
+}
+
+/*
+ * Write a packet to a libuv stream, and account it in the route stats.
+ *
+ * Same as ic_proxy_router_write(), in addition the packet and the time it
+ * takes for the write to complete are recorded in "stats" if it is not NULL.
+ */
+void
+ic_proxy_router_write_extended(uv_stream_t *stream, ICProxyPkt *pkt,
+							   int32 offset, ICProxyRouteStats *stats,
+							   ic_proxy_sent_cb callback, void *opaque)
 {
 	ICProxyWriteReq *wreq;
 	uv_buf_t	wbuf;
@@ -307,6 +336,8 @@ ic_proxy_router_write(uv_stream_t *stream, ICProxyPkt *pkt, int32 offset,
 	wreq->req.data = pkt;
 	wreq->callback = callback;
 	wreq->opaque = opaque;
+	wreq->stats = stats;
+	wreq->startTime = stats ? uv_hrtime() : 0;
 
 	wbuf.base = ((char *) pkt) + offset;
 	wbuf.len = pkt->len - offset;
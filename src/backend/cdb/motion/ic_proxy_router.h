@@ -29,6 +29,11 @@ extern void ic_proxy_router_route(uv_loop_t *loop, ICProxyPkt *pkt,
 extern void ic_proxy_router_write(uv_stream_t *stream,
 								  ICProxyPkt *pkt, int32 offset,
 								  ic_proxy_sent_cb callback, void *opaque);
+extern void ic_proxy_router_write_extended(uv_stream_t *stream,
+										   ICProxyPkt *pkt, int32 offset,
+										   struct ICProxyRouteStats *stats,
+										   ic_proxy_sent_cb callback,
+										   void *opaque);
 
 
 #endif   /* IC_PROXY_ROUTER_H */
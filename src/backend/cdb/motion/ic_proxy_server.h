@@ -16,6 +16,8 @@
 
 #include <uv.h>
 
+#include "cdb/ic_proxy_stats.h"
+
 #include "ic_proxy.h"
 #include "ic_proxy_iobuf.h"
 #include "ic_proxy_packet.h"
@@ -68,6 +70,9 @@ struct ICProxyPeer
 
 	ICProxyIBuf	ibuf;			/* ibuf detects the packet boundaries */
 
+	ICProxyRouteStats *stats;	/* stats of the route to the peer, resolved
+								 * once the peer is ready for data */
+
 	char		name[128];		/* name of the client, only for logging */
 };
 
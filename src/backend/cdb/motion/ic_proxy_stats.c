@@ -0,0 +1,176 @@
+/*-------------------------------------------------------------------------
+ *
+ * ic_proxy_stats.c
+ *
+ *    Interconnect Proxy Statistics
+ *
+ * The proxy bgworker counts the packets and bytes it exchanges with every
+ * peer, and how long the writes to the peer take to complete.  The counters
+ * are kept in shared memory, so they can be queried with the SQL function
+ * gp_ic_proxy_route_stats() from any backend.
+ *
+ * This file is built even without ic-proxy support, so that the SQL function
+ * always exists; it returns no rows then.
+ *
+ *
+ * Copyright (c) 2020-Present Pivotal Software, Inc.
+ *
+ *
+ *-------------------------------------------------------------------------
+ */
+
+#include "postgres.h"
+
+#include "access/htup_details.h"
+#include "catalog/pg_type.h"
+#include "cdb/cdbvars.h"
+#include "cdb/ic_proxy_stats.h"
+#include "funcapi.h"
+#include "storage/barrier.h"
+#include "storage/shmem.h"
+
+typedef struct ICProxyStatsShmem
+{
+	int			nroutes;		/* number of used routes */
+	ICProxyRouteStats routes[IC_PROXY_STATS_MAX_ROUTES];
+} ICProxyStatsShmem;
+
+static ICProxyStatsShmem *ic_proxy_stats = NULL;
+
+Size
+ICProxyStatsShmemSize(void)
+{
+#ifdef ENABLE_IC_PROXY
+	return sizeof(ICProxyStatsShmem);
+#else
+	return 0;
+#endif  /* ENABLE_IC_PROXY */
+}
+
+void
+ICProxyStatsShmemInit(void)
+{
+#ifdef ENABLE_IC_PROXY
+	bool		found;
+
+	ic_proxy_stats = ShmemInitStruct("IC Proxy Route Stats",
+									 ICProxyStatsShmemSize(), &found);
+	if (!found)
+		MemSet(ic_proxy_stats, 0, ICProxyStatsShmemSize());
+#endif  /* ENABLE_IC_PROXY */
+}
+
+/*
+ * Get the stats of the route to the peer, creating it if needed.
+ *
+ * Only called by the proxy bgworker.  Return NULL if no more routes can be
+ * tracked.
+ */
+ICProxyRouteStats *
+ic_proxy_stats_get_route(int16 content, uint16 dbid)
+{
+	ICProxyRouteStats *stats;
+	int			i;
+
+	if (ic_proxy_stats == NULL)
+		return NULL;
+
+	for (i = 0; i < ic_proxy_stats->nroutes; i++)
+	{
+		stats = &ic_proxy_stats->routes[i];
+
+		if (stats->dbid == dbid)
+			return stats;
+	}
+
+	if (ic_proxy_stats->nroutes >= IC_PROXY_STATS_MAX_ROUTES)
+		return NULL;
+
+	stats = &ic_proxy_stats->routes[ic_proxy_stats->nroutes];
+	MemSet(stats, 0, sizeof(*stats));
+	stats->content = content;
+	stats->dbid = dbid;
+
+	/* make the route visible to readers only after it is initialized */
+	pg_write_barrier();
+	ic_proxy_stats->nroutes++;
+
+	return stats;
+}
+
+/*
+ * SQL function to show the stats of all the routes of the local proxy.
+ */
+Datum
+gp_ic_proxy_route_stats(PG_FUNCTION_ARGS)
+{
+	FuncCallContext *funcctx;
+	int		   *nroutes;
+
+	if (SRF_IS_FIRSTCALL())
+	{
+		TupleDesc	tupdesc;
+		MemoryContext oldcontext;
+
+		funcctx = SRF_FIRSTCALL_INIT();
+
+		oldcontext = MemoryContextSwitchTo(funcctx->multi_call_memory_ctx);
+
+		tupdesc = CreateTemplateTupleDesc(9, false);
+		TupleDescInitEntry(tupdesc, (AttrNumber) 1, "segid",
+						   INT4OID, -1, 0);
+		TupleDescInitEntry(tupdesc, (AttrNumber) 2, "peer_content",
+						   INT4OID, -1, 0);
+		TupleDescInitEntry(tupdesc, (AttrNumber) 3, "peer_dbid",
+						   INT4OID, -1, 0);
+		TupleDescInitEntry(tupdesc, (AttrNumber) 4, "sent_packets",
+						   INT8OID, -1, 0);
+		TupleDescInitEntry(tupdesc, (AttrNumber) 5, "sent_bytes",
+						   INT8OID, -1, 0);
+		TupleDescInitEntry(tupdesc, (AttrNumber) 6, "recv_packets",
+						   INT8OID, -1, 0);
+		TupleDescInitEntry(tupdesc, (AttrNumber) 7, "recv_bytes",
+						   INT8OID, -1, 0);
+		TupleDescInitEntry(tupdesc, (AttrNumber) 8, "write_time_us",
+						   INT8OID, -1, 0);
+		TupleDescInitEntry(tupdesc, (AttrNumber) 9, "max_write_time_us",
+						   INT8OID, -1, 0);
+
+		funcctx->tuple_desc = BlessTupleDesc(tupdesc);
+
+		nroutes = palloc(sizeof(int));
+		*nroutes = ic_proxy_stats ? ic_proxy_stats->nroutes : 0;
+		pg_read_barrier();
+		funcctx->user_fctx = nroutes;
+
+		MemoryContextSwitchTo(oldcontext);
+	}
+
+	funcctx = SRF_PERCALL_SETUP();
+	nroutes = funcctx->user_fctx;
+
+	if (funcctx->call_cntr < *nroutes)
+	{
+		volatile ICProxyRouteStats *stats = &ic_proxy_stats->routes[funcctx->call_cntr];
+		Datum		values[9];
+		bool		nulls[9];
+		HeapTuple	tuple;
+
+		MemSet(nulls, false, sizeof(nulls));
+
+		values[0] = Int32GetDatum(GpIdentity.segindex);
+		values[1] = Int32GetDatum(stats->content);
+		values[2] = Int32GetDatum(stats->dbid);
+		values[3] = Int64GetDatum(stats->sentPkts);
+		values[4] = Int64GetDatum(stats->sentBytes);
+		values[5] = Int64GetDatum(stats->recvPkts);
+		values[6] = Int64GetDatum(stats->recvBytes);
+		values[7] = Int64GetDatum(stats->writeTimeUs);
+		values[8] = Int64GetDatum(stats->maxWriteTimeUs);
+
+		tuple = heap_form_tuple(funcctx->tuple_desc, values, nulls);
+		SRF_RETURN_NEXT(funcctx, HeapTupleGetDatum(tuple));
+	}
+
+	SRF_RETURN_DONE(funcctx);
+}
@@ -22,6 +22,7 @@
 #include "libpq/ip.h"
 #include "postmaster/postmaster.h"
 #include "utils/builtins.h"
+#include "utils/memutils.h"
 
 #include "cdb/cdbselect.h"
 #include "cdb/tupchunklist.h"
@@ -37,6 +38,7 @@
 #include <limits.h>
 #include <unistd.h>
 #include <arpa/inet.h>
+#include <sys/stat.h>
 #include <sys/time.h>
 #include <netinet/in.h>
 
@@ -54,6 +56,34 @@ int			listenerBacklog = 128;
 /* our timeout value for select() and other socket operations. */
 static struct timeval tval;
 
+/*
+ * Host-local listener, see gp_interconnect_tcp_local_socket.  Senders on the
+ * same host find it by the receiver's pid and TCP listener port, which they
+ * already know from its CdbProcess.
+ *
+ * The sockets live in a directory that only the OS user running the cluster
+ * may enter, so no other local user can create or connect to them; accepted
+ * connections are checked to come from that user as well.
+ */
+static int	TCP_localListenerFd = -1;
+static char TCP_localListenerPath[UNIXSOCK_PATH_BUFLEN];
+
+static inline void
+buildLocalSocketDir(char *buf, size_t bufsize)
+{
+	snprintf(buf, bufsize, "%s/.s.PGSQL.ic_tcp.%d",
+			 DEFAULT_PGSOCKET_DIR, (int) geteuid());
+}
+
+static inline void
+buildLocalSocketPath(char *buf, size_t bufsize, int pid, int port)
+{
+	char		dir[MAXPGPATH];
+
+	buildLocalSocketDir(dir, sizeof(dir));
+	snprintf(buf, bufsize, "%s/%d.%d", dir, port, pid);
+}
+
 static inline MotionConn *
 getMotionConn(ChunkTransportStateEntry *pEntry, int iConn)
 {
@@ -71,14 +101,16 @@ static ChunkTransportStateEntry *startOutgoingConnections(ChunkTransportState *t
 static void format_fd_set(StringInfo buf, int nfds, mpp_fd_set *fds, char *pfx, char *sfx);
 static void setupOutgoingConnection(ChunkTransportState *transportStates,
 						ChunkTransportStateEntry *pEntry, MotionConn *conn);
+static bool setupLocalOutgoingConnection(ChunkTransportState *transportStates,
+							 ChunkTransportStateEntry *pEntry, MotionConn *conn);
 static void updateOutgoingConnection(ChunkTransportState *transportStates,
 						 ChunkTransportStateEntry *pEntry, MotionConn *conn, int errnoSave);
 static void sendRegisterMessage(ChunkTransportState *transportStates, ChunkTransportStateEntry *pEntry, MotionConn *conn);
 static bool readRegisterMessage(ChunkTransportState *transportStates,
 					MotionConn *conn);
-static MotionConn *acceptIncomingConnection(void);
+static MotionConn *acceptIncomingConnection(int listenerFd);
 
-static void flushInterconnectListenerBacklog(void);
+static void flushInterconnectListenerBacklog(int listenerFd);
 
 static void waitOnOutbound(ChunkTransportStateEntry *pEntry);
 
@@ -100,6 +132,11 @@ static bool flushBuffer(ChunkTransportState *transportStates,
 			ChunkTransportStateEntry *pEntry, MotionConn *conn, int16 motionId);
 
 static void doSendStopMessageTCP(ChunkTransportState *transportStates, int16 motNodeID);
+static void doSendRuntimeFilterTCP(ChunkTransportState *transportStates, int16 motNodeID,
+					   const char *data, int len);
+static bool doRecvRuntimeFiltersTCP(ChunkTransportState *transportStates, int16 motNodeID,
+						int timeout_ms, RuntimeFilterCallback callback, void *arg);
+static bool readRuntimeFilterMessage(MotionConn *conn);
 
 #ifdef AMS_VERBOSE_LOGGING
 static void dumpEntryConnections(int elevel, ChunkTransportStateEntry *pEntry);
@@ -265,6 +302,97 @@ error:
 			 errdetail("%s: %m", fun)));
 }								/* setupListeningSocket */
 
+/*
+ * setupLocalListeningSocket
+ *
+ * Listen on a Unix-domain socket next to the TCP listener.  Failure is not
+ * fatal: senders that cannot reach this socket simply fall back to TCP.
+ */
+static void
+setupLocalListeningSocket(int backlog, uint16 listenerPort)
+{
+	struct sockaddr_un addr;
+	struct stat st;
+	char		dir[MAXPGPATH];
+	int			errnoSave;
+	int			fd = -1;
+	const char *fun;
+
+	/*
+	 * Create the socket directory, or make sure the one that is there belongs
+	 * to us and is private.  Anybody else could have created it first.
+	 */
+	buildLocalSocketDir(dir, sizeof(dir));
+	if (mkdir(dir, S_IRWXU) < 0 && errno != EEXIST)
+	{
+		ereport(LOG,
+				(errcode(ERRCODE_GP_INTERCONNECTION_ERROR),
+				 errmsg("interconnect could not set up host-local listener socket, using tcp only"),
+				 errdetail("mkdir \"%s\": %m", dir)));
+		return;
+	}
+	if (lstat(dir, &st) < 0)
+	{
+		ereport(LOG,
+				(errcode(ERRCODE_GP_INTERCONNECTION_ERROR),
+				 errmsg("interconnect could not set up host-local listener socket, using tcp only"),
+				 errdetail("lstat \"%s\": %m", dir)));
+		return;
+	}
+	if (!S_ISDIR(st.st_mode) || st.st_uid != geteuid() ||
+		(st.st_mode & (S_IRWXG | S_IRWXO)) != 0)
+	{
+		ereport(LOG,
+				(errcode(ERRCODE_GP_INTERCONNECTION_ERROR),
+				 errmsg("interconnect could not set up host-local listener socket, using tcp only"),
+				 errdetail("\"%s\" is not a directory accessible only by the current user.",
+						   dir)));
+		return;
+	}
+
+	buildLocalSocketPath(TCP_localListenerPath, sizeof(TCP_localListenerPath),
+						 MyProcPid, listenerPort);
+
+	/* A previous backend with the same pid may have left its file behind. */
+	unlink(TCP_localListenerPath);
+
+	MemSet(&addr, 0, sizeof(addr));
+	addr.sun_family = AF_UNIX;
+	strlcpy(addr.sun_path, TCP_localListenerPath, sizeof(addr.sun_path));
+
+	fun = "socket";
+	fd = socket(AF_UNIX, SOCK_STREAM, 0);
+	if (fd < 0)
+		goto error;
+
+	fun = "bind";
+	if (bind(fd, (struct sockaddr *) &addr, sizeof(addr)) < 0)
+		goto error;
+
+	fun = "fcntl(O_NONBLOCK)";
+	if (!pg_set_noblock(fd))
+		goto error;
+
+	fun = "listen";
+	if (listen(fd, backlog) < 0)
+		goto error;
+
+	TCP_localListenerFd = fd;
+	return;
+
+error:
+	errnoSave = errno;
+	if (fd >= 0)
+		closesocket(fd);
+	unlink(TCP_localListenerPath);
+	TCP_localListenerPath[0] = '\0';
+	errno = errnoSave;
+	ereport(LOG,
+			(errcode(ERRCODE_GP_INTERCONNECTION_ERROR),
+			 errmsg("interconnect could not set up host-local listener socket, using tcp only"),
+			 errdetail("%s: %m", fun)));
+}								/* setupLocalListeningSocket */
+
 /*
  * Initialize TCP specific comms.
  */
@@ -276,6 +404,10 @@ InitMotionTCP(int *listenerSocketFd, uint16 *listenerPort)
 
 	setupTCPListeningSocket(listenerBacklog, listenerSocketFd, listenerPort);
 
+	if (gp_interconnect_tcp_local_socket &&
+		Gp_interconnect_type == INTERCONNECT_TYPE_TCP)
+		setupLocalListeningSocket(listenerBacklog, *listenerPort);
+
 	return;
 }
 
@@ -283,8 +415,17 @@ InitMotionTCP(int *listenerSocketFd, uint16 *listenerPort)
 void
 CleanupMotionTCP(void)
 {
-	/* nothing to do. */
-	return;
+	if (TCP_localListenerFd >= 0)
+	{
+		closesocket(TCP_localListenerFd);
+		TCP_localListenerFd = -1;
+	}
+
+	if (TCP_localListenerPath[0] != '\0')
+	{
+		unlink(TCP_localListenerPath);
+		TCP_localListenerPath[0] = '\0';
+	}
 }
 
 /* Function readPacket() is used to read in the next packet from the given
@@ -484,6 +625,7 @@ startOutgoingConnections(ChunkTransportState *transportStates,
 	ListCell   *cell;
 	Slice	   *recvSlice;
 	CdbProcess *cdbProc;
+	char	   *localAddr = NULL;
 
 	*pOutgoingCount = 0;
 
@@ -507,6 +649,26 @@ startOutgoingConnections(ChunkTransportState *transportStates,
 									   recvSlice,
 									   list_length(recvSlice->primaryProcesses));
 
+	/*
+	 * Find our own interconnect address, receivers sharing it are on this
+	 * host and may be reached through their Unix-domain listener.
+	 */
+	if (gp_interconnect_tcp_local_socket &&
+		Gp_interconnect_type == INTERCONNECT_TYPE_TCP)
+	{
+		foreach(cell, sendSlice->primaryProcesses)
+		{
+			cdbProc = (CdbProcess *) lfirst(cell);
+			if (cdbProc &&
+				cdbProc->pid == MyProcPid &&
+				cdbProc->contentid == GpIdentity.segindex)
+			{
+				localAddr = cdbProc->listenerAddr;
+				break;
+			}
+		}
+	}
+
 	/*
 	 * Setup a MotionConn entry for each of our outbound connections. Request
 	 * a connection to each receiving backend's listening port.
@@ -521,6 +683,8 @@ startOutgoingConnections(ChunkTransportState *transportStates,
 			conn->cdbProc = cdbProc;
 			conn->pBuff = palloc(Gp_max_packet_size);
 			conn->state = mcsSetupOutgoingConnection;
+			conn->tryLocalSocket = (localAddr != NULL &&
+									strcmp(cdbProc->listenerAddr, localAddr) == 0);
 			(*pOutgoingCount)++;
 		}
 		conn++;
@@ -604,6 +768,15 @@ setupOutgoingConnection(ChunkTransportState *transportStates, ChunkTransportStat
 	}
 #endif  /* ENABLE_IC_PROXY */
 
+	if (conn->tryLocalSocket)
+	{
+		if (setupLocalOutgoingConnection(transportStates, pEntry, conn))
+			return;
+
+		/* The receiver has no local listener, use TCP from now on. */
+		conn->tryLocalSocket = false;
+	}
+
 	/* Initialize hint structure */
 	MemSet(&hint, 0, sizeof(hint));
 	hint.ai_socktype = SOCK_STREAM;
@@ -701,6 +874,98 @@ setupOutgoingConnection(ChunkTransportState *transportStates, ChunkTransportStat
 }								/* setupOutgoingConnection */
 
 
+/*
+ * setupLocalOutgoingConnection
+ *
+ * Like setupOutgoingConnection, but for a receiver on this host: connect to
+ * its Unix-domain listener.
+ *
+ * Returns false if the receiver does not listen locally (for example, it
+ * started with gp_interconnect_tcp_local_socket off); the caller should then
+ * fall back to TCP.  Otherwise conn->state is set as setupOutgoingConnection
+ * describes.
+ */
+static bool
+setupLocalOutgoingConnection(ChunkTransportState *transportStates, ChunkTransportStateEntry *pEntry, MotionConn *conn)
+{
+	CdbProcess *cdbProc = conn->cdbProc;
+	struct sockaddr_un addr;
+
+	MemSet(&addr, 0, sizeof(addr));
+	addr.sun_family = AF_UNIX;
+	buildLocalSocketPath(addr.sun_path, sizeof(addr.sun_path),
+						 cdbProc->pid, cdbProc->listenerPort);
+
+	conn->sockfd = socket(AF_UNIX, SOCK_STREAM, 0);
+	if (conn->sockfd < 0)
+		ereport(ERROR,
+				(errcode(ERRCODE_GP_INTERCONNECTION_ERROR),
+				 errmsg("interconnect error setting up outgoing connection"),
+				 errdetail("%s: %m", "socket")));
+
+	if (!pg_set_noblock(conn->sockfd))
+		ereport(ERROR,
+				(errcode(ERRCODE_GP_INTERCONNECTION_ERROR),
+				 errmsg("interconnect error setting up outgoing connection"),
+				 errdetail("%s: %m", "fcntl(O_NONBLOCK)")));
+
+	for (;;)
+	{							/* connect() EINTR retry loop */
+		ML_CHECK_FOR_INTERRUPTS(transportStates->teardownActive);
+
+		if (connect(conn->sockfd, (struct sockaddr *) &addr, sizeof(addr)) == 0)
+		{
+			if (gp_log_interconnect >= GPVARS_VERBOSITY_DEBUG)
+				ereport(DEBUG1, (errmsg("Interconnect connected to seg%d slice%d %s "
+										"pid=%d sockfd=%d through %s",
+										conn->remoteContentId,
+										pEntry->recvSlice->sliceIndex,
+										conn->remoteHostAndPort,
+										cdbProc->pid,
+										conn->sockfd,
+										addr.sun_path)));
+
+			sendRegisterMessage(transportStates, pEntry, conn);
+			return true;
+		}
+
+		if (errno == EINTR)
+			continue;
+
+		if (errno == EINPROGRESS)
+		{
+			conn->state = mcsConnecting;
+			return true;
+		}
+
+		/*
+		 * A non-blocking connect() to a Unix-domain socket whose backlog is
+		 * full fails with EAGAIN instead of completing later.  Close it and
+		 * let the caller retry after a while, as for a failed TCP connect.
+		 */
+		if (errno == EAGAIN)
+		{
+			closesocket(conn->sockfd);
+			conn->sockfd = -1;
+			conn->state = mcsSetupOutgoingConnection;
+			return true;
+		}
+
+		break;
+	}							/* connect() EINTR retry loop */
+
+	if (gp_log_interconnect >= GPVARS_VERBOSITY_DEBUG)
+		ereport(DEBUG1, (errmsg("Interconnect cannot use local socket %s "
+								"for seg%d pid=%d, falling back to tcp: %m",
+								addr.sun_path, conn->remoteContentId,
+								cdbProc->pid)));
+
+	closesocket(conn->sockfd);
+	conn->sockfd = -1;
+	return false;
+}								/* setupLocalOutgoingConnection */
+
+
 /*
  * updateOutgoingConnection
  *
@@ -1116,7 +1381,7 @@ old_conn:
  * socket does not have any pending connection requests.
  */
 static MotionConn *
-acceptIncomingConnection(void)
+acceptIncomingConnection(int listenerFd)
 {
 	int			newsockfd;
 	socklen_t	addrsize;
@@ -1131,9 +1396,31 @@ acceptIncomingConnection(void)
 	{							/* loop until success or EWOULDBLOCK */
 		MemSet(&remoteAddr, 0, sizeof(remoteAddr));
 		addrsize = sizeof(remoteAddr);
-		newsockfd = accept(TCP_listenerFd, (struct sockaddr *) &remoteAddr, &addrsize);
+		newsockfd = accept(listenerFd, (struct sockaddr *) &remoteAddr, &addrsize);
 		if (newsockfd >= 0)
-			break;
+		{
+			uid_t		peeruid;
+			gid_t		peergid;
+
+			if (listenerFd != TCP_localListenerFd)
+				break;
+
+			/*
+			 * Only processes of the user running the cluster may talk to the
+			 * host-local listener.
+			 */
+			if (getpeereid(newsockfd, &peeruid, &peergid) == 0 &&
+				peeruid == geteuid())
+				break;
+
+			ereport(LOG,
+					(errcode(ERRCODE_GP_INTERCONNECTION_ERROR),
+					 errmsg("interconnect rejected connection on host-local listener socket %s",
+							TCP_localListenerPath),
+					 errdetail("The peer is not running as the current user.")));
+			closesocket(newsockfd);
+			continue;
+		}
 
 		switch (errno)
 		{
@@ -1157,7 +1444,7 @@ acceptIncomingConnection(void)
 						(errcode(ERRCODE_GP_INTERCONNECTION_ERROR),
 						 errmsg("interconnect error on listener port %d",
 								Gp_listener_port),
-						 errdetail("accept sockfd=%d: %m", TCP_listenerFd)));
+						 errdetail("accept sockfd=%d: %m", listenerFd)));
 				break;			/* not reached */
 			case ENOMEM:
 			case ENFILE:
@@ -1168,7 +1455,7 @@ acceptIncomingConnection(void)
 						(errcode(ERRCODE_GP_INTERCONNECTION_ERROR),
 						 errmsg("interconnect error on listener port %d",
 								Gp_listener_port),
-						 errdetail("accept sockfd=%d: %m", TCP_listenerFd)));
+						 errdetail("accept sockfd=%d: %m", listenerFd)));
 				break;			/* not reached */
 			default:
 				/* Network problem, connection aborted, etc.  Continue. */
@@ -1176,7 +1463,7 @@ acceptIncomingConnection(void)
 						(errcode(ERRCODE_GP_INTERCONNECTION_ERROR),
 						 errmsg("interconnect connection request not completed on listener port %d",
 								Gp_listener_port),
-						 errdetail("accept sockfd=%d: %m", TCP_listenerFd)));
+						 errdetail("accept sockfd=%d: %m", listenerFd)));
 		}						/* switch (errno) */
 	}							/* loop until success or EWOULDBLOCK */
 
@@ -1276,6 +1563,16 @@ SetupTCPInterconnect(EState *estate)
 	interconnect_context->SendChunk = SendChunkTCP;
 	interconnect_context->doSendStopMessage = doSendStopMessageTCP;
 
+	/*
+	 * Runtime filters travel from the receivers to the senders, on the same
+	 * connections as stop messages.  The proxy doesn't forward them.
+	 */
+	if (Gp_interconnect_type == INTERCONNECT_TYPE_TCP)
+	{
+		interconnect_context->doSendRuntimeFilter = doSendRuntimeFilterTCP;
+		interconnect_context->doRecvRuntimeFilters = doRecvRuntimeFiltersTCP;
+	}
+
 #ifdef ENABLE_IC_PROXY
 	ic_proxy_backend_init_context(interconnect_context);
 #endif /* ENABLE_IC_PROXY */
@@ -1434,6 +1731,12 @@ SetupTCPInterconnect(EState *estate)
 
 			MPP_FD_SET(TCP_listenerFd, &rset);
 			highsock = TCP_listenerFd;
+
+			if (TCP_localListenerFd >= 0)
+			{
+				MPP_FD_SET(TCP_localListenerFd, &rset);
+				highsock = Max(highsock, TCP_localListenerFd);
+			}
 		}
 
 		/* Inbound connections awaiting registration message */
@@ -1739,12 +2042,17 @@ SetupTCPInterconnect(EState *estate)
 		}
 
 		/*
-		 * Someone tickling our listener port?  Accept pending connections.
+		 * Someone tickling our listener ports?  Accept pending connections.
 		 */
-		if (MPP_FD_ISSET(TCP_listenerFd, &rset))
+		for (i = 0; i < 2; i++)
 		{
+			int			listenerFd = (i == 0) ? TCP_listenerFd : TCP_localListenerFd;
+
+			if (listenerFd < 0 || !MPP_FD_ISSET(listenerFd, &rset))
+				continue;
+
 			n--;
-			while ((conn = acceptIncomingConnection()) != NULL)
+			while ((conn = acceptIncomingConnection(listenerFd)) != NULL)
 			{
 				/*
 				 * get the connection read for a subsequent call to
@@ -2108,7 +2416,9 @@ TeardownTCPInterconnect(ChunkTransportState *transportStates, bool hasErrors)
 	 * them on a subsequent query!)
 	 */
 	if (TCP_listenerFd != -1)
-		flushInterconnectListenerBacklog();
+		flushInterconnectListenerBacklog(TCP_listenerFd);
+	if (TCP_localListenerFd != -1)
+		flushInterconnectListenerBacklog(TCP_localListenerFd);
 
 	transportStates->activated = false;
 	transportStates->sliceTable = NULL;
@@ -2206,7 +2516,7 @@ format_fd_set(StringInfo buf, int nfds, mpp_fd_set *fds, char *pfx, char *sfx)
 }
 
 static void
-flushInterconnectListenerBacklog(void)
+flushInterconnectListenerBacklog(int listenerFd)
 {
 	int			pendingConn,
 				newfd,
@@ -2217,11 +2527,11 @@ flushInterconnectListenerBacklog(void)
 	do
 	{
 		MPP_FD_ZERO(&rset);
-		MPP_FD_SET(TCP_listenerFd, &rset);
+		MPP_FD_SET(listenerFd, &rset);
 		timeout.tv_sec = 0;
 		timeout.tv_usec = 0;
 
-		pendingConn = select(TCP_listenerFd + 1, (fd_set *) &rset, NULL, NULL, &timeout);
+		pendingConn = select(listenerFd + 1, (fd_set *) &rset, NULL, NULL, &timeout);
 		if (pendingConn > 0)
 		{
 			for (i = 0; i < pendingConn; i++)
@@ -2233,7 +2543,7 @@ flushInterconnectListenerBacklog(void)
 				socklen_t	addrsize;
 
 				addrsize = sizeof(remoteAddr);
-				newfd = accept(TCP_listenerFd, (struct sockaddr *) &remoteAddr, &addrsize);
+				newfd = accept(listenerFd, (struct sockaddr *) &remoteAddr, &addrsize);
 				if (newfd < 0)
 				{
 					ereport(DEBUG3, (errcode(ERRCODE_GP_INTERCONNECTION_ERROR),
@@ -2287,7 +2597,7 @@ flushInterconnectListenerBacklog(void)
 			ereport(LOG,
 					(errcode(ERRCODE_GP_INTERCONNECTION_ERROR),
 					 errmsg("interconnect error during listener cleanup"),
-					 errdetail("select sockfd=%d: %m", TCP_listenerFd)));
+					 errdetail("select sockfd=%d: %m", listenerFd)));
 		}
 
 		/*
@@ -2441,6 +2751,10 @@ waitOnOutbound(ChunkTransportStateEntry *pEntry)
 				int			count;
 				char		buf;
 
+				/* skip a runtime filter the receiver sent us earlier */
+				if (!readRuntimeFilterMessage(conn))
+					continue;
+
 				/* ready to read. */
 				count = recv(conn->sockfd, &buf, sizeof(buf), 0);
 
@@ -2528,6 +2842,278 @@ doSendStopMessageTCP(ChunkTransportState *transportStates, int16 motNodeID)
 	}
 }
 
+/*
+ * Runtime filters
+ *
+ * A receiver can send one runtime filter back to each of its senders.  The
+ * message is a RUNTIME_FILTER_MSG_TYPE byte and the length of the payload,
+ * followed by the payload.  A sender never sees anything else from the
+ * receiver but a stop message ('S') or the closing of the connection, so the
+ * first byte tells them apart.
+ */
+#define RUNTIME_FILTER_MSG_TYPE		'F'
+#define RUNTIME_FILTER_HDR_SIZE		(1 + sizeof(uint32))
+#define RUNTIME_FILTER_MAX_SIZE		(256 * 1024)
+
+/*
+ * Send a runtime filter to all the senders of the motion node that are still
+ * sending to us.
+ *
+ * The message is small, and nothing else is written in this direction before
+ * it, so the socket buffer can normally take it at once.
+ */
+static void
+doSendRuntimeFilterTCP(ChunkTransportState *transportStates, int16 motNodeID,
+					   const char *data, int len)
+{
+	ChunkTransportStateEntry *pEntry = NULL;
+	MotionConn *conn;
+	char	   *msg;
+	uint32		msglen = len;
+	int			i;
+
+	Assert(len >= 0 && len <= RUNTIME_FILTER_MAX_SIZE);
+
+	getChunkTransportState(transportStates, motNodeID, &pEntry);
+	Assert(pEntry);
+
+	msg = palloc(RUNTIME_FILTER_HDR_SIZE + len);
+	msg[0] = RUNTIME_FILTER_MSG_TYPE;
+	memcpy(msg + 1, &msglen, sizeof(msglen));
+	memcpy(msg + RUNTIME_FILTER_HDR_SIZE, data, len);
+
+	for (i = 0; i < pEntry->numConns; i++)
+	{
+		int			sent = 0;
+
+		conn = pEntry->conns + i;
+
+		if (conn->sockfd < 0 || !conn->stillActive)
+			continue;
+
+		while (sent < RUNTIME_FILTER_HDR_SIZE + len)
+		{
+			ssize_t		n;
+
+			n = send(conn->sockfd, msg + sent, RUNTIME_FILTER_HDR_SIZE + len - sent, 0);
+			if (n >= 0)
+			{
+				sent += n;
+				continue;
+			}
+
+			if (errno == EINTR)
+			{
+				ML_CHECK_FOR_INTERRUPTS(transportStates->teardownActive);
+				continue;
+			}
+
+			if (errno == EWOULDBLOCK)
+			{
+				mpp_fd_set	wset;
+				struct timeval timeout;
+
+				ML_CHECK_FOR_INTERRUPTS(transportStates->teardownActive);
+
+				timeout.tv_sec = Gp_interconnect_transmit_timeout;
+				timeout.tv_usec = 0;
+				MPP_FD_ZERO(&wset);
+				MPP_FD_SET(conn->sockfd, &wset);
+				if (select(conn->sockfd + 1, NULL, (fd_set *) &wset, NULL, &timeout) == 0)
+					ereport(ERROR,
+							(errcode(ERRCODE_GP_INTERCONNECTION_ERROR),
+							 errmsg("interconnect timed out sending a runtime filter"),
+							 errdetail("for remote connection: contentId=%d at %s",
+									   conn->remoteContentId,
+									   conn->remoteHostAndPort)));
+				continue;
+			}
+
+			/* the sender is gone, it has no use for the filter */
+			if (gp_log_interconnect >= GPVARS_VERBOSITY_DEBUG)
+				elog(DEBUG3, "could not send runtime filter to contentId=%d at %s: %m",
+					 conn->remoteContentId, conn->remoteHostAndPort);
+			break;
+		}
+	}
+
+	pfree(msg);
+}
+
+/*
+ * Sender: read what is available of the runtime filter message on the
+ * connection, without blocking.
+ *
+ * Returns true if a stop message or the closing of the connection is pending
+ * instead, which is left for the caller to handle.  conn->rfReceived is set
+ * once the whole message has been read, or if none is coming.
+ */
+static bool
+readRuntimeFilterMessage(MotionConn *conn)
+{
+	for (;;)
+	{
+		int32		want;
+		ssize_t		n;
+
+		if (conn->rfReceived)
+			return true;
+
+		if (conn->rfRead == 0)
+		{
+			char		msgtype;
+
+			n = recv(conn->sockfd, &msgtype, 1, MSG_PEEK);
+			if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR))
+				return false;
+			if (n <= 0 || msgtype != RUNTIME_FILTER_MSG_TYPE)
+			{
+				conn->rfReceived = true;
+				return true;
+			}
+
+			conn->rfBuf = MemoryContextAlloc(InterconnectContext,
+											 RUNTIME_FILTER_HDR_SIZE);
+		}
+
+		if (conn->rfRead < RUNTIME_FILTER_HDR_SIZE)
+			want = RUNTIME_FILTER_HDR_SIZE - conn->rfRead;
+		else
+			want = RUNTIME_FILTER_HDR_SIZE + conn->rfLen - conn->rfRead;
+
+		n = recv(conn->sockfd, conn->rfBuf + conn->rfRead, want, 0);
+		if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR))
+			return false;
+		if (n <= 0)
+		{
+			/* the receiver went away in the middle of the message */
+			pfree(conn->rfBuf);
+			conn->rfBuf = NULL;
+			conn->rfReceived = true;
+			return true;
+		}
+
+		if (conn->rfRead < RUNTIME_FILTER_HDR_SIZE &&
+			conn->rfRead + n == RUNTIME_FILTER_HDR_SIZE)
+		{
+			uint32		len;
+
+			memcpy(&len, conn->rfBuf + 1, sizeof(len));
+			if (len > RUNTIME_FILTER_MAX_SIZE)
+				ereport(ERROR,
+						(errcode(ERRCODE_GP_INTERCONNECTION_ERROR),
+						 errmsg("interconnect received an invalid runtime filter of %u bytes", len),
+						 errdetail("from remote connection: contentId=%d at %s",
+								   conn->remoteContentId,
+								   conn->remoteHostAndPort)));
+			conn->rfLen = len;
+			conn->rfBuf = repalloc(conn->rfBuf, RUNTIME_FILTER_HDR_SIZE + len);
+		}
+		conn->rfRead += n;
+
+		if (conn->rfRead == RUNTIME_FILTER_HDR_SIZE + conn->rfLen)
+		{
+			conn->rfReceived = true;
+			return false;
+		}
+	}
+}
+
+/*
+ * Sender: wait up to timeout_ms for the runtime filters of all the receivers
+ * of the motion node, and pass them to the callback.
+ *
+ * A receiver that has stopped us, or gone away, will not send a filter; it
+ * won't get any tuples either.  Returns false on timeout.
+ */
+static bool
+doRecvRuntimeFiltersTCP(ChunkTransportState *transportStates, int16 motNodeID,
+						int timeout_ms, RuntimeFilterCallback callback, void *arg)
+{
+	ChunkTransportStateEntry *pEntry = NULL;
+	MotionConn *conn;
+	GpMonotonicTime startTime;
+	bool		done;
+	int			i;
+
+	getChunkTransportState(transportStates, motNodeID, &pEntry);
+	Assert(pEntry);
+
+	gp_set_monotonic_begin_time(&startTime);
+
+	for (;;)
+	{
+		mpp_fd_set	rset;
+		struct timeval timeout;
+		int			maxfd = -1;
+		uint64		elapsed_ms;
+		int			n;
+
+		MPP_FD_ZERO(&rset);
+		for (i = 0; i < pEntry->numConns; i++)
+		{
+			conn = pEntry->conns + i;
+
+			if (conn->sockfd < 0 || conn->rfReceived)
+				continue;
+
+			MPP_FD_SET(conn->sockfd, &rset);
+			if (conn->sockfd > maxfd)
+				maxfd = conn->sockfd;
+		}
+
+		done = (maxfd < 0);
+		if (done)
+			break;
+
+		elapsed_ms = gp_get_elapsed_ms(&startTime);
+		if (elapsed_ms >= timeout_ms)
+			break;
+
+		timeout.tv_sec = (timeout_ms - elapsed_ms) / 1000;
+		timeout.tv_usec = ((timeout_ms - elapsed_ms) % 1000) * 1000;
+
+		n = select(maxfd + 1, (fd_set *) &rset, NULL, NULL, &timeout);
+		if (n < 0)
+		{
+			if (errno == EINTR)
+			{
+				ML_CHECK_FOR_INTERRUPTS(transportStates->teardownActive);
+				continue;
+			}
+			ereport(ERROR,
+					(errcode(ERRCODE_GP_INTERCONNECTION_ERROR),
+					 errmsg("interconnect error waiting for runtime filters: %m")));
+		}
+
+		ML_CHECK_FOR_INTERRUPTS(transportStates->teardownActive);
+
+		for (i = 0; i < pEntry->numConns && n > 0; i++)
+		{
+			conn = pEntry->conns + i;
+
+			if (conn->sockfd >= 0 && !conn->rfReceived &&
+				MPP_FD_ISSET(conn->sockfd, &rset))
+				(void) readRuntimeFilterMessage(conn);
+		}
+	}
+
+	/* Deliver the complete messages, even if we timed out */
+	for (i = 0; i < pEntry->numConns; i++)
+	{
+		conn = pEntry->conns + i;
+
+		if (conn->rfReceived && conn->rfBuf != NULL)
+		{
+			callback(arg, conn->rfBuf + RUNTIME_FILTER_HDR_SIZE, conn->rfLen);
+			pfree(conn->rfBuf);
+			conn->rfBuf = NULL;
+		}
+	}
+
+	return done;
+}
+
 static TupleChunkListItem
 RecvTupleChunkFromTCP(ChunkTransportState *transportStates,
 					  int16 motNodeID,
@@ -2789,7 +3375,8 @@ flushBuffer(ChunkTransportState *transportStates,
 		 */
 		n = select(conn->sockfd + 1, (fd_set *) &rset, NULL, NULL, &timeout);
 		/* handle errors at the write call, below */
-		if (n > 0 && MPP_FD_ISSET(conn->sockfd, &rset))
+		if (n > 0 && MPP_FD_ISSET(conn->sockfd, &rset) &&
+			readRuntimeFilterMessage(conn))
 		{
 #ifdef AMS_VERBOSE_LOGGING
 			print_connection(transportStates, conn->sockfd, "stop from");
@@ -2844,11 +3431,14 @@ flushBuffer(ChunkTransportState *transportStates,
 					}
 
 					/*
-					 * as a sender... if there is something to read... it must
-					 * mean its a StopSendingMessage or receiver has teared down
-					 * the interconnect, we don't even bother to read it.
+					 * as a sender... if there is something to read, other
+					 * than a runtime filter... it must mean its a
+					 * StopSendingMessage or receiver has teared down the
+					 * interconnect, we don't even bother to read it.
 					 */
-					if (MPP_FD_ISSET(conn->sockfd, &rset) || transportStates->teardownActive)
+					if ((MPP_FD_ISSET(conn->sockfd, &rset) &&
+						 readRuntimeFilterMessage(conn)) ||
+						transportStates->teardownActive)
 					{
 #ifdef AMS_VERBOSE_LOGGING
 						print_connection(transportStates, conn->sockfd, "stop from");
@@ -0,0 +1,187 @@
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include "cmockery.h"
+
+#include "../cdbsrlz.c"
+
+#include "catalog/pg_collation.h"
+#include "catalog/pg_type.h"
+#include "nodes/makefuncs.h"
+#include "utils/builtins.h"
+
+static Const *
+make_text_const(const char *str)
+{
+	return makeConst(TEXTOID, -1, DEFAULT_COLLATION_OID, -1,
+					 PointerGetDatum(cstring_to_text(str)), false, false);
+}
+
+/*
+ * Identical subtrees are written once and back-referenced afterwards, and
+ * the reader still gets a separate copy of each.
+ */
+static void
+test__nodeToBinaryStringFast__dedups_repeated_subtrees(void **state)
+{
+	const char *value = "a constant long enough to be worth deduplicating";
+	List	   *list = NIL;
+	List	   *copy;
+	ListCell   *lc;
+	char	   *one;
+	char	   *many;
+	int			one_len;
+	int			many_len;
+	int			i;
+
+	one = nodeToBinaryStringFast(list_make1(make_text_const(value)), &one_len);
+
+	for (i = 0; i < 10; i++)
+		list = lappend(list, make_text_const(value));
+	many = nodeToBinaryStringFast(list, &many_len);
+
+	/* only the first copy is written in full */
+	assert_true(many_len < 2 * one_len);
+
+	copy = (List *) readNodeFromBinaryString(many, many_len);
+	assert_true(equal(copy, list));
+
+	foreach(lc, copy)
+	{
+		if (lnext(lc))
+			assert_true(lfirst(lc) != lfirst(lnext(lc)));
+	}
+
+	pfree(one);
+	pfree(many);
+}
+
+/*
+ * A back-reference inside a deduplicated subtree: the second RangeTblEntry
+ * repeats the first, which itself refers to the Alias of an earlier one.
+ */
+static void
+test__nodeToBinaryStringFast__nested_backrefs(void **state)
+{
+	List	   *colnames = list_make3(makeString("first_column_name"),
+									  makeString("second_column_name"),
+									  makeString("third_column_name"));
+	List	   *list = NIL;
+	List	   *copy;
+	char	   *str;
+	int			len;
+	int			i;
+
+	for (i = 0; i < 4; i++)
+	{
+		RangeTblEntry *rte = makeNode(RangeTblEntry);
+
+		rte->rtekind = RTE_RELATION;
+		rte->relid = (i < 2) ? 16384 : 16385;
+		rte->relkind = 'r';
+		rte->eref = makeAlias("partition_alias", copyObject(colnames));
+		rte->inFromCl = true;
+		rte->requiredPerms = ACL_SELECT;
+		list = lappend(list, rte);
+	}
+
+	str = nodeToBinaryStringFast(list, &len);
+	copy = (List *) readNodeFromBinaryString(str, len);
+	assert_true(equal(copy, list));
+
+	pfree(str);
+}
+
+#ifdef HAVE_LIBZSTD
+static char *
+make_large_string(int len)
+{
+	char	   *str = palloc(len);
+	int			i;
+
+	for (i = 0; i < len; i++)
+		str[i] = 'a' + (i * 7 + i / 13) % 26;
+
+	return str;
+}
+
+/*
+ * Compressing the same string again reuses the cached result.
+ */
+static void
+test__compress_string_cached__reuses_result(void **state)
+{
+	int			len = 2 * COMPRESS_CACHE_MIN_SIZE;
+	char	   *src = make_large_string(len);
+	char	   *first;
+	char	   *second;
+	int			first_size;
+	int			second_size;
+
+	gp_plan_compress_cache_size = 16384;
+
+	first = compress_string_cached(src, len, &first_size);
+	assert_true(compressCacheBytes == (Size) len + first_size);
+
+	second = compress_string_cached(src, len, &second_size);
+	assert_int_equal(second_size, first_size);
+	assert_memory_equal(second, first, first_size);
+	assert_true(compressCacheBytes == (Size) len + first_size);
+}
+
+/*
+ * gp_plan_compress_cache_size bounds the cache, and 0 releases it.
+ */
+static void
+test__compress_string_cached__bounded_by_guc(void **state)
+{
+	int			len = 2 * COMPRESS_CACHE_MIN_SIZE;
+	char	   *src = make_large_string(len);
+	char	   *other = make_large_string(len);
+	int			size;
+	int			i;
+
+	gp_plan_compress_cache_size = 16384;
+	compress_string_cached(src, len, &size);
+	assert_true(compressCacheContext != NULL);
+
+	/* room for one entry only: adding another evicts the first */
+	gp_plan_compress_cache_size = (len + len / 2) / 1024;
+	other[0] = 'Z';
+	compress_string_cached(other, len, &size);
+	assert_true(compressCacheBytes <= (Size) gp_plan_compress_cache_size * 1024);
+	for (i = 0; i < COMPRESS_CACHE_SIZE; i++)
+		assert_true(compressCache[i].uncompressed == NULL ||
+					compressCache[i].uncompressed[0] == 'Z');
+
+	/* too large for the cache: not remembered */
+	gp_plan_compress_cache_size = 64;
+	compress_string_cached(src, len, &size);
+	assert_true(compressCacheBytes <= (Size) 64 * 1024);
+
+	gp_plan_compress_cache_size = 0;
+	compress_string_cached(src, len, &size);
+	assert_true(compressCacheContext == NULL);
+	assert_true(compressCacheBytes == 0);
+}
+#endif			/* HAVE_LIBZSTD */
+
+int
+main(int argc, char *argv[])
+{
+	cmockery_parse_arguments(argc, argv);
+
+	const		UnitTest tests[] =
+	{
+		unit_test(test__nodeToBinaryStringFast__dedups_repeated_subtrees),
+		unit_test(test__nodeToBinaryStringFast__nested_backrefs),
+#ifdef HAVE_LIBZSTD
+		unit_test(test__compress_string_cached__reuses_result),
+		unit_test(test__compress_string_cached__bounded_by_guc),
+#endif
+	};
+
+	MemoryContextInit();
+
+	return run_tests(tests);
+}
@@ -664,7 +664,21 @@ ExplainOnePlan(PlannedStmt *plannedstmt, IntoClause *into, ExplainState *es,
 		ExplainProperty("Optimizer", "Postgres query optimizer", false, es);
 #ifdef USE_ORCA
 	else
+	{
+		PlannedStmt *pstmt = queryDesc->plannedstmt;
+
 		ExplainPropertyStringInfo("Optimizer", es, "Pivotal Optimizer (GPORCA)");
+
+		/* Show how far the search got, if it had a budget */
+		if (pstmt->optimizerSearchStages > 0)
+			ExplainPropertyStringInfo("Optimizer Search", es,
+									  "stage %d of %d, %d ms%s",
+									  pstmt->optimizerSearchStage,
+									  pstmt->optimizerSearchStages,
+									  pstmt->optimizerSearchTime,
+									  pstmt->optimizerSearchBudgetExceeded ?
+									  ", budget exceeded" : "");
+	}
 #endif
 
 	/* We only list the non-default GUCs in verbose mode */
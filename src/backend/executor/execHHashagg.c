@@ -27,6 +27,8 @@
 #include "executor/execHHashagg.h"
 #include "storage/buffile.h"
 #include "utils/datum.h"
+#include "utils/fmgroids.h"
+#include "utils/hyperloglog/gp_hyperloglog.h"
 #include "utils/memutils.h"
 #include "utils/lsyscache.h"
 #include "utils/elog.h"
@@ -41,6 +43,33 @@
 #define BUFFER_INCREMENT_SIZE 1024
 #define HHA_MSG_LVL DEBUG2
 
+/*
+ * The streaming lower phase of a multiphase aggregation only pays off if it
+ * reduces the rows sent to the upper phase.  Each time the hash table fills
+ * up, and every gp_hashagg_passthrough_sample input tuples in between, we
+ * check how many groups the input tuples made since the table was last
+ * emptied.  If there are more than gp_hashagg_passthrough_ratio groups per
+ * tuple, we stop looking up groups and output every further input tuple as a
+ * group of its own.
+ */
+
+/*
+ * Every batch file keeps a small HyperLogLog sketch of the hash values of
+ * the entries written to it.  The same group is written to a file again each
+ * time the hash table spills, so the number of entries in a file can be much
+ * larger than the number of groups they add up to.  The sketch estimates the
+ * latter, which decides how much memory reloading the file takes and into
+ * how many batches it must be split if that is more than we have.
+ *
+ * The requested error rate gives 256 registers, for a standard error of
+ * 1.04 / sqrt(256), about 6.5%.  Estimates are raised by HHA_HLL_MARGIN
+ * times the error rate before they are used to size anything, so that a
+ * batch file is rarely split into too few batches.
+ */
+#define HHA_HLL_NDISTINCT ((double) (1ULL << 63))
+#define HHA_HLL_ERROR 0.066
+#define HHA_HLL_REGISTERS 256
+#define HHA_HLL_MARGIN 2.0
 
 /* Encapture data related to a batch file. */
 struct BatchFileInfo
@@ -49,8 +78,13 @@ struct BatchFileInfo
 	int64 ntuples;
 	BufFile *wfile;
 	bool suspended;
+	GpHLLCounter hll; /* HyperLogLog sketch of the hash values */
 };
 
+/* Size of a BatchFileInfo, with its sketch of at most a byte per register */
+#define BATCHFILE_INFO_SIZE \
+	(sizeof(BatchFileInfo) + sizeof(GpHLLData) + HHA_HLL_REGISTERS)
+
 /*
  * Estimate per-file memory overhead. We assume that a BufFile consumed about
  * 64 bytes for various structs. It also keeps a buffer of size BLCKSZ. It
@@ -64,7 +98,7 @@ struct BatchFileInfo
 /* #define FREEABLE_BATCHFILE_METADATA (BLCKSZ) */
 #define FREEABLE_BATCHFILE_METADATA (16 * 1024)
 #define BATCHFILE_METADATA \
-	(sizeof(BatchFileInfo) + 64 + FREEABLE_BATCHFILE_METADATA)
+	(BATCHFILE_INFO_SIZE + 64 + FREEABLE_BATCHFILE_METADATA)
 
 /* Used for padding */
 static char padding_dummy[MAXIMUM_ALIGNOF];
@@ -135,9 +169,12 @@ static HashAggEntry *lookup_agg_hash_entry(AggState *aggstate, void *input_recor
 										   InputRecordType input_type, int32 input_size,
 										   uint32 hashkey, bool *p_isnew);
 static void agg_hash_table_stat_upd(HashAggTable *ht);
+static bool check_passthrough(AggState *aggstate);
 static void reset_agg_hash_table(AggState *aggstate, int64 nentries);
 static bool agg_hash_reload(AggState *aggstate);
 static void reCalcNumberBatches(HashAggTable *hashtable, SpillFile *spill_file);
+static void batch_file_add_hash(BatchFileInfo *file_info, HashKey hashvalue);
+static double batch_file_est_groups(BatchFileInfo *file_info);
 static inline void *mpool_cxt_alloc(void *manager, Size len);
 
 static inline void *mpool_cxt_alloc(void *manager, Size len)
@@ -434,6 +471,33 @@ setGroupAggs(HashAggTable *hashtable, HashAggEntry *entry)
 	}
 }
 
+/*
+ * Function: equality_is_bitwise
+ *
+ * Is the equality function true exactly when two non-NULL Datums of its
+ * input type are identical?  Then grouping keys can be compared without
+ * calling it.  This holds for the built-in equality of pass-by-value
+ * integer-like types.
+ */
+static bool
+equality_is_bitwise(Oid eqfn_oid)
+{
+	switch (eqfn_oid)
+	{
+		case F_INT8EQ:
+			return FLOAT8PASSBYVAL;
+		case F_INT2EQ:
+		case F_INT4EQ:
+		case F_OIDEQ:
+		case F_CHAREQ:
+		case F_BOOLEQ:
+		case F_DATE_EQ:
+			return true;
+		default:
+			return false;
+	}
+}
+
 /*
  * Function: lookup_agg_hash_entry
  *
@@ -519,7 +583,9 @@ lookup_agg_hash_entry(AggState *aggstate,
 			entry_datum = memtuple_getattr(mtup, mt_bind, att, &entry_isNull);
 
 			if ( !input_isNull && !entry_isNull &&
-				 (DatumGetBool(FunctionCall2(&aggstate->eqfunctions[i],
+				 (hashtable->key_eq_bitwise[i] ?
+				  input_datum == entry_datum :
+				  DatumGetBool(FunctionCall2(&aggstate->eqfunctions[i],
 											 input_datum,
 											 entry_datum)) ) )
 				continue; /* Both non-NULL and equal. */
@@ -808,9 +874,11 @@ create_agg_hash_table(AggState *aggstate)
 	HashAggTable *hashtable;
 	Agg *agg = (Agg *)aggstate->ss.ps.plan;
 	MemoryContext oldcxt;
+	int i;
 
 	oldcxt = MemoryContextSwitchTo(aggstate->aggcontext);
 	hashtable = (HashAggTable *) palloc0(sizeof(HashAggTable));
+	hashtable->passthrough_next_check = gp_hashagg_passthrough_sample;
 
 	hashtable->entry_cxt = AllocSetContextCreate(aggstate->aggcontext, 
 												 "HashAggTableEntryContext",
@@ -848,6 +916,10 @@ create_agg_hash_table(AggState *aggstate)
 	hashtable->pshift = 0;
 	hashtable->expandable = true;
 
+	hashtable->key_eq_bitwise = (bool *) palloc(agg->numCols * sizeof(bool));
+	for (i = 0; i < agg->numCols; i++)
+		hashtable->key_eq_bitwise[i] = equality_is_bitwise(aggstate->eqfunctions[i].fn_oid);
+
 	MemoryContextSwitchTo(hashtable->entry_cxt);
 	
 	/* Initialize buffer for hash entries */
@@ -967,11 +1039,33 @@ agg_hash_initial_pass(AggState *aggstate)
 		/* set up for advance_aggregates call */
 		tmpcontext->ecxt_outertuple = outerslot;
 
-		/* Find or (if there's room) build a hash table entry for the
-		 * input tuple's group. */
-		hashkey = calc_hash_value(aggstate, outerslot);
-		entry = lookup_agg_hash_entry(aggstate, (void *)outerslot,
-									  INPUT_RECORD_TUPLE, 0, hashkey, &isNew);
+		if (hashtable->is_passthrough)
+		{
+			/*
+			 * Don't look for the group of the tuple, the upper phase will
+			 * combine it.  The entries don't need to be found again, so they
+			 * all go into the first bucket.
+			 */
+			hashkey = 0;
+			isNew = false;
+			entry = makeHashAggEntryForInput(aggstate, outerslot, hashkey);
+			if (entry != NULL)
+			{
+				entry->next = hashtable->buckets[0];
+				hashtable->buckets[0] = entry;
+				++hashtable->num_ht_groups;
+				++hashtable->num_entries;
+				isNew = true;
+			}
+		}
+		else
+		{
+			/* Find or (if there's room) build a hash table entry for the
+			 * input tuple's group. */
+			hashkey = calc_hash_value(aggstate, outerslot);
+			entry = lookup_agg_hash_entry(aggstate, (void *)outerslot,
+										  INPUT_RECORD_TUPLE, 0, hashkey, &isNew);
+		}
 		
 		if (entry == NULL)
 		{
@@ -991,6 +1085,7 @@ agg_hash_initial_pass(AggState *aggstate)
 			{
 				Assert(tuple_remaining);
 				hashtable->prev_slot = outerslot;
+				check_passthrough(aggstate);
 				/* Stream existing entries instead of spilling */
 				break;
 			}
@@ -1029,10 +1124,21 @@ agg_hash_initial_pass(AggState *aggstate)
 		{
 			Assert(tuple_remaining);
 			ExecClearTuple(aggstate->hashslot);
+			check_passthrough(aggstate);
 			/* Pause and stream entries before reading the next tuple */
 			break;
 		}
 
+		if (streaming && !hashtable->is_passthrough &&
+			hashtable->num_tuples >= hashtable->passthrough_next_check &&
+			check_passthrough(aggstate))
+		{
+			Assert(tuple_remaining);
+			ExecClearTuple(aggstate->hashslot);
+			/* Stream the groups found so far, then pass through */
+			break;
+		}
+
 		/* Read the next tuple */
 		outerslot = ExecProcNode(outerPlanState(aggstate));
 	}
@@ -1061,7 +1167,8 @@ agg_hash_initial_pass(AggState *aggstate)
 		}
 	}
 
-	if (!hashtable->is_spilling && aggstate->ss.ps.instrument && aggstate->ss.ps.instrument->need_cdb)
+	if (!hashtable->is_spilling && !hashtable->is_passthrough &&
+		aggstate->ss.ps.instrument && aggstate->ss.ps.instrument->need_cdb)
 	{
 		/* Update in-memory hash table statistics if not already done when spilling */
 		agg_hash_table_stat_upd(hashtable);
@@ -1074,6 +1181,38 @@ agg_hash_initial_pass(AggState *aggstate)
 	return tuple_remaining;
 }
 
+/*
+ * Function: check_passthrough
+ *
+ * Decide whether the streaming aggregation reduces the tuples read since the
+ * hash table was last emptied enough to be worth looking up groups.  Returns
+ * true if it switched to passing the input tuples through; otherwise the
+ * next check is gp_hashagg_passthrough_sample tuples later.
+ */
+static bool
+check_passthrough(AggState *aggstate)
+{
+	HashAggTable *hashtable = aggstate->hhashtable;
+	uint64		ntuples = hashtable->num_tuples - hashtable->passthrough_window_start;
+
+	if (hashtable->is_passthrough || gp_hashagg_passthrough_sample == 0)
+		return false;
+
+	hashtable->passthrough_next_check = hashtable->num_tuples + gp_hashagg_passthrough_sample;
+
+	if (ntuples == 0 ||
+		hashtable->num_entries < ntuples * gp_hashagg_passthrough_ratio)
+		return false;
+
+	elog(HHA_MSG_LVL,
+		 "HashAgg: " INT64_FORMAT " groups in " INT64_FORMAT " tuples, passing the rest through",
+		 hashtable->num_entries, ntuples);
+
+	hashtable->is_passthrough = true;
+	hashtable->passthrough_after = hashtable->num_tuples;
+	return true;
+}
+
 /* Create a spill set for the given branching_factor (a power of two) 
  * and hash key range.
  *
@@ -1163,6 +1302,7 @@ getSpillFile(workfile_set *work_set, SpillSet *set, int file_no, int *p_alloc_si
 		spill_file->file_info->wfile = NULL; 
 		spill_file->file_info->wfile = BufFileCreateTempInSet(work_set, false /* interXact */);
 		spill_file->file_info->suspended = false;
+		spill_file->file_info->hll = gp_hll_create(HHA_HLL_NDISTINCT, HHA_HLL_ERROR, PACKED);
 		BufFilePledgeSequential(spill_file->file_info->wfile);	/* allow compression */
 
 		elog(HHA_MSG_LVL, "HashAgg: create %d level batch file %d",
@@ -1235,15 +1375,16 @@ closeSpillFile(AggState *aggstate, SpillSet *spill_set, int file_no)
 	{
 		BufFileClose(spill_file->file_info->wfile);
 		spill_file->file_info->wfile = NULL;
-		freedspace += (BATCHFILE_METADATA - sizeof(BatchFileInfo));
+		freedspace += (BATCHFILE_METADATA - BATCHFILE_INFO_SIZE);
 		if (spill_file->file_info->suspended)
 			freedspace -= FREEABLE_BATCHFILE_METADATA;
 	}
 	if (spill_file->file_info)
 	{
+		pfree(spill_file->file_info->hll);
 		pfree(spill_file->file_info);
 		spill_file->file_info = NULL;
-		freedspace += sizeof(BatchFileInfo);
+		freedspace += BATCHFILE_INFO_SIZE;
 	}
 
 	return freedspace;
@@ -1420,6 +1561,7 @@ spill_hash_table(AggState *aggstate)
 					written_bytes = writeHashEntry(aggstate, spill_file->file_info, spill_entry);
 					spill_file->file_info->ntuples++;
 					spill_file->file_info->total_bytes += written_bytes;
+					batch_file_add_hash(spill_file->file_info, spill_entry->hashvalue);
 
 					hashtable->num_spill_groups++;
 				}
@@ -1831,6 +1973,9 @@ agg_hash_stream(AggState *aggstate)
 		"HashAgg: streaming");
 
 	reset_agg_hash_table(aggstate, 0 /* don't reallocate buckets */);
+
+	/* Judge the groups of the next table load on their own */
+	aggstate->hhashtable->passthrough_window_start = aggstate->hhashtable->num_tuples;
 	
 	return agg_hash_initial_pass(aggstate);
 }
@@ -1852,7 +1997,8 @@ agg_hash_reload(AggState *aggstate)
 
 	Assert(spill_file && spill_file->file_info);
 
-	reset_agg_hash_table(aggstate, spill_file->file_info->ntuples);
+	reset_agg_hash_table(aggstate,
+						 (int64) batch_file_est_groups(spill_file->file_info));
 	reCalcNumberBatches(hashtable, spill_file);
 
 	/*
@@ -2033,6 +2179,44 @@ agg_hash_reload(AggState *aggstate)
 	return has_tuples;
 }
 
+/*
+ * Function: batch_file_add_hash
+ *
+ * Record the hash value of an entry written to the batch file in its
+ * HyperLogLog sketch.  The sketch hashes the value again, which it needs
+ * to, because some of its bits are the same for all the entries of the
+ * file: they picked the file.
+ */
+static void
+batch_file_add_hash(BatchFileInfo *file_info, HashKey hashvalue)
+{
+	file_info->hll = gp_hll_add_element(file_info->hll, (const char *) &hashvalue,
+										sizeof(hashvalue));
+}
+
+/*
+ * Function: batch_file_est_groups
+ *
+ * Estimate the number of distinct groups among the entries of the batch
+ * file, from its HyperLogLog sketch plus the safety margin.  The result is
+ * at least 1 and at most the number of entries.
+ */
+static double
+batch_file_est_groups(BatchFileInfo *file_info)
+{
+	double estimate;
+
+	estimate = gp_hyperloglog_estimate(file_info->hll);
+	estimate *= 1.0 + HHA_HLL_MARGIN * HHA_HLL_ERROR;
+
+	if (estimate > file_info->ntuples)
+		estimate = file_info->ntuples;
+	if (estimate < 1.0)
+		estimate = 1.0;
+
+	return estimate;
+}
+
 /*
  * Function: reCalcNumberBatches
  *
@@ -2040,6 +2224,11 @@ agg_hash_reload(AggState *aggstate)
  * for a given spill file. This function limits the maximum number of
  * batches to the default one -- gp_hashagg_default_nbatches.
  *
+ * Reloading the file only takes space for the distinct groups in it, so
+ * the size is based on the estimated number of groups rather than on the
+ * number of entries written.  Batches sized this way are expected to fit
+ * in memory when they are reloaded, without spilling again.
+ *
  * Note that we may over-estimate the number of batches, but it is still
  * better than under-estimate it.
  */
@@ -2049,12 +2238,20 @@ reCalcNumberBatches(HashAggTable *hashtable, SpillFile *spill_file)
 	unsigned nbatches;
 	double metadata_size;
 	uint64 total_bytes;
+	BatchFileInfo *file_info = spill_file->file_info;
+	double ngroups;
 	
-	Assert(spill_file->file_info != NULL);
+	Assert(file_info != NULL);
 	Assert(hashtable->max_mem > hashtable->mem_for_metadata);
-		
-	total_bytes = spill_file->file_info->total_bytes +
-		spill_file->file_info->ntuples * sizeof(HashAggEntry);
+	Assert(file_info->ntuples > 0);
+
+	ngroups = batch_file_est_groups(file_info);
+	total_bytes = (uint64)
+		(ngroups * ((double) file_info->total_bytes / file_info->ntuples +
+					sizeof(HashAggEntry))) + 1;
+
+	elog(HHA_MSG_LVL, "HashAgg: batch file with " INT64_FORMAT " entries has an estimated %.0f groups",
+		 file_info->ntuples, ngroups);
 	
 	nbatches =
 		(total_bytes - 1) / 
@@ -2260,6 +2457,14 @@ agg_hash_explain(AggState *aggstate)
 		appendStringInfo(hbuf, ".\n");
 	}
 
+	if (hashtable->is_passthrough)
+	{
+		appendStringInfo(hbuf,
+				"Grouping passed through after " INT64_FORMAT
+				" input rows, which formed too many groups.\n",
+				hashtable->passthrough_after);
+	}
+
 	/* Hash chain statistics */
 	if (hashtable->chainlength.vcnt > 0)
 	{
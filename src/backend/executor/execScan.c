@@ -21,6 +21,7 @@
 #include "postgres.h"
 
 #include "executor/executor.h"
+#include "executor/nodeHash.h"
 #include "miscadmin.h"
 #include "utils/memutils.h"
 
@@ -114,6 +115,7 @@ ExecScan(ScanState *node,
 	ExprContext *econtext;
 	List	   *qual;
 	ProjectionInfo *projInfo;
+	HashRuntimeFilter filter;
 
 	/*
 	 * Fetch data from node
@@ -121,12 +123,13 @@ ExecScan(ScanState *node,
 	qual = node->ps.qual;
 	projInfo = node->ps.ps_ProjInfo;
 	econtext = node->ps.ps_ExprContext;
+	filter = node->ss_runtimeFilter;
 
 	/*
 	 * If we have neither a qual to check nor a projection to do, just skip
 	 * all the overhead and return the raw scan tuple.
 	 */
-	if (!qual && !projInfo)
+	if (!qual && !projInfo && !filter)
 	{
 		ResetExprContext(econtext);
 		return ExecScanFetch(node, accessMtd, recheckMtd);
@@ -181,6 +184,8 @@ ExecScan(ScanState *node,
 		 */
 		if (!qual || ExecQual(qual, econtext, false))
 		{
+			TupleTableSlot *result;
+
 			/*
 			 * Found a satisfactory scan tuple.
 			 */
@@ -190,15 +195,22 @@ ExecScan(ScanState *node,
 				 * Form a projection tuple, store it in the result tuple slot
 				 * and return it.
 				 */
-				return ExecProject(projInfo, NULL);
+				result = ExecProject(projInfo, NULL);
 			}
 			else
 			{
 				/*
 				 * Here, we aren't projecting, so just return scan tuple.
 				 */
-				return slot;
+				result = slot;
 			}
+
+			/*
+			 * CDB: The join keys of a runtime filter are computed from the
+			 * output of the scan, so it is checked last.
+			 */
+			if (!filter || ExecHashRuntimeFilterCheck(filter, result))
+				return result;
 		}
 		else
 			InstrCountFiltered1(node, 1);
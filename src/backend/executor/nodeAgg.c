@@ -138,6 +138,7 @@
 #include "parser/parse_coerce.h"
 #include "utils/acl.h"
 #include "utils/builtins.h"
+#include "utils/fmgroids.h"
 #include "utils/lsyscache.h"
 #include "utils/memutils.h"
 #include "utils/syscache.h"
@@ -409,6 +410,99 @@ advance_transition_function(AggState *aggstate,
 							  aggstate->tmpcontext->ecxt_per_tuple_memory);
 }
 
+/*
+ * Compute the transition functions of count(), sum(), min() and max() on
+ * integer types, and the combine functions of their partial aggregates,
+ * without calling them through fmgr.
+ *
+ * The transition value and the input are known to be non-NULL.  Returns
+ * false if the function isn't one of them, or if the result would overflow;
+ * the caller then calls the function, which reports the error.
+ */
+static inline bool
+advance_transition_inline(Oid transfn_oid, Datum transValue,
+						  FunctionCallInfo fcinfo, Datum *newVal)
+{
+	int64		oldval;
+	int64		result;
+
+	switch (transfn_oid)
+	{
+		case F_INT8INC:
+		case F_INT8INC_ANY:
+			if (!FLOAT8PASSBYVAL)
+				return false;
+			oldval = DatumGetInt64(transValue);
+			if (oldval == PG_INT64_MAX)
+				return false;
+			*newVal = Int64GetDatum(oldval + 1);
+			return true;
+
+		case F_INT8PL:
+			if (!FLOAT8PASSBYVAL)
+				return false;
+			oldval = DatumGetInt64(transValue);
+			result = oldval + DatumGetInt64(fcinfo->arg[1]);
+			/* overflow if the inputs have the same sign, but not the result */
+			if ((oldval < 0) == (DatumGetInt64(fcinfo->arg[1]) < 0) &&
+				(result < 0) != (oldval < 0))
+				return false;
+			*newVal = Int64GetDatum(result);
+			return true;
+
+		case F_INT2_SUM:
+			if (!FLOAT8PASSBYVAL)
+				return false;
+			*newVal = Int64GetDatum(DatumGetInt64(transValue) +
+									(int64) DatumGetInt16(fcinfo->arg[1]));
+			return true;
+
+		case F_INT4_SUM:
+			if (!FLOAT8PASSBYVAL)
+				return false;
+			*newVal = Int64GetDatum(DatumGetInt64(transValue) +
+									(int64) DatumGetInt32(fcinfo->arg[1]));
+			return true;
+
+		case F_INT2LARGER:
+			*newVal = (DatumGetInt16(transValue) >= DatumGetInt16(fcinfo->arg[1])) ?
+				transValue : fcinfo->arg[1];
+			return true;
+
+		case F_INT2SMALLER:
+			*newVal = (DatumGetInt16(transValue) <= DatumGetInt16(fcinfo->arg[1])) ?
+				transValue : fcinfo->arg[1];
+			return true;
+
+		case F_INT4LARGER:
+			*newVal = (DatumGetInt32(transValue) >= DatumGetInt32(fcinfo->arg[1])) ?
+				transValue : fcinfo->arg[1];
+			return true;
+
+		case F_INT4SMALLER:
+			*newVal = (DatumGetInt32(transValue) <= DatumGetInt32(fcinfo->arg[1])) ?
+				transValue : fcinfo->arg[1];
+			return true;
+
+		case F_INT8LARGER:
+			if (!FLOAT8PASSBYVAL)
+				return false;
+			*newVal = (DatumGetInt64(transValue) >= DatumGetInt64(fcinfo->arg[1])) ?
+				transValue : fcinfo->arg[1];
+			return true;
+
+		case F_INT8SMALLER:
+			if (!FLOAT8PASSBYVAL)
+				return false;
+			*newVal = (DatumGetInt64(transValue) <= DatumGetInt64(fcinfo->arg[1])) ?
+				transValue : fcinfo->arg[1];
+			return true;
+
+		default:
+			return false;
+	}
+}
+
 Datum
 invoke_agg_trans_func(AggState *aggstate,
 					  AggStatePerAgg peraggstate,
@@ -468,6 +562,18 @@ invoke_agg_trans_func(AggState *aggstate,
 		}
 	}
 
+	/*
+	 * Common built-in transition functions on pass-by-value types are
+	 * computed inline, saving the function call for every input row.
+	 */
+	if (transtypeByVal && !*transValueIsNull &&
+		(numTransInputs == 0 || !fcinfo->argnull[1]) &&
+		advance_transition_inline(transfn->fn_oid, transValue, fcinfo, &newVal))
+	{
+		fcinfo->isnull = false;
+		return newVal;
+	}
+
 	/* We run the transition functions in per-input-tuple memory context */
 	oldContext = MemoryContextSwitchTo(tuplecontext);
 
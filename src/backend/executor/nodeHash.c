@@ -42,6 +42,7 @@
 #include "utils/syscache.h"
 
 #include "cdb/cdbexplain.h"
+#include "cdb/cdbmotion.h"
 #include "cdb/cdbutil.h"
 #include "cdb/cdbvars.h"
 
@@ -53,8 +54,17 @@ static void ExecHashSkewTableInsert(HashState *hashState, HashJoinTable hashtabl
 						uint32 hashvalue,
 						int bucketNumber);
 static void ExecHashRemoveNextSkewBucket(HashState *hashState, HashJoinTable hashtable);
+static bool ExecHashComputeHashValue(ExprContext *econtext,
+						 List *hashkeys,
+						 FmgrInfo *hashfunctions,
+						 bool *hashStrict,
+						 bool keep_nulls,
+						 uint32 *hashvalue,
+						 bool *hashkeys_null);
 
 static void ExecHashTableExplainEnd(PlanState *planstate, struct StringInfoData *buf);
+static void ExecHashRuntimeFilterExplainEnd(PlanState *planstate,
+								struct StringInfoData *buf);
 static void
 ExecHashTableExplainBatches(HashJoinTable   hashtable,
                             StringInfo      buf,
@@ -142,6 +152,9 @@ MultiExecHash(HashState *node)
 				ExecHashTableInsert(node, hashtable, slot, hashvalue);
 			}
 			hashtable->totalTuples += 1;
+
+			if (node->hs_runtimeFilter)
+				ExecHashRuntimeFilterInsert(node->hs_runtimeFilter, hashvalue);
 		}
 
 		if (hashkeys_null)
@@ -314,6 +327,7 @@ ExecHashTableCreate(HashState *hashState, HashJoinState *hjstate, List *hashOper
 	hashtable->nbuckets = nbuckets;
 	hashtable->log2_nbuckets = log2_nbuckets;
 	hashtable->buckets = NULL;
+	hashtable->bucketTags = NULL;
 	hashtable->keepNulls = keepNulls;
 	hashtable->skewEnabled = false;
 	hashtable->skewBucket = NULL;
@@ -413,6 +427,8 @@ ExecHashTableCreate(HashState *hashState, HashJoinState *hjstate, List *hashOper
 
 	hashtable->buckets = (HashJoinTuple *)
 		palloc0(nbuckets * sizeof(HashJoinTuple));
+	hashtable->bucketTags = (uint16 *)
+		palloc0(nbuckets * sizeof(uint16));
 
 	/*
 	 * Set up for skew optimization, if possible and there's a need for more
@@ -523,8 +539,9 @@ ExecChooseHashTableSize(double ntuples, int tupwidth, bool useskew,
 	 * memory is filled.  Set nbatch to the smallest power of 2 that appears
 	 * sufficient.  The Min() steps limit the results so that the pointer
 	 * arrays we'll try to allocate do not exceed work_mem nor MaxAllocSize.
+	 * Each bucket also has a uint16 tag in bucketTags.
 	 */
-	max_pointers = (operatorMemKB * 1024L) / sizeof(HashJoinTuple);
+	max_pointers = (operatorMemKB * 1024L) / (sizeof(HashJoinTuple) + sizeof(uint16));
 	max_pointers = Min(max_pointers, MaxAllocSize / sizeof(HashJoinTuple));
 	/* If max_pointers isn't a power of 2, must round it down to one */
 	mppow2 = 1L << my_log2(max_pointers);
@@ -539,6 +556,7 @@ ExecChooseHashTableSize(double ntuples, int tupwidth, bool useskew,
 	{
 		/* We'll need multiple batches */
 		long		lbuckets;
+		long		tag_bytes;
 		double		dbatch;
 		int			minbatch;
 
@@ -558,6 +576,13 @@ ExecChooseHashTableSize(double ntuples, int tupwidth, bool useskew,
 			i++;
 		nbuckets = (1 << i);
 
+		/* The bucket tags take their share of the memory for each batch */
+		tag_bytes = (long) nbuckets * sizeof(uint16);
+		if (tag_bytes < hash_table_bytes / 2)
+			hash_table_bytes -= tag_bytes;
+		else
+			hash_table_bytes /= 2;
+
 		dbatch = ceil(inner_rel_bytes / hash_table_bytes);
 		dbatch = Min(dbatch, max_pointers);
 		minbatch = (int) dbatch;
@@ -616,7 +641,8 @@ ExecChooseHashTableSize(double ntuples, int tupwidth, bool useskew,
 
 		/* if we have work_mem to spare, we'd like to use it -- so
 		 * divide up our memory evenly (see the spill case above) */
-		dbuckets_upper = (double)hash_table_bytes / ((double)tupsize * gp_hashjoin_tuples_per_bucket);
+		dbuckets_upper = (double)hash_table_bytes /
+			((double)tupsize * gp_hashjoin_tuples_per_bucket + sizeof(uint16));
 
 		/* we'll use our "lower" work_mem independent guess as a lower
 		 * limit; but if we've got memory to spare we'll take the mean
@@ -787,6 +813,7 @@ ExecHashIncreaseNumBatches(HashJoinTable hashtable)
 	{
 		HashJoinTuple prevtuple;
 		HashJoinTuple tuple;
+		uint16		tag = 0;
 
 		prevtuple = NULL;
 		tuple = hashtable->buckets[i];
@@ -806,6 +833,7 @@ ExecHashIncreaseNumBatches(HashJoinTable hashtable)
 			{
 				/* keep tuple */
 				prevtuple = tuple;
+				tag |= HJ_BUCKET_TAG(tuple->hashvalue);
 			}
 			else
 			{
@@ -839,6 +867,9 @@ ExecHashIncreaseNumBatches(HashJoinTable hashtable)
 			/* allow this loop to be cancellable */
 			CHECK_FOR_INTERRUPTS();
 		}
+
+		/* the tag only needs the tuples that are left */
+		hashtable->bucketTags[i] = tag;
 	}
 
 #ifdef HJDEBUG
@@ -931,6 +962,7 @@ ExecHashTableInsert(HashState *hashState, HashJoinTable hashtable,
 		/* Push it onto the front of the bucket's list */
 		hashTuple->next = hashtable->buckets[bucketno];
 		hashtable->buckets[bucketno] = hashTuple;
+		hashtable->bucketTags[bucketno] |= HJ_BUCKET_TAG(hashvalue);
 
 		/* Account for space used, and back off if we've used too much */
 		hashtable->spaceUsed += hashTupleSize;
@@ -992,17 +1024,44 @@ ExecHashGetHashValue(HashState *hashState, HashJoinTable hashtable,
 					 bool keep_nulls,
 					 uint32 *hashvalue,
 					 bool *hashkeys_null)
+{
+	bool		result;
+
+	START_MEMORY_ACCOUNT(hashState->ps.memoryAccountId);
+	{
+	result = ExecHashComputeHashValue(econtext, hashkeys,
+									  outer_tuple ?
+									  hashtable->outer_hashfunctions :
+									  hashtable->inner_hashfunctions,
+									  hashtable->hashStrict,
+									  keep_nulls,
+									  hashvalue,
+									  hashkeys_null);
+	}
+	END_MEMORY_ACCOUNT();
+	return result;
+}
+
+/*
+ * ExecHashComputeHashValue
+ *		Workhorse of ExecHashGetHashValue(), given the hash functions and
+ *		strictness of the hash join operators.
+ */
+static bool
+ExecHashComputeHashValue(ExprContext *econtext,
+						 List *hashkeys,
+						 FmgrInfo *hashfunctions,
+						 bool *hashStrict,
+						 bool keep_nulls,
+						 uint32 *hashvalue,
+						 bool *hashkeys_null)
 {
 	uint32		hashkey = 0;
-	FmgrInfo   *hashfunctions;
 	ListCell   *hk;
 	int			i = 0;
 	MemoryContext oldContext;
 	bool		result = true;
 
-	START_MEMORY_ACCOUNT(hashState->ps.memoryAccountId);
-	{
-
 	Assert(hashkeys_null);
 
 	(*hashkeys_null) = true;
@@ -1015,11 +1074,6 @@ ExecHashGetHashValue(HashState *hashState, HashJoinTable hashtable,
 
 	oldContext = MemoryContextSwitchTo(econtext->ecxt_per_tuple_memory);
 
-	if (outer_tuple)
-		hashfunctions = hashtable->outer_hashfunctions;
-	else
-		hashfunctions = hashtable->inner_hashfunctions;
-
 	foreach(hk, hashkeys)
 	{
 		ExprState  *keyexpr = (ExprState *) lfirst(hk);
@@ -1054,7 +1108,7 @@ ExecHashGetHashValue(HashState *hashState, HashJoinTable hashtable,
 		 */
 		if (isNull)
 		{
-			if (hashtable->hashStrict[i] && !keep_nulls)
+			if (hashStrict[i] && !keep_nulls)
 			{
 				result = false;
 			}
@@ -1075,8 +1129,6 @@ ExecHashGetHashValue(HashState *hashState, HashJoinTable hashtable,
 	MemoryContextSwitchTo(oldContext);
 
 	*hashvalue = hashkey;
-	}
-	END_MEMORY_ACCOUNT();
 	return result;
 }
 
@@ -1161,13 +1213,14 @@ ExecScanHashBucket(HashState *hashState, HashJoinState *hjstate,
 	 * bucket, or NULL if it's time to start scanning a new bucket.
 	 *
 	 * If the tuple hashed to a skew bucket then scan the skew bucket
-	 * otherwise scan the standard hashtable bucket.
+	 * otherwise scan the standard hashtable bucket.  Skip the standard bucket
+	 * if its tag says that no tuple in it has our hash value.
 	 */
 	if (hashTuple != NULL)
 		hashTuple = hashTuple->next;
 	else if (hjstate->hj_CurSkewBucketNo != INVALID_SKEW_BUCKET_NO)
 		hashTuple = hashtable->skewBucket[hjstate->hj_CurSkewBucketNo]->tuples;
-	else
+	else if (hashtable->bucketTags[hjstate->hj_CurBucketNo] & HJ_BUCKET_TAG(hashvalue))
 		hashTuple = hashtable->buckets[hjstate->hj_CurBucketNo];
 
 	while (hashTuple != NULL)
@@ -1318,6 +1371,8 @@ ExecHashTableReset(HashState *hashState, HashJoinTable hashtable)
 	/* Reallocate and reinitialize the hash bucket headers. */
 	hashtable->buckets = (HashJoinTuple *)
 		palloc0(nbuckets * sizeof(HashJoinTuple));
+	hashtable->bucketTags = (uint16 *)
+		palloc0(nbuckets * sizeof(uint16));
 
 	hashtable->spaceUsed = 0;
 	hashtable->totalTuples = 0;
@@ -2044,6 +2099,7 @@ ExecHashRemoveNextSkewBucket(HashState *hashState, HashJoinTable hashtable)
 			/* Move the tuple to the main hash table */
 			hashTuple->next = hashtable->buckets[bucketno];
 			hashtable->buckets[bucketno] = hashTuple;
+			hashtable->bucketTags[bucketno] |= HJ_BUCKET_TAG(hashvalue);
 			/* We have reduced skew space, but overall space doesn't change */
 			hashtable->spaceUsedSkew -= tupleSize;
 		}
@@ -2099,3 +2155,396 @@ ExecHashRemoveNextSkewBucket(HashState *hashState, HashJoinTable hashtable)
 		hashtable->spaceUsedSkew = 0;
 	}
 }
+
+/*
+ * The two bits of a hash value in its word of a runtime filter.  The word is
+ * picked by at most the low 19 bits (RUNTIME_FILTER_MAX_BITS / 64 words), so
+ * the bit positions are independent of it.
+ */
+static inline uint64
+RuntimeFilterBits(uint32 hashvalue)
+{
+	return ((uint64) 1 << ((hashvalue >> 20) & 63)) |
+		((uint64) 1 << ((hashvalue >> 26) & 63));
+}
+
+/*
+ * Does the Motion emit the columns of its input, in the same order?
+ */
+static bool
+motionPassesColumns(Motion *motion)
+{
+	List	   *tlist = motion->plan.targetlist;
+	ListCell   *lc;
+	AttrNumber	attno = 1;
+
+	if (list_length(tlist) != list_length(outerPlan(motion)->targetlist))
+		return false;
+
+	foreach(lc, tlist)
+	{
+		TargetEntry *tle = (TargetEntry *) lfirst(lc);
+		Var		   *var = (Var *) tle->expr;
+
+		if (!IsA(var, Var) || var->varattno != attno)
+			return false;
+		attno++;
+	}
+
+	return true;
+}
+
+/*
+ * ExecHashJoinPushesRuntimeFilter
+ *		Does the hash join push a runtime filter down to the scan of its outer
+ *		input?
+ *
+ * The scan must be the outer input itself, or right below a Motion.  In the
+ * latter case the filter is shipped over the interconnect, which only the
+ * TCP interconnect can do.
+ *
+ * This only looks at the plan, so that the slice of the join and the slice
+ * of the scan come to the same conclusion.
+ */
+bool
+ExecHashJoinPushesRuntimeFilter(HashJoin *node)
+{
+	Plan	   *outerNode = outerPlan(node);
+
+	if (!gp_enable_runtime_filter)
+		return false;
+
+	/* Only joins that don't emit unmatched outer tuples can drop them early */
+	if (node->join.jointype != JOIN_INNER &&
+		node->join.jointype != JOIN_SEMI &&
+		node->join.jointype != JOIN_RIGHT)
+		return false;
+
+	if (IsA(outerNode, SeqScan))
+		return true;
+
+	if (!IsA(outerNode, Motion) ||
+		!IsA(outerPlan(outerNode), SeqScan) ||
+		Gp_interconnect_type != INTERCONNECT_TYPE_TCP)
+		return false;
+
+	/*
+	 * The outer hash keys are computed by the scan, so the Motion must pass
+	 * its columns through unchanged.
+	 */
+	return motionPassesColumns((Motion *) outerNode);
+}
+
+/*
+ * Set up a runtime filter for the hash join.
+ *
+ * If outerScan is given, the filter is applied by that scan, and we prepare
+ * to compute the hash values of its tuples.  The filter is shipped over the
+ * Motion motNodeID, if that is not 0.
+ *
+ * The size of the filter is based on the planner's estimate of the number of
+ * inner rows.  A shipped filter is sent by every segment to every segment,
+ * so its size is also limited by the number of segments.  Both sides of the
+ * Motion must come to the same size.
+ */
+static HashRuntimeFilter
+makeRuntimeFilter(HashJoin *node, EState *estate, ScanState *outerScan,
+				  int16 motNodeID)
+{
+	HashRuntimeFilter filter;
+	double		nbits;
+	double		maxbits = RUNTIME_FILTER_MAX_BITS;
+	uint32		nwords;
+
+	if (motNodeID != 0)
+	{
+		double		ncopies = (double) getgpsegmentCount() * getgpsegmentCount();
+
+		maxbits = RUNTIME_FILTER_MAX_REMOTE_BITS;
+		while (maxbits > RUNTIME_FILTER_MIN_BITS &&
+			   maxbits * ncopies > RUNTIME_FILTER_MAX_REMOTE_TOTAL_BITS)
+			maxbits /= 2;
+	}
+
+	nbits = innerPlan(node)->plan_rows * RUNTIME_FILTER_BITS_PER_ROW;
+	nbits = Max(nbits, RUNTIME_FILTER_MIN_BITS);
+	nbits = Min(nbits, maxbits);
+
+	/* round up to a power of 2, so that the word can be picked by masking */
+	nwords = 1;
+	while (nwords * 64.0 < nbits)
+		nwords <<= 1;
+
+	filter = (HashRuntimeFilter) palloc0(sizeof(HashRuntimeFilterData));
+	filter->estate = estate;
+	filter->words = (uint64 *) palloc0(nwords * sizeof(uint64));
+	filter->nwords = nwords;
+	filter->motNodeID = motNodeID;
+
+	if (outerScan)
+	{
+		int			nkeys = list_length(node->hashclauses);
+		ListCell   *lc;
+		int			i = 0;
+
+		/* Same as the outer side of ExecInitHashJoin() and ExecHashTableCreate() */
+		filter->hashfunctions = (FmgrInfo *) palloc(nkeys * sizeof(FmgrInfo));
+		filter->hashStrict = (bool *) palloc(nkeys * sizeof(bool));
+		foreach(lc, node->hashclauses)
+		{
+			OpExpr	   *hclause = (OpExpr *) lfirst(lc);
+			Oid			left_hashfn;
+			Oid			right_hashfn;
+
+			Assert(IsA(hclause, OpExpr));
+			filter->hashkeys = lappend(filter->hashkeys,
+									   ExecInitExpr(linitial(hclause->args),
+													&outerScan->ps));
+
+			if (!get_op_hash_functions(hclause->opno, &left_hashfn, &right_hashfn))
+				elog(ERROR, "could not find hash function for hash operator %u",
+					 hclause->opno);
+			fmgr_info(left_hashfn, &filter->hashfunctions[i]);
+			filter->hashStrict[i] = op_strict(hclause->opno);
+			i++;
+		}
+		filter->keepNulls = (node->hashqualclauses != NIL);
+		filter->econtext = CreateExprContext(estate);
+
+		outerScan->ss_runtimeFilter = filter;
+
+		/*
+		 * CDB: Offer extra info for EXPLAIN ANALYZE, on the scan that applies
+		 * the filter.
+		 */
+		if ((estate->es_instrument & INSTRUMENT_CDB) &&
+			outerScan->ps.cdbexplainfun == NULL)
+			outerScan->ps.cdbexplainfun = ExecHashRuntimeFilterExplainEnd;
+	}
+
+	return filter;
+}
+
+/*
+ * ExecHashRuntimeFilterCreate
+ *		Create the runtime filter of a hash join, built by its Hash node.
+ *
+ * If the outer input is a Motion, the filter is shipped to the senders of
+ * the Motion.  Otherwise the outer input is the scan that applies it.
+ */
+void
+ExecHashRuntimeFilterCreate(HashJoinState *hjstate)
+{
+	HashJoin   *node = (HashJoin *) hjstate->js.ps.plan;
+	EState	   *estate = hjstate->js.ps.state;
+	PlanState  *outerNode = outerPlanState(hjstate);
+	HashRuntimeFilter filter;
+
+	if (IsA(outerNode, MotionState))
+		filter = makeRuntimeFilter(node, estate, NULL,
+								   ((Motion *) outerNode->plan)->motionID);
+	else
+		filter = makeRuntimeFilter(node, estate, (ScanState *) outerNode, 0);
+
+	hjstate->hj_RuntimeFilter = filter;
+	((HashState *) innerPlanState(hjstate))->hs_runtimeFilter = filter;
+}
+
+/*
+ * ExecHashRuntimeFilterCreateSender
+ *		Create a runtime filter for the scan below a sending Motion, to be
+ *		filled in with the filters of the hash join on the receiving side.
+ */
+void
+ExecHashRuntimeFilterCreateSender(HashJoin *node, EState *estate,
+								  ScanState *outerScan, int16 motNodeID)
+{
+	(void) makeRuntimeFilter(node, estate, outerScan, motNodeID);
+}
+
+/*
+ * ExecHashRuntimeFilterReset
+ *		Clear the filter before the hash table is (re)built.
+ *
+ * The filter passes every tuple until ExecHashRuntimeFilterFinish() is
+ * called.
+ */
+void
+ExecHashRuntimeFilterReset(HashRuntimeFilter filter)
+{
+	filter->ready = false;
+	filter->ninserted = 0;
+	MemSet(filter->words, 0, filter->nwords * sizeof(uint64));
+}
+
+/*
+ * ExecHashRuntimeFilterInsert
+ *		Add the hash value of an inner tuple to the filter.
+ */
+void
+ExecHashRuntimeFilterInsert(HashRuntimeFilter filter, uint32 hashvalue)
+{
+	filter->words[hashvalue & (filter->nwords - 1)] |=
+		RuntimeFilterBits(hashvalue);
+	filter->ninserted++;
+}
+
+/*
+ * ExecHashRuntimeFilterFinish
+ *		The hash table has been built, start applying the filter.
+ *
+ * If the inner side turned out much bigger than estimated, most bits are set
+ * and the filter would remove few rows; don't bother probing it then.
+ *
+ * A cross-slice filter is shipped to the senders the first time the hash
+ * table is built.  They have started scanning by the time it is rebuilt.
+ */
+void
+ExecHashRuntimeFilterFinish(HashRuntimeFilter filter)
+{
+	uint64		nbits = (uint64) filter->nwords * 64;
+
+	filter->overflowed = (filter->ninserted > nbits / 4);
+	filter->ready = !filter->overflowed;
+
+	if (filter->motNodeID != 0 && !filter->shipped)
+	{
+		HashRuntimeFilterMsg *msg;
+		Size		hdrlen = MAXALIGN(sizeof(HashRuntimeFilterMsg));
+		Size		len = hdrlen + filter->nwords * sizeof(uint64);
+
+		msg = (HashRuntimeFilterMsg *) palloc(len);
+		msg->nwords = filter->nwords;
+		msg->overflowed = filter->overflowed;
+		memcpy((char *) msg + hdrlen, filter->words,
+			   filter->nwords * sizeof(uint64));
+
+		SendRuntimeFilter(filter->estate->interconnect_context,
+						  filter->motNodeID, (char *) msg, len);
+		pfree(msg);
+
+		filter->shipped = true;
+	}
+}
+
+/*
+ * Callback of RecvRuntimeFilters(): merge the filter of one receiver.
+ */
+static void
+ExecHashRuntimeFilterMerge(void *arg, const char *data, int len)
+{
+	HashRuntimeFilter filter = (HashRuntimeFilter) arg;
+	HashRuntimeFilterMsg msg;
+	Size		hdrlen = MAXALIGN(sizeof(HashRuntimeFilterMsg));
+	const uint64 *words = (const uint64 *) (data + hdrlen);
+	uint32		i;
+
+	if (len < hdrlen)
+		elog(ERROR, "invalid runtime filter message of %d bytes", len);
+	memcpy(&msg, data, sizeof(msg));
+	if (msg.nwords != filter->nwords ||
+		len != hdrlen + msg.nwords * sizeof(uint64))
+		elog(ERROR, "invalid runtime filter message of %d bytes with %u words, expected %u words",
+			 len, msg.nwords, filter->nwords);
+
+	if (msg.overflowed)
+		filter->overflowed = true;
+
+	for (i = 0; i < filter->nwords; i++)
+		filter->words[i] |= words[i];
+}
+
+/*
+ * ExecHashRuntimeFilterCheck
+ *		Can the tuple in the given slot, produced by the outer side of the
+ *		join, have a join partner?
+ *
+ * Returns false if the tuple can be discarded.  If the filter is not ready,
+ * always returns true.
+ *
+ * A cross-slice filter is only ready if the filters of all the receivers
+ * arrived within gp_runtime_filter_wait_time, which we wait for on the first
+ * call.
+ */
+bool
+ExecHashRuntimeFilterCheck(HashRuntimeFilter filter, TupleTableSlot *slot)
+{
+	ExprContext *econtext = filter->econtext;
+	uint32		hashvalue;
+	bool		hashkeys_null = false;
+	bool		pass;
+
+	if (filter->motNodeID != 0 && !filter->waited)
+	{
+		filter->waited = true;
+		if (RecvRuntimeFilters(filter->estate->interconnect_context,
+							   filter->motNodeID,
+							   gp_runtime_filter_wait_time,
+							   ExecHashRuntimeFilterMerge,
+							   filter))
+			filter->ready = !filter->overflowed;
+		else
+			filter->timedout = true;
+	}
+
+	if (!filter->ready || filter->disabled)
+		return true;
+
+	econtext->ecxt_outertuple = slot;
+	if (ExecHashComputeHashValue(econtext,
+								 filter->hashkeys,
+								 filter->hashfunctions,
+								 filter->hashStrict,
+								 filter->keepNulls,
+								 &hashvalue,
+								 &hashkeys_null))
+	{
+		uint64		bits = RuntimeFilterBits(hashvalue);
+
+		pass = ((filter->words[hashvalue & (filter->nwords - 1)] & bits) == bits);
+	}
+	else
+		pass = false;
+
+	filter->nchecked++;
+	if (!pass)
+		filter->nfiltered++;
+
+	/*
+	 * Computing the hash values costs about as much as probing the hash
+	 * table itself, so stop if the filter doesn't remove enough rows.
+	 */
+	if (filter->nchecked == RUNTIME_FILTER_SAMPLE_ROWS &&
+		filter->nfiltered < RUNTIME_FILTER_SAMPLE_ROWS * RUNTIME_FILTER_MIN_SELECTIVITY)
+		filter->disabled = true;
+
+	return pass;
+}
+
+/*
+ * ExecHashRuntimeFilterExplainEnd
+ *		Called before ExecutorEnd to report the rows removed by the filter,
+ *		on the scan node that applied it.
+ */
+static void
+ExecHashRuntimeFilterExplainEnd(PlanState *planstate, struct StringInfoData *buf)
+{
+	HashRuntimeFilter filter = ((ScanState *) planstate)->ss_runtimeFilter;
+
+	if (!filter)
+		return;
+
+	if (filter->nchecked > 0)
+	{
+		appendStringInfo(buf, "Rows Removed by Runtime Filter: " UINT64_FORMAT
+						 " of " UINT64_FORMAT ".",
+						 filter->nfiltered, filter->nchecked);
+		if (filter->disabled)
+			appendStringInfoString(buf, "  Filter disabled, it removed too few rows.");
+	}
+	else if (filter->timedout)
+		appendStringInfo(buf, "Runtime filter not received within %d ms.",
+						 gp_runtime_filter_wait_time);
+	else if (filter->overflowed)
+		appendStringInfoString(buf, "Runtime filter not used, the inner side has too many rows for it.");
+}
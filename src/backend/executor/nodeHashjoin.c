@@ -121,6 +121,13 @@ ExecHashJoin_guts(HashJoinState *node)
 				 */
 				Assert(hashtable == NULL);
 
+				/*
+				 * The runtime filter must pass all outer tuples until it has
+				 * been rebuilt, too.
+				 */
+				if (node->hj_RuntimeFilter)
+					ExecHashRuntimeFilterReset(node->hj_RuntimeFilter);
+
 				/*
 				 * MPP-4165: My fix for MPP-3300 was correct in that we avoided
 				 * the *deadlock* but had very unexpected (and painful)
@@ -218,6 +225,9 @@ ExecHashJoin_guts(HashJoinState *node)
 				hashNode->hashtable = hashtable;
 				(void) MultiExecProcNode((PlanState *) hashNode);
 
+				if (node->hj_RuntimeFilter)
+					ExecHashRuntimeFilterFinish(node->hj_RuntimeFilter);
+
 #ifdef HJDEBUG
 				elog(gp_workfile_caching_loglevel, "HashJoin built table with %.1f tuples by executing subplan for batch 0", hashtable->totalTuples);
 #endif
@@ -753,6 +763,14 @@ ExecInitHashJoin(HashJoin *node, EState *estate, int eflags)
 	hjstate->hj_MatchedOuter = false;
 	hjstate->hj_OuterNotEmpty = false;
 
+	/*
+	 * CDB: Push a runtime filter down to the scan of the outer input, which
+	 * may be in another slice.
+	 */
+	if (!(eflags & EXEC_FLAG_EXPLAIN_ONLY) &&
+		ExecHashJoinPushesRuntimeFilter(node))
+		ExecHashRuntimeFilterCreate(hjstate);
+
 	return hjstate;
 }
 
@@ -358,6 +358,26 @@ pass_down_bound(LimitState *node, PlanState *child_node)
 			sortState->bound = tuples_needed;
 		}
 	}
+	else if (IsA(child_node, MotionState))
+	{
+		/*
+		 * A receiving Motion returns exactly the tuples it receives, so it
+		 * can stop its senders as soon as the parent has all it needs.  The
+		 * senders have their own bounded Sort under the preliminary Limit the
+		 * planner pushed down to them.
+		 */
+		MotionState *motionState = (MotionState *) child_node;
+		int64		tuples_needed = node->count + node->offset;
+
+		if (motionState->mstype != MOTIONSTATE_RECV ||
+			node->noCount || tuples_needed <= 0)
+			motionState->bounded = false;
+		else
+		{
+			motionState->bounded = true;
+			motionState->bound = tuples_needed;
+		}
+	}
 	else if (IsA(child_node, MergeAppendState))
 	{
 		MergeAppendState *maState = (MergeAppendState *) child_node;
@@ -163,7 +163,7 @@ ExecMaterial(MaterialState *node)
 			{
 				if (ma->driver_slice == currentSliceId)
 				{
-					ntuplestore_flush(ts);
+					shareinput_writer_publish(node->share_lk_ctxt, ts);
 					shareinput_writer_notifyready(node->share_lk_ctxt, ma->share_id,
 												  ma->nsharer_xslice, estate->es_plannedstmt->planGen);
 				}
@@ -24,11 +24,13 @@
 #include "executor/executor.h"
 #include "executor/execdebug.h"
 #include "executor/execUtils.h"
+#include "executor/nodeHash.h"
 #include "executor/nodeMotion.h"
-#include "lib/binaryheap.h"
+#include "lib/losertree.h"
 #include "utils/tuplesort.h"
 #include "utils/tuplesort_mk_details.h"
 #include "miscadmin.h"
+#include "optimizer/walkers.h"
 #include "utils/memutils.h"
 
 
@@ -48,7 +50,7 @@
 /*
  * CdbTupleHeapInfo
  *
- * A priority queue element holding the next tuple of the
+ * A merge tree element holding the next tuple of the
  * sorted tuple stream received from a particular sender.
  * Used by sorted receiver (Merge Receive).
  */
@@ -98,10 +100,22 @@ static CdbMergeComparatorContext *CdbMergeComparator_CreateContext(CdbTupleHeapI
 static void CdbMergeComparator_DestroyContext(CdbMergeComparatorContext *ctx);
 
 
+/*
+ * Context of findRuntimeFilterJoin_walker().
+ */
+typedef struct RuntimeFilterJoinContext
+{
+	plan_tree_base_prefix base; /* Required prefix for plan_tree_walker */
+	int			motionID;		/* the Motion we are looking for */
+	HashJoin   *result;			/* the hash join above it, if found */
+} RuntimeFilterJoinContext;
+
 /*=========================================================================
  * FUNCTIONS PROTOTYPES
  */
 static TupleTableSlot *execMotionSender(MotionState *node);
+static void setupRuntimeFilterSender(MotionState *node);
+static bool findRuntimeFilterJoin_walker(Node *node, RuntimeFilterJoinContext *context);
 static TupleTableSlot *execMotionUnsortedReceiver(MotionState *node);
 static TupleTableSlot *execMotionSortedReceiver(MotionState *node);
 static TupleTableSlot *execMotionSortedReceiver_mk(MotionState *node);
@@ -210,7 +224,13 @@ ExecMotion(MotionState *node)
 		else
 			node->ps.state->active_recv_id = motion->motionID;
 
-		if (motion->sendSorted)
+		/*
+		 * If a LIMIT above has got all the tuples it needs, the senders have
+		 * already been told to stop; don't wait for anything more from them.
+		 */
+		if (node->bounded && node->numTuplesBounded >= node->bound)
+			tuple = NULL;
+		else if (motion->sendSorted)
 		{
 			if (gp_enable_motion_mk_sort)
 				tuple = execMotionSortedReceiver_mk(node);
@@ -233,6 +253,19 @@ ExecMotion(MotionState *node)
 		if (QueryFinishPending)
 			tuple = NULL;
 
+		/*
+		 * Once the tuple that completes the LIMIT is out, send the stop
+		 * message right away instead of when the Limit node is squelched.
+		 * The senders can quit producing and sorting tuples that would only
+		 * be thrown away, even if the parent doesn't ask for another tuple
+		 * for a long time, like with a cursor.
+		 */
+		if (!TupIsNull(tuple) && node->bounded &&
+			++node->numTuplesBounded == node->bound)
+			SendStopMessage(node->ps.state->motionlayer_context,
+							node->ps.state->interconnect_context,
+							motion->motionID);
+
 		if (tuple == NULL)
 			node->ps.state->active_recv_id = -1;
 #ifdef MEASURE_MOTION_TIME
@@ -698,12 +731,15 @@ execMotionSortedReceiver_mk(MotionState *node)
 	return slot;
 }
 
-/* Sorted receiver using binary heap */
+/*
+ * Sorted receiver using a loser tree.  Only used when gp_enable_motion_mk_sort
+ * is off; by default execMotionSortedReceiver_mk() merges with the mk heap.
+ */
 static TupleTableSlot *
 execMotionSortedReceiver(MotionState *node)
 {
 	TupleTableSlot *slot;
-	binaryheap *hp = node->tupleheap;
+	losertree  *lt = node->tupleheap;
 	GenericTuple tuple,
 				inputTuple;
 	Motion	   *motion = (Motion *) node->ps.plan;
@@ -712,7 +748,7 @@ execMotionSortedReceiver(MotionState *node)
 
 	AssertState(motion->motionType == MOTIONTYPE_FIXED &&
 				motion->sendSorted &&
-				hp != NULL);
+				lt != NULL);
 
 	/* Notify senders and return EOS if caller doesn't want any more data. */
 	if (node->stopRequested)
@@ -749,20 +785,20 @@ execMotionSortedReceiver(MotionState *node)
 			ereport(ERROR, (errmsg("Interconnect is down unexpectedly.")));
 	}
 
-	/* On first call, fill the priority queue with each sender's first tuple. */
+	/* On first call, fill the merge tree with each sender's first tuple. */
 	if (!node->tupleheapReady)
 	{
 		execMotionSortedReceiverFirstTime(node);
 	}
 
 	/*
-	 * Delete from the priority queue the element that we fetched last time.
-	 * Receive and insert the next tuple from that same sender.
+	 * Replace in the merge tree the element that we fetched last time with
+	 * the next tuple from that same sender.
 	 */
 	else
 	{
-		/* Old element is still at the head of the pq. */
-		Assert(DatumGetInt32(binaryheap_first(hp)) == node->routeIdNext);
+		/* Old element is still the winner of the merge tree. */
+		Assert(DatumGetInt32(losertree_first(lt)) == node->routeIdNext);
 
 		/* Receive the successor of the tuple that we returned last time. */
 		inputTuple = RecvTupleFrom(node->ps.state->motionlayer_context,
@@ -770,7 +806,10 @@ execMotionSortedReceiver(MotionState *node)
 								   motion->motionID,
 								   node->routeIdNext);
 
-		/* Substitute it in the pq for its predecessor. */
+		/*
+		 * Substitute it in the tree for its predecessor.  Only the matches
+		 * on the path of this sender's leaf are replayed.
+		 */
 		if (inputTuple)
 		{
 			CdbTupleHeapInfo *info = &node->tupleheap_entries[node->routeIdNext];
@@ -789,7 +828,7 @@ execMotionSortedReceiver(MotionState *node)
 											node->tupleheap_cxt->tupDesc,
 											&info->isnull1);
 
-			binaryheap_replace_first(hp, Int32GetDatum(node->routeIdNext));
+			losertree_replace_first(lt, Int32GetDatum(node->routeIdNext));
 
 			node->numTuplesFromAMS++;
 
@@ -812,13 +851,13 @@ execMotionSortedReceiver(MotionState *node)
 		}
 		else
 		{
-			/* At EOS, drop this sender from the priority queue. */
-			binaryheap_remove_first(hp);
+			/* At EOS, drop this sender from the merge tree. */
+			losertree_remove_first(lt);
 		}
 	}
 
 	/* Finished if all senders have returned EOS. */
-	if (binaryheap_empty(hp))
+	if (losertree_empty(lt))
 	{
 		Assert(node->numTuplesFromAMS == node->numTuplesToParent);
 		Assert(node->numTuplesFromChild == 0);
@@ -827,19 +866,18 @@ execMotionSortedReceiver(MotionState *node)
 	}
 
 	/*
-	 * Our next result tuple, with lowest key among all senders, is now at the
-	 * head of the priority queue.  Get it from there.
+	 * Our next result tuple, with lowest key among all senders, is now the
+	 * winner of the merge tree.  Get it from there.
 	 *
-	 * We transfer ownership of the tuple from the pq element to our caller,
-	 * but the pq element itself will remain in place until the next time we
-	 * are called, to avoid an unnecessary rearrangement of the priority
-	 * queue.
+	 * We transfer ownership of the tuple from the tree element to our caller,
+	 * but the tree element itself will remain in place until the next time
+	 * we are called, when it is replaced by its successor.
 	 */
-	node->routeIdNext = binaryheap_first(hp);
+	node->routeIdNext = DatumGetInt32(losertree_first(lt));
 	tupHeapInfo = &node->tupleheap_entries[node->routeIdNext];
 	tuple = tupHeapInfo->tuple;
 
-	/* Zap dangling tuple ptr for safety. PQ element doesn't own it anymore. */
+	/* Zap dangling tuple ptr for safety. Tree element doesn't own it anymore. */
 	tupHeapInfo->tuple = NULL;
 
 	/* Update counters. */
@@ -875,7 +913,7 @@ void
 execMotionSortedReceiverFirstTime(MotionState *node)
 {
 	GenericTuple inputTuple;
-	binaryheap *hp = node->tupleheap;
+	losertree  *lt = node->tupleheap;
 	Motion	   *motion = (Motion *) node->ps.plan;
 	int			iSegIdx;
 	ListCell   *lcProcess;
@@ -886,7 +924,7 @@ execMotionSortedReceiverFirstTime(MotionState *node)
 	Assert(sendSlice->sliceIndex == motion->motionID);
 
 	/*
-	 * Get the first tuple from every sender, and stick it into the heap.
+	 * Get the first tuple from every sender, and stick it into the tree.
 	 */
 	foreach_with_count(lcProcess, sendSlice->primaryProcesses, iSegIdx)
 	{
@@ -907,7 +945,7 @@ execMotionSortedReceiverFirstTime(MotionState *node)
 
 			info->tuple = inputTuple;
 
-			binaryheap_add_unordered(hp, iSegIdx);
+			losertree_add_unordered(lt, Int32GetDatum(iSegIdx));
 
 			if (is_memtuple(inputTuple))
 				info->datum1 = memtuple_getattr((MemTuple) inputTuple,
@@ -943,11 +981,10 @@ execMotionSortedReceiverFirstTime(MotionState *node)
 	Assert(iSegIdx == node->numInputSegs);
 
 	/*
-	 * Done adding the elements, now arrange the heap to satisfy the heap
-	 * property. This is quicker than inserting the initial elements one by
-	 * one.
+	 * Done adding the elements, now play the tournament to find the first
+	 * winner.
 	 */
-	binaryheap_build(hp);
+	losertree_build(lt);
 
 	node->tupleheapReady = true;
 }								/* execMotionSortedReceiverFirstTime */
@@ -991,6 +1028,9 @@ ExecInitMotion(Motion *node, EState *estate, int eflags)
 	motionstate->ps.state = estate;
 	motionstate->mstype = MOTIONSTATE_NONE;
 	motionstate->stopRequested = false;
+	motionstate->bounded = false;
+	motionstate->bound = 0;
+	motionstate->numTuplesBounded = 0;
 	motionstate->hashExprs = NIL;
 	motionstate->cdbhash = NULL;
 	motionstate->isExplictGatherMotion = false;
@@ -1139,6 +1179,16 @@ ExecInitMotion(Motion *node, EState *estate, int eflags)
 
 	motionstate->ps.ps_ProjInfo = NULL;
 
+	/*
+	 * CDB: The hash join that receives our tuples may ship a runtime filter
+	 * back to the scan below us.
+	 */
+	if (motionstate->mstype == MOTIONSTATE_SEND &&
+		gp_enable_runtime_filter &&
+		!(eflags & EXEC_FLAG_EXPLAIN_ONLY) &&
+		IsA(outerPlan, SeqScanState))
+		setupRuntimeFilterSender(motionstate);
+
 	/* Set up motion send data structures */
 	if (motionstate->mstype == MOTIONSTATE_SEND && node->motionType == MOTIONTYPE_HASH)
 	{
@@ -1177,7 +1227,7 @@ ExecInitMotion(Motion *node, EState *estate, int eflags)
 		motionstate->cdbhash = makeCdbHash(numsegments, nkeys, node->hashFuncs);
 	}
 
-	/* Merge Receive: Set up the key comparator and priority queue. */
+	/* Merge Receive: Set up the key comparator and merge tree. */
 	if (node->sendSorted && motionstate->mstype == MOTIONSTATE_RECV)
 	{
 		if (gp_enable_motion_mk_sort)
@@ -1187,7 +1237,7 @@ ExecInitMotion(Motion *node, EState *estate, int eflags)
 			/* Allocate context object for the key comparator. */
 			motionstate->tupleheap_entries =
 				palloc(motionstate->numInputSegs * sizeof(CdbTupleHeapInfo));
-			/* Create the priority queue structure. */
+			/* Create the merge tree structure. */
 			motionstate->tupleheap_cxt =
 				CdbMergeComparator_CreateContext(motionstate->tupleheap_entries,
 												 tupDesc,
@@ -1197,7 +1247,7 @@ ExecInitMotion(Motion *node, EState *estate, int eflags)
 												 node->collations,
 												 node->nullsFirst);
 			motionstate->tupleheap =
-				binaryheap_allocate(motionstate->numInputSegs,
+				losertree_allocate(motionstate->numInputSegs,
 									CdbMergeComparator,
 									motionstate->tupleheap_cxt);
 		}
@@ -1227,6 +1277,65 @@ ExecInitMotion(Motion *node, EState *estate, int eflags)
 	return motionstate;
 }
 
+/*
+ * Set up the runtime filter of the scan below a sending Motion, if the hash
+ * join that receives the tuples ships one.
+ *
+ * The whole plan is available in every slice, so we can find the hash join
+ * and make the same decision as its slice does in ExecInitHashJoin().
+ */
+static void
+setupRuntimeFilterSender(MotionState *node)
+{
+	Motion	   *motion = (Motion *) node->ps.plan;
+	EState	   *estate = node->ps.state;
+	PlannedStmt *stmt = estate->es_plannedstmt;
+	RuntimeFilterJoinContext context;
+	ListCell   *lc;
+
+	exec_init_plan_tree_base(&context.base, stmt);
+	context.motionID = motion->motionID;
+	context.result = NULL;
+
+	if (!findRuntimeFilterJoin_walker((Node *) stmt->planTree, &context))
+	{
+		foreach(lc, stmt->subplans)
+		{
+			if (findRuntimeFilterJoin_walker((Node *) lfirst(lc), &context))
+				break;
+		}
+	}
+
+	if (context.result && ExecHashJoinPushesRuntimeFilter(context.result))
+		ExecHashRuntimeFilterCreateSender(context.result, estate,
+										  (ScanState *) outerPlanState(node),
+										  motion->motionID);
+}
+
+/*
+ * Find the hash join whose outer input is the Motion context->motionID.
+ */
+static bool
+findRuntimeFilterJoin_walker(Node *node, RuntimeFilterJoinContext *context)
+{
+	if (node == NULL)
+		return false;
+
+	if (IsA(node, HashJoin))
+	{
+		Plan	   *outerNode = outerPlan(node);
+
+		if (outerNode && IsA(outerNode, Motion) &&
+			((Motion *) outerNode)->motionID == context->motionID)
+		{
+			context->result = (HashJoin *) node;
+			return true;
+		}
+	}
+
+	return plan_tree_walker(node, findRuntimeFilterJoin_walker, context);
+}
+
 /* ----------------------------------------------------------------
  *		ExecEndMotion(node)
  * ----------------------------------------------------------------
@@ -1306,10 +1415,10 @@ ExecEndMotion(MotionState *node)
 	}
 #endif							/* MEASURE_MOTION_TIME */
 
-	/* Merge Receive: Free the priority queue and associated structures. */
+	/* Merge Receive: Free the merge tree and associated structures. */
 	if (node->tupleheap != NULL)
 	{
-		binaryheap_free(node->tupleheap);
+		losertree_free(node->tupleheap);
 
 		CdbMergeComparator_DestroyContext(node->tupleheap_cxt);
 		node->tupleheap = NULL;
@@ -26,37 +26,24 @@
 
 #include "postgres.h"
 
-#ifdef HAVE_POLL_H
-#include <poll.h>
-#endif
-#ifdef HAVE_SYS_POLL_H
-#include <sys/poll.h>
-#endif
-
 #include "access/xact.h"
 #include "cdb/cdbvars.h"
 #include "commands/tablespace.h"
 #include "executor/executor.h"
 #include "executor/nodeShareInputScan.h"
 #include "miscadmin.h"
+#include "storage/dsm.h"
+#include "storage/ipc.h"
+#include "storage/latch.h"
+#include "storage/lwlock.h"
+#include "storage/proc.h"
+#include "storage/shmem.h"
 #include "utils/faultinjector.h"
 #include "utils/gp_alloc.h"
+#include "utils/hsearch.h"
 #include "utils/tuplesort.h"
 #include "utils/tuplestorenew.h"
 
-typedef struct ShareInput_Lk_Context
-{
-	int readyfd;
-	int donefd;
-	int  zcnt;
-	bool del_ready;
-	bool del_done;
-	char lkname_ready[MAXPGPATH];
-	char lkname_done[MAXPGPATH];
-} ShareInput_Lk_Context;
-
-static void writer_wait_for_acks(ShareInput_Lk_Context *pctxt, int share_id, int xslice);
-
 static void ExecEagerFreeShareInputScan(ShareInputScanState *node);
 
 /*
@@ -91,8 +78,20 @@ init_tuplestore_state(ShareInputScanState *node)
 
 	if(share_type == SHARE_MATERIAL_XSLICE)
 	{
+		char	   *pages;
+		int			npages;
+
+		/*
+		 * A reader in the writer's own slice finds the shared state through
+		 * the writer's context.
+		 */
+		void	   *ctxt = snState ? ((MaterialState *) snState)->share_lk_ctxt : node->share_lk_ctxt;
+
 		node->ts_state = palloc0(sizeof(GenericTupStore));
-		node->ts_state->matstore = ntuplestore_create_readerwriter(node->share_bufname_prefix, 0, false);
+		if (shareinput_reader_shmem_pages(ctxt, &pages, &npages))
+			node->ts_state->matstore = ntuplestore_create_reader_shmem(pages, npages, 0);
+		else
+			node->ts_state->matstore = ntuplestore_create_readerwriter(node->share_bufname_prefix, 0, false);
 		node->ts_pos = (void *) ntuplestore_create_accessor(node->ts_state->matstore, false);
 		ntuplestore_acc_seek_bof((NTupleStoreAccessor *)node->ts_pos);
 	}
@@ -295,11 +294,8 @@ ExecInitShareInputScan(ShareInputScan *node, EState *estate, int eflags)
 
 	/*
 	 * `PrepareTempTablespaces()` should be called when initializing ShareInputScanState.
-	 * The shareinput-reader will open/create the named pipe file in
-	 * ExecSliceDependencyShareInputScan() which is called at the begining of ExecutePlan().
-	 * The shareinput-writer will open/create the named pipe file when data is ready.
-	 * The READER and the WRITER share the pipe file for communication, so the pipe file
-	 * must be in the same tablespace.
+	 * The READER and the WRITER of a cross-slice share open the same tuplestore
+	 * file, so they must both choose the same temp tablespace for it.
 	 *
 	 * We can't call PrepareTempTablespaces() under ExecShareInputScan()/ExecProcNode()
 	 * like other callers, because it's too late for the READER.
@@ -387,60 +383,91 @@ ExecReScanShareInputScan(ShareInputScanState *node)
 }
 
 /*************************************************************************
- * XXX
- * we need some IPC mechanism for shareinput_read_wait/writer_notify.  Semaphore is
- * the first thing come to mind but it turns out postgres is very picky about
- * how to use semaphore and we do not want to mess up with it.
+ * Cross-slice synchronization.
  *
- * Here we used FIFO (named pipe).  mkfifo is Posix.1 and should be available on any
- * reasonable Unix like system.
+ * The writer (producer) of a cross-slice share materializes its input into a
+ * tuplestore, and the readers (consumers) in other slices of the same
+ * segment must not read it before it is complete.  The writer in turn must
+ * not release it before all the readers are done with it.
  *
- * When we open fifo, we open it with O_RDWR.  So the fifo has both reader and writer.
- * That also means, for write, it will not block, but reader will until writer writes
- * something.
+ * If the materialized input fits in gp_shareinput_shmem_max_size, and never
+ * spilled, the writer copies its pages to a dynamic shared memory segment and
+ * the readers read them from there.  Otherwise the tuplestore is written to
+ * a file that the readers open.  Shared sorts always use files.
  *
- * At first, I used postgres File to manage the FIFO.  It turns out this is not
- * correct because when postgres run out of file descriptors, it will try to close
- * some file descriptors using an LRU algorithm.  Later when the File is used again,
- * postgres will reopen it. The FIFO here is used for synchronization so it is simply
- * wrong.  Here we use the file descriptor directly, and use a XCallBack to cleanup
- * the resource at the end of transaction (commit or abort).
+ * The state of every cross-slice share that is in use lives in a small hash
+ * table in shared memory, keyed by session, command and share id.  Each
+ * process that takes part in the share attaches to the entry, and the last
+ * one to detach removes it.  Whenever the state changes, the processes of
+ * the session are woken up by setting their latches, so nobody needs to poll.
  *
- * XXX However, it is always better to have this kind of stuff abstracted out
- * by the system.
+ * The processes are detached from a XCallBack at the end of transaction
+ * (commit or abort), so an entry never outlives the query that created it.
  **************************************************************************/
 
-#include "fcntl.h"
-#include "unistd.h"
-#include "sys/types.h"
-#include "sys/stat.h"
-#include "storage/fd.h"
-#include "cdb/cdbselect.h"
+/*
+ * Upper bound on the number of shares that can be in use at the same time,
+ * per backend.  Every process of a share is attached to its entry, so this is
+ * generous.
+ */
+#define SHARE_INPUT_XSLICE_PER_BACKEND	4
 
-char *shareinput_create_bufname_prefix(int share_id)
+typedef struct ShareInputXSliceKey
 {
-	return psprintf("SIRW_%d_%d_%d", gp_session_id, gp_command_count, share_id);
-}
+	int32		session_id;
+	int32		command_count;
+	int32		share_id;
+} ShareInputXSliceKey;
 
-/* Here we use the absolute path name as the lock name.  See fd.c
- * for how the name is created (GP_TEMP_FILE_DIR and make_database_relative).
- */
-static void
-sisc_lockname(char *p, int size, int share_id, const char* name)
+typedef struct ShareInputXSliceState
 {
-	char		filename[MAXPGPATH];
-	char	   *path;
+	ShareInputXSliceKey key;	/* hash key, must be first */
 
-	snprintf(filename, sizeof(filename),
-			 "gpcdb2.sisc_%d_%d_%d_%d_%s",
-			 GpIdentity.segindex, gp_session_id, gp_command_count, share_id, name);
+	int			refcount;		/* number of attached processes */
+	bool		ready;			/* has the writer produced all the tuples? */
+	int			nacks;			/* readers that have seen 'ready' */
+	int			ndone;			/* readers that are done reading */
+	int			shm_npages;		/* tuplestore pages in shared memory, or -1 */
+	dsm_handle	shm_handle;		/* segment holding them, if shm_npages > 0 */
+} ShareInputXSliceState;
 
-	/* Ensure that temp tablespaces are set up to build temporary path. */
-	PrepareTempTablespaces();
-	path = GetTempFilePath(filename, true);
-	if (strlen(path) >= size)
-		elog(ERROR, "path to temporary file too long: %s", path);
-	strcpy(p, path);
+typedef struct ShareInput_Lk_Context
+{
+	int			share_id;
+	ShareInputXSliceState *state;	/* shared state, if attached */
+	dsm_segment *seg;			/* tuplestore pages, if mapped */
+} ShareInput_Lk_Context;
+
+static HTAB *shareinput_xslice_hash = NULL;
+
+Size
+ShareInputShmemSize(void)
+{
+	return hash_estimate_size(SHARE_INPUT_XSLICE_PER_BACKEND * MaxBackends,
+							  sizeof(ShareInputXSliceState));
+}
+
+void
+ShareInputShmemInit(void)
+{
+	HASHCTL		info;
+
+	MemSet(&info, 0, sizeof(info));
+	info.keysize = sizeof(ShareInputXSliceKey);
+	info.entrysize = sizeof(ShareInputXSliceState);
+	info.hash = tag_hash;
+
+	shareinput_xslice_hash =
+		ShmemInitHash("ShareInputScan cross-slice state",
+					  SHARE_INPUT_XSLICE_PER_BACKEND * MaxBackends,
+					  SHARE_INPUT_XSLICE_PER_BACKEND * MaxBackends,
+					  &info,
+					  HASH_ELEM | HASH_FUNCTION);
+}
+
+char *shareinput_create_bufname_prefix(int share_id)
+{
+	return psprintf("SIRW_%d_%d_%d", gp_session_id, gp_command_count, share_id);
 }
 
 void *shareinput_init_lk_ctxt(int share_id)
@@ -451,177 +478,191 @@ void *shareinput_init_lk_ctxt(int share_id)
 		ereport(ERROR, (errcode(ERRCODE_OUT_OF_MEMORY),
 			errmsg("Share input reader failed: out of memory")));
 
-	pctxt->readyfd = -1;
-	pctxt->donefd = -1;
-	pctxt->zcnt = 0;
-	pctxt->del_ready = false;
-	pctxt->del_done = false;
-
-	sisc_lockname(pctxt->lkname_ready, MAXPGPATH, share_id, "ready");
-	sisc_lockname(pctxt->lkname_done, MAXPGPATH, share_id, "done");
+	pctxt->share_id = share_id;
+	pctxt->state = NULL;
+	pctxt->seg = NULL;
 
 	return pctxt;
 }
 
+static void XCallBack_ShareInput_XSlice(XactEvent ev, void* vp);
+
+/*
+ * Attach to the shared state of the share, creating it if we are the first.
+ */
+static void
+shareinput_attach(ShareInput_Lk_Context *pctxt)
+{
+	ShareInputXSliceKey key;
+	ShareInputXSliceState *state;
+	bool		found;
+
+	Assert(pctxt->state == NULL);
+
+	MemSet(&key, 0, sizeof(key));
+	key.session_id = gp_session_id;
+	key.command_count = gp_command_count;
+	key.share_id = pctxt->share_id;
+
+	LWLockAcquire(ShareInputScanLock, LW_EXCLUSIVE);
+
+	state = (ShareInputXSliceState *)
+		hash_search(shareinput_xslice_hash, &key, HASH_ENTER_NULL, &found);
+	if (!state)
+	{
+		LWLockRelease(ShareInputScanLock);
+		ereport(ERROR,
+				(errcode(ERRCODE_OUT_OF_MEMORY),
+				 errmsg("out of shared memory for cross-slice share input")));
+	}
+	if (!found)
+	{
+		state->refcount = 0;
+		state->ready = false;
+		state->nacks = 0;
+		state->ndone = 0;
+		state->shm_npages = -1;
+		state->shm_handle = 0;
+	}
+	state->refcount++;
+
+	LWLockRelease(ShareInputScanLock);
+
+	pctxt->state = state;
+	RegisterXactCallbackOnce(XCallBack_ShareInput_XSlice, pctxt);
+}
+
 static void shareinput_clean_lk_ctxt(ShareInput_Lk_Context *lk_ctxt)
 {
 	elog(DEBUG1, "shareinput_clean_lk_ctxt cleanup lk ctxt %p", lk_ctxt);
 	if (!lk_ctxt)
 		return;
 
-	if (lk_ctxt->readyfd >= 0)
+	if (lk_ctxt->seg)
 	{
-		if (gp_retry_close(lk_ctxt->readyfd))
-			ereport(WARNING,
-				(errcode(ERRCODE_IO_ERROR),
-				errmsg("shareinput_clean_lk_ctxt cannot close readyfd: %m")));
+		dsm_detach(lk_ctxt->seg);
+		lk_ctxt->seg = NULL;
 	}
 
-	if (lk_ctxt->donefd >= 0)
+	if (lk_ctxt->state)
 	{
-		if (gp_retry_close(lk_ctxt->donefd))
-			ereport(WARNING,
-				(errcode(ERRCODE_IO_ERROR),
-				errmsg("shareinput_clean_lk_ctxt cannot close donefd: %m")));
-	}
+		ShareInputXSliceState *state = lk_ctxt->state;
 
-	if (lk_ctxt->del_ready && lk_ctxt->lkname_ready[0])
-	{
-		if (unlink(lk_ctxt->lkname_ready))
-			ereport(WARNING,
-				(errcode(ERRCODE_IO_ERROR),
-				errmsg("shareinput_clean_lk_ctxt cannot unlink \"%s\": %m",
-					lk_ctxt->lkname_ready)));
-	}
+		LWLockAcquire(ShareInputScanLock, LW_EXCLUSIVE);
 
-	if (lk_ctxt->del_done && lk_ctxt->lkname_done[0])
-	{
-		if (unlink(lk_ctxt->lkname_done))
-			ereport(WARNING,
-				(errcode(ERRCODE_IO_ERROR),
-				errmsg("shareinput_clean_lk_ctxt cannot unlink \"%s\": %m",
-					lk_ctxt->lkname_done)));
+		Assert(state->refcount > 0);
+		if (--state->refcount == 0)
+			hash_search(shareinput_xslice_hash, &state->key, HASH_REMOVE, NULL);
+
+		LWLockRelease(ShareInputScanLock);
+
+		lk_ctxt->state = NULL;
 	}
 
 	gp_free(lk_ctxt);
 }
 
-static void XCallBack_ShareInput_FIFO(XactEvent ev, void* vp)
+static void XCallBack_ShareInput_XSlice(XactEvent ev, void* vp)
 {
 	ShareInput_Lk_Context *lk_ctxt = (ShareInput_Lk_Context *) vp;
 	shareinput_clean_lk_ctxt(lk_ctxt);
 }
 
+/*
+ * Wake up the other processes of our session, after changing the state of a
+ * share.  The waiters recheck the state, so waking up a process that isn't
+ * waiting for this share is harmless.
+ */
 static void
-create_tmp_fifo(const char *fifoname)
+shareinput_wakeup_session(void)
 {
-#ifdef WIN32
-	elog(ERROR, "mkfifo not supported on win32");
-#else
-	int err = mkfifo(fifoname, 0600);
-	if (err < 0 && errno != EEXIST)
-		elog(ERROR, "could not create temporary fifo \"%s\": %m", fifoname);
-#endif
+	int			i;
+
+	for (i = 0; i < ProcGlobal->allProcCount; i++)
+	{
+		PGPROC	   *proc = &ProcGlobal->allProcs[i];
+
+		if (proc != MyProc && proc->mppSessionId == gp_session_id)
+			SetLatch(&proc->procLatch);
+	}
 }
 
+/* Which state change does shareinput_wait() wait for? */
+typedef enum
+{
+	SHAREINPUT_WAIT_READY,
+	SHAREINPUT_WAIT_ACKS,
+	SHAREINPUT_WAIT_DONE
+} ShareInputWaitFor;
+
 /*
- * As all other read/write in postgres, we may be interrupted so retry is needed.
+ * Sleep on our latch until the share reaches the given state.
+ *
+ * This is a blocking operation, but it can be cancelled.
  */
-static int retry_read(int fd, char *buf, int rsize)
+static void
+shareinput_wait(ShareInput_Lk_Context *pctxt, ShareInputWaitFor waitFor, int n)
 {
-	int sz;
-	Assert(rsize > 0);
-
-read_retry:
-	sz = read(fd, buf, rsize);
-	if (sz > 0)
-		return sz;
-	else if(sz == 0 || errno == EINTR)
-		goto read_retry;
-	else
-		elog(ERROR, "could not read from fifo: %m");
+	ShareInputXSliceState *state = pctxt->state;
 
-	Assert(!"Never be here");
-	return 0;
-}
+	Assert(state != NULL);
 
-static int retry_write(int fd, char *buf, int wsize)
-{
-	int sz;
-	Assert(wsize > 0);
-
-write_retry:
-	sz = write(fd, buf, wsize);
-	if(sz > 0)
-		return sz;
-	else if(sz == 0 || errno == EINTR)
-		goto write_retry;
-	else
-		elog(ERROR, "could not write to fifo: %m");
+	while(1)
+	{
+		bool		reached;
+		int			rc;
 
-	Assert(!"Never be here");
-	return 0;
-}
+		CHECK_FOR_INTERRUPTS();
 
-#ifdef FAULT_INJECTOR
-/**
- * create and open many tmp files, so the next fd number is bigger.
- **/
-static void fi_create_many_fds(int *fds, char *file_prefix, int num)
-{
-	for (int i = 0; i < num; i++)
-	{
-		char filepath[1024];
-		snprintf(filepath, sizeof(filepath), "%s/si_%d", file_prefix, i);
-		fds[i] = open(filepath, O_RDWR | O_CREAT, 0666);
-	}
-	if (fds[num-1] > 0)
-		Assert(fds[num-1] > num);
-}
+		ResetLatch(&MyProc->procLatch);
 
-/**
- * close opened fds and delete the tmp files
- **/
-static void fi_close_created_fds(int *fds, char *file_prefix, int num)
-{
-	for (int i = 0; i < num; i++)
-	{
-		char filepath[1024];
-		snprintf(filepath, sizeof(filepath), "%s/si_%d", file_prefix, i);
-		if (fds[i] > 0) {
-			close(fds[i]);
-			unlink(filepath);
+		LWLockAcquire(ShareInputScanLock, LW_SHARED);
+		switch (waitFor)
+		{
+			case SHAREINPUT_WAIT_READY:
+				reached = state->ready;
+				break;
+			case SHAREINPUT_WAIT_ACKS:
+				reached = state->nacks >= n;
+				break;
+			case SHAREINPUT_WAIT_DONE:
+				reached = state->ndone >= n;
+				break;
+			default:
+				reached = true;
+				Assert(false);
 		}
+		LWLockRelease(ShareInputScanLock);
+
+		if (reached)
+			break;
+
+		rc = WaitLatch(&MyProc->procLatch,
+					   WL_LATCH_SET | WL_TIMEOUT | WL_POSTMASTER_DEATH,
+					   1000);
+		if (rc & WL_POSTMASTER_DEATH)
+			proc_exit(1);
+		if (rc & WL_TIMEOUT)
+			elog(DEBUG1, "SISC (shareid=%d, slice=%d): wait time out once",
+				 pctxt->share_id, currentSliceId);
 	}
 }
-#endif
 
 /*
- * Readiness (a) synchronization.
- *
- * For readiness, the shared node will write xslice of 'a' into the pipe.
- * For each share, there is just one ready writer.  Once sharer starts write
- * it need to write all xslice copies of 'a', even if we are interrupted, that
- * is, we should not call CHECK_FOR_INTERRUPTS.
+ * Readiness synchronization.
  *
- * For sharer, it need to check for ready to read (using select), because read
- * is blocking.  Otherwise if shared is cancelled before write, then we will be
- * blocked here forever.  Once shared has write at least one 'a', it will write
- * all xslice of 'a', so once select succeed, read will eventually succeed.  Once
- * sharer got 'a', it write 'b' back to shared.
+ * The writer marks the share ready once all the tuples are in the tuplestore,
+ * and every reader waits for that before it starts reading.
  *
- * Done (b and z) synchronization.
- * For done, the shared is the only reader.  sharer will not block for writing,
- * but shared may block for read, therefore, we much call select before shared
- * calling read.  Because there is only one shared, nobody can steal char from
- * the pipe, therefore, if select succeed, read will not block forever.
+ * For planner-generated plans, every reader acknowledges the readiness, and
+ * the writer waits for all the acknowledgements before it proceeds.  For
+ * optimizer-generated plans we skip that, as it can cause deadlocks
+ * (OPT-2690).
  *
- * One thing to note is that some 'z' may comeback before all 'b' come back.
- * So, need to handle this in notifyready.
+ * Done synchronization.
  *
- * For optimizer-generated plans, we skip the 'b' synchronization. The writer
- * does not wait for readers to acknowledge the "ready" handshake anymore, as
- * that can cause deadlocks (OPT-2690).
+ * Every reader counts itself as done once it has read all it needs, and the
+ * writer waits for all the readers before it releases the tuplestore.
  */
 
 /*
@@ -635,97 +676,114 @@ static void fi_close_created_fds(int *fds, char *file_prefix, int num)
 void
 shareinput_reader_waitready(void *ctxt, int share_id, PlanGenerator planGen)
 {
-	struct pollfd fds[1];
-	int nfds = 0;
-	char a;
 	ShareInput_Lk_Context *pctxt = (ShareInput_Lk_Context *) ctxt;
-	RegisterXactCallbackOnce(XCallBack_ShareInput_FIFO, pctxt);
 
-#ifdef FAULT_INJECTOR
-	/**
-	 * In preivous code, use MPP_FD_SET(call select() internally) to operate FIFO,
-	 * so the FIFO's fd number cannot exceed 65536.
-	 *
-	 * After using poll() instead of select(), it can overcome this limit.
-	 * Using FAULT_INJECTOR here to test whether it works normally in this
-	 * scenario (already opened many fds).
-	 **/
-	// we should use 70000(>65536) to test here, but the test env (docker)'s open files
-	// is not very big, so only using a smaller value instead.
-	// const int num = 70000;
-	const int num = 40000;
-	int tmp_fds[num];
-	memset(tmp_fds, 0, sizeof(tmp_fds));
-	char tmpfile_prefix[] = "/tmp/_gpdb_fault_inject_tmp_dir/"; // need create the dir first
-	if (SIMPLE_FAULT_INJECTOR("inject_many_fds_for_shareinputscan") == FaultInjectorTypeSkip)
-		fi_create_many_fds(tmp_fds, tmpfile_prefix, num);
-#endif
-
-	create_tmp_fifo(pctxt->lkname_ready);
-	pctxt->readyfd = open(pctxt->lkname_ready, O_RDWR, 0600);
-	if(pctxt->readyfd < 0)
-		elog(ERROR, "could not open fifo \"%s\": %m", pctxt->lkname_ready);
-
-	create_tmp_fifo(pctxt->lkname_done);
-	pctxt->donefd = open(pctxt->lkname_done, O_RDWR, 0600);
-	if(pctxt->donefd < 0)
-		elog(ERROR, "could not open fifo \"%s\": %m", pctxt->lkname_done);
-
-#ifdef FAULT_INJECTOR
-	/* close opened fds */
-	fi_close_created_fds(tmp_fds, tmpfile_prefix, num);
-#endif
-
-	fds[0].fd = pctxt->readyfd;
-	fds[0].events = POLLIN;
-	nfds++;
-	while(1)
+	shareinput_attach(pctxt);
+
+	shareinput_wait(pctxt, SHAREINPUT_WAIT_READY, 0);
+
+	elog(DEBUG1, "SISC READER (shareid=%d, slice=%d): Wait ready got writer's handshake",
+			share_id, currentSliceId);
+
+	if (planGen == PLANGEN_PLANNER)
 	{
-		CHECK_FOR_INTERRUPTS();
+		/* For planner-generated plans, we send ack back after receiving the handshake */
+		elog(DEBUG1, "SISC READER (shareid=%d, slice=%d): Wait ready writing ack back to writer",
+				share_id, currentSliceId);
 
-		int nready = 0;
-		int poll_timeout = 1000; // unit: ms
+		LWLockAcquire(ShareInputScanLock, LW_EXCLUSIVE);
+		pctxt->state->nacks++;
+		LWLockRelease(ShareInputScanLock);
 
-		nready = poll(fds, nfds, poll_timeout);
+		shareinput_wakeup_session();
+	}
+}
 
-		if (nready == 1)
-		{
-#if USE_ASSERT_CHECKING
-			int rwsize =
-#endif
-			retry_read(pctxt->readyfd, &a, 1);
-			Assert(rwsize == 1 && a == 'a');
+/*
+ * shareinput_writer_publish
+ *
+ *  Called by the writer (producer) once all the tuples are in its tuplestore,
+ *  before shareinput_writer_notifyready(), to make them readable by the
+ *  readers: in shared memory if they fit, else in the tuplestore file.
+ */
+void
+shareinput_writer_publish(void *ctxt, NTupleStore *ts)
+{
+	ShareInput_Lk_Context *pctxt = (ShareInput_Lk_Context *) ctxt;
+	int			npages = ntuplestore_count_pages(ts);
+	dsm_handle	handle = 0;
 
-			elog(DEBUG1, "SISC READER (shareid=%d, slice=%d): Wait ready got writer's handshake",
-					share_id, currentSliceId);
+	if (npages < 0 ||
+		dynamic_shared_memory_type == DSM_IMPL_NONE ||
+		(int64) npages * (BLCKSZ / 1024) > gp_shareinput_shmem_max_size)
+	{
+		ntuplestore_flush(ts);
+		return;
+	}
 
-			if (planGen == PLANGEN_PLANNER)
-			{
-				/* For planner-generated plans, we send ack back after receiving the handshake */
-				elog(DEBUG1, "SISC READER (shareid=%d, slice=%d): Wait ready writing ack back to writer",
-						share_id, currentSliceId);
-
-#if USE_ASSERT_CHECKING
-				rwsize =
-#endif
-				retry_write(pctxt->donefd, "b", 1);
-				Assert(rwsize == 1);
-			}
+	if (pctxt->state == NULL)
+		shareinput_attach(pctxt);
 
-			break;
-		}
-		else if (nready == 0)
-		{
-			elog(DEBUG1, "SISC READER (shareid=%d, slice=%d): Wait ready time out once",
-					share_id, currentSliceId);
-		}
-		else
+	if (npages > 0)
+	{
+		pctxt->seg = dsm_create((Size) npages * BLCKSZ);
+		/* Keep the mapping until the end of the share, not of the resowner */
+		dsm_pin_mapping(pctxt->seg);
+		ntuplestore_copy_pages(ts, dsm_segment_address(pctxt->seg));
+		handle = dsm_segment_handle(pctxt->seg);
+	}
+
+	LWLockAcquire(ShareInputScanLock, LW_EXCLUSIVE);
+	pctxt->state->shm_npages = npages;
+	pctxt->state->shm_handle = handle;
+	LWLockRelease(ShareInputScanLock);
+
+	elog(DEBUG1, "SISC WRITER (shareid=%d, slice=%d): published %d pages in shared memory",
+		 pctxt->share_id, currentSliceId, npages);
+}
+
+/*
+ * shareinput_reader_shmem_pages
+ *
+ *  Called by a reader, after the share is ready, to find the tuplestore pages
+ *  that the writer published in shared memory.  Returns false if the readers
+ *  must read the tuplestore file instead.
+ */
+bool
+shareinput_reader_shmem_pages(void *ctxt, char **pages, int *npages)
+{
+	ShareInput_Lk_Context *pctxt = (ShareInput_Lk_Context *) ctxt;
+	dsm_handle	handle;
+
+	if (pctxt == NULL || pctxt->state == NULL)
+		return false;
+
+	LWLockAcquire(ShareInputScanLock, LW_SHARED);
+	*npages = pctxt->state->shm_npages;
+	handle = pctxt->state->shm_handle;
+	LWLockRelease(ShareInputScanLock);
+
+	if (*npages < 0)
+		return false;
+
+	*pages = NULL;
+	if (*npages > 0)
+	{
+		/* The writer's slice already has the segment mapped */
+		if (pctxt->seg == NULL)
 		{
-			int save_errno = errno;
-			elog(LOG, "SISC READER (shareid=%d, slice=%d): Wait ready try again, errno %d ... ",
-					share_id, currentSliceId, save_errno);
+			pctxt->seg = dsm_attach(handle);
+			if (pctxt->seg == NULL)
+				ereport(ERROR,
+						(errcode(ERRCODE_INTERNAL_ERROR),
+						 errmsg("could not map the shared memory of cross-slice share input %d",
+								pctxt->share_id)));
+			dsm_pin_mapping(pctxt->seg);
 		}
+		*pages = dsm_segment_address(pctxt->seg);
 	}
+
+	return true;
 }
 
 /*
@@ -744,99 +802,27 @@ shareinput_reader_waitready(void *ctxt, int share_id, PlanGenerator planGen)
 void
 shareinput_writer_notifyready(void *ctxt, int share_id, int xslice, PlanGenerator planGen)
 {
-	int n;
 	ShareInput_Lk_Context *pctxt = (ShareInput_Lk_Context *) ctxt;
-	RegisterXactCallbackOnce(XCallBack_ShareInput_FIFO, pctxt);
 
-	create_tmp_fifo(pctxt->lkname_ready);
-	pctxt->del_ready = true;
-	pctxt->readyfd = open(pctxt->lkname_ready, O_RDWR, 0600);
-	if(pctxt->readyfd < 0)
-		elog(ERROR, "could not open fifo \"%s\": %m", pctxt->lkname_ready);
+	if (pctxt->state == NULL)
+		shareinput_attach(pctxt);
 
-	create_tmp_fifo(pctxt->lkname_done);
-	pctxt->del_done = true;
-	pctxt->donefd = open(pctxt->lkname_done, O_RDWR, 0600);
-	if(pctxt->donefd < 0)
-		elog(ERROR, "could not open fifo \"%s\": %m", pctxt->lkname_done);
+	LWLockAcquire(ShareInputScanLock, LW_EXCLUSIVE);
+	pctxt->state->ready = true;
+	LWLockRelease(ShareInputScanLock);
+
+	shareinput_wakeup_session();
 
-	for(n=0; n<xslice; ++n)
-	{
-#if USE_ASSERT_CHECKING
-		int rwsize =
-#endif
-		retry_write(pctxt->readyfd, "a", 1);
-		Assert(rwsize == 1);
-	}
 	elog(DEBUG1, "SISC WRITER (shareid=%d, slice=%d): wrote notify_ready to %d xslice readers",
 						share_id, currentSliceId, xslice);
 
 	if (planGen == PLANGEN_PLANNER)
 	{
 		/* For planner-generated plans, we wait for acks from all the readers */
-		writer_wait_for_acks(pctxt, share_id, xslice);
-	}
-}
-
-/*
- * writer_wait_for_acks
- *
- * After sending the handshake to all the reader, the writer waits for acks
- * from all the readers.
- *
- * This is a blocking operation.
- */
-static void
-writer_wait_for_acks(ShareInput_Lk_Context *pctxt, int share_id, int xslice)
-{
-	int ack_needed = xslice;
-	struct pollfd fds[1];
-	int nfds = 0;
-	char b;
-
-	fds[0].fd = pctxt->donefd;
-	fds[0].events = POLLIN;
-	nfds++;
-	while(ack_needed > 0)
-	{
-		CHECK_FOR_INTERRUPTS();
+		shareinput_wait(pctxt, SHAREINPUT_WAIT_ACKS, xslice);
 
-		int nready = 0;
-		int poll_timeout = 1000; // unit: ms
-
-		nready = poll(fds, nfds, poll_timeout);
-
-		if (nready == 1)
-		{
-#if USE_ASSERT_CHECKING
-			int rwsize =
-#endif
-			retry_read(pctxt->donefd, &b, 1);
-			Assert(rwsize == 1);
-
-			if(b == 'z')
-			{
-				++pctxt->zcnt;
-			}
-			else
-			{
-				Assert(b == 'b');
-				--ack_needed;
-				elog(DEBUG1, "SISC WRITER (shareid=%d, slice=%d): notify ready succeed 1, xslice remaining %d",
-						share_id, currentSliceId, ack_needed);
-			}
-		}
-		else if (nready == 0)
-		{
-			elog(DEBUG1, "SISC WRITER (shareid=%d, slice=%d): Notify ready time out once ... ",
-					share_id, currentSliceId);
-		}
-		else
-		{
-			int save_errno = errno;
-			elog(LOG, "SISC WRITER (shareid=%d, slice=%d): notify still wait for an answer, errno %d",
-					share_id, currentSliceId, save_errno);
-		}
+		elog(DEBUG1, "SISC WRITER (shareid=%d, slice=%d): notify ready acknowledged by %d xslice readers",
+				share_id, currentSliceId, xslice);
 	}
 }
 
@@ -853,17 +839,17 @@ shareinput_reader_notifydone(void *ctxt, int share_id)
 {
 	ShareInput_Lk_Context *pctxt = (ShareInput_Lk_Context *) ctxt;
 
-	if (pctxt->donefd < 0)
+	if (pctxt->state == NULL)
 		return;
 
-#if USE_ASSERT_CHECKING
-	int rwsize  =
-#endif
-	retry_write(pctxt->donefd, "z", 1);
-	Assert(rwsize == 1);
+	LWLockAcquire(ShareInputScanLock, LW_EXCLUSIVE);
+	pctxt->state->ndone++;
+	LWLockRelease(ShareInputScanLock);
+
+	shareinput_wakeup_session();
 
 	shareinput_clean_lk_ctxt(pctxt);
-	UnregisterXactCallbackOnce(XCallBack_ShareInput_FIFO, (void *) ctxt);
+	UnregisterXactCallbackOnce(XCallBack_ShareInput_XSlice, (void *) ctxt);
 }
 
 /*
@@ -878,60 +864,20 @@ void
 shareinput_writer_waitdone(void *ctxt, int share_id, int nsharer_xslice)
 {
 	ShareInput_Lk_Context *pctxt = (ShareInput_Lk_Context *) ctxt;
-	struct pollfd fds[1];
-	int nfds = 0;
 
-	if (pctxt->donefd < 0)
+	if (pctxt->state == NULL)
 		return;
 
-	char z;
-	int ack_needed = nsharer_xslice - pctxt->zcnt;
-
 	elog(DEBUG1, "SISC WRITER (shareid=%d, slice=%d): waiting for DONE message from %d readers",
-							share_id, currentSliceId, ack_needed);
-
-	fds[0].fd = pctxt->donefd;
-	fds[0].events = POLLIN;
-	nfds++;
-	while(ack_needed > 0)
-	{
-		CHECK_FOR_INTERRUPTS();
+							share_id, currentSliceId, nsharer_xslice);
 
-		int nready = 0;
-		int poll_timeout = 1000; // unit: ms
-
-		nready = poll(fds, nfds, poll_timeout);
-
-		if (nready == 1)
-		{
-#if USE_ASSERT_CHECKING
-			int rwsize =
-#endif
-			retry_read(pctxt->donefd, &z, 1);
-			Assert(rwsize == 1 && z == 'z');
-
-			elog(DEBUG1, "SISC WRITER (shareid=%d, slice=%d): wait done get 1 notification",
-					share_id, currentSliceId);
-			--ack_needed;
-		}
-		else if (nready == 0)
-		{
-			elog(DEBUG1, "SISC WRITER (shareid=%d, slice=%d): wait done timeout once",
-					share_id, currentSliceId);
-		}
-		else
-		{
-			int save_errno = errno;
-			elog(LOG, "SISC WRITER (shareid=%d, slice=%d): wait done time out once, errno %d",
-					share_id, currentSliceId, save_errno);
-		}
-	}
+	shareinput_wait(pctxt, SHAREINPUT_WAIT_DONE, nsharer_xslice);
 
 	elog(DEBUG1, "SISC WRITER (shareid=%d, slice=%d): Writer received all %d reader done notifications",
-			share_id, currentSliceId, nsharer_xslice - pctxt->zcnt);
+			share_id, currentSliceId, nsharer_xslice);
 
 	shareinput_clean_lk_ctxt(ctxt);
-	UnregisterXactCallbackOnce(XCallBack_ShareInput_FIFO, (void *) ctxt);
+	UnregisterXactCallbackOnce(XCallBack_ShareInput_XSlice, (void *) ctxt);
 }
 
 /*
@@ -2491,12 +2491,13 @@ gpdb::CountLeafPartTables(Oid rel_oid)
  * Cache, we use the normal PostgreSQL catalog cache invalidation mechanism.
  * We register a callback to a cache on all the catalog tables that contain
  * information that's contained in the ORCA metadata cache.
-
- * There is no fine-grained mechanism in the metadata cache for invalidating
- * individual entries ATM, so we just blow the whole cache whenever anything
- * changes. The callback simply increments a counter. Whenever we start
- * planning a query, we check the counter to see if it has changed since the
- * last planned query, and reset the whole cache if it has.
+ *
+ * The callbacks remember what was invalidated: the OID of a relation, or the
+ * hash value of a catalog cache entry.  Whenever we start planning a query,
+ * only the objects of the metadata cache that match one of those are
+ * evicted, see COptTasks::OptimizeTask().  Catalog caches whose keys can't
+ * be matched to cached objects, a full catalog cache reset, or more
+ * invalidations than we care to remember, still reset the whole cache.
  *
  * To make sure we've covered all catalog tables that contain information
  * that's stored in the metadata cache, there are "catalog tables: xxx"
@@ -2505,21 +2506,105 @@ gpdb::CountLeafPartTables(Oid rel_oid)
  * anything fetched via the wrapper functions in this file can end up in the
  * metadata cache and hence need to have an invalidation callback registered.
  */
-static bool mdcache_invalidation_counter_registered = false;
-static int64 mdcache_invalidation_counter = 0;
-static int64 last_mdcache_invalidation_counter = 0;
+#define MDCACHE_MAX_INVALIDATIONS 256
+
+typedef struct MDCacheSyscacheInval
+{
+	int			cacheid;
+	uint32		hashvalue;
+} MDCacheSyscacheInval;
+
+static bool mdcache_invalidation_registered = false;
+static bool mdcache_reset_pending = false;
+static int	mdcache_num_relcache_invals = 0;
+static Oid	mdcache_relcache_invals[MDCACHE_MAX_INVALIDATIONS];
+static int	mdcache_num_syscache_invals = 0;
+static MDCacheSyscacheInval mdcache_syscache_invals[MDCACHE_MAX_INVALIDATIONS];
 
 static void
-mdsyscache_invalidation_counter_callback(Datum arg, int cacheid,
-										 uint32 hashvalue)
+mdsyscache_invalidation_callback(Datum arg, int cacheid, uint32 hashvalue)
+{
+	switch (cacheid)
+	{
+		/* caches keyed by the OID of the object, or by (relid, attnum, inh) */
+		case AGGFNOID:
+		case CONSTROID:
+		case OPEROID:
+		case PROCOID:
+		case STATRELATTINH:
+		case TYPEOID:
+			/* hash value 0 means the whole catalog cache was reset */
+			if (hashvalue != 0 &&
+				mdcache_num_syscache_invals < MDCACHE_MAX_INVALIDATIONS)
+			{
+				MDCacheSyscacheInval *inval =
+					&mdcache_syscache_invals[mdcache_num_syscache_invals++];
+
+				inval->cacheid = cacheid;
+				inval->hashvalue = hashvalue;
+				break;
+			}
+			mdcache_reset_pending = true;
+			break;
+
+		default:
+			mdcache_reset_pending = true;
+			break;
+	}
+}
+
+static void
+mdrelcache_invalidation_callback(Datum arg, Oid relid)
 {
-	mdcache_invalidation_counter++;
+	/* InvalidOid means all relations */
+	if (OidIsValid(relid) &&
+		mdcache_num_relcache_invals < MDCACHE_MAX_INVALIDATIONS)
+		mdcache_relcache_invals[mdcache_num_relcache_invals++] = relid;
+	else
+		mdcache_reset_pending = true;
 }
 
+/*
+ * The statistics and the indexes of a partitioned table are gathered from
+ * its leaf partitions, but changes to a partition only invalidate the
+ * partition itself.  Treat them as changes to the root of the partitioned
+ * table as well.
+ *
+ * A partition that was dropped or detached has no pg_partition_rule entry
+ * anymore, but then the pg_partition_rule invalidation resets the whole
+ * cache anyway.
+ */
 static void
-mdrelcache_invalidation_counter_callback(Datum arg, Oid relid)
+mdcache_add_partition_roots(void)
 {
-	mdcache_invalidation_counter++;
+	int			nrelids = mdcache_num_relcache_invals;
+	int			i;
+
+	for (i = 0; i < nrelids && !mdcache_reset_pending; i++)
+	{
+		Oid			root_oid;
+		int			j;
+
+		/* catalog tables: pg_partition, pg_partition_rule */
+		if (!rel_is_child_partition(mdcache_relcache_invals[i]))
+			continue;
+		root_oid = rel_partition_get_master(mdcache_relcache_invals[i]);
+		if (!OidIsValid(root_oid))
+			continue;
+
+		for (j = 0; j < mdcache_num_relcache_invals; j++)
+		{
+			if (mdcache_relcache_invals[j] == root_oid)
+				break;
+		}
+		if (j < mdcache_num_relcache_invals)
+			continue;
+
+		if (mdcache_num_relcache_invals < MDCACHE_MAX_INVALIDATIONS)
+			mdcache_relcache_invals[mdcache_num_relcache_invals++] = root_oid;
+		else
+			mdcache_reset_pending = true;
+	}
 }
 
 static void
@@ -2581,39 +2666,250 @@ register_mdcache_invalidation_callbacks(void)
 	for (i = 0; i < lengthof(metadata_caches); i++)
 	{
 		CacheRegisterSyscacheCallback(metadata_caches[i],
-									  &mdsyscache_invalidation_counter_callback,
+									  &mdsyscache_invalidation_callback,
 									  (Datum) 0);
 	}
 
 	/* also register the relcache callback */
-	CacheRegisterRelcacheCallback(&mdrelcache_invalidation_counter_callback,
+	CacheRegisterRelcacheCallback(&mdrelcache_invalidation_callback,
 								  (Datum) 0);
 }
 
-// Has there been any catalog changes since last call?
+// Does the whole metadata cache need to be reset?
+//
+// Forgets the pending invalidations if it returns true.  Otherwise, adds the
+// roots of the invalidated partitions to them.
 bool
 gpdb::MDCacheNeedsReset(void)
 {
 	GP_WRAP_START;
 	{
-		if (!mdcache_invalidation_counter_registered)
+		if (!mdcache_invalidation_registered)
 		{
 			register_mdcache_invalidation_callbacks();
-			mdcache_invalidation_counter_registered = true;
+			mdcache_invalidation_registered = true;
 		}
-		if (last_mdcache_invalidation_counter == mdcache_invalidation_counter)
+		mdcache_add_partition_roots();
+		if (!mdcache_reset_pending)
 			return false;
 		else
 		{
-			last_mdcache_invalidation_counter = mdcache_invalidation_counter;
+			MDCacheClearInvalidations();
+			return true;
+		}
+	}
+	GP_WRAP_END;
+
+	return true;
+}
+
+// Have there been any catalog changes since the invalidations were last
+// cleared?
+bool
+gpdb::MDCacheHasInvalidations(void)
+{
+	return mdcache_reset_pending || mdcache_num_relcache_invals > 0 ||
+		   mdcache_num_syscache_invals > 0;
+}
+
+// Forget the pending invalidations, once they have been applied
+void
+gpdb::MDCacheClearInvalidations(void)
+{
+	mdcache_reset_pending = false;
+	mdcache_num_relcache_invals = 0;
+	mdcache_num_syscache_invals = 0;
+}
+
+// Has the object with the given OID been invalidated?  The OID can be that of
+// a relation, index, type, operator, function, aggregate or constraint.
+bool
+gpdb::MDCacheOidInvalidated(Oid oid)
+{
+	GP_WRAP_START;
+	{
+		int i;
+
+		for (i = 0; i < mdcache_num_relcache_invals; i++)
+		{
+			if (mdcache_relcache_invals[i] == oid)
+				return true;
+		}
+
+		for (i = 0; i < mdcache_num_syscache_invals; i++)
+		{
+			MDCacheSyscacheInval *inval = &mdcache_syscache_invals[i];
+
+			if (inval->cacheid != STATRELATTINH &&
+				inval->hashvalue ==
+					GetSysCacheHashValue1(inval->cacheid, ObjectIdGetDatum(oid)))
+				return true;
+		}
+		return false;
+	}
+	GP_WRAP_END;
+
+	return true;
+}
+
+/*
+ * ORCA identifies the column of a column statistics object by its position
+ * in the columns of the relation's metadata object.  Those are all the
+ * attributes of the relation, dropped ones included, followed by the system
+ * columns.  Map the position to the attribute number, or InvalidAttrNumber
+ * for a system column or a column that doesn't exist anymore.
+ */
+static AttrNumber
+colstats_position_to_attno(Oid rel_oid, int pos)
+{
+	Relation	rel;
+	AttrNumber	attno = InvalidAttrNumber;
+
+	/* catalog tables: relcache */
+	rel = RelationIdGetRelation(rel_oid);
+	if (!RelationIsValid(rel))
+		return InvalidAttrNumber;
+
+	if (pos >= 0 && pos < rel->rd_att->natts)
+		attno = rel->rd_att->attrs[pos]->attnum;
+	RelationClose(rel);
+
+	return attno;
+}
+
+// Have the statistics of the column at the given position been invalidated?
+bool
+gpdb::MDCacheColStatsInvalidated(Oid rel_oid, int pos)
+{
+	GP_WRAP_START;
+	{
+		AttrNumber attno;
+		int i;
+
+		if (0 == mdcache_num_syscache_invals)
+			return false;
+
+		attno = colstats_position_to_attno(rel_oid, pos);
+		if (attno == InvalidAttrNumber)
 			return true;
+
+		for (i = 0; i < mdcache_num_syscache_invals; i++)
+		{
+			MDCacheSyscacheInval *inval = &mdcache_syscache_invals[i];
+
+			if (inval->cacheid != STATRELATTINH)
+				continue;
+
+			/* catalog tables: pg_statistic */
+			if (inval->hashvalue ==
+					GetSysCacheHashValue3(STATRELATTINH,
+										  ObjectIdGetDatum(rel_oid),
+										  Int16GetDatum(attno),
+										  BoolGetDatum(false)) ||
+				inval->hashvalue ==
+					GetSysCacheHashValue3(STATRELATTINH,
+										  ObjectIdGetDatum(rel_oid),
+										  Int16GetDatum(attno),
+										  BoolGetDatum(true)))
+				return true;
 		}
+		return false;
 	}
 	GP_WRAP_END;
 
 	return true;
 }
 
+void
+gpdb::SharedMDCacheBeginOptimization(void)
+{
+	GP_WRAP_START;
+	{
+		::SharedMDCacheBeginOptimization();
+		return;
+	}
+	GP_WRAP_END;
+}
+
+bool
+gpdb::SharedMDCacheOidVersion(Oid oid, uint64 *version)
+{
+	GP_WRAP_START;
+	{
+		return ::SharedMDCacheOidVersion(oid, version);
+	}
+	GP_WRAP_END;
+
+	return false;
+}
+
+bool
+gpdb::SharedMDCacheRelVersion(Oid rel_oid, uint64 *version)
+{
+	GP_WRAP_START;
+	{
+		/* catalog tables: pg_partition */
+		return ::SharedMDCacheRelVersion(rel_oid, version);
+	}
+	GP_WRAP_END;
+
+	return false;
+}
+
+bool
+gpdb::SharedMDCacheIndexVersion(Oid index_oid, uint64 *version)
+{
+	GP_WRAP_START;
+	{
+		/* catalog tables: pg_index, pg_partition */
+		return ::SharedMDCacheIndexVersion(index_oid, version);
+	}
+	GP_WRAP_END;
+
+	return false;
+}
+
+bool
+gpdb::SharedMDCacheColStatsVersion(Oid rel_oid, int pos, uint64 *version)
+{
+	GP_WRAP_START;
+	{
+		AttrNumber attno = colstats_position_to_attno(rel_oid, pos);
+
+		if (attno == InvalidAttrNumber)
+			return false;
+
+		return ::SharedMDCacheColStatsVersion(rel_oid, attno, version);
+	}
+	GP_WRAP_END;
+
+	return false;
+}
+
+void *
+gpdb::SharedMDCacheLookup(const char *key, uint64 version, Size *len)
+{
+	GP_WRAP_START;
+	{
+		return ::SharedMDCacheLookup(key, version, len);
+	}
+	GP_WRAP_END;
+
+	return NULL;
+}
+
+void
+gpdb::SharedMDCacheInsert(const char *key, uint64 version, const void *data,
+						  Size len)
+{
+	GP_WRAP_START;
+	{
+		::SharedMDCacheInsert(key, version, data, len);
+		return;
+	}
+	GP_WRAP_END;
+}
+
 // returns true if a query cancel is requested in GPDB
 bool
 gpdb::IsAbortRequested(void)
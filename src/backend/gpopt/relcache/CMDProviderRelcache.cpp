@@ -16,12 +16,18 @@
 
 extern "C" {
 #include "postgres.h"
+
+#include "utils/shared_mdcache.h"
 }
+#include "gpopt/gpdbwrappers.h"
 #include "gpopt/mdcache/CMDAccessor.h"
 #include "gpopt/relcache/CMDProviderRelcache.h"
 #include "gpopt/translate/CTranslatorRelcacheToDXL.h"
 #include "naucrates/dxl/CDXLUtils.h"
 #include "naucrates/exception.h"
+#include "naucrates/md/CMDIdColStats.h"
+#include "naucrates/md/CMDIdGPDB.h"
+#include "naucrates/md/CMDIdRelStats.h"
 
 using namespace gpos;
 using namespace gpdxl;
@@ -32,12 +38,106 @@ CMDProviderRelcache::CMDProviderRelcache(CMemoryPool *mp) : m_mp(mp)
 	GPOS_ASSERT(NULL != m_mp);
 }
 
+//---------------------------------------------------------------------------
+//	@function:
+//		CMDProviderRelcache::GetSharedMDCacheKey
+//
+//	@doc:
+//		Computes the key and version of the object in the metadata cache
+//		shared by all backends. Only the objects whose invalidations can be
+//		told apart are shared, the same ones that are evicted selectively
+//		from the backend-local cache, see COptTasks::IsMDCacheObjectStale.
+//		The shared cache adds the database to the key.
+//
+//---------------------------------------------------------------------------
+BOOL
+CMDProviderRelcache::GetSharedMDCacheKey(IMDId *md_id,
+										 IMDCacheObject::Emdtype mdtype,
+										 CHAR *key, uint64 *version)
+{
+	BOOL shared = false;
+
+	switch (md_id->MdidType())
+	{
+		case IMDId::EmdidGeneral:
+		case IMDId::EmdidCheckConstraint:
+			// triggers are invalidated with their relation only
+			if (IMDCacheObject::EmdtTrigger != mdtype)
+			{
+				shared = gpdb::SharedMDCacheOidVersion(
+					CMDIdGPDB::CastMdid(md_id)->Oid(), version);
+			}
+			break;
+
+		case IMDId::EmdidRel:
+			shared = gpdb::SharedMDCacheRelVersion(
+				CMDIdGPDB::CastMdid(md_id)->Oid(), version);
+			break;
+
+		case IMDId::EmdidInd:
+			shared = gpdb::SharedMDCacheIndexVersion(
+				CMDIdGPDB::CastMdid(md_id)->Oid(), version);
+			break;
+
+		case IMDId::EmdidRelStats:
+			shared = gpdb::SharedMDCacheRelVersion(
+				CMDIdGPDB::CastMdid(
+					CMDIdRelStats::CastMdid(md_id)->GetRelMdId())
+					->Oid(),
+				version);
+			break;
+
+		case IMDId::EmdidColStats:
+		{
+			CMDIdColStats *mdid_col_stats = CMDIdColStats::CastMdid(md_id);
+
+			shared = gpdb::SharedMDCacheColStatsVersion(
+				CMDIdGPDB::CastMdid(mdid_col_stats->GetRelMdId())->Oid(),
+				(int) mdid_col_stats->Position(), version);
+			break;
+		}
+
+		default:
+			break;
+	}
+
+	if (!shared)
+	{
+		return false;
+	}
+
+	// the ids are plain ASCII, like "0.16384.1.0"
+	const WCHAR *mdid_str = md_id->GetBuffer();
+	ULONG i;
+
+	for (i = 0;
+		 i < SHARED_MDCACHE_KEYLEN - 1 && mdid_str[i] != GPOS_WSZ_LIT('\0'); i++)
+	{
+		if (mdid_str[i] > 0x7f)
+		{
+			return false;
+		}
+		key[i] = (CHAR) mdid_str[i];
+	}
+
+	if (mdid_str[i] != GPOS_WSZ_LIT('\0'))
+	{
+		return false;
+	}
+	key[i] = '\0';
+
+	return true;
+}
+
 //---------------------------------------------------------------------------
 //	@function:
 //		CMDProviderRelcache::GetMDObjDXLStr
 //
 //	@doc:
-//		Returns the DXL of the requested object in the provided memory pool
+//		Returns the DXL of the requested object in the provided memory pool.
+//		Looks in the shared metadata cache first, if it is enabled, and adds
+//		the object to it after translating it from the relcache.  Neither
+//		happens in a transaction that may have changed the catalogs.
 //
 //---------------------------------------------------------------------------
 CWStringBase *
@@ -45,6 +145,26 @@ CMDProviderRelcache::GetMDObjDXLStr(CMemoryPool *mp, CMDAccessor *md_accessor,
 									IMDId *md_id,
 									IMDCacheObject::Emdtype mdtype) const
 {
+	CHAR key[SHARED_MDCACHE_KEYLEN];
+	uint64 version = 0;
+	BOOL shared = GetSharedMDCacheKey(md_id, mdtype, key, &version);
+
+	if (shared)
+	{
+		Size len;
+		WCHAR *dxl = (WCHAR *) gpdb::SharedMDCacheLookup(key, version, &len);
+
+		if (NULL != dxl)
+		{
+			GPOS_ASSERT(len % GPOS_SIZEOF(WCHAR) == 0);
+
+			CWStringDynamic *str = GPOS_NEW(m_mp) CWStringDynamic(m_mp, dxl);
+			gpdb::GPDBFree(dxl);
+
+			return str;
+		}
+	}
+
 	IMDCacheObject *md_obj = CTranslatorRelcacheToDXL::RetrieveObject(
 		mp, md_accessor, md_id, mdtype);
 
@@ -56,6 +176,13 @@ CMDProviderRelcache::GetMDObjDXLStr(CMemoryPool *mp, CMDAccessor *md_accessor,
 	// cleanup DXL object
 	md_obj->Release();
 
+	if (shared)
+	{
+		// include the terminating null character
+		gpdb::SharedMDCacheInsert(key, version, str->GetBuffer(),
+								  (str->Length() + 1) * GPOS_SIZEOF(WCHAR));
+	}
+
 	return str;
 }
 
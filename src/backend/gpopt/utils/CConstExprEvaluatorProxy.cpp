@@ -62,6 +62,8 @@ CConstExprEvaluatorProxy::CEmptyMappingColIdVar::VarFromDXLNodeScId(
 CDXLNode *
 CConstExprEvaluatorProxy::EvaluateExpr(const CDXLNode *dxl_expr)
 {
+	m_has_evaluated_expr = true;
+
 	// Translate DXL -> GPDB Expr
 	Expr *expr = m_dxl2scalar_translator.TranslateDXLToScalar(
 		dxl_expr, &m_emptymapcidvar);
@@ -25,7 +25,7 @@ extern "C" {
 using namespace gpos;
 
 // ctor
-CMemoryPoolPalloc::CMemoryPoolPalloc() : m_cxt(NULL)
+CMemoryPoolPalloc::CMemoryPoolPalloc() : m_cxt(NULL), m_num_allocations(0)
 {
 	m_cxt = gpdb::GPDBAllocSetContextCreate();
 }
@@ -34,6 +34,8 @@ void *
 CMemoryPoolPalloc::NewImpl(const ULONG bytes, const CHAR *, const ULONG,
 						   CMemoryPool::EAllocationType eat)
 {
+	m_num_allocations++;
+
 	// if it's a singleton allocation, allocate requested memory
 	if (CMemoryPool::EatSingleton == eat)
 	{
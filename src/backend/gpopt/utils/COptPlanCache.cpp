@@ -0,0 +1,1188 @@
+//---------------------------------------------------------------------------
+//	Greenplum Database
+//	Copyright (C) 2020 Pivotal Software, Inc.
+//
+//	@filename:
+//		COptPlanCache.cpp
+//
+//	@doc:
+//		Cache of the plans produced by the optimizer, for queries of the
+//		same shape
+//
+//	@test:
+//
+//---------------------------------------------------------------------------
+
+extern "C" {
+#include "postgres.h"
+}
+
+#include "gpopt/utils/COptPlanCache.h"
+
+#include "gpos/common/CAutoRg.h"
+#include "gpos/io/COstreamString.h"
+#include "gpos/memory/CCacheAccessor.h"
+#include "gpos/memory/CCacheFactory.h"
+#include "gpos/task/CAutoTraceFlag.h"
+#include "gpos/task/CTask.h"
+
+#include "gpopt/engine/CEnumeratorConfig.h"
+#include "gpopt/gpdbwrappers.h"
+#include "gpopt/mdcache/CMDAccessor.h"
+#include "gpopt/optimizer/COptimizerConfig.h"
+#include "naucrates/base/IDatum.h"
+#include "naucrates/dxl/CDXLUtils.h"
+#include "naucrates/dxl/operators/CDXLLogicalGet.h"
+#include "naucrates/dxl/operators/CDXLScalarConstValue.h"
+#include "naucrates/dxl/operators/CDXLScalarIdent.h"
+#include "naucrates/dxl/xml/CXMLSerializer.h"
+#include "naucrates/md/CDXLBucket.h"
+#include "naucrates/md/CMDIdCast.h"
+#include "naucrates/md/CMDIdColStats.h"
+#include "naucrates/md/CMDIdGPDB.h"
+#include "naucrates/md/CMDIdRelStats.h"
+#include "naucrates/md/CMDIdScCmp.h"
+#include "naucrates/md/IMDColStats.h"
+#include "naucrates/md/IMDRelation.h"
+#include "naucrates/md/IMDType.h"
+
+using namespace gpos;
+using namespace gpdxl;
+using namespace gpmd;
+using namespace gpopt;
+
+typedef CCacheAccessor<COptPlanCache::CPlanEntry *, CWStringDynamic *>
+	PlanCacheAccessor;
+
+// number of reuses of a verified plan with other literals, after which the
+// query is optimized again to check that the plan still fits
+#define GPOPT_PLAN_CACHE_REVERIFY_INTERVAL 16
+
+// largest ratio between the row estimates of a plan node in the cached and
+// in the new plan, for the cached plan to be reused with other literals
+#define GPOPT_PLAN_CACHE_MAX_ROWS_RATIO 2.0
+
+// global instance of the plan cache
+COptPlanCache::PlanCache *COptPlanCache::m_pcache = NULL;
+
+// maximum size of the cache
+ULLONG COptPlanCache::m_cache_quota = UNLIMITED_CACHE_QUOTA;
+
+// counters, kept across resets of the cache
+ULLONG COptPlanCache::m_num_hits = 0;
+ULLONG COptPlanCache::m_num_misses = 0;
+ULLONG COptPlanCache::m_num_inserts = 0;
+ULLONG COptPlanCache::m_num_verified = 0;
+ULLONG COptPlanCache::m_num_rejected = 0;
+
+//---------------------------------------------------------------------------
+//	@function:
+//		COptPlanCache::CPlanEntry::~CPlanEntry
+//
+//	@doc:
+//		Dtor
+//
+//---------------------------------------------------------------------------
+COptPlanCache::CPlanEntry::~CPlanEntry()
+{
+	GPOS_DELETE(m_key);
+	GPOS_DELETE(m_plan);
+	CRefCount::SafeRelease(m_literals);
+	GPOS_DELETE_ARRAY(m_deps);
+}
+
+//---------------------------------------------------------------------------
+//	@function:
+//		COptPlanCache::HashKey
+//
+//	@doc:
+//		Hash function for the cache keys
+//
+//---------------------------------------------------------------------------
+ULONG
+COptPlanCache::HashKey(CWStringDynamic *const &key)
+{
+	return gpos::HashByteArray((const BYTE *) key->GetBuffer(),
+							   key->Length() * GPOS_SIZEOF(WCHAR));
+}
+
+//---------------------------------------------------------------------------
+//	@function:
+//		COptPlanCache::EqualKeys
+//
+//	@doc:
+//		Equality function for the cache keys
+//
+//---------------------------------------------------------------------------
+BOOL
+COptPlanCache::EqualKeys(CWStringDynamic *const &left,
+						 CWStringDynamic *const &right)
+{
+	if (NULL == left || NULL == right)
+	{
+		return left == right;
+	}
+
+	return left->Equals(right);
+}
+
+//---------------------------------------------------------------------------
+//	@function:
+//		COptPlanCache::Init
+//
+//	@doc:
+//		Initializes global instance
+//
+//---------------------------------------------------------------------------
+void
+COptPlanCache::Init()
+{
+	GPOS_ASSERT(NULL == m_pcache && "Plan cache was already created");
+
+	m_pcache = CCacheFactory::CreateCache<CPlanEntry *, CWStringDynamic *>(
+		true /*fUnique*/, m_cache_quota, HashKey, EqualKeys);
+}
+
+//---------------------------------------------------------------------------
+//	@function:
+//		COptPlanCache::Shutdown
+//
+//	@doc:
+//		Cleans up the underlying cache
+//
+//---------------------------------------------------------------------------
+void
+COptPlanCache::Shutdown()
+{
+	GPOS_DELETE(m_pcache);
+	m_pcache = NULL;
+}
+
+//---------------------------------------------------------------------------
+//	@function:
+//		COptPlanCache::Reset
+//
+//	@doc:
+//		Reset plan cache
+//
+//---------------------------------------------------------------------------
+void
+COptPlanCache::Reset()
+{
+	CAutoTraceFlag atf1(EtraceSimulateOOM, false);
+	CAutoTraceFlag atf2(EtraceSimulateAbort, false);
+	CAutoTraceFlag atf3(EtraceSimulateIOError, false);
+	CAutoTraceFlag atf4(EtraceSimulateNetError, false);
+
+	Shutdown();
+	Init();
+}
+
+//---------------------------------------------------------------------------
+//	@function:
+//		COptPlanCache::SetCacheQuota
+//
+//	@doc:
+//		Set the maximum size of the cache
+//
+//---------------------------------------------------------------------------
+void
+COptPlanCache::SetCacheQuota(ULLONG cache_quota)
+{
+	GPOS_ASSERT(NULL != m_pcache && "Plan cache was not created");
+	m_cache_quota = cache_quota;
+	m_pcache->SetCacheQuota(cache_quota);
+}
+
+//---------------------------------------------------------------------------
+//	@function:
+//		COptPlanCache::GetCacheQuota
+//
+//	@doc:
+//		Get the maximum size of the cache
+//
+//---------------------------------------------------------------------------
+ULLONG
+COptPlanCache::GetCacheQuota()
+{
+	return m_cache_quota;
+}
+
+//---------------------------------------------------------------------------
+//	@function:
+//		COptPlanCache::IsPlanStale
+//
+//	@doc:
+//		Filter for Invalidate, selecting the cached plans that depend on
+//		catalog objects changed since the last optimization
+//
+//---------------------------------------------------------------------------
+BOOL
+COptPlanCache::IsPlanStale(CWStringDynamic *const &,  // key
+						   CPlanEntry *const &entry,
+						   void *  // arg
+)
+{
+	if (entry->m_depends_on_all)
+	{
+		return true;
+	}
+
+	for (ULONG ul = 0; ul < entry->m_num_deps; ul++)
+	{
+		const SDependency *dep = &entry->m_deps[ul];
+
+		if (gpdb::MDCacheOidInvalidated(dep->m_oid) ||
+			(0 <= dep->m_pos &&
+			 gpdb::MDCacheColStatsInvalidated(dep->m_oid, dep->m_pos)))
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
+//---------------------------------------------------------------------------
+//	@function:
+//		COptPlanCache::Invalidate
+//
+//	@doc:
+//		Evict the plans affected by the catalog changes since the last
+//		optimization. Must be called before the invalidations are cleared.
+//
+//---------------------------------------------------------------------------
+ULONG
+COptPlanCache::Invalidate()
+{
+	GPOS_ASSERT(NULL != m_pcache && "Plan cache was not created");
+
+	CAutoTraceFlag atf1(EtraceSimulateOOM, false);
+	CAutoTraceFlag atf2(EtraceSimulateAbort, false);
+	CAutoTraceFlag atf3(EtraceSimulateIOError, false);
+	CAutoTraceFlag atf4(EtraceSimulateNetError, false);
+
+	return m_pcache->DeleteEntries(IsPlanStale, NULL);
+}
+
+//---------------------------------------------------------------------------
+//	@function:
+//		COptPlanCache::AppendChars
+//
+//	@doc:
+//		Append the given number of characters of a buffer to a string
+//
+//---------------------------------------------------------------------------
+void
+COptPlanCache::AppendChars(CMemoryPool *mp, CWStringDynamic *str,
+						   const WCHAR *buffer, ULONG length)
+{
+	if (0 == length)
+	{
+		return;
+	}
+
+	CAutoRg<WCHAR> a_buffer;
+	a_buffer = GPOS_NEW_ARRAY(mp, WCHAR, length + 1);
+	clib::WcStrNCpy(a_buffer.Rgt(), buffer, length);
+	a_buffer[length] = WCHAR_EOS;
+	str->AppendWideCharArray(a_buffer.Rgt());
+}
+
+//---------------------------------------------------------------------------
+//	@function:
+//		COptPlanCache::GetLiteralStr
+//
+//	@doc:
+//		Serialize the attributes of a constant, e.g.
+//		' TypeMdid="0.23.1.0" Value="5"/>'. The same datum is serialized
+//		the same way in query and plan DXL, also when it is not part of a
+//		ConstValue element, e.g. in direct dispatch info.
+//
+//---------------------------------------------------------------------------
+CWStringDynamic *
+COptPlanCache::GetLiteralStr(CMemoryPool *mp, const CDXLNode *const_node)
+{
+	CWStringDynamic str(mp);
+	COstreamString oss(&str);
+	CXMLSerializer xml_serializer(mp, oss, false /*indentation*/);
+	const_node->SerializeToDXL(&xml_serializer);
+
+	// skip the element name
+	INT pos = str.Find(' ');
+	GPOS_ASSERT(0 < pos);
+
+	return GPOS_NEW(mp) CWStringDynamic(mp, str.GetBuffer() + pos);
+}
+
+//---------------------------------------------------------------------------
+//	@function:
+//		COptPlanCache::FindGet
+//
+//	@doc:
+//		Find the Get of the base table that produces the column with the
+//		given id, and return the attribute number of the column
+//
+//---------------------------------------------------------------------------
+const CDXLNode *
+COptPlanCache::FindGet(const CDXLNode *node, ULONG colid, INT *attno)
+{
+	Edxlopid op_id = node->GetOperator()->GetDXLOperator();
+
+	if (EdxlopLogicalGet == op_id || EdxlopLogicalExternalGet == op_id)
+	{
+		CDXLTableDescr *table_descr =
+			CDXLLogicalGet::Cast(node->GetOperator())->GetDXLTableDescr();
+
+		for (ULONG ul = 0; ul < table_descr->Arity(); ul++)
+		{
+			const CDXLColDescr *col_descr = table_descr->GetColumnDescrAt(ul);
+			if (col_descr->Id() == colid)
+			{
+				*attno = col_descr->AttrNum();
+				return node;
+			}
+		}
+		return NULL;
+	}
+
+	for (ULONG ul = 0; ul < node->Arity(); ul++)
+	{
+		const CDXLNode *get = FindGet((*node)[ul], colid, attno);
+		if (NULL != get)
+		{
+			return get;
+		}
+	}
+
+	return NULL;
+}
+
+//---------------------------------------------------------------------------
+//	@function:
+//		COptPlanCache::GetBucket
+//
+//	@doc:
+//		Position of a datum in the histogram of a column: 2i+1 if it falls
+//		into the i-th bucket, 2i if it falls between the (i-1)-th and the
+//		i-th bucket, and twice the number of buckets if it comes after all
+//		of them. Return -1 if the column has no histogram, or the datum
+//		cannot be compared with it.
+//
+//---------------------------------------------------------------------------
+INT
+COptPlanCache::GetBucket(CMemoryPool *mp, CMDAccessor *md_accessor,
+						 IMDId *rel_mdid, INT attno,
+						 const CDXLDatum *dxl_datum)
+{
+	if (0 >= attno)
+	{
+		// system column
+		return -1;
+	}
+
+	const IMDRelation *rel = md_accessor->RetrieveRel(rel_mdid);
+	ULONG pos = rel->GetPosFromAttno(attno);
+
+	rel_mdid->AddRef();
+	CMDIdColStats *mdid_col_stats =
+		GPOS_NEW(mp) CMDIdColStats(CMDIdGPDB::CastMdid(rel_mdid), pos);
+	const IMDColStats *col_stats = md_accessor->Pmdcolstats(mdid_col_stats);
+	mdid_col_stats->Release();
+
+	const ULONG num_buckets = col_stats->Buckets();
+	if (col_stats->IsColStatsMissing() || 0 == num_buckets)
+	{
+		return -1;
+	}
+
+	IDatum *datum = md_accessor->RetrieveType(dxl_datum->MDId())
+						->GetDatumForDXLDatum(mp, dxl_datum);
+	const IMDType *col_type = md_accessor->RetrieveType(
+		col_stats->GetDXLBucketAt(0)->GetDXLDatumLower()->MDId());
+
+	INT bucket = 2 * num_buckets;
+	for (ULONG ul = 0; ul < num_buckets; ul++)
+	{
+		const CDXLBucket *dxl_bucket = col_stats->GetDXLBucketAt(ul);
+		IDatum *lower =
+			col_type->GetDatumForDXLDatum(mp, dxl_bucket->GetDXLDatumLower());
+		IDatum *upper =
+			col_type->GetDatumForDXLDatum(mp, dxl_bucket->GetDXLDatumUpper());
+
+		BOOL comparable =
+			datum->StatsAreComparable(lower) && datum->StatsAreComparable(upper);
+		BOOL before = comparable && datum->StatsAreLessThan(lower);
+		BOOL within = comparable && !before && !upper->StatsAreLessThan(datum);
+
+		lower->Release();
+		upper->Release();
+
+		if (!comparable)
+		{
+			bucket = -1;
+			break;
+		}
+		if (before)
+		{
+			bucket = 2 * ul;
+			break;
+		}
+		if (within)
+		{
+			bucket = 2 * ul + 1;
+			break;
+		}
+	}
+
+	datum->Release();
+
+	return bucket;
+}
+
+//---------------------------------------------------------------------------
+//	@function:
+//		COptPlanCache::CollectLiterals
+//
+//	@doc:
+//		Collect the literals compared to a base table column with a
+//		histogram. Each distinct literal is added once to the array; the
+//		bucket of each comparison is appended to the string, prefixed by
+//		the index of its literal. The ids of the compared columns are added
+//		to the bit set; if a column is compared more than once, the plan is
+//		not generalizable.
+//
+//---------------------------------------------------------------------------
+void
+COptPlanCache::CollectLiterals(CMemoryPool *mp, CMDAccessor *md_accessor,
+							   const CDXLNode *root, const CDXLNode *node,
+							   StringPtrArray *literals, CWStringDynamic *buckets,
+							   CBitSet *colids, BOOL *is_generalizable)
+{
+	GPOS_CHECK_STACK_SIZE;
+
+	if (EdxlopScalarCmp == node->GetOperator()->GetDXLOperator())
+	{
+		const CDXLNode *ident = (*node)[0];
+		const CDXLNode *constant = (*node)[1];
+		if (EdxlopScalarConstValue == ident->GetOperator()->GetDXLOperator())
+		{
+			std::swap(ident, constant);
+		}
+
+		if (EdxlopScalarIdent == ident->GetOperator()->GetDXLOperator() &&
+			EdxlopScalarConstValue == constant->GetOperator()->GetDXLOperator())
+		{
+			const CDXLDatum *dxl_datum =
+				CDXLScalarConstValue::Cast(constant->GetOperator())
+					->GetDatumVal();
+			ULONG colid = CDXLScalarIdent::Cast(ident->GetOperator())
+							  ->GetDXLColRef()
+							  ->Id();
+			INT attno = 0;
+			const CDXLNode *get = NULL;
+			INT bucket = -1;
+
+			if (!dxl_datum->IsNull() &&
+				NULL != (get = FindGet(root, colid, &attno)))
+			{
+				IMDId *rel_mdid = CDXLLogicalGet::Cast(get->GetOperator())
+									  ->GetDXLTableDescr()
+									  ->MDId();
+				bucket =
+					GetBucket(mp, md_accessor, rel_mdid, attno, dxl_datum);
+			}
+
+			if (0 <= bucket)
+			{
+				CWStringDynamic *literal = GetLiteralStr(mp, constant);
+				ULONG idx = 0;
+				while (idx < literals->Size() &&
+					   !(*literals)[idx]->Equals(literal))
+				{
+					idx++;
+				}
+
+				if (idx == literals->Size())
+				{
+					literals->Append(literal);
+				}
+				else
+				{
+					GPOS_DELETE(literal);
+				}
+				buckets->AppendFormat(GPOS_WSZ_LIT(" %d:%d"), idx, bucket);
+
+				// comparisons of the same column, like a > 5 AND a > 7, may
+				// be merged, and which literal survives depends on the values
+				if (colids->ExchangeSet(colid))
+				{
+					*is_generalizable = false;
+				}
+			}
+		}
+	}
+
+	for (ULONG ul = 0; ul < node->Arity(); ul++)
+	{
+		CollectLiterals(mp, md_accessor, root, (*node)[ul], literals,
+						buckets, colids, is_generalizable);
+	}
+}
+
+//---------------------------------------------------------------------------
+//	@function:
+//		COptPlanCache::Contains
+//
+//	@doc:
+//		Does a string contain another one?
+//
+//---------------------------------------------------------------------------
+BOOL
+COptPlanCache::Contains(const CWStringBase *str, const CWStringBase *substr)
+{
+	const WCHAR *buffer = str->GetBuffer();
+	const ULONG length = str->Length();
+	const ULONG sublength = substr->Length();
+
+	for (ULONG ul = 0; sublength <= length && ul <= length - sublength; ul++)
+	{
+		if (0 == clib::Wcsncmp(buffer + ul, substr->GetBuffer(), sublength))
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
+//---------------------------------------------------------------------------
+//	@function:
+//		COptPlanCache::ReplaceLiterals
+//
+//	@doc:
+//		Replace all the occurrences of the literals in a string by the
+//		corresponding replacements, in one pass
+//
+//---------------------------------------------------------------------------
+CWStringDynamic *
+COptPlanCache::ReplaceLiterals(CMemoryPool *mp, const CWStringBase *str,
+							   const StringPtrArray *literals,
+							   const StringPtrArray *replacements)
+{
+	GPOS_ASSERT(literals->Size() == replacements->Size());
+
+	CWStringDynamic *result = GPOS_NEW(mp) CWStringDynamic(mp);
+	const WCHAR *buffer = str->GetBuffer();
+	const ULONG length = str->Length();
+	const ULONG num_literals = literals->Size();
+
+	// start of the part of the string not copied yet
+	ULONG start = 0;
+	ULONG ul = 0;
+	while (ul < length)
+	{
+		ULONG matched = gpos::ulong_max;
+		for (ULONG idx = 0; idx < num_literals; idx++)
+		{
+			const CWStringBase *literal = (*literals)[idx];
+			if (buffer[ul] == literal->GetBuffer()[0] &&
+				literal->Length() <= length - ul &&
+				0 == clib::Wcsncmp(buffer + ul, literal->GetBuffer(),
+								   literal->Length()))
+			{
+				matched = idx;
+				break;
+			}
+		}
+
+		if (gpos::ulong_max == matched)
+		{
+			ul++;
+			continue;
+		}
+
+		AppendChars(mp, result, buffer + start, ul - start);
+		result->Append((*replacements)[matched]);
+		ul += (*literals)[matched]->Length();
+		start = ul;
+	}
+	AppendChars(mp, result, buffer + start, length - start);
+
+	return result;
+}
+
+//---------------------------------------------------------------------------
+//	@function:
+//		COptPlanCache::StripPlanForCompare
+//
+//	@doc:
+//		Copy plan DXL without the plan header and the costs, which hold the
+//		plan id and row estimates that differ between otherwise equal plans
+//
+//---------------------------------------------------------------------------
+CWStringDynamic *
+COptPlanCache::StripPlanForCompare(CMemoryPool *mp, const CWStringBase *plan)
+{
+	const WCHAR *tags[] = {GPOS_WSZ_LIT("<dxl:Plan "),
+						   GPOS_WSZ_LIT("<dxl:Cost ")};
+	CWStringDynamic *result = GPOS_NEW(mp) CWStringDynamic(mp);
+	const WCHAR *buffer = plan->GetBuffer();
+	const ULONG length = plan->Length();
+
+	ULONG start = 0;
+	ULONG ul = 0;
+	while (ul < length)
+	{
+		BOOL matched = false;
+		for (ULONG idx = 0; idx < GPOS_ARRAY_SIZE(tags); idx++)
+		{
+			ULONG tag_length = GPOS_WSZ_LENGTH(tags[idx]);
+			if (tag_length <= length - ul &&
+				0 == clib::Wcsncmp(buffer + ul, tags[idx], tag_length))
+			{
+				matched = true;
+				break;
+			}
+		}
+
+		if (!matched)
+		{
+			ul++;
+			continue;
+		}
+
+		// skip the whole tag
+		AppendChars(mp, result, buffer + start, ul - start);
+		while (ul < length && GPOS_WSZ_LIT('>') != buffer[ul])
+		{
+			ul++;
+		}
+		ul++;
+		start = ul;
+	}
+	AppendChars(mp, result, buffer + start, std::min(length, ul) - start);
+
+	return result;
+}
+
+//---------------------------------------------------------------------------
+//	@function:
+//		COptPlanCache::NextRowEstimate
+//
+//	@doc:
+//		Find the next row estimate in plan DXL, starting at the given
+//		position, and move the position past it. Return false if there
+//		is none left.
+//
+//---------------------------------------------------------------------------
+BOOL
+COptPlanCache::NextRowEstimate(const CWStringBase *plan, ULONG *pos,
+							   DOUBLE *rows)
+{
+	const WCHAR *attr = GPOS_WSZ_LIT(" Rows=\"");
+	const ULONG attr_length = GPOS_WSZ_LENGTH(attr);
+	const WCHAR *buffer = plan->GetBuffer();
+	const ULONG length = plan->Length();
+
+	ULONG ul = *pos;
+	while (ul + attr_length <= length &&
+		   0 != clib::Wcsncmp(buffer + ul, attr, attr_length))
+	{
+		ul++;
+	}
+	if (ul + attr_length > length)
+	{
+		*pos = length;
+		return false;
+	}
+
+	// estimates are serialized as plain numbers, that fit in a small buffer
+	CHAR value[64];
+	ULONG num_chars = 0;
+	ul += attr_length;
+	while (ul < length && GPOS_WSZ_LIT('"') != buffer[ul])
+	{
+		if (num_chars < GPOS_ARRAY_SIZE(value) - 1)
+		{
+			value[num_chars++] = (CHAR) buffer[ul];
+		}
+		ul++;
+	}
+	value[num_chars] = '\0';
+
+	*rows = clib::Strtod(value);
+	*pos = ul;
+	return true;
+}
+
+//---------------------------------------------------------------------------
+//	@function:
+//		COptPlanCache::RowEstimatesDiffer
+//
+//	@doc:
+//		Compare the row estimates of the nodes of two plans of the same
+//		shape. Return true if any of them differ by more than
+//		GPOPT_PLAN_CACHE_MAX_ROWS_RATIO, so that the cached plan would
+//		carry cardinalities that no longer fit the query.
+//
+//---------------------------------------------------------------------------
+BOOL
+COptPlanCache::RowEstimatesDiffer(const CWStringBase *plan,
+								  const CWStringBase *other_plan)
+{
+	ULONG pos = 0;
+	ULONG other_pos = 0;
+	DOUBLE rows = 0.0;
+	DOUBLE other_rows = 0.0;
+
+	while (NextRowEstimate(plan, &pos, &rows) &&
+		   NextRowEstimate(other_plan, &other_pos, &other_rows))
+	{
+		rows = std::max(rows, 1.0);
+		other_rows = std::max(other_rows, 1.0);
+		if (rows > other_rows * GPOPT_PLAN_CACHE_MAX_ROWS_RATIO ||
+			other_rows > rows * GPOPT_PLAN_CACHE_MAX_ROWS_RATIO)
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
+//---------------------------------------------------------------------------
+//	@function:
+//		COptPlanCache::SerializePlan
+//
+//	@doc:
+//		Serialize plan DXL into a string
+//
+//---------------------------------------------------------------------------
+CWStringDynamic *
+COptPlanCache::SerializePlan(CMemoryPool *mp, const CDXLNode *plan_dxl,
+							 COptimizerConfig *optimizer_config)
+{
+	CWStringDynamic *plan = GPOS_NEW(mp) CWStringDynamic(mp);
+	COstreamString oss(plan);
+	CDXLUtils::SerializePlan(
+		mp, oss, plan_dxl, optimizer_config->GetEnumeratorCfg()->GetPlanId(),
+		optimizer_config->GetEnumeratorCfg()->GetPlanSpaceSize(),
+		true /*serialize_header_footer*/, false /*indentation*/);
+
+	return plan;
+}
+
+//---------------------------------------------------------------------------
+//	@function:
+//		COptPlanCache::ParsePlan
+//
+//	@doc:
+//		Parse plan DXL from a string
+//
+//---------------------------------------------------------------------------
+CDXLNode *
+COptPlanCache::ParsePlan(CMemoryPool *mp, const CWStringBase *plan)
+{
+	CAutoRg<CHAR> a_plan;
+	a_plan = CDXLUtils::CreateMultiByteCharStringFromWCString(
+		mp, plan->GetBuffer());
+
+	ULLONG plan_id = 0;
+	ULLONG plan_space_size = 0;
+
+	return CDXLUtils::GetPlanDXLNode(mp, a_plan.Rgt(), NULL /*xsd_file_path*/,
+									 &plan_id, &plan_space_size);
+}
+
+//---------------------------------------------------------------------------
+//	@function:
+//		COptPlanCache::SetDependencies
+//
+//	@doc:
+//		Record the catalog objects that a plan depends on, that is all the
+//		metadata objects accessed while optimizing it
+//
+//---------------------------------------------------------------------------
+void
+COptPlanCache::SetDependencies(CMemoryPool *mp, CMDAccessor *md_accessor,
+							   CPlanEntry *entry)
+{
+	IMdIdArray *mdids = md_accessor->GetAccessedMDIds(mp);
+	const ULONG num_mdids = mdids->Size();
+
+	// casts and comparisons depend on two types each
+	entry->m_deps = GPOS_NEW_ARRAY(entry->m_mp, SDependency, 2 * num_mdids);
+	entry->m_num_deps = 0;
+
+	for (ULONG ul = 0; ul < num_mdids; ul++)
+	{
+		IMDId *mdid = (*mdids)[ul];
+		SDependency *dep = &entry->m_deps[entry->m_num_deps];
+
+		switch (mdid->MdidType())
+		{
+			case IMDId::EmdidGeneral:
+			case IMDId::EmdidRel:
+			case IMDId::EmdidInd:
+			case IMDId::EmdidCheckConstraint:
+				dep->m_oid = CMDIdGPDB::CastMdid(mdid)->Oid();
+				dep->m_pos = -1;
+				entry->m_num_deps++;
+				break;
+
+			case IMDId::EmdidRelStats:
+				dep->m_oid = CMDIdGPDB::CastMdid(
+								 CMDIdRelStats::CastMdid(mdid)->GetRelMdId())
+								 ->Oid();
+				dep->m_pos = -1;
+				entry->m_num_deps++;
+				break;
+
+			case IMDId::EmdidColStats:
+			{
+				CMDIdColStats *mdid_col_stats = CMDIdColStats::CastMdid(mdid);
+				dep->m_oid =
+					CMDIdGPDB::CastMdid(mdid_col_stats->GetRelMdId())->Oid();
+				dep->m_pos = (INT) mdid_col_stats->Position();
+				entry->m_num_deps++;
+				break;
+			}
+
+			// changes to pg_cast and to the operator classes reset the
+			// whole cache, so only the types need to be tracked
+			case IMDId::EmdidCastFunc:
+			{
+				CMDIdCast *mdid_cast = CMDIdCast::CastMdid(mdid);
+				dep[0].m_oid = CMDIdGPDB::CastMdid(mdid_cast->MdidSrc())->Oid();
+				dep[0].m_pos = -1;
+				dep[1].m_oid = CMDIdGPDB::CastMdid(mdid_cast->MdidDest())->Oid();
+				dep[1].m_pos = -1;
+				entry->m_num_deps += 2;
+				break;
+			}
+
+			case IMDId::EmdidScCmp:
+			{
+				CMDIdScCmp *mdid_sc_cmp = CMDIdScCmp::CastMdid(mdid);
+				dep[0].m_oid =
+					CMDIdGPDB::CastMdid(mdid_sc_cmp->GetLeftMdid())->Oid();
+				dep[0].m_pos = -1;
+				dep[1].m_oid =
+					CMDIdGPDB::CastMdid(mdid_sc_cmp->GetRightMdid())->Oid();
+				dep[1].m_pos = -1;
+				entry->m_num_deps += 2;
+				break;
+			}
+
+			default:
+				entry->m_depends_on_all = true;
+				break;
+		}
+	}
+
+	mdids->Release();
+}
+
+//---------------------------------------------------------------------------
+//	@function:
+//		COptPlanCache::BuildKey
+//
+//	@doc:
+//		Build the key of a query: its DXL with the abstracted literals
+//		replaced by placeholders, the buckets of the literals, and the
+//		optimizer settings. The abstracted literals are added to the
+//		given array. Sets is_generalizable to false if the plan of the
+//		query must not be reused with other literals.
+//
+//---------------------------------------------------------------------------
+CWStringDynamic *
+COptPlanCache::BuildKey(CMemoryPool *mp, CMDAccessor *md_accessor,
+						const CDXLNode *query_dxl,
+						const CDXLNodeArray *query_output_dxlnode_array,
+						const CDXLNodeArray *cte_dxlnode_array,
+						COptimizerConfig *optimizer_config,
+						ULONG num_segments, StringPtrArray *literals,
+						BOOL *is_generalizable)
+{
+	GPOS_ASSERT(0 == literals->Size());
+
+	*is_generalizable = true;
+
+	CWStringDynamic buckets(mp);
+	CBitSet *colids = GPOS_NEW(mp) CBitSet(mp);
+	CollectLiterals(mp, md_accessor, query_dxl, query_dxl, literals,
+					&buckets, colids, is_generalizable);
+	for (ULONG ul = 0; NULL != cte_dxlnode_array && ul < cte_dxlnode_array->Size();
+		 ul++)
+	{
+		const CDXLNode *cte = (*cte_dxlnode_array)[ul];
+		CollectLiterals(mp, md_accessor, cte, cte, literals, &buckets, colids,
+						is_generalizable);
+	}
+	colids->Release();
+
+	CWStringDynamic query_str(mp);
+	COstreamString oss(&query_str);
+	CDXLUtils::SerializeQuery(mp, oss, query_dxl, query_output_dxlnode_array,
+							  cte_dxlnode_array, false /*serialize_header_footer*/,
+							  false /*indentation*/);
+
+	StringPtrArray *placeholders = GPOS_NEW(mp) StringPtrArray(mp);
+	for (ULONG ul = 0; ul < literals->Size(); ul++)
+	{
+		CWStringDynamic *placeholder = GPOS_NEW(mp) CWStringDynamic(mp);
+		placeholder->AppendFormat(GPOS_WSZ_LIT(" $%d/>"), ul);
+		placeholders->Append(placeholder);
+	}
+	CWStringDynamic *key =
+		ReplaceLiterals(mp, &query_str, literals, placeholders);
+	placeholders->Release();
+
+	key->Append(&buckets);
+
+	// the settings, including the trace flags set for this query
+	COstreamString oss_key(key);
+	CXMLSerializer xml_serializer(mp, oss_key, false /*indentation*/);
+	CBitSet *trace_flags = CTask::Self()->GetTaskCtxt()->copy_trace_flags(mp);
+	optimizer_config->Serialize(mp, &xml_serializer, trace_flags);
+	trace_flags->Release();
+	key->AppendFormat(GPOS_WSZ_LIT(" segments=%d"), num_segments);
+
+	return key;
+}
+
+//---------------------------------------------------------------------------
+//	@function:
+//		COptPlanCache::Lookup
+//
+//	@doc:
+//		Look up the plan of a query. On a hit, return the plan. If the
+//		cached plan has not been tried with other literals yet, or has been
+//		reused with other literals GPOPT_PLAN_CACHE_REVERIFY_INTERVAL times
+//		since it was last verified, return the plan that optimizing the
+//		query should produce for it to be reusable.
+//
+//---------------------------------------------------------------------------
+COptPlanCache::ELookupResult
+COptPlanCache::Lookup(CMemoryPool *mp, CWStringDynamic *key,
+					  const StringPtrArray *literals, CDXLNode **plan_dxl,
+					  CWStringDynamic **expected_plan)
+{
+	GPOS_ASSERT(NULL != m_pcache && "Plan cache was not created");
+
+	PlanCacheAccessor acc(m_pcache);
+	acc.Lookup(key);
+	CPlanEntry *entry = acc.Val();
+
+	if (NULL == entry)
+	{
+		m_num_misses++;
+		return ElrMiss;
+	}
+
+	// the key has a placeholder for each literal
+	GPOS_ASSERT(entry->m_literals->Size() == literals->Size());
+
+	BOOL same_literals = true;
+	for (ULONG ul = 0; same_literals && ul < literals->Size(); ul++)
+	{
+		same_literals = (*literals)[ul]->Equals((*entry->m_literals)[ul]);
+	}
+
+	if (same_literals)
+	{
+		*plan_dxl = ParsePlan(mp, entry->m_plan);
+		m_num_hits++;
+		return ElrHit;
+	}
+
+	switch (entry->m_state)
+	{
+		case EpsVerified:
+		{
+			entry->m_num_reuses++;
+			if (0 == entry->m_num_reuses % GPOPT_PLAN_CACHE_REVERIFY_INTERVAL)
+			{
+				*expected_plan = ReplaceLiterals(mp, entry->m_plan,
+												 entry->m_literals, literals);
+				m_num_misses++;
+				return ElrVerify;
+			}
+
+			CAutoP<CWStringDynamic> a_plan;
+			a_plan = ReplaceLiterals(mp, entry->m_plan, entry->m_literals,
+									 literals);
+			*plan_dxl = ParsePlan(mp, a_plan.Value());
+			m_num_hits++;
+			return ElrHit;
+		}
+
+		case EpsUnverified:
+			*expected_plan = ReplaceLiterals(mp, entry->m_plan,
+											 entry->m_literals, literals);
+			m_num_misses++;
+			return ElrVerify;
+
+		default:
+			m_num_misses++;
+			return ElrSkip;
+	}
+}
+
+//---------------------------------------------------------------------------
+//	@function:
+//		COptPlanCache::Insert
+//
+//	@doc:
+//		Insert the plan of a query that was not found in the cache. The
+//		plan is only reused with other literals if it is generalizable, and
+//		all the literals can be found in it.
+//
+//---------------------------------------------------------------------------
+void
+COptPlanCache::Insert(CMemoryPool *mp, CMDAccessor *md_accessor,
+					  CWStringDynamic *key, const StringPtrArray *literals,
+					  BOOL is_generalizable, const CDXLNode *plan_dxl,
+					  COptimizerConfig *optimizer_config)
+{
+	GPOS_ASSERT(NULL != m_pcache && "Plan cache was not created");
+
+	CAutoP<CWStringDynamic> a_plan;
+	a_plan = SerializePlan(mp, plan_dxl, optimizer_config);
+
+	PlanCacheAccessor acc(m_pcache);
+	CMemoryPool *entry_mp = acc.Pmp();
+
+	CPlanEntry *entry = GPOS_NEW(entry_mp) CPlanEntry(entry_mp);
+	entry->m_key = GPOS_NEW(entry_mp) CWStringDynamic(entry_mp, key->GetBuffer());
+	entry->m_plan =
+		GPOS_NEW(entry_mp) CWStringDynamic(entry_mp, a_plan->GetBuffer());
+	entry->m_literals = GPOS_NEW(entry_mp) StringPtrArray(entry_mp);
+	for (ULONG ul = 0; ul < literals->Size(); ul++)
+	{
+		entry->m_literals->Append(GPOS_NEW(entry_mp) CWStringDynamic(
+			entry_mp, (*literals)[ul]->GetBuffer()));
+	}
+	SetDependencies(mp, md_accessor, entry);
+
+	// a literal that was folded into another one, or into something else,
+	// cannot be substituted
+	for (ULONG ul = 0; is_generalizable && ul < literals->Size(); ul++)
+	{
+		is_generalizable = Contains(a_plan.Value(), (*literals)[ul]);
+	}
+	if (!is_generalizable)
+	{
+		entry->m_state = EpsLiteralSensitive;
+	}
+
+	// if another entry with the key was inserted meanwhile, the cache
+	// keeps that one
+	if (entry == acc.Insert(entry->m_key, entry))
+	{
+		m_num_inserts++;
+	}
+	entry->Release();
+}
+
+//---------------------------------------------------------------------------
+//	@function:
+//		COptPlanCache::Verify
+//
+//	@doc:
+//		Compare the plan produced for a query with the plan that the lookup
+//		expected, and record whether the cached plan can be reused with
+//		other literals. Plans of the same shape are still told apart if
+//		their row estimates drifted apart.
+//
+//---------------------------------------------------------------------------
+void
+COptPlanCache::Verify(CMemoryPool *mp, CWStringDynamic *key,
+					  const CDXLNode *plan_dxl,
+					  COptimizerConfig *optimizer_config,
+					  const CWStringDynamic *expected_plan)
+{
+	GPOS_ASSERT(NULL != m_pcache && "Plan cache was not created");
+
+	CAutoP<CWStringDynamic> a_plan;
+	a_plan = SerializePlan(mp, plan_dxl, optimizer_config);
+
+	CAutoP<CWStringDynamic> a_actual;
+	a_actual = StripPlanForCompare(mp, a_plan.Value());
+	CAutoP<CWStringDynamic> a_expected;
+	a_expected = StripPlanForCompare(mp, expected_plan);
+
+	if (!a_actual->Equals(a_expected.Value()) ||
+		RowEstimatesDiffer(a_plan.Value(), expected_plan))
+	{
+		Reject(key);
+		return;
+	}
+
+	PlanCacheAccessor acc(m_pcache);
+	acc.Lookup(key);
+	CPlanEntry *entry = acc.Val();
+	if (NULL != entry && EpsLiteralSensitive != entry->m_state)
+	{
+		entry->m_state = EpsVerified;
+		m_num_verified++;
+	}
+}
+
+//---------------------------------------------------------------------------
+//	@function:
+//		COptPlanCache::Reject
+//
+//	@doc:
+//		Record that the cached plan of a query can only be reused with the
+//		exact same literals
+//
+//---------------------------------------------------------------------------
+void
+COptPlanCache::Reject(CWStringDynamic *key)
+{
+	GPOS_ASSERT(NULL != m_pcache && "Plan cache was not created");
+
+	PlanCacheAccessor acc(m_pcache);
+	acc.Lookup(key);
+	CPlanEntry *entry = acc.Val();
+	if (NULL != entry && EpsLiteralSensitive != entry->m_state)
+	{
+		entry->m_state = EpsLiteralSensitive;
+		m_num_rejected++;
+	}
+}
+
+//---------------------------------------------------------------------------
+//	@function:
+//		COptPlanCache::GetStats
+//
+//	@doc:
+//		Get the counters of the cache
+//
+//---------------------------------------------------------------------------
+void
+COptPlanCache::GetStats(ULLONG *num_hits, ULLONG *num_misses,
+						ULLONG *num_inserts, ULLONG *num_verified,
+						ULLONG *num_rejected, ULLONG *num_evictions,
+						ULLONG *num_entries, ULLONG *size)
+{
+	*num_hits = m_num_hits;
+	*num_misses = m_num_misses;
+	*num_inserts = m_num_inserts;
+	*num_verified = m_num_verified;
+	*num_rejected = m_num_rejected;
+	*num_evictions = 0;
+	*num_entries = 0;
+	*size = 0;
+
+	if (NULL != m_pcache)
+	{
+		*num_evictions = m_pcache->GetEvictionCounter();
+		*num_entries = m_pcache->Size();
+		*size = m_pcache->TotalAllocatedSize();
+	}
+}
+
+// EOF
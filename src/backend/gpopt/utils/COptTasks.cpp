@@ -30,6 +30,7 @@
 #include "gpopt/translate/CTranslatorRelcacheToDXL.h"
 #include "gpopt/translate/CTranslatorUtils.h"
 #include "gpopt/utils/CConstExprEvaluatorProxy.h"
+#include "gpopt/utils/COptPlanCache.h"
 #include "gpopt/utils/gpdbdefs.h"
 
 #include "cdb/cdbvars.h"
@@ -67,6 +68,7 @@
 #include "naucrates/exception.h"
 #include "naucrates/init.h"
 #include "naucrates/md/CMDIdCast.h"
+#include "naucrates/md/CMDIdColStats.h"
 #include "naucrates/md/CMDIdRelStats.h"
 #include "naucrates/md/CMDIdScCmp.h"
 #include "naucrates/md/CSystemId.h"
@@ -83,7 +85,8 @@ using namespace gpdbcost;
 #define GPOPT_ERROR_BUFFER_SIZE 10 * 1024 * 1024
 
 // definition of default AutoMemoryPool
-#define AUTO_MEM_POOL(amp) CAutoMemoryPool amp(CAutoMemoryPool::ElcExc)
+#define AUTO_MEM_POOL(amp) \
+	CAutoMemoryPool amp(CAutoMemoryPool::ElcExc, optimizer_use_arena_allocator)
 
 // default id for the source system
 const CSystemId default_sysid(IMDId::EmdidGeneral, GPOS_WSZ_STR_LENGTH("GPDB"));
@@ -386,6 +389,8 @@ COptTasks::CreateOptimizerConfig(CMemoryPool *mp, ICostModel *cost_model)
 		(ULONG) optimizer_push_group_by_below_setop_threshold;
 	ULONG xform_bind_threshold = (ULONG) optimizer_xform_bind_threshold;
 	ULONG skew_factor = (ULONG) optimizer_skew_factor;
+	ULONG search_time_budget = (ULONG) optimizer_search_time_budget;
+	ULONG search_memory_budget = (ULONG) optimizer_search_memory_budget;
 
 	return GPOS_NEW(mp) COptimizerConfig(
 		GPOS_NEW(mp)
@@ -401,7 +406,7 @@ COptTasks::CreateOptimizerConfig(CMemoryPool *mp, ICostModel *cost_model)
 				  false, /* don't create Assert nodes for constraints, we'll
 								      * enforce them ourselves in the executor */
 				  push_group_by_below_setop_threshold, xform_bind_threshold,
-				  skew_factor),
+				  skew_factor, search_time_budget, search_memory_budget),
 		GPOS_NEW(mp) CWindowOids(OID(F_WINDOW_ROW_NUMBER), OID(F_WINDOW_RANK)));
 }
 
@@ -463,6 +468,63 @@ COptTasks::GetCostModel(CMemoryPool *mp, ULONG num_segments)
 	return cost_model;
 }
 
+//---------------------------------------------------------------------------
+//	@function:
+//		COptTasks::IsMDCacheObjectStale
+//
+//	@doc:
+//		Filter for CMDCache::Invalidate, selecting the cached objects that
+//		were affected by the catalog changes since the last optimization
+//
+//---------------------------------------------------------------------------
+BOOL
+COptTasks::IsMDCacheObjectStale(CMDKey *const &key, IMDCacheObject *const &obj,
+								void *  // arg
+)
+{
+	const IMDId *mdid = key->MDId();
+
+	switch (mdid->MdidType())
+	{
+		case IMDId::EmdidGeneral:
+		case IMDId::EmdidRel:
+		case IMDId::EmdidInd:
+		case IMDId::EmdidCheckConstraint:
+		case IMDId::EmdidGPDBCtas:
+			// changes to pg_trigger only invalidate the relation, not the
+			// trigger, so triggers go whenever anything changes
+			if (IMDCacheObject::EmdtTrigger == obj->MDType())
+			{
+				return true;
+			}
+			return gpdb::MDCacheOidInvalidated(
+				CMDIdGPDB::CastMdid(mdid)->Oid());
+
+		case IMDId::EmdidRelStats:
+			return gpdb::MDCacheOidInvalidated(
+				CMDIdGPDB::CastMdid(
+					CMDIdRelStats::CastMdid(mdid)->GetRelMdId())
+					->Oid());
+
+		case IMDId::EmdidColStats:
+		{
+			const CMDIdColStats *mdid_col_stats =
+				CMDIdColStats::CastMdid(mdid);
+			OID rel_oid =
+				CMDIdGPDB::CastMdid(mdid_col_stats->GetRelMdId())->Oid();
+
+			return gpdb::MDCacheOidInvalidated(rel_oid) ||
+				   gpdb::MDCacheColStatsInvalidated(
+					   rel_oid, (int) mdid_col_stats->Position());
+		}
+
+		default:
+			// casts and comparisons are looked up by a combination of types
+			// and operators, and are cheap to look up again
+			return true;
+	}
+}
+
 //---------------------------------------------------------------------------
 //	@function:
 //		COptTasks::OptimizeTask
@@ -484,6 +546,10 @@ COptTasks::OptimizeTask(void *ptr)
 	AUTO_MEM_POOL(amp);
 	CMemoryPool *mp = amp.Pmp();
 
+	// Snapshot the versions of the shared metadata cache. This accepts any
+	// pending invalidation messages, so do it before checking them below.
+	gpdb::SharedMDCacheBeginOptimization();
+
 	// Does the metadatacache need to be reset?
 	//
 	// On the first call, before the cache has been initialized, we
@@ -492,6 +558,35 @@ COptTasks::OptimizeTask(void *ptr)
 	// the invalidation mechanism.
 	bool reset_mdcache = gpdb::MDCacheNeedsReset();
 
+	// initialize the plan cache, or evict the plans affected by catalog
+	// changes. This must be done before the invalidations are cleared below.
+	if (0 == optimizer_plan_cache_size || !optimizer_metadata_caching)
+	{
+		COptPlanCache::Shutdown();
+	}
+	else if (!COptPlanCache::FInitialized())
+	{
+		COptPlanCache::Init();
+		COptPlanCache::SetCacheQuota(optimizer_plan_cache_size * 1024L);
+	}
+	else
+	{
+		if (reset_mdcache || !CMDCache::FInitialized())
+		{
+			COptPlanCache::Reset();
+		}
+		else if (gpdb::MDCacheHasInvalidations())
+		{
+			COptPlanCache::Invalidate();
+		}
+
+		if (COptPlanCache::GetCacheQuota() !=
+			(ULLONG) optimizer_plan_cache_size * 1024L)
+		{
+			COptPlanCache::SetCacheQuota(optimizer_plan_cache_size * 1024L);
+		}
+	}
+
 	// initialize metadata cache, or purge if needed, or change size if requested
 	if (!CMDCache::FInitialized())
 	{
@@ -503,6 +598,18 @@ COptTasks::OptimizeTask(void *ptr)
 		CMDCache::Reset();
 		CMDCache::SetCacheQuota(optimizer_mdcache_size * 1024L);
 	}
+	else if (gpdb::MDCacheHasInvalidations())
+	{
+		// evict only the objects affected by the catalog changes
+		CMDCache::Invalidate(IsMDCacheObjectStale, NULL);
+		gpdb::MDCacheClearInvalidations();
+
+		if (CMDCache::ULLGetCacheQuota() !=
+			(ULLONG) optimizer_mdcache_size * 1024L)
+		{
+			CMDCache::SetCacheQuota(optimizer_mdcache_size * 1024L);
+		}
+	}
 	else if (CMDCache::ULLGetCacheQuota() !=
 			 (ULLONG) optimizer_mdcache_size * 1024L)
 	{
@@ -522,6 +629,11 @@ COptTasks::OptimizeTask(void *ptr)
 	IMdIdArray *col_stats = NULL;
 	MdidHashSet *rel_stats = NULL;
 
+	CWStringDynamic *plan_cache_key = NULL;
+	StringPtrArray *plan_cache_literals = NULL;
+	BOOL plan_cache_generalizable = false;
+	CWStringDynamic *expected_plan = NULL;
+
 	GPOS_TRY
 	{
 		// set trace flags
@@ -557,6 +669,11 @@ COptTasks::OptimizeTask(void *ptr)
 			IConstExprEvaluator *expr_evaluator =
 				GPOS_NEW(mp) CConstExprEvaluatorDXL(mp, &mda, &expr_eval_proxy);
 
+			// The query is translated to DXL even when no minidump is taken:
+			// the plan cache key is built from the query DXL as well. No
+			// direct Query to CExpression translator is provided, as no
+			// measurement showed the DXL trees to cost enough to justify a
+			// second translator to keep in step with this one.
 			CDXLNode *query_dxl =
 				query_to_dxl_translator->TranslateQueryToDXL();
 			CDXLNodeArray *query_output_dxlnode_array =
@@ -570,17 +687,76 @@ COptTasks::OptimizeTask(void *ptr)
 				(!optimizer_enable_motions_masteronly_queries &&
 				 !query_to_dxl_translator->HasDistributedTables());
 			// See NoteDistributionPolicyOpclasses() in src/backend/gpopt/translate/CTranslatorQueryToDXL.cpp
+			DistributionHashOpsKind distribution_hashops =
+				query_to_dxl_translator->GetDistributionHashOpsKind();
 			BOOL use_legacy_opfamilies =
-				(query_to_dxl_translator->GetDistributionHashOpsKind() ==
-				 DistrUseLegacyHashOps);
+				(distribution_hashops == DistrUseLegacyHashOps);
 			CAutoTraceFlag atf1(EopttraceDisableMotions, is_master_only);
 			CAutoTraceFlag atf2(EopttraceUseLegacyOpfamilies,
 								use_legacy_opfamilies);
 
-			plan_dxl = COptimizer::PdxlnOptimize(
-				mp, &mda, query_dxl, query_output_dxlnode_array,
-				cte_dxlnode_array, expr_evaluator, num_segments, gp_session_id,
-				gp_command_count, search_strategy_arr, optimizer_config);
+			// Only plain SELECTs go through the plan cache. Nor is it used
+			// when the plan DXL or a minidump is asked for, as those are
+			// produced by the optimization itself.
+			COptPlanCache::ELookupResult plan_cache_result =
+				COptPlanCache::ElrSkip;
+			if (COptPlanCache::FInitialized() &&
+				CMD_SELECT == opt_ctxt->m_query->commandType &&
+				PARENTSTMTTYPE_NONE == opt_ctxt->m_query->parentStmtType &&
+				NIL == opt_ctxt->m_query->rowMarks &&
+				!opt_ctxt->m_should_serialize_plan_dxl &&
+				!GPOS_FTRACE(EopttraceMinidump))
+			{
+				plan_cache_literals = GPOS_NEW(mp) StringPtrArray(mp);
+				plan_cache_key = COptPlanCache::BuildKey(
+					mp, &mda, query_dxl, query_output_dxlnode_array,
+					cte_dxlnode_array, optimizer_config, num_segments,
+					plan_cache_literals, &plan_cache_generalizable);
+				plan_cache_result = COptPlanCache::Lookup(
+					mp, plan_cache_key, plan_cache_literals, &plan_dxl,
+					&expected_plan);
+			}
+
+			if (COptPlanCache::ElrHit != plan_cache_result)
+			{
+				plan_dxl = COptimizer::PdxlnOptimize(
+					mp, &mda, query_dxl, query_output_dxlnode_array,
+					cte_dxlnode_array, expr_evaluator, num_segments,
+					gp_session_id, gp_command_count, search_strategy_arr,
+					optimizer_config);
+
+				// a plan that depends on the values of stable functions at
+				// optimization time, or on how far the search got within its
+				// budget, is not reusable
+				BOOL is_reusable = !expr_eval_proxy.HasEvaluatedExpr() &&
+								   !optimizer_config->FSearchBudgetExceeded();
+				if (COptPlanCache::ElrMiss == plan_cache_result && is_reusable)
+				{
+					COptPlanCache::Insert(mp, &mda, plan_cache_key,
+										  plan_cache_literals,
+										  plan_cache_generalizable, plan_dxl,
+										  optimizer_config);
+				}
+				else if (COptPlanCache::ElrVerify == plan_cache_result)
+				{
+					if (!is_reusable)
+					{
+						COptPlanCache::Reject(plan_cache_key);
+					}
+					else
+					{
+						COptPlanCache::Verify(mp, plan_cache_key, plan_dxl,
+											  optimizer_config,
+											  expected_plan);
+					}
+				}
+			}
+
+			// the query DXL, and the mutated query the translator holds, are
+			// not needed to translate the plan; release them now rather than
+			// keep them alive through the plan translation
+			query_dxl->Release();
+			GPOS_DELETE(query_to_dxl_translator.Reset());
 
 			if (opt_ctxt->m_should_serialize_plan_dxl)
 			{
@@ -604,7 +780,23 @@ COptTasks::OptimizeTask(void *ptr)
 				opt_ctxt->m_plan_stmt =
 					(PlannedStmt *) gpdb::CopyObject(ConvertToPlanStmtFromDXL(
 						mp, &mda, plan_dxl, opt_ctxt->m_query->canSetTag,
-						query_to_dxl_translator->GetDistributionHashOpsKind()));
+						distribution_hashops));
+
+				// report how far the search got within its budget
+				if (COptPlanCache::ElrHit != plan_cache_result &&
+					(0 < optimizer_search_time_budget ||
+					 0 < optimizer_search_memory_budget))
+				{
+					PlannedStmt *plan_stmt = opt_ctxt->m_plan_stmt;
+					plan_stmt->optimizerSearchStage =
+						(int) optimizer_config->UlSearchStagesCompleted();
+					plan_stmt->optimizerSearchStages =
+						(int) optimizer_config->UlSearchStages();
+					plan_stmt->optimizerSearchTime =
+						(int) optimizer_config->UlSearchTime();
+					plan_stmt->optimizerSearchBudgetExceeded =
+						optimizer_config->FSearchBudgetExceeded();
+				}
 			}
 
 			CStatisticsConfig *stats_conf = optimizer_config->GetStatsConf();
@@ -616,9 +808,11 @@ COptTasks::OptimizeTask(void *ptr)
 
 			rel_stats->Release();
 			col_stats->Release();
+			GPOS_DELETE(plan_cache_key);
+			CRefCount::SafeRelease(plan_cache_literals);
+			GPOS_DELETE(expected_plan);
 
 			expr_evaluator->Release();
-			query_dxl->Release();
 			optimizer_config->Release();
 			plan_dxl->Release();
 		}
@@ -633,6 +827,7 @@ COptTasks::OptimizeTask(void *ptr)
 		CRefCount::SafeRelease(trace_flags);
 		CRefCount::SafeRelease(plan_dxl);
 		CMDCache::Shutdown();
+		COptPlanCache::Shutdown();
 
 		IErrorContext *errctxt = CTask::Self()->GetErrCtxt();
 
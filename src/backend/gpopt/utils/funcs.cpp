@@ -18,13 +18,16 @@
 extern "C" {
 #include "postgres.h"
 
+#include "access/htup_details.h"
 #include "fmgr.h"
+#include "funcapi.h"
 #include "utils/builtins.h"
 }
 
 #include "gpos/_api.h"
 
 #include "gpopt/gpdbwrappers.h"
+#include "gpopt/utils/COptPlanCache.h"
 #include "gpopt/utils/COptTasks.h"
 #include "gpopt/utils/funcs.h"
 
@@ -116,3 +119,39 @@ LibraryVersion()
 	PG_RETURN_TEXT_P(result);
 }
 }
+
+//---------------------------------------------------------------------------
+//	@function:
+//		PlanCacheStats
+//
+//	@doc:
+//		Returns the counters of the plan cache of this session
+//
+//---------------------------------------------------------------------------
+extern "C" {
+Datum
+PlanCacheStats(PG_FUNCTION_ARGS)
+{
+	TupleDesc tupdesc;
+	ULLONG counters[8];
+	Datum values[8];
+	bool nulls[8];
+
+	if (get_call_result_type(fcinfo, NULL, &tupdesc) != TYPEFUNC_COMPOSITE)
+		elog(ERROR, "return type must be a row type");
+
+	COptPlanCache::GetStats(&counters[0], &counters[1], &counters[2],
+							&counters[3], &counters[4], &counters[5],
+							&counters[6], &counters[7]);
+
+	for (int i = 0; i < 8; i++)
+	{
+		values[i] = Int64GetDatum((int64) counters[i]);
+		nulls[i] = false;
+	}
+
+	HeapTuple tuple = heap_form_tuple(BlessTupleDesc(tupdesc), values, nulls);
+
+	PG_RETURN_DATUM(HeapTupleGetDatum(tuple));
+}
+}
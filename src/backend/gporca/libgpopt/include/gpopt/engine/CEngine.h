@@ -12,6 +12,7 @@
 #define GPOPT_CEngine_H
 
 #include "gpos/base.h"
+#include "gpos/common/CWallClock.h"
 
 #include "gpopt/search/CMemo.h"
 #include "gpopt/search/CSearchStage.h"
@@ -60,6 +61,26 @@ private:
 	// memo table
 	CMemo *m_pmemo;
 
+	// wall clock time since the search started
+	CWallClock m_timerSearch;
+
+	// time budget of the search in milliseconds, 0 for no limit
+	ULONG m_ulSearchTimeBudget;
+
+	// memory budget of the search in bytes, 0 for no limit
+	ULLONG m_ullSearchMemoryBudget;
+
+	// has the search used up its budget?
+	BOOL m_fSearchBudgetExceeded;
+
+	// number of group expressions pruned by cost bounds before optimizing
+	// any of their children
+	ULONG m_ulPrunedBeforeChildren;
+
+	// number of group expressions pruned by cost bounds after optimizing
+	// some of their children
+	ULONG m_ulPrunedAfterChildren;
+
 	//  pattern used for adding enforcers
 	CExpression *m_pexprEnforcerPattern;
 
@@ -159,8 +180,11 @@ private:
 	BOOL
 	FSearchTerminated() const
 	{
-		// at least one stage has completed and achieved required cost
-		return (NULL != PssPrevious() && PssPrevious()->FAchievedReqdCost());
+		// at least one stage has completed and achieved required cost, or
+		// found a plan before the search used up its budget
+		return (NULL != PssPrevious() &&
+				(PssPrevious()->FAchievedReqdCost() ||
+				 (m_fSearchBudgetExceeded && NULL != PssPrevious()->PexprBest())));
 	}
 
 	// generate random plan id
@@ -353,6 +377,9 @@ public:
 		return m_search_stage_array->Size();
 	}
 
+	// check if the search has used up its time or memory budget
+	BOOL FSearchBudgetExceeded();
+
 	// set of xforms of current stage
 	CXformSet *
 	PxfsCurrentStage() const
@@ -382,7 +409,23 @@ public:
 	// determine if a plan, rooted by given group expression, can be safely pruned based on cost bounds
 	BOOL FSafeToPrune(CGroupExpression *pgexpr, CReqdPropPlan *prpp,
 					  CCostContext *pccChild, ULONG child_index,
-					  CCost *pcostLowerBound);
+					  CCostContextArray *pdrgpccPrev, CCost *pcostLowerBound);
+
+	// number of group expressions pruned by cost bounds before optimizing
+	// any of their children
+	ULONG
+	UlPrunedBeforeChildren() const
+	{
+		return m_ulPrunedBeforeChildren;
+	}
+
+	// number of group expressions pruned by cost bounds after optimizing
+	// some of their children
+	ULONG
+	UlPrunedAfterChildren() const
+	{
+		return m_ulPrunedAfterChildren;
+	}
 
 	// print
 	IOstream &OsPrint(IOstream &) const;
@@ -20,6 +20,8 @@
 #define PUSH_GROUP_BY_BELOW_SETOP_THRESHOLD ULONG(10)
 #define XFORM_BIND_THRESHOLD ULONG(0)
 #define SKEW_FACTOR ULONG(0)
+#define SEARCH_TIME_BUDGET ULONG(0)
+#define SEARCH_MEMORY_BUDGET ULONG(0)
 
 
 namespace gpopt
@@ -55,13 +57,18 @@ private:
 	CHint(const CHint &);
 	ULONG m_ulSkewFactor;
 
+	ULONG m_ulSearchTimeBudget;
+
+	ULONG m_ulSearchMemoryBudget;
+
 public:
 	// ctor
 	CHint(ULONG join_arity_for_associativity_commutativity,
 		  ULONG array_expansion_threshold, ULONG ulJoinOrderDPLimit,
 		  ULONG broadcast_threshold, BOOL enforce_constraint_on_dml,
 		  ULONG push_group_by_below_setop_threshold, ULONG xform_bind_threshold,
-		  ULONG skew_factor)
+		  ULONG skew_factor, ULONG search_time_budget = SEARCH_TIME_BUDGET,
+		  ULONG search_memory_budget = SEARCH_MEMORY_BUDGET)
 		: m_ulJoinArityForAssociativityCommutativity(
 			  join_arity_for_associativity_commutativity),
 		  m_ulArrayExpansionThreshold(array_expansion_threshold),
@@ -71,7 +78,9 @@ public:
 		  m_ulPushGroupByBelowSetopThreshold(
 			  push_group_by_below_setop_threshold),
 		  m_ulXform_bind_threshold(xform_bind_threshold),
-		  m_ulSkewFactor(skew_factor)
+		  m_ulSkewFactor(skew_factor),
+		  m_ulSearchTimeBudget(search_time_budget),
+		  m_ulSearchMemoryBudget(search_memory_budget)
 	{
 	}
 
@@ -143,6 +152,22 @@ public:
 		return m_ulSkewFactor;
 	}
 
+	// Stop exploring alternatives once the search has taken this many
+	// milliseconds, 0 for no limit
+	ULONG
+	UlSearchTimeBudget() const
+	{
+		return m_ulSearchTimeBudget;
+	}
+
+	// Stop exploring alternatives once the optimizer memory pool holds this
+	// many KB, 0 for no limit
+	ULONG
+	UlSearchMemoryBudget() const
+	{
+		return m_ulSearchMemoryBudget;
+	}
+
 	// generate default hint configurations, which disables sort during insert on
 	// append only row-oriented partitioned tables by default
 	static CHint *
@@ -156,7 +181,9 @@ public:
 			true,								 /* enforce_constraint_on_dml */
 			PUSH_GROUP_BY_BELOW_SETOP_THRESHOLD, /* push_group_by_below_setop_threshold */
 			XFORM_BIND_THRESHOLD,				 /* xform_bind_threshold */
-			SKEW_FACTOR							 /* skew_factor */
+			SKEW_FACTOR,						 /* skew_factor */
+			SEARCH_TIME_BUDGET,					 /* search_time_budget */
+			SEARCH_MEMORY_BUDGET				 /* search_memory_budget */
 		);
 	}
 
@@ -20,6 +20,7 @@
 #include "gpos/base.h"
 #include "gpos/common/CRefCount.h"
 
+#include "gpopt/base/CCostContext.h"
 #include "gpopt/base/CReqdProp.h"
 #include "gpopt/cost/ICostModel.h"
 
@@ -29,7 +30,6 @@ using namespace gpos;
 
 class CGroupExpression;
 class CCost;
-class CCostContext;
 
 //---------------------------------------------------------------------------
 //	@class:
@@ -54,6 +54,10 @@ private:
 	// index of known child plan
 	ULONG m_ulChildIndex;
 
+	// cost contexts of the children optimized before the known child, in
+	// optimization order -- can be null if only one child plan is known
+	CCostContextArray *m_pdrgpccPrev;
+
 	// private copy ctor
 	CPartialPlan(const CPartialPlan &);
 
@@ -68,7 +72,8 @@ private:
 public:
 	// ctor
 	CPartialPlan(CGroupExpression *pgexpr, CReqdPropPlan *prpp,
-				 CCostContext *pccChild, ULONG child_index);
+				 CCostContext *pccChild, ULONG child_index,
+				 CCostContextArray *pdrgpccPrev);
 
 	// dtor
 	virtual ~CPartialPlan();
@@ -101,6 +106,13 @@ public:
 		return m_ulChildIndex;
 	}
 
+	// accessor of the cost contexts of previously optimized children
+	CCostContextArray *
+	PdrgpccPrev() const
+	{
+		return m_pdrgpccPrev;
+	}
+
 	// compute partial plan cost
 	CCost CostCompute(CMemoryPool *mp);
 
@@ -368,6 +368,9 @@ public:
 	// serialize object to passed stream
 	void Serialize(COstream &oos);
 
+	// mdids of all the objects accessed so far
+	IMdIdArray *GetAccessedMDIds(CMemoryPool *mp);
+
 	// serialize system ids to passed stream
 	void SerializeSysid(COstream &oos);
 };
@@ -79,6 +79,10 @@ public:
 	// reset global instance
 	static void Reset();
 
+	// delete the objects selected by the filter, return how many were deleted
+	static ULONG Invalidate(CMDAccessor::MDCache::FilterFuncPtr filter,
+							void *arg);
+
 	// global accessor
 	static CMDAccessor::MDCache *
 	Pcache()
@@ -65,6 +65,24 @@ private:
 	// default window oids
 	CWindowOids *m_window_oids;
 
+	// number of search stages completed by the last optimization
+	ULONG m_search_stages_completed;
+
+	// number of search stages of the last optimization
+	ULONG m_search_stages;
+
+	// duration of the search of the last optimization, in milliseconds
+	ULONG m_search_time;
+
+	// did the last optimization stop exploring because of a search budget?
+	BOOL m_search_budget_exceeded;
+
+	// number of memo groups of the last optimization
+	ULONG m_memo_groups;
+
+	// number of optimization jobs of the last optimization
+	ULLONG m_jobs;
+
 public:
 	// ctor
 	COptimizerConfig(CEnumeratorConfig *pec, CStatisticsConfig *stats_config,
@@ -117,6 +135,62 @@ public:
 		return m_hint;
 	}
 
+	// record the outcome of the search of an optimization
+	void
+	SetSearchOutcome(ULONG search_stages_completed, ULONG search_stages,
+					 ULONG search_time, BOOL search_budget_exceeded,
+					 ULONG memo_groups, ULLONG jobs)
+	{
+		m_search_stages_completed = search_stages_completed;
+		m_search_stages = search_stages;
+		m_search_time = search_time;
+		m_search_budget_exceeded = search_budget_exceeded;
+		m_memo_groups = memo_groups;
+		m_jobs = jobs;
+	}
+
+	// number of search stages completed by the last optimization
+	ULONG
+	UlSearchStagesCompleted() const
+	{
+		return m_search_stages_completed;
+	}
+
+	// number of search stages of the last optimization
+	ULONG
+	UlSearchStages() const
+	{
+		return m_search_stages;
+	}
+
+	// duration of the search of the last optimization, in milliseconds
+	ULONG
+	UlSearchTime() const
+	{
+		return m_search_time;
+	}
+
+	// did the last optimization stop exploring because of a search budget?
+	BOOL
+	FSearchBudgetExceeded() const
+	{
+		return m_search_budget_exceeded;
+	}
+
+	// number of memo groups of the last optimization
+	ULONG
+	UlMemoGroups() const
+	{
+		return m_memo_groups;
+	}
+
+	// number of optimization jobs of the last optimization
+	ULLONG
+	UllJobs() const
+	{
+		return m_jobs;
+	}
+
 	// generate default optimizer configurations
 	static COptimizerConfig *PoconfDefault(CMemoryPool *mp);
 
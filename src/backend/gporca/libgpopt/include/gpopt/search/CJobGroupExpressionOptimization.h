@@ -90,6 +90,10 @@ private:
 	// array of derived properties of optimal implementations of child groups
 	CDrvdPropArray *m_pdrgpdp;
 
+	// cost contexts of optimal implementations of child groups, used to
+	// tighten the cost lower bound as children get optimized
+	CCostContextArray *m_pdrgpccChildren;
+
 	// optimization order of children
 	CPhysical::EChildExecOrder m_eceo;
 
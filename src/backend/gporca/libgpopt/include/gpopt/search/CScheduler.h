@@ -51,6 +51,11 @@ class CSchedulerContext;
 //		complete. At this point, a queued job can be terminated if it does not
 //		have any further dependencies.
 //
+//		Although the job state machines are designed for concurrent workers,
+//		all jobs are run by the single worker of the optimizing backend, and
+//		the job queues, the memo and its groups are not synchronized; see
+//		CWorkerPoolManager.
+//
 //---------------------------------------------------------------------------
 class CScheduler
 {
@@ -188,6 +193,13 @@ public:
 	// print statistics
 	void PrintStats() const;
 
+	// number of jobs completed so far
+	ULONG_PTR
+	UlpCompleted() const
+	{
+		return m_ulpStatsCompleted;
+	}
+
 #ifdef GPOS_DEBUG
 	// get flag for tracking jobs
 	BOOL
@@ -494,6 +494,10 @@ public:
 	// return true if xform is a subquery unnesting xform
 	static BOOL FSubqueryUnnesting(CXform *pxform);
 
+	// return true if some operators cannot be implemented without
+	// applying the xform
+	static BOOL FRequiredForImplementation(CXform *pxform);
+
 	// return true if xform should be applied to the next binding
 	static BOOL FApplyToNextBinding(CXform *pxform,
 									CExpression *pexprLastBinding);
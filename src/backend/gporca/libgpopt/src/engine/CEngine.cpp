@@ -28,6 +28,7 @@
 #include "gpopt/base/CReqdPropPlan.h"
 #include "gpopt/base/CReqdPropRelational.h"
 #include "gpopt/engine/CEnumeratorConfig.h"
+#include "gpopt/engine/CHint.h"
 #include "gpopt/engine/CStatisticsConfig.h"
 #include "gpopt/exception.h"
 #include "gpopt/minidump/CSerializableStackTrace.h"
@@ -80,6 +81,11 @@ CEngine::CEngine(CMemoryPool *mp)
 	  m_search_stage_array(NULL),
 	  m_ulCurrSearchStage(0),
 	  m_pmemo(NULL),
+	  m_ulSearchTimeBudget(0),
+	  m_ullSearchMemoryBudget(0),
+	  m_fSearchBudgetExceeded(false),
+	  m_ulPrunedBeforeChildren(0),
+	  m_ulPrunedAfterChildren(0),
 	  m_pexprEnforcerPattern(NULL),
 	  m_xforms(NULL),
 	  m_pdrgpulpXformCalls(NULL),
@@ -169,6 +175,10 @@ CEngine::Init(CQueryContext *pqc, CSearchStageArray *search_stage_array)
 	}
 	GPOS_ASSERT(0 < m_search_stage_array->Size());
 
+	CHint *phint = COptCtxt::PoctxtFromTLS()->GetOptimizerConfig()->GetHint();
+	m_ulSearchTimeBudget = phint->UlSearchTimeBudget();
+	m_ullSearchMemoryBudget = (ULLONG) phint->UlSearchMemoryBudget() * 1024;
+
 	if (GPOS_FTRACE(EopttracePrintOptimizationStatistics))
 	{
 		// initialize per-stage xform calls array
@@ -616,13 +626,17 @@ CEngine::FSafeToPruneWithDPEStats(CGroupExpression *pgexpr,
 //
 //	@doc:
 //		Determine if a plan rooted by given group expression can be safely
-//		pruned during optimization
+//		pruned during optimization; the best plan of the group for the given
+//		properties is the upper bound, and the lower bound uses the plans of
+//		the children optimized so far, if any
 //
 //---------------------------------------------------------------------------
 BOOL
 CEngine::FSafeToPrune(
 	CGroupExpression *pgexpr, CReqdPropPlan *prpp, CCostContext *pccChild,
 	ULONG child_index,
+	CCostContextArray *
+		pdrgpccPrev,  // children optimized before the given child, if any
 	CCost *pcostLowerBound	// output: a lower bound on plan's cost
 )
 {
@@ -650,12 +664,21 @@ CEngine::FSafeToPrune(
 	if (NULL != pocGroup && NULL != pocGroup->PccBest())
 	{
 		// compute a cost lower bound for the equivalent plan rooted by given group expression
-		CCost costLowerBound =
-			pgexpr->CostLowerBound(m_mp, prpp, pccChild, child_index);
+		CCost costLowerBound = pgexpr->CostLowerBound(m_mp, prpp, pccChild,
+													  child_index, pdrgpccPrev);
 		*pcostLowerBound = costLowerBound;
 		if (costLowerBound > pocGroup->PccBest()->Cost())
 		{
 			// group expression cannot deliver a better plan for given properties and can be safely pruned
+			if (NULL == pccChild)
+			{
+				m_ulPrunedBeforeChildren++;
+			}
+			else
+			{
+				m_ulPrunedAfterChildren++;
+			}
+
 			return true;
 		}
 	}
@@ -1000,7 +1023,7 @@ CEngine::PccOptimizeChild(
 	CCost costLowerBound(GPOPT_INVALID_COST);
 	if (exprhdl.UlFirstOptimizedChildIndex() == child_index &&
 		FSafeToPrune(pgexpr, pocOrigin->Prpp(), pccChildBest, child_index,
-					 &costLowerBound))
+					 NULL /*pdrgpccPrev*/, &costLowerBound))
 	{
 		// failed to optimize child due to cost bounding
 		(void) pgexpr->PccComputeCost(m_mp, pocOrigin, ulOptReq,
@@ -1129,7 +1152,8 @@ CEngine::OptimizeGroupExpression(CGroupExpression *pgexpr,
 		// check if group expression optimization can be early terminated without optimizing any child
 		CCost costLowerBound(GPOPT_INVALID_COST);
 		if (FSafeToPrune(pgexpr, poc->Prpp(), NULL /*pccChild*/,
-						 gpos::ulong_max /*child_index*/, &costLowerBound))
+						 gpos::ulong_max /*child_index*/, NULL /*pdrgpccPrev*/,
+						 &costLowerBound))
 		{
 			(void) pgexpr->PccComputeCost(m_mp, poc, ul, NULL /*pdrgpoc*/,
 										  true /*fPruned*/, costLowerBound);
@@ -1518,6 +1542,42 @@ CEngine::FinalizeImplementation()
 	}
 }
 
+//---------------------------------------------------------------------------
+//	@function:
+//		CEngine::FSearchBudgetExceeded
+//
+//	@doc:
+//		Check if the search has used up its time or memory budget; once it
+//		has, no more alternatives are explored, and the search only
+//		completes the plans of the alternatives found so far. Operators
+//		that cannot be implemented as such, like n-ary joins, are still
+//		transformed, see CXformUtils::FRequiredForImplementation
+//
+//---------------------------------------------------------------------------
+BOOL
+CEngine::FSearchBudgetExceeded()
+{
+	if (!m_fSearchBudgetExceeded &&
+		((0 < m_ulSearchTimeBudget &&
+		  m_timerSearch.ElapsedMS() > m_ulSearchTimeBudget) ||
+		 (0 < m_ullSearchMemoryBudget &&
+		  m_mp->TotalAllocatedSize() > m_ullSearchMemoryBudget)))
+	{
+		m_fSearchBudgetExceeded = true;
+
+		if (GPOS_FTRACE(EopttracePrintOptimizationStatistics))
+		{
+			CAutoTrace at(m_mp);
+			at.Os() << "[OPT]: Search budget exceeded at stage "
+					<< m_ulCurrSearchStage << " after "
+					<< m_timerSearch.ElapsedMS() << " msec";
+		}
+	}
+
+	return m_fSearchBudgetExceeded;
+}
+
+
 //---------------------------------------------------------------------------
 //	@function:
 //		CEngine::FinalizeSearchStage
@@ -1602,7 +1662,9 @@ CEngine::OsPrintMemoryConsumption(IOstream &os, const CHAR *szHeader) const
 	   << (DOUBLE)(
 			  CMemoryPoolManager::GetMemoryPoolMgr()->TotalAllocatedSize()) /
 			  GPOPT_MEM_UNIT
-	   << "] " << GPOPT_MEM_UNIT_NAME;
+	   << "] " << GPOPT_MEM_UNIT_NAME << ", Engine allocations: ["
+	   << m_mp->NumAllocations() << "], Engine frees: [" << m_mp->NumFrees()
+	   << "]";
 
 	return os;
 }
@@ -1658,6 +1720,11 @@ CEngine::ProcessTraceFlags()
 					<< " was found";
 		}
 
+		at.Os() << std::endl
+				<< "[OPT]: Cost bounds pruned " << m_ulPrunedBeforeChildren
+				<< " group expressions before optimizing their children, "
+				<< m_ulPrunedAfterChildren << " after optimizing some of them";
+
 		PrintActivatedXforms(at.Os());
 
 		(void) OsPrintMemoryConsumption(
@@ -1695,6 +1762,8 @@ CEngine::Optimize()
 	CSchedulerContext sc;
 	sc.Init(m_mp, &jf, &sched, this);
 
+	m_timerSearch.Restart();
+
 	const ULONG ulSearchStages = m_search_stage_array->Size();
 	for (ULONG ul = 0; !FSearchTerminated() && ul < ulSearchStages; ul++)
 	{
@@ -1725,8 +1794,15 @@ CEngine::Optimize()
 		PssCurrent()->SetBestExpr(pexprPlan);
 
 		FinalizeSearchStage();
+
+		// the budget may have run out after the last exploration
+		(void) FSearchBudgetExceeded();
 	}
 
+	optimizer_config->SetSearchOutcome(
+		m_ulCurrSearchStage, ulSearchStages, m_timerSearch.ElapsedMS(),
+		m_fSearchBudgetExceeded, (ULONG) m_pmemo->UlpGroups(),
+		sched.UlpCompleted());
 
 	if (GPOS_FTRACE(EopttracePrintOptimizationStatistics))
 	{
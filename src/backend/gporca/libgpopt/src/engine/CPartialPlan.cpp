@@ -32,16 +32,18 @@ using namespace gpopt;
 //
 //---------------------------------------------------------------------------
 CPartialPlan::CPartialPlan(CGroupExpression *pgexpr, CReqdPropPlan *prpp,
-						   CCostContext *pccChild,
-						   ULONG child_index)
+						   CCostContext *pccChild, ULONG child_index,
+						   CCostContextArray *pdrgpccPrev)
 	: m_pgexpr(pgexpr),	 // not owned
 	  m_prpp(prpp),
 	  m_pccChild(pccChild),	 // cost context of an already optimized child
-	  m_ulChildIndex(child_index)
+	  m_ulChildIndex(child_index),
+	  m_pdrgpccPrev(pdrgpccPrev)
 {
 	GPOS_ASSERT(NULL != pgexpr);
 	GPOS_ASSERT(NULL != prpp);
 	GPOS_ASSERT_IMP(NULL != pccChild, child_index < pgexpr->Arity());
+	GPOS_ASSERT_IMP(NULL != pdrgpccPrev, NULL != pccChild);
 }
 
 
@@ -57,6 +59,7 @@ CPartialPlan::~CPartialPlan()
 {
 	m_prpp->Release();
 	CRefCount::SafeRelease(m_pccChild);
+	CRefCount::SafeRelease(m_pdrgpccPrev);
 }
 
 //---------------------------------------------------------------------------
@@ -77,6 +80,35 @@ CPartialPlan::ExtractChildrenCostingInfo(CMemoryPool *mp, ICostModel *pcm,
 	GPOS_ASSERT_IMP(NULL != m_pccChild, m_ulChildIndex < exprhdl.Arity());
 
 	const ULONG arity = m_pgexpr->Arity();
+
+	// map children with known plans to their cost contexts
+	CCostContext **rgpccKnown = GPOS_NEW_ARRAY(mp, CCostContext *, arity);
+	for (ULONG ul = 0; ul < arity; ul++)
+	{
+		rgpccKnown[ul] = NULL;
+	}
+	if (NULL != m_pccChild)
+	{
+		rgpccKnown[m_ulChildIndex] = m_pccChild;
+	}
+	if (NULL != m_pdrgpccPrev)
+	{
+		// previous children were optimized in the order of the handle,
+		// skipping scalar children
+		ULONG ulPos = 0;
+		ULONG child_index = exprhdl.UlFirstOptimizedChildIndex();
+		do
+		{
+			if (!(*m_pgexpr)[child_index]->FScalar() &&
+				ulPos < m_pdrgpccPrev->Size())
+			{
+				rgpccKnown[child_index] = (*m_pdrgpccPrev)[ulPos];
+				ulPos++;
+			}
+		} while (ulPos < m_pdrgpccPrev->Size() &&
+				 exprhdl.FNextChildIndex(&child_index));
+	}
+
 	ULONG ulIndex = 0;
 	for (ULONG ul = 0; ul < arity; ul++)
 	{
@@ -91,18 +123,19 @@ CPartialPlan::ExtractChildrenCostingInfo(CMemoryPool *mp, ICostModel *pcm,
 		IStatistics *child_stats = pgroupChild->Pstats();
 		RaiseExceptionIfStatsNull(child_stats);
 
-		if (ul == m_ulChildIndex)
+		CCostContext *pccChild = rgpccKnown[ul];
+		if (NULL != pccChild)
 		{
 			// we have reached a child with a known plan,
 			// we have perfect costing information about this child
 
 			// use stats in provided child context
-			child_stats = m_pccChild->Pstats();
+			child_stats = pccChild->Pstats();
 
 			// use provided child cost context to collect accurate costing info
 			DOUBLE dRowsChild = child_stats->Rows().Get();
 			if (CDistributionSpec::EdptPartitioned ==
-				m_pccChild->Pdpplan()->Pds()->Edpt())
+				pccChild->Pdpplan()->Pds()->Edpt())
 			{
 				// scale statistics row estimate by number of segments
 				dRowsChild = pcm->DRowsPerHost(CDouble(dRowsChild)).Get();
@@ -113,7 +146,7 @@ CPartialPlan::ExtractChildrenCostingInfo(CMemoryPool *mp, ICostModel *pcm,
 				child_stats->Width(mp, prppChild->PcrsRequired()).Get();
 			pci->SetChildWidth(ulIndex, dWidthChild);
 			pci->SetChildRebinds(ulIndex, child_stats->NumRebinds().Get());
-			pci->SetChildCost(ulIndex, m_pccChild->Cost().Get());
+			pci->SetChildCost(ulIndex, pccChild->Cost().Get());
 
 			// continue with next child
 			ulIndex++;
@@ -139,6 +172,8 @@ CPartialPlan::ExtractChildrenCostingInfo(CMemoryPool *mp, ICostModel *pcm,
 		// advance to next child
 		ulIndex++;
 	}
+
+	GPOS_DELETE_ARRAY(rgpccKnown);
 }
 
 
@@ -299,6 +334,22 @@ CPartialPlan::Equals(const CPartialPlan *pppFst, const CPartialPlan *pppSnd)
 		fEqual = (pppFst->PccChild() == pppSnd->PccChild());
 	}
 
+	CCostContextArray *pdrgpccFst = pppFst->PdrgpccPrev();
+	CCostContextArray *pdrgpccSnd = pppSnd->PdrgpccPrev();
+	if (NULL == pdrgpccFst || NULL == pdrgpccSnd)
+	{
+		fEqual = fEqual && (NULL == pdrgpccFst && NULL == pdrgpccSnd);
+	}
+	else
+	{
+		const ULONG size = pdrgpccFst->Size();
+		fEqual = fEqual && size == pdrgpccSnd->Size();
+		for (ULONG ul = 0; fEqual && ul < size; ul++)
+		{
+			fEqual = ((*pdrgpccFst)[ul] == (*pdrgpccSnd)[ul]);
+		}
+	}
+
 	return fEqual && pppFst->UlChildIndex() == pppSnd->UlChildIndex() &&
 		   pppFst->Pgexpr() ==
 			   pppSnd->Pgexpr() &&	// use pointers for fast comparison
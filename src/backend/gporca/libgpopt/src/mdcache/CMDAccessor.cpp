@@ -1258,6 +1258,49 @@ CMDAccessor::Serialize(COstream &oos)
 		oos << cacheEntries[ul]->GetStrRepr()->GetBuffer();
 }
 
+//---------------------------------------------------------------------------
+//	@function:
+//		CMDAccessor::GetAccessedMDIds
+//
+//	@doc:
+//		Return the mdids of all the objects accessed so far, e.g. to find
+//		out what metadata a plan depends on
+//
+//---------------------------------------------------------------------------
+IMdIdArray *
+CMDAccessor::GetAccessedMDIds(CMemoryPool *mp)
+{
+	ULONG nentries = m_shtCacheAccessors.Size();
+	IMDId **mdids;
+	CAutoRg<IMDId *> a_mdids;
+	ULONG ul;
+
+	// as in Serialize(), don't allocate memory while iterating
+	mdids = GPOS_NEW_ARRAY(m_mp, IMDId *, nentries);
+	a_mdids = mdids;
+	{
+		MDHTIter mdhtit(m_shtCacheAccessors);
+		ul = 0;
+		while (mdhtit.Advance())
+		{
+			MDHTIterAccessor mdhtitacc(mdhtit);
+			SMDAccessorElem *pmdaccelem = mdhtitacc.Value();
+			GPOS_ASSERT(NULL != pmdaccelem);
+			mdids[ul++] = pmdaccelem->MDId();
+		}
+		GPOS_ASSERT(ul == nentries);
+	}
+
+	IMdIdArray *mdid_array = GPOS_NEW(mp) IMdIdArray(mp, nentries);
+	for (ul = 0; ul < nentries; ul++)
+	{
+		mdids[ul]->AddRef();
+		mdid_array->Append(mdids[ul]);
+	}
+
+	return mdid_array;
+}
+
 //---------------------------------------------------------------------------
 //	@function:
 //		CMDAccessor::SerializeSysid
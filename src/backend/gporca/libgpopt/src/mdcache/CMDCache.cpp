@@ -129,4 +129,26 @@ CMDCache::Reset()
 	Init();
 }
 
+//---------------------------------------------------------------------------
+//	@function:
+//		CMDCache::Invalidate
+//
+//	@doc:
+//		Delete the cached objects selected by the given filter, leaving the
+//		rest of the cache intact
+//
+//---------------------------------------------------------------------------
+ULONG
+CMDCache::Invalidate(CMDAccessor::MDCache::FilterFuncPtr filter, void *arg)
+{
+	GPOS_ASSERT(NULL != m_pcache && "Metadata cache was not created");
+
+	CAutoTraceFlag atf1(EtraceSimulateOOM, false);
+	CAutoTraceFlag atf2(EtraceSimulateAbort, false);
+	CAutoTraceFlag atf3(EtraceSimulateIOError, false);
+	CAutoTraceFlag atf4(EtraceSimulateNetError, false);
+
+	return m_pcache->DeleteEntries(filter, arg);
+}
+
 // EOF
@@ -269,11 +269,21 @@ COptimizer::PdxlnOptimize(
 	CErrorHandlerStandard errhdl;
 	GPOS_TRY_HDL(&errhdl)
 	{
-		CSerializableStackTrace serStack;
-		CSerializableOptimizerConfig serOptConfig(mp, optimizer_config);
-		CSerializableMDAccessor serMDA(md_accessor);
-		CSerializableQuery serQuery(mp, query, query_output_dxlnode_array,
-									cte_producers);
+		// the inputs are only registered for serialization when a minidump
+		// is requested, as nothing else reads them back
+		CAutoP<CSerializableStackTrace> serStack;
+		CAutoP<CSerializableOptimizerConfig> serOptConfig;
+		CAutoP<CSerializableMDAccessor> serMDA;
+		CAutoP<CSerializableQuery> serQuery;
+		if (fMinidump)
+		{
+			serStack = GPOS_NEW(mp) CSerializableStackTrace();
+			serOptConfig =
+				GPOS_NEW(mp) CSerializableOptimizerConfig(mp, optimizer_config);
+			serMDA = GPOS_NEW(mp) CSerializableMDAccessor(md_accessor);
+			serQuery = GPOS_NEW(mp) CSerializableQuery(
+				mp, query, query_output_dxlnode_array, cte_producers);
+		}
 
 		{
 			optimizer_config->AddRef();
@@ -285,7 +295,8 @@ COptimizer::PdxlnOptimize(
 			// install opt context in TLS
 			CAutoOptCtxt aoc(mp, md_accessor, pceeval, optimizer_config);
 
-			// translate DXL Tree -> Expr Tree
+			// translate DXL Tree -> Expr Tree; the plan is returned as DXL
+			// too, which the caller caches or translates to its own plan
 			CTranslatorDXLToExpr dxltr(mp, md_accessor);
 			CExpression *pexprTranslated = dxltr.PexprTranslateQuery(
 				query, query_output_dxlnode_array, cte_producers);
@@ -300,9 +311,6 @@ COptimizer::PdxlnOptimize(
 
 			PrintQueryOrPlan(mp, pexprTranslated, pqc);
 
-			CWStringDynamic strTrace(mp);
-			COstreamString oss(&strTrace);
-
 			// if the number of inlinable CTEs is greater than the cutoff, then
 			// disable inlining for this query
 			if (!GPOS_FTRACE(EopttraceEnableCTEInlining) ||
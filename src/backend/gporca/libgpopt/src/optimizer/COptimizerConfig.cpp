@@ -38,7 +38,13 @@ COptimizerConfig::COptimizerConfig(CEnumeratorConfig *pec,
 	  m_cte_conf(pcteconf),
 	  m_cost_model(cost_model),
 	  m_hint(phint),
-	  m_window_oids(pwindowoids)
+	  m_window_oids(pwindowoids),
+	  m_search_stages_completed(0),
+	  m_search_stages(0),
+	  m_search_time(0),
+	  m_search_budget_exceeded(false),
+	  m_memo_groups(0),
+	  m_jobs(0)
 {
 	GPOS_ASSERT(NULL != pec);
 	GPOS_ASSERT(NULL != stats_config);
@@ -210,6 +216,20 @@ COptimizerConfig::Serialize(CMemoryPool *mp, CXMLSerializer *xml_serializer,
 	xml_serializer->AddAttribute(
 		CDXLTokens::GetDXLTokenStr(gpdxl::EdxltokenSkewFactor),
 		m_hint->UlSkewFactor());
+	// budgets make the plan depend on the speed of the machine, only
+	// record them when they are set
+	if (SEARCH_TIME_BUDGET != m_hint->UlSearchTimeBudget())
+	{
+		xml_serializer->AddAttribute(
+			CDXLTokens::GetDXLTokenStr(EdxltokenSearchTimeBudget),
+			m_hint->UlSearchTimeBudget());
+	}
+	if (SEARCH_MEMORY_BUDGET != m_hint->UlSearchMemoryBudget())
+	{
+		xml_serializer->AddAttribute(
+			CDXLTokens::GetDXLTokenStr(EdxltokenSearchMemoryBudget),
+			m_hint->UlSearchMemoryBudget());
+	}
 	xml_serializer->CloseElement(
 		CDXLTokens::GetDXLTokenStr(EdxltokenNamespacePrefix),
 		CDXLTokens::GetDXLTokenStr(EdxltokenHint));
@@ -2108,7 +2108,8 @@ CGroup::CostLowerBound(CMemoryPool *mp, CReqdPropPlan *prppInput)
 		{
 			CCost costLowerBoundGExpr =
 				pgexprCurrent->CostLowerBound(mp, prppInput, NULL /*pccChild*/,
-											  gpos::ulong_max /*child_index*/);
+											  gpos::ulong_max /*child_index*/,
+											  NULL /*pdrgpccPrev*/);
 			if (costLowerBoundGExpr < costLowerBound)
 			{
 				costLowerBound = costLowerBoundGExpr;
@@ -493,7 +493,8 @@ CGroupExpression::PccComputeCost(
 //---------------------------------------------------------------------------
 CCost
 CGroupExpression::CostLowerBound(CMemoryPool *mp, CReqdPropPlan *prppInput,
-								 CCostContext *pccChild, ULONG child_index)
+								 CCostContext *pccChild, ULONG child_index,
+								 CCostContextArray *pdrgpccPrev)
 {
 	GPOS_ASSERT(NULL != prppInput);
 	GPOS_ASSERT(Pop()->FPhysical());
@@ -503,8 +504,12 @@ CGroupExpression::CostLowerBound(CMemoryPool *mp, CReqdPropPlan *prppInput,
 	{
 		pccChild->AddRef();
 	}
-	CPartialPlan *ppp =
-		GPOS_NEW(mp) CPartialPlan(this, prppInput, pccChild, child_index);
+	if (NULL != pdrgpccPrev)
+	{
+		pdrgpccPrev->AddRef();
+	}
+	CPartialPlan *ppp = GPOS_NEW(mp)
+		CPartialPlan(this, prppInput, pccChild, child_index, pdrgpccPrev);
 	CCost *pcostLowerBound = m_ppartialplancostmap->Find(ppp);
 	if (NULL != pcostLowerBound)
 	{
@@ -21,6 +21,7 @@
 #include "gpopt/search/CScheduler.h"
 #include "gpopt/search/CSchedulerContext.h"
 #include "gpopt/xforms/CXformFactory.h"
+#include "gpopt/xforms/CXformUtils.h"
 
 
 using namespace gpopt;
@@ -173,13 +174,33 @@ CJobGroupExpressionExploration::ScheduleApplicableTransformations(
 	GPOS_ASSERT(!FXformsScheduled());
 
 	// get all applicable xforms
+	CMemoryPool *mp = psc->GetGlobalMemoryPool();
 	COperator *pop = m_pgexpr->Pop();
-	CXformSet *xform_set =
-		CLogical::PopConvert(pop)->PxfsCandidates(psc->GetGlobalMemoryPool());
+	CXformSet *xform_set = CLogical::PopConvert(pop)->PxfsCandidates(mp);
 
-	// intersect them with required xforms and schedule jobs
+	// intersect them with required xforms
 	xform_set->Intersection(CXformFactory::Pxff()->PxfsExploration());
 	xform_set->Intersection(psc->Peng()->PxfsCurrentStage());
+
+	// once the search budget is used up, no more alternatives are explored,
+	// except those without which the operator cannot be implemented
+	if (psc->Peng()->FSearchBudgetExceeded())
+	{
+		CXformSet *xform_set_required = GPOS_NEW(mp) CXformSet(mp);
+		CXformSetIter xsi(*xform_set);
+		while (xsi.Advance())
+		{
+			CXform *pxform = CXformFactory::Pxff()->Pxf(xsi.TBit());
+			if (CXformUtils::FRequiredForImplementation(pxform))
+			{
+				(void) xform_set_required->ExchangeSet(xsi.TBit());
+			}
+		}
+		xform_set->Release();
+		xform_set = xform_set_required;
+	}
+
+	// schedule jobs
 	ScheduleTransformations(psc, xform_set);
 	xform_set->Release();
 
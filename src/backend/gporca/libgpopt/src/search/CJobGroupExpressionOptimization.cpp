@@ -213,6 +213,7 @@ CJobGroupExpressionOptimization::Init(CGroupExpression *pgexpr,
 	m_pdrgpoc = NULL;
 	m_pdrgpstatCurrentCtxt = NULL;
 	m_pdrgpdp = NULL;
+	m_pdrgpccChildren = NULL;
 	m_pexprhdlPlan = NULL;
 	m_pexprhdlRel = NULL;
 	m_eceo = CPhysical::PopConvert(pgexpr->Pop())->Eceo();
@@ -249,6 +250,7 @@ CJobGroupExpressionOptimization::Cleanup()
 	CRefCount::SafeRelease(m_pdrgpoc);
 	CRefCount::SafeRelease(m_pdrgpstatCurrentCtxt);
 	CRefCount::SafeRelease(m_pdrgpdp);
+	CRefCount::SafeRelease(m_pdrgpccChildren);
 	CRefCount::SafeRelease(m_prppCTEProducer);
 	GPOS_DELETE(m_pexprhdlPlan);
 	GPOS_DELETE(m_pexprhdlRel);
@@ -298,6 +300,10 @@ CJobGroupExpressionOptimization::InitChildGroupsOptimization(
 	m_pdrgpdp = GPOS_NEW(psc->GetGlobalMemoryPool())
 		CDrvdPropArray(psc->GetGlobalMemoryPool());
 
+	// create child groups cost contexts
+	m_pdrgpccChildren = GPOS_NEW(psc->GetGlobalMemoryPool())
+		CCostContextArray(psc->GetGlobalMemoryPool());
+
 	// initialize stats context with input stats context
 	m_pdrgpstatCurrentCtxt = GPOS_NEW(psc->GetGlobalMemoryPool())
 		IStatisticsArray(psc->GetGlobalMemoryPool());
@@ -332,9 +338,10 @@ CJobGroupExpressionOptimization::EevtInitialize(CSchedulerContext *psc,
 
 	// check if job can be early terminated without optimizing any child
 	CCost costLowerBound(GPOPT_INVALID_COST);
-	if (psc->Peng()->FSafeToPrune(
-			pjgeo->m_pgexpr, pjgeo->m_poc->Prpp(), NULL /*pccChild*/,
-			gpos::ulong_max /*child_index*/, &costLowerBound))
+	if (psc->Peng()->FSafeToPrune(pjgeo->m_pgexpr, pjgeo->m_poc->Prpp(),
+								  NULL /*pccChild*/,
+								  gpos::ulong_max /*child_index*/,
+								  NULL /*pdrgpccPrev*/, &costLowerBound))
 	{
 		(void) pjgeo->m_pgexpr->PccComputeCost(
 			psc->GetGlobalMemoryPool(), pjgeo->m_poc, pjgeo->m_ulOptReq,
@@ -384,10 +391,24 @@ CJobGroupExpressionOptimization::DerivePrevChildProps(CSchedulerContext *psc)
 		return;
 	}
 
-	// check if job can be early terminated after previous children have been optimized
+	// check if job can be early terminated after previous children have been
+	// optimized, bounding the cost with the plans of all of them; the
+	// partial plan keeps the array, so pass a copy that is not appended to
+	CCostContextArray *pdrgpccPrev = NULL;
+	if (0 < m_pdrgpccChildren->Size())
+	{
+		pdrgpccPrev = GPOS_NEW(psc->GetGlobalMemoryPool())
+			CCostContextArray(psc->GetGlobalMemoryPool());
+		CUtils::AddRefAppend<CCostContext, CleanupRelease>(pdrgpccPrev,
+														   m_pdrgpccChildren);
+	}
+
 	CCost costLowerBound(GPOPT_INVALID_COST);
-	if (psc->Peng()->FSafeToPrune(m_pgexpr, m_poc->Prpp(), pccChildBest,
-								  ulPrevChildIndex, &costLowerBound))
+	BOOL fPruned = psc->Peng()->FSafeToPrune(m_pgexpr, m_poc->Prpp(),
+											 pccChildBest, ulPrevChildIndex,
+											 pdrgpccPrev, &costLowerBound);
+	CRefCount::SafeRelease(pdrgpccPrev);
+	if (fPruned)
 	{
 		// failed to optimize child due to cost bounding
 		(void) m_pgexpr->PccComputeCost(psc->GetGlobalMemoryPool(), m_poc,
@@ -397,6 +418,9 @@ CJobGroupExpressionOptimization::DerivePrevChildProps(CSchedulerContext *psc)
 		return;
 	}
 
+	pccChildBest->AddRef();
+	m_pdrgpccChildren->Append(pccChildBest);
+
 	CExpressionHandle exprhdl(psc->GetGlobalMemoryPool());
 	exprhdl.Attach(pccChildBest);
 	exprhdl.DerivePlanPropsForCostContext();
@@ -18,6 +18,7 @@
 #include "gpopt/search/CJobFactory.h"
 #include "gpopt/search/CScheduler.h"
 #include "gpopt/search/CSchedulerContext.h"
+#include "gpopt/xforms/CXformUtils.h"
 
 
 using namespace gpopt;
@@ -133,6 +134,14 @@ CJobTransformation::EevtTransform(CSchedulerContext *psc, CJob *pjOwner)
 	CGroupExpression *pgexpr = pjt->m_pgexpr;
 	CXform *pxform = pjt->m_xform;
 
+	// skip exploration xforms scheduled before the search budget was used
+	// up, unless the operator cannot be implemented without them
+	if (pxform->FExploration() && psc->Peng()->FSearchBudgetExceeded() &&
+		!CXformUtils::FRequiredForImplementation(pxform))
+	{
+		return eevCompleted;
+	}
+
 	// insert transformation results to memo
 	CXformResult *pxfres = GPOS_NEW(pmpGlobal) CXformResult(pmpGlobal);
 	ULONG ulElapsedTime = 0;
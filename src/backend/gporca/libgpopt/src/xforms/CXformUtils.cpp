@@ -2061,6 +2061,69 @@ CXformUtils::FSubqueryUnnesting(CXform *pxform)
 		   CXformExploration::Pxformexp(pxform)->FSubqueryUnnesting();
 }
 
+//---------------------------------------------------------------------------
+//      @function:
+//              CXformUtils::FRequiredForImplementation
+//
+//      @doc:
+//          Check if xform is an exploration xform that some operators need
+//          to be implemented at all, because they have no implementation
+//          xform of their own, or only one that does not apply to them
+//          as long as they have subqueries
+//
+//---------------------------------------------------------------------------
+BOOL
+CXformUtils::FRequiredForImplementation(CXform *pxform)
+{
+	GPOS_ASSERT(NULL != pxform);
+
+	if (!pxform->FExploration())
+	{
+		return false;
+	}
+
+	if (FSubqueryUnnesting(pxform) || FSubqueryDecorrelation(pxform))
+	{
+		return true;
+	}
+
+	switch (pxform->Exfid())
+	{
+		// an n-ary join is implemented through one of the join orders
+		// produced by these xforms, the cheapest ones being enough
+		case CXform::ExfExpandNAryJoin:
+		case CXform::ExfExpandNAryJoinMinCard:
+		case CXform::ExfExpandNAryJoinGreedy:
+			return true;
+
+		// the dynamic programming ones are only needed when the cheaper
+		// ones are all disabled
+		case CXform::ExfExpandNAryJoinDP:
+		case CXform::ExfExpandNAryJoinDPv2:
+			return GPOPT_FDISABLED_XFORM(CXform::ExfExpandNAryJoin) &&
+				   GPOPT_FDISABLED_XFORM(CXform::ExfExpandNAryJoinMinCard) &&
+				   GPOPT_FDISABLED_XFORM(CXform::ExfExpandNAryJoinGreedy);
+
+		case CXform::ExfDifference2LeftAntiSemiJoin:
+		case CXform::ExfDifferenceAll2LeftAntiSemiJoin:
+		case CXform::ExfIntersect2Join:
+		case CXform::ExfIntersectAll2LeftSemiJoin:
+		case CXform::ExfUnion2UnionAll:
+		case CXform::ExfInsert2DML:
+		case CXform::ExfDelete2DML:
+		case CXform::ExfUpdate2DML:
+		case CXform::ExfCTEAnchor2Sequence:
+		case CXform::ExfCTEAnchor2TrivialSelect:
+		case CXform::ExfMaxOneRow2Assert:
+		case CXform::ExfExpandFullOuterJoin:
+		case CXform::ExfImplementFullOuterMergeJoin:
+			return true;
+
+		default:
+			return false;
+	}
+}
+
 //---------------------------------------------------------------------------
 //      @function:
 //              CXformUtils::FApplyToNextBinding
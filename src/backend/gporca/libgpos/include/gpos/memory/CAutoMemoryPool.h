@@ -59,8 +59,9 @@ private:
 	ELeakCheck m_leak_check_type;
 
 public:
-	// ctor
-	CAutoMemoryPool(ELeakCheck leak_check_type = ElcExc);
+	// ctor; an arena pool trades frees for cheaper allocations, leaks in
+	// it are not checked
+	CAutoMemoryPool(ELeakCheck leak_check_type = ElcExc, BOOL use_arena = false);
 
 	// dtor
 	~CAutoMemoryPool();
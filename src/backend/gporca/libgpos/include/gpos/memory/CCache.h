@@ -77,6 +77,9 @@ public:
 	typedef ULONG (*HashFuncPtr)(const K &);
 	typedef BOOL (*EqualFuncPtr)(const K &, const K &);
 
+	// type definition of the filter selecting the objects to delete
+	typedef BOOL (*FilterFuncPtr)(const K &, const T &, void *);
+
 private:
 	typedef CCacheEntry<T, K> CCacheHashTableEntry;
 
@@ -514,6 +517,57 @@ public:
 		return m_eviction_factor;
 	}
 
+	// delete all objects for which the filter returns true, and return
+	// how many were deleted; objects that are still in use are marked for
+	// deletion and go away when their last accessor releases them
+	ULONG
+	DeleteEntries(FilterFuncPtr filter, void *arg)
+	{
+		GPOS_ASSERT(NULL != filter);
+
+		ULONG num_deleted = 0;
+		CCacheHashtableIter iter(m_hash_table);
+		BOOL advanced = false;
+
+		while (advanced || iter.Advance())
+		{
+			advanced = false;
+			CCacheHashTableEntry *entry = NULL;
+			BOOL deleted = false;
+
+			// scope for CCacheHashtableIterAccessor
+			{
+				CCacheHashtableIterAccessor acc(iter);
+
+				if (NULL != (entry = acc.Value()) &&
+					!entry->IsMarkedForDeletion() &&
+					filter(entry->Key(), entry->Val(), arg))
+				{
+					if (EXPECTED_REF_COUNT_FOR_DELETE == entry->RefCount())
+					{
+						// remove advances iterator automatically
+						acc.Remove(entry);
+						deleted = true;
+						advanced = true;
+						m_cache_size -= entry->Pmp()->TotalAllocatedSize();
+					}
+					else
+					{
+						entry->MarkForDeletion();
+					}
+					num_deleted++;
+				}
+			}
+
+			if (deleted)
+			{
+				DestroyCacheEntry(entry);
+			}
+		}
+
+		return num_deleted;
+	}
+
 };	//  CCache
 
 // invalid key
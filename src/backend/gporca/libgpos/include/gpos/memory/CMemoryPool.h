@@ -154,6 +154,27 @@ public:
 		return 0;
 	}
 
+	// return the highest total allocated size so far, if the pool tracks it
+	virtual ULLONG
+	PeakAllocatedSize() const
+	{
+		return 0;
+	}
+
+	// return number of allocations, if the pool counts them
+	virtual ULLONG
+	NumAllocations() const
+	{
+		return 0;
+	}
+
+	// return number of frees, if the pool counts them
+	virtual ULLONG
+	NumFrees() const
+	{
+		return 0;
+	}
+
 	// requested size of allocation
 	static ULONG UserSizeOfAlloc(const void *ptr);
 
@@ -0,0 +1,195 @@
+//---------------------------------------------------------------------------
+//	Greenplum Database
+//	Copyright (C) 2020 Pivotal Software, Inc.
+//
+//	@filename:
+//		CMemoryPoolArena.h
+//
+//	@doc:
+//		Memory pool that carves small allocations out of large blocks,
+//		and releases all of them at once when it is destroyed
+//
+//	@test:
+//		CMemoryPoolBasicTest
+//
+//---------------------------------------------------------------------------
+#ifndef GPOS_CMemoryPoolArena_H
+#define GPOS_CMemoryPoolArena_H
+
+#include "gpos/memory/CMemoryPool.h"
+#include "gpos/types.h"
+
+// size of the blocks requested from the underlying pool
+#define GPOS_MEM_ARENA_BLOCK_SIZE (256 * 1024)
+
+// largest allocation, including its header, carved out of a block
+#define GPOS_MEM_ARENA_MAX_CHUNK_SIZE (1024)
+
+// number of free lists, one per aligned chunk size
+#define GPOS_MEM_ARENA_SIZE_CLASSES \
+	(GPOS_MEM_ARENA_MAX_CHUNK_SIZE / GPOS_MEM_ARCH + 1)
+
+namespace gpos
+{
+//---------------------------------------------------------------------------
+//	@class:
+//		CMemoryPoolArena
+//
+//	@doc:
+//		Memory pool for objects that mostly live until the pool is destroyed,
+//		like the objects of an optimization.
+//
+//		Small allocations are carved out of large blocks obtained from an
+//		underlying pool of the type used by the pool manager. Freed
+//		allocations are kept in free lists, one per size, and handed out
+//		again by later allocations of the same size. Large allocations are
+//		passed on to the underlying pool. Destroying the pool destroys the
+//		underlying pool, which releases the blocks in bulk.
+//
+//		Frees go through CMemoryPool::DeleteImpl, which does not know the
+//		pool of an allocation; the live arenas are kept in a list, and each
+//		arena keeps the sorted addresses of its blocks, so that the arena
+//		owning an allocation can be found.
+//
+//---------------------------------------------------------------------------
+class CMemoryPoolArena : public CMemoryPool
+{
+private:
+	// header of the allocations carved out of the blocks
+	struct SAllocHeader
+	{
+		// user requested size
+		ULONG m_user_size;
+
+		// index of the free list the allocation is returned to
+		ULONG m_size_class;
+	};
+
+	// pool the blocks and large allocations are requested from
+	CMemoryPool *m_underlying_mp;
+
+	// free space of the current block
+	BYTE *m_next;
+
+	// end of the current block
+	BYTE *m_end;
+
+	// sorted start addresses of the blocks
+	ULONG_PTR *m_block_starts;
+
+	// number of blocks
+	ULONG m_num_blocks;
+
+	// capacity of the block addresses array
+	ULONG m_block_starts_size;
+
+	// free lists, by aligned chunk size
+	SAllocHeader *m_free_lists[GPOS_MEM_ARENA_SIZE_CLASSES];
+
+	// number of allocations
+	ULLONG m_num_allocations;
+
+	// number of allocations served from a free list
+	ULLONG m_num_reused;
+
+	// number of allocations passed on to the underlying pool
+	ULLONG m_num_large_allocations;
+
+	// number of frees of allocations carved out of the blocks
+	ULLONG m_num_frees;
+
+	// next live arena
+	CMemoryPoolArena *m_next_arena;
+
+	// list of live arenas
+	static CMemoryPoolArena *m_arenas;
+
+	// private copy ctor
+	CMemoryPoolArena(CMemoryPoolArena &);
+
+	// request a new block from the underlying pool
+	void AllocateBlock();
+
+	// was the given allocation carved out of a block of this pool?
+	BOOL FOwns(const void *ptr) const;
+
+protected:
+	// dtor
+	virtual ~CMemoryPoolArena();
+
+public:
+	// ctor; takes ownership of the underlying pool
+	explicit CMemoryPoolArena(CMemoryPool *underlying_mp);
+
+	// prepare the memory pool to be deleted
+	virtual void TearDown();
+
+	// allocate memory
+	virtual void *NewImpl(const ULONG bytes, const CHAR *file, const ULONG line,
+						  CMemoryPool::EAllocationType eat);
+
+	// return an allocation carved out of a block of this pool
+	void Free(void *ptr);
+
+	// return total allocated size, including the unused parts of the blocks
+	virtual ULLONG
+	TotalAllocatedSize() const
+	{
+		return m_underlying_mp->TotalAllocatedSize();
+	}
+
+	// return the highest total allocated size so far
+	virtual ULLONG
+	PeakAllocatedSize() const
+	{
+		return m_underlying_mp->PeakAllocatedSize();
+	}
+
+	// number of allocations
+	virtual ULLONG
+	NumAllocations() const
+	{
+		return m_num_allocations;
+	}
+
+	// number of frees, not counting the large allocations
+	virtual ULLONG
+	NumFrees() const
+	{
+		return m_num_frees;
+	}
+
+	// number of allocations served from a free list
+	ULLONG
+	NumReused() const
+	{
+		return m_num_reused;
+	}
+
+	// number of allocations passed on to the underlying pool
+	ULLONG
+	NumLargeAllocations() const
+	{
+		return m_num_large_allocations;
+	}
+
+	// number of blocks
+	ULONG
+	NumBlocks() const
+	{
+		return m_num_blocks;
+	}
+
+	// live arena owning the given allocation, or NULL if it was not carved
+	// out of the blocks of an arena
+	static CMemoryPoolArena *PmpOwner(const void *ptr);
+
+	// get user requested size of an allocation carved out of a block
+	static ULONG UserSizeOfAlloc(const void *ptr);
+
+};	// class CMemoryPoolArena
+}  // namespace gpos
+
+#endif	// !GPOS_CMemoryPoolArena_H
+
+// EOF
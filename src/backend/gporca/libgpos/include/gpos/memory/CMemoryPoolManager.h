@@ -65,6 +65,9 @@ private:
 	// create new pool of given type
 	virtual CMemoryPool *NewMemoryPool();
 
+	// add memory pool to the created pools
+	CMemoryPool *RegisterMemoryPool(CMemoryPool *mp);
+
 	// no copy ctor
 	CMemoryPoolManager(const CMemoryPoolManager &);
 
@@ -132,6 +135,9 @@ public:
 	// create new memory pool
 	CMemoryPool *CreateMemoryPool();
 
+	// create new arena memory pool
+	CMemoryPool *CreateArenaMemoryPool();
+
 	// release memory pool
 	void Destroy(CMemoryPool *);
 
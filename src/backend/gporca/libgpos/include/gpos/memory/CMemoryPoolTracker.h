@@ -109,6 +109,27 @@ public:
 		return m_memory_pool_statistics.TotalAllocatedSize();
 	}
 
+	// return the highest total allocated size so far
+	virtual ULLONG
+	PeakAllocatedSize() const
+	{
+		return m_memory_pool_statistics.PeakLiveObjTotalSize();
+	}
+
+	// return number of allocations
+	virtual ULLONG
+	NumAllocations() const
+	{
+		return m_memory_pool_statistics.GetNumSuccessfulAllocations();
+	}
+
+	// return number of frees
+	virtual ULLONG
+	NumFrees() const
+	{
+		return m_memory_pool_statistics.GetNumFree();
+	}
+
 #ifdef GPOS_DEBUG
 
 	// check if the memory pool keeps track of live objects
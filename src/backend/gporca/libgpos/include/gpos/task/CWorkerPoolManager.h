@@ -62,7 +62,14 @@ private:
 	// active flag
 	BOOL m_active;
 
-	// we only support a single worker now
+	// we only support a single worker now. The optimizer runs inside a
+	// backend, and the search allocates with palloc, fetches metadata and
+	// statistics from the catalog, and may raise errors with elog, none of
+	// which may be done from another thread. This is unlike the threads of
+	// the parallel multi-key sort (tuplesort_mkqsort.c), which only compare
+	// datums that are already in memory, and are only used when that cannot
+	// allocate or fail. Reference counts and the synchronized containers
+	// (CSyncList, CSyncHashtable) do not use atomics or locks either.
 	CWorker *m_single_worker;
 
 	// task storage
@@ -50,6 +50,10 @@ private:
 		//key equality function
 		static BOOL FMyEqual(ULONG *const &pvKey, ULONG *const &pvKeySecond);
 
+		// deletion filter selecting odd keys
+		static BOOL FOddKey(ULONG *const &pvKey, SSimpleObject *const &pso,
+							void *arg);
+
 		// equality for object-based comparison
 		BOOL
 		operator==(const SSimpleObject &obj) const
@@ -157,6 +161,7 @@ public:
 	static GPOS_RESULT EresUnittest_DeepObject();
 	static GPOS_RESULT EresUnittest_Iteration();
 	static GPOS_RESULT EresUnittest_IterativeDeletion();
+	static GPOS_RESULT EresUnittest_FilteredDeletion();
 
 
 };	// class CCacheTest
@@ -47,7 +47,8 @@ CCacheTest::EresUnittest()
 		GPOS_UNITTEST_FUNC(CCacheTest::EresUnittest_Eviction),
 		GPOS_UNITTEST_FUNC(CCacheTest::EresUnittest_Iteration),
 		GPOS_UNITTEST_FUNC(CCacheTest::EresUnittest_DeepObject),
-		GPOS_UNITTEST_FUNC(CCacheTest::EresUnittest_IterativeDeletion)};
+		GPOS_UNITTEST_FUNC(CCacheTest::EresUnittest_IterativeDeletion),
+		GPOS_UNITTEST_FUNC(CCacheTest::EresUnittest_FilteredDeletion)};
 
 	fUnique = true;
 	GPOS_RESULT eres = CUnittest::EresExecute(rgut, GPOS_ARRAY_SIZE(rgut));
@@ -998,4 +999,99 @@ CCacheTest::EresUnittest_IterativeDeletion()
 	return GPOS_OK;
 }
 
+
+//---------------------------------------------------------------------------
+//	@function:
+//		CCacheTest::SSimpleObject::FOddKey
+//
+//	@doc:
+//		Deletion filter selecting the objects with an odd key
+//
+//---------------------------------------------------------------------------
+BOOL
+CCacheTest::SSimpleObject::FOddKey(ULONG *const &pvKey,
+								   SSimpleObject *const &,	// pso
+								   void *						// arg
+)
+{
+	return 1 == *pvKey % 2;
+}
+
+
+//---------------------------------------------------------------------------
+//	@function:
+//		CCacheTest::EresUnittest_FilteredDeletion
+//
+//	@doc:
+//		Delete the entries selected by a filter, and check that the others
+//		are intact
+//
+//---------------------------------------------------------------------------
+GPOS_RESULT
+CCacheTest::EresUnittest_FilteredDeletion()
+{
+	CAutoP<CCache<SSimpleObject *, ULONG *> > apcache;
+	apcache = CCacheFactory::CreateCache<SSimpleObject *, ULONG *>(
+		fUnique, UNLIMITED_CACHE_QUOTA, SSimpleObject::UlMyHash,
+		SSimpleObject::FMyEqual);
+
+	CCache<SSimpleObject *, ULONG *> *pcache = apcache.Value();
+
+	CCacheTest::EresInsertDuplicates(pcache);
+
+	ULONG ulDuplicates = 1;
+	if (!pcache->AllowsDuplicateKeys())
+	{
+		ulDuplicates = GPOS_CACHE_DUPLICATES;
+	}
+
+	ULONG ulDeleted = pcache->DeleteEntries(SSimpleObject::FOddKey, NULL);
+	if (ulDeleted != ulDuplicates * (GPOS_CACHE_ELEMENTS / 2))
+	{
+		return GPOS_FAILED;
+	}
+
+	for (ULONG i = 0; i < GPOS_CACHE_ELEMENTS; i++)
+	{
+		GPOS_CHECK_ABORT;
+
+		CSimpleObjectCacheAccessor ca(pcache);
+		ca.Lookup(&i);
+		SSimpleObject *pso = ca.Val();
+
+		if (1 == i % 2)
+		{
+			if (NULL != pso)
+			{
+				return GPOS_FAILED;
+			}
+			continue;
+		}
+
+		if (NULL == pso)
+		{
+			return GPOS_FAILED;
+		}
+
+		// release object since there is no customer to release it after lookup and before CCache's cleanup
+		pso->Release();
+
+		ULONG count = 0;
+		while (NULL != pso)
+		{
+			GPOS_CHECK_ABORT;
+
+			count++;
+			pso = ca.Next();
+		}
+
+		if (count != ulDuplicates)
+		{
+			return GPOS_FAILED;
+		}
+	}
+
+	return GPOS_OK;
+}
+
 // EOF
@@ -45,7 +45,8 @@ CMemoryPoolBasicTest::EresUnittest()
 #ifdef GPOS_DEBUG
 		GPOS_UNITTEST_FUNC(CMemoryPoolBasicTest::EresUnittest_Print),
 #endif	// GPOS_DEBUG
-		GPOS_UNITTEST_FUNC(CMemoryPoolBasicTest::EresUnittest_TestTracker)};
+		GPOS_UNITTEST_FUNC(CMemoryPoolBasicTest::EresUnittest_TestTracker),
+		GPOS_UNITTEST_FUNC(CMemoryPoolBasicTest::EresUnittest_TestArena)};
 
 	CAutoTraceFlag atf(EtraceTestMemoryPools, true /*value*/);
 
@@ -97,6 +98,83 @@ CMemoryPoolBasicTest::EresUnittest_TestTracker()
 }
 
 
+//---------------------------------------------------------------------------
+//	@function:
+//		CMemoryPoolBasicTest::EresUnittest_TestArena
+//
+//	@doc:
+//		Run tests for pool carving allocations out of blocks
+//
+//---------------------------------------------------------------------------
+GPOS_RESULT
+CMemoryPoolBasicTest::EresUnittest_TestArena()
+{
+	CAutoTimer at("Arena test", true /*fPrint*/);
+	CAutoMemoryPool amp(CAutoMemoryPool::ElcExc, true /*use_arena*/);
+	CMemoryPool *mp = amp.Pmp();
+
+	// freed allocations are reused by allocations of the same size
+	ULONG *pul = GPOS_NEW(mp) ULONG(1);
+	GPOS_DELETE(pul);
+	ULONG *pulReused = GPOS_NEW(mp) ULONG(2);
+	if (pul != pulReused || 2 != *pulReused)
+	{
+		return GPOS_FAILED;
+	}
+
+	// arrays keep their size for the element destructors
+	WCHAR *wsz = GPOS_NEW_ARRAY(mp, WCHAR, 100);
+	if (100 * GPOS_SIZEOF(WCHAR) != CMemoryPool::UserSizeOfAlloc(wsz))
+	{
+		return GPOS_FAILED;
+	}
+
+	// large allocations are passed on to the underlying pool
+	BYTE *pbLarge = GPOS_NEW_ARRAY(mp, BYTE, 64 * 1024);
+	if (64 * 1024 != CMemoryPool::UserSizeOfAlloc(pbLarge))
+	{
+		return GPOS_FAILED;
+	}
+	GPOS_DELETE_ARRAY(pbLarge);
+
+	// the peak size still accounts for the freed large allocation
+	if (mp->PeakAllocatedSize() < 64 * 1024 ||
+		mp->PeakAllocatedSize() < mp->TotalAllocatedSize())
+	{
+		return GPOS_FAILED;
+	}
+
+	// allocations spanning several blocks
+	const ULONG ulAllocs = 10000;
+	ULLONG *rgpull[ulAllocs];
+	for (ULONG ul = 0; ul < ulAllocs; ul++)
+	{
+		rgpull[ul] = GPOS_NEW_ARRAY(mp, ULLONG, 1 + ul % 64);
+		rgpull[ul][0] = ul;
+	}
+
+	for (ULONG ul = 0; ul < ulAllocs; ul++)
+	{
+		if (ul != rgpull[ul][0])
+		{
+			return GPOS_FAILED;
+		}
+		GPOS_DELETE_ARRAY(rgpull[ul]);
+	}
+
+	GPOS_DELETE_ARRAY(wsz);
+	GPOS_DELETE(pulReused);
+
+	if (ulAllocs + 4 != mp->NumAllocations() ||
+		ulAllocs + 3 != mp->NumFrees())
+	{
+		return GPOS_FAILED;
+	}
+
+	return GPOS_OK;
+}
+
+
 //---------------------------------------------------------------------------
 //	@function:
 //		CMemoryPoolBasicTest::EresTestType
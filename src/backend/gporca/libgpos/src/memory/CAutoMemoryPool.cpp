@@ -39,10 +39,17 @@ using namespace gpos;
 //  	the CMemoryPoolManager global instance
 //
 //---------------------------------------------------------------------------
-CAutoMemoryPool::CAutoMemoryPool(ELeakCheck leak_check_type)
+CAutoMemoryPool::CAutoMemoryPool(ELeakCheck leak_check_type, BOOL use_arena)
 	: m_leak_check_type(leak_check_type)
 {
-	m_mp = CMemoryPoolManager::GetMemoryPoolMgr()->CreateMemoryPool();
+	if (use_arena)
+	{
+		m_mp = CMemoryPoolManager::GetMemoryPoolMgr()->CreateArenaMemoryPool();
+	}
+	else
+	{
+		m_mp = CMemoryPoolManager::GetMemoryPoolMgr()->CreateMemoryPool();
+	}
 }
 
 
@@ -16,6 +16,7 @@
 #include "gpos/error/CFSimulator.h"
 #endif	// GPOS_DEBUG
 #include "gpos/memory/CMemoryPool.h"
+#include "gpos/memory/CMemoryPoolArena.h"
 #include "gpos/memory/CMemoryPoolManager.h"
 #include "gpos/memory/CMemoryPoolTracker.h"
 #include "gpos/memory/CMemoryVisitorPrint.h"
@@ -33,6 +34,11 @@ CMemoryPool::UserSizeOfAlloc(const void *ptr)
 {
 	GPOS_ASSERT(NULL != ptr);
 
+	if (NULL != CMemoryPoolArena::PmpOwner(ptr))
+	{
+		return CMemoryPoolArena::UserSizeOfAlloc(ptr);
+	}
+
 	return CMemoryPoolManager::GetMemoryPoolMgr()->UserSizeOfAlloc(ptr);
 }
 
@@ -40,6 +46,15 @@ CMemoryPool::UserSizeOfAlloc(const void *ptr)
 void
 CMemoryPool::DeleteImpl(void *ptr, EAllocationType eat)
 {
+	// allocations carved out of arena blocks have no header of the
+	// managed pool type
+	CMemoryPoolArena *arena = CMemoryPoolArena::PmpOwner(ptr);
+	if (NULL != arena)
+	{
+		arena->Free(ptr);
+		return;
+	}
+
 	CMemoryPoolManager::GetMemoryPoolMgr()->DeleteImpl(ptr, eat);
 }
 
@@ -0,0 +1,330 @@
+//---------------------------------------------------------------------------
+//	Greenplum Database
+//	Copyright (C) 2020 Pivotal Software, Inc.
+//
+//	@filename:
+//		CMemoryPoolArena.cpp
+//
+//	@doc:
+//		Implementation of memory pool that carves small allocations out of
+//		large blocks
+//
+//---------------------------------------------------------------------------
+
+#include "gpos/memory/CMemoryPoolArena.h"
+
+#include <algorithm>
+
+#include "gpos/assert.h"
+#include "gpos/common/clibwrapper.h"
+#include "gpos/memory/CMemoryPoolManager.h"
+#include "gpos/types.h"
+
+using namespace gpos;
+
+#define GPOS_MEM_ARENA_HEADER_SIZE GPOS_MEM_ALIGNED_STRUCT_SIZE(SAllocHeader)
+
+// initial capacity of the block addresses array
+#define GPOS_MEM_ARENA_INIT_BLOCKS (16)
+
+// a freed allocation keeps the link to the next one of its free list
+GPOS_CPL_ASSERT(GPOS_SIZEOF(void *) <= GPOS_MEM_ARCH);
+
+// list of live arenas
+CMemoryPoolArena *CMemoryPoolArena::m_arenas = NULL;
+
+
+// ctor
+CMemoryPoolArena::CMemoryPoolArena(CMemoryPool *underlying_mp)
+	: CMemoryPool(),
+	  m_underlying_mp(underlying_mp),
+	  m_next(NULL),
+	  m_end(NULL),
+	  m_block_starts(NULL),
+	  m_num_blocks(0),
+	  m_block_starts_size(0),
+	  m_num_allocations(0),
+	  m_num_reused(0),
+	  m_num_large_allocations(0),
+	  m_num_frees(0),
+	  m_next_arena(m_arenas)
+{
+	GPOS_ASSERT(NULL != underlying_mp);
+
+	for (ULONG ul = 0; ul < GPOS_MEM_ARENA_SIZE_CLASSES; ul++)
+	{
+		m_free_lists[ul] = NULL;
+	}
+
+	m_arenas = this;
+}
+
+
+// dtor
+CMemoryPoolArena::~CMemoryPoolArena()
+{
+	GPOS_ASSERT(NULL == m_underlying_mp);
+}
+
+
+//---------------------------------------------------------------------------
+//	@function:
+//		CMemoryPoolArena::NewImpl
+//
+//	@doc:
+//		Allocate memory; allocations that fit in a chunk are served from
+//		the free list of their size, or carved out of the current block
+//
+//---------------------------------------------------------------------------
+void *
+CMemoryPoolArena::NewImpl(const ULONG bytes, const CHAR *file,
+						  const ULONG line, CMemoryPool::EAllocationType eat)
+{
+	GPOS_ASSERT(bytes <= GPOS_MEM_ALLOC_MAX);
+
+	m_num_allocations++;
+
+	// freed allocations need room for the free list link
+	ULONG user_size = GPOS_MEM_ALIGNED_SIZE(bytes);
+	if (0 == user_size)
+	{
+		user_size = GPOS_MEM_ARCH;
+	}
+
+	const ULONG chunk_size = GPOS_MEM_ARENA_HEADER_SIZE + user_size;
+	if (GPOS_MEM_ARENA_MAX_CHUNK_SIZE < chunk_size)
+	{
+		m_num_large_allocations++;
+		return m_underlying_mp->NewImpl(bytes, file, line, eat);
+	}
+
+	const ULONG size_class = chunk_size / GPOS_MEM_ARCH;
+	SAllocHeader *header = m_free_lists[size_class];
+	if (NULL != header)
+	{
+		m_free_lists[size_class] = *reinterpret_cast<SAllocHeader **>(
+			reinterpret_cast<BYTE *>(header) + GPOS_MEM_ARENA_HEADER_SIZE);
+		m_num_reused++;
+	}
+	else
+	{
+		if (m_next + chunk_size > m_end)
+		{
+			// the rest of the current block is left unused
+			AllocateBlock();
+		}
+
+		header = reinterpret_cast<SAllocHeader *>(m_next);
+		m_next += chunk_size;
+	}
+
+	header->m_user_size = bytes;
+	header->m_size_class = size_class;
+
+	void *ptr = reinterpret_cast<BYTE *>(header) + GPOS_MEM_ARENA_HEADER_SIZE;
+
+#ifdef GPOS_DEBUG
+	clib::Memset(ptr, GPOS_MEM_INIT_PATTERN_CHAR, bytes);
+#endif	// GPOS_DEBUG
+
+	return ptr;
+}
+
+
+//---------------------------------------------------------------------------
+//	@function:
+//		CMemoryPoolArena::AllocateBlock
+//
+//	@doc:
+//		Request a new block from the underlying pool, and record its
+//		address in the sorted block addresses array; the array is grown
+//		first, so that a failure leaves no block unrecorded
+//
+//---------------------------------------------------------------------------
+void
+CMemoryPoolArena::AllocateBlock()
+{
+	if (m_num_blocks == m_block_starts_size)
+	{
+		ULONG size = std::max((ULONG) GPOS_MEM_ARENA_INIT_BLOCKS,
+							  2 * m_block_starts_size);
+		ULONG_PTR *block_starts =
+			GPOS_NEW_ARRAY(m_underlying_mp, ULONG_PTR, size);
+
+		if (0 < m_num_blocks)
+		{
+			clib::Memcpy(block_starts, m_block_starts,
+						 m_num_blocks * GPOS_SIZEOF(ULONG_PTR));
+			GPOS_DELETE_ARRAY(m_block_starts);
+		}
+
+		m_block_starts = block_starts;
+		m_block_starts_size = size;
+	}
+
+	// blocks are not initialized, their chunks are when allocated
+	BYTE *block = static_cast<BYTE *>(
+		m_underlying_mp->NewImpl(GPOS_MEM_ARENA_BLOCK_SIZE, __FILE__, __LINE__,
+								 CMemoryPool::EatArray));
+	GPOS_OOM_CHECK(block);
+
+	// insert the block address in order
+	ULONG_PTR start = reinterpret_cast<ULONG_PTR>(block);
+	ULONG pos = m_num_blocks;
+	while (0 < pos && m_block_starts[pos - 1] > start)
+	{
+		m_block_starts[pos] = m_block_starts[pos - 1];
+		pos--;
+	}
+	m_block_starts[pos] = start;
+	m_num_blocks++;
+
+	m_next = block;
+	m_end = block + GPOS_MEM_ARENA_BLOCK_SIZE;
+}
+
+
+//---------------------------------------------------------------------------
+//	@function:
+//		CMemoryPoolArena::FOwns
+//
+//	@doc:
+//		Was the given allocation carved out of a block of this pool?
+//
+//---------------------------------------------------------------------------
+BOOL
+CMemoryPoolArena::FOwns(const void *ptr) const
+{
+	const ULONG_PTR addr = reinterpret_cast<ULONG_PTR>(ptr);
+	if (0 == m_num_blocks || addr < m_block_starts[0] ||
+		addr >= m_block_starts[m_num_blocks - 1] + GPOS_MEM_ARENA_BLOCK_SIZE)
+	{
+		return false;
+	}
+
+	// find the last block starting at or before the address
+	ULONG low = 0;
+	ULONG high = m_num_blocks;
+	while (1 < high - low)
+	{
+		ULONG mid = (low + high) / 2;
+		if (m_block_starts[mid] <= addr)
+		{
+			low = mid;
+		}
+		else
+		{
+			high = mid;
+		}
+	}
+
+	return addr < m_block_starts[low] + GPOS_MEM_ARENA_BLOCK_SIZE;
+}
+
+
+//---------------------------------------------------------------------------
+//	@function:
+//		CMemoryPoolArena::PmpOwner
+//
+//	@doc:
+//		Live arena owning the given allocation, or NULL if it was not carved
+//		out of the blocks of an arena; there are rarely more than a few
+//		live arenas
+//
+//---------------------------------------------------------------------------
+CMemoryPoolArena *
+CMemoryPoolArena::PmpOwner(const void *ptr)
+{
+	for (CMemoryPoolArena *arena = m_arenas; NULL != arena;
+		 arena = arena->m_next_arena)
+	{
+		if (arena->FOwns(ptr))
+		{
+			return arena;
+		}
+	}
+
+	return NULL;
+}
+
+
+//---------------------------------------------------------------------------
+//	@function:
+//		CMemoryPoolArena::Free
+//
+//	@doc:
+//		Return an allocation carved out of a block of this pool to the free
+//		list of its size
+//
+//---------------------------------------------------------------------------
+void
+CMemoryPoolArena::Free(void *ptr)
+{
+	GPOS_ASSERT(FOwns(ptr));
+
+	SAllocHeader *header = reinterpret_cast<SAllocHeader *>(
+		static_cast<BYTE *>(ptr) - GPOS_MEM_ARENA_HEADER_SIZE);
+	const ULONG size_class = header->m_size_class;
+	GPOS_ASSERT(0 < size_class && size_class < GPOS_MEM_ARENA_SIZE_CLASSES);
+
+#ifdef GPOS_DEBUG
+	clib::Memset(ptr, GPOS_MEM_FREED_PATTERN_CHAR, header->m_user_size);
+#endif	// GPOS_DEBUG
+
+	*static_cast<SAllocHeader **>(ptr) = m_free_lists[size_class];
+	m_free_lists[size_class] = header;
+	m_num_frees++;
+}
+
+
+//---------------------------------------------------------------------------
+//	@function:
+//		CMemoryPoolArena::UserSizeOfAlloc
+//
+//	@doc:
+//		Get user requested size of an allocation carved out of a block
+//
+//---------------------------------------------------------------------------
+ULONG
+CMemoryPoolArena::UserSizeOfAlloc(const void *ptr)
+{
+	GPOS_ASSERT(NULL != PmpOwner(ptr));
+
+	const SAllocHeader *header = reinterpret_cast<const SAllocHeader *>(
+		static_cast<const BYTE *>(ptr) - GPOS_MEM_ARENA_HEADER_SIZE);
+
+	return header->m_user_size;
+}
+
+
+//---------------------------------------------------------------------------
+//	@function:
+//		CMemoryPoolArena::TearDown
+//
+//	@doc:
+//		Unregister the pool, and destroy the underlying pool, which
+//		releases the blocks and the large allocations
+//
+//---------------------------------------------------------------------------
+void
+CMemoryPoolArena::TearDown()
+{
+	CMemoryPoolArena **link = &m_arenas;
+	while (this != *link)
+	{
+		GPOS_ASSERT(NULL != *link);
+		link = &(*link)->m_next_arena;
+	}
+	*link = m_next_arena;
+
+	m_block_starts = NULL;
+	m_num_blocks = 0;
+	m_next = NULL;
+	m_end = NULL;
+
+	m_underlying_mp->TearDown();
+	GPOS_DELETE(m_underlying_mp);
+	m_underlying_mp = NULL;
+}
+
+// EOF
@@ -19,6 +19,7 @@
 #include "gpos/error/CAutoTrace.h"
 #include "gpos/error/CFSimulator.h"	 // for GPOS_FPSIMULATOR
 #include "gpos/memory/CMemoryPool.h"
+#include "gpos/memory/CMemoryPoolArena.h"
 #include "gpos/memory/CMemoryPoolTracker.h"
 #include "gpos/memory/CMemoryVisitorPrint.h"
 #include "gpos/task/CAutoSuspendAbort.h"
@@ -82,8 +83,37 @@ CMemoryPoolManager::Init()
 CMemoryPool *
 CMemoryPoolManager::CreateMemoryPool()
 {
-	CMemoryPool *mp = NewMemoryPool();
+	return RegisterMemoryPool(NewMemoryPool());
+}
+
+
+// Create new arena memory pool, carving its allocations out of blocks
+// requested from a new pool of the managed type
+CMemoryPool *
+CMemoryPoolManager::CreateArenaMemoryPool()
+{
+	CMemoryPool *underlying_mp = NewMemoryPool();
+	CMemoryPool *mp = NULL;
+	GPOS_TRY
+	{
+		mp = GPOS_NEW(m_internal_memory_pool) CMemoryPoolArena(underlying_mp);
+	}
+	GPOS_CATCH_EX(ex)
+	{
+		underlying_mp->TearDown();
+		GPOS_DELETE(underlying_mp);
+		GPOS_RETHROW(ex);
+	}
+	GPOS_CATCH_END;
+
+	return RegisterMemoryPool(mp);
+}
 
+
+// Add given memory pool to the created pools
+CMemoryPool *
+CMemoryPoolManager::RegisterMemoryPool(CMemoryPool *mp)
+{
 	// accessor scope
 	{
 		// HERE BE DRAGONS
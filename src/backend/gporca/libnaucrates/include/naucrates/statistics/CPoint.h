@@ -46,6 +46,39 @@ private:
 	// datum corresponding to the point
 	IDatum *m_datum;
 
+	// have the properties of the datum below been cached?
+	mutable BOOL m_is_cached;
+
+	// properties of the datum that the comparisons use; looking them up
+	// takes virtual calls and type lookups, and a point is compared many
+	// times while histograms are merged
+	mutable BOOL m_is_null;
+	mutable BOOL m_is_lint_mappable;
+	mutable BOOL m_is_double_mappable;
+	mutable BOOL m_is_time_related;
+
+	// LINT mapping of a non-null datum mappable to LINT
+	mutable LINT m_lint_mapping;
+
+	// CDouble mapping of a non-null datum mappable to CDouble
+	mutable CDouble m_double_mapping;
+
+	// cache the properties of the datum
+	void CacheDatumProps() const;
+
+	// cache the properties of the datum if not done yet
+	void
+	EnsureDatumProps() const
+	{
+		if (!m_is_cached)
+		{
+			CacheDatumProps();
+		}
+	}
+
+	// can this point be compared to another
+	BOOL StatsAreComparable(const CPoint *point) const;
+
 public:
 	// c'tor
 	explicit CPoint(IDatum *);
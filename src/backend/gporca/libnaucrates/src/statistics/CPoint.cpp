@@ -14,6 +14,7 @@
 #include "gpos/base.h"
 
 #include "gpopt/mdcache/CMDAccessor.h"
+#include "naucrates/md/CMDTypeGenericGPDB.h"
 #include "naucrates/statistics/CStatistics.h"
 
 using namespace gpnaucrates;
@@ -29,11 +30,79 @@ FORCE_GENERATE_DBGSTR(CPoint);
 //		Ctor
 //
 //---------------------------------------------------------------------------
-CPoint::CPoint(IDatum *datum) : m_datum(datum)
+CPoint::CPoint(IDatum *datum)
+	: m_datum(datum),
+	  m_is_cached(false),
+	  m_is_null(false),
+	  m_is_lint_mappable(false),
+	  m_is_double_mappable(false),
+	  m_is_time_related(false),
+	  m_lint_mapping(0),
+	  m_double_mapping(0.0)
 {
 	GPOS_ASSERT(NULL != m_datum);
 }
 
+//---------------------------------------------------------------------------
+//	@function:
+//		CPoint::CacheDatumProps
+//
+//	@doc:
+//		Cache the properties of the datum used by the comparisons; this is
+//		done on the first comparison, as the mapping of some datums can only
+//		be looked up in an optimization context
+//
+//---------------------------------------------------------------------------
+void
+CPoint::CacheDatumProps() const
+{
+	m_is_null = m_datum->IsNull();
+	m_is_lint_mappable = m_datum->IsDatumMappableToLINT();
+	m_is_double_mappable = m_datum->IsDatumMappableToDouble();
+	m_is_time_related =
+		CMDTypeGenericGPDB::IsTimeRelatedType(m_datum->MDId());
+
+	if (!m_is_null && m_is_lint_mappable)
+	{
+		m_lint_mapping = m_datum->GetLINTMapping();
+	}
+
+	if (!m_is_null && m_is_double_mappable)
+	{
+		m_double_mapping = m_datum->GetDoubleMapping();
+	}
+
+	m_is_cached = true;
+}
+
+//---------------------------------------------------------------------------
+//	@function:
+//		CPoint::StatsAreComparable
+//
+//	@doc:
+//		Can this point be compared to another; same as
+//		IDatum::StatsAreComparable, on the cached properties
+//
+//---------------------------------------------------------------------------
+BOOL
+CPoint::StatsAreComparable(const CPoint *point) const
+{
+	GPOS_ASSERT(NULL != point);
+
+	EnsureDatumProps();
+	point->EnsureDatumProps();
+
+	// different time related types cannot be compared
+	if (m_is_time_related && point->m_is_time_related &&
+		!m_datum->MDId()->Equals(point->m_datum->MDId()))
+	{
+		return false;
+	}
+
+	return (m_is_double_mappable && point->m_is_double_mappable) ||
+		   (m_is_lint_mappable && point->m_is_lint_mappable);
+}
+
 //---------------------------------------------------------------------------
 //	@function:
 //		CPoint::Equals
@@ -46,7 +115,33 @@ BOOL
 CPoint::Equals(const CPoint *point) const
 {
 	GPOS_ASSERT(NULL != point);
-	return m_datum->StatsAreEqual(point->m_datum);
+
+	EnsureDatumProps();
+	point->EnsureDatumProps();
+
+	BOOL is_lint_comparison = m_is_lint_mappable && point->m_is_lint_mappable;
+	BOOL is_double_comparison =
+		m_is_double_mappable && point->m_is_double_mappable;
+
+	if (!is_lint_comparison && !is_double_comparison)
+	{
+		// datums without a mapping are compared byte by byte
+		return m_datum->StatsAreEqual(point->m_datum);
+	}
+
+	// nulls are equal from stats point of view
+	if (m_is_null || point->m_is_null)
+	{
+		return m_is_null && point->m_is_null;
+	}
+
+	if (is_lint_comparison)
+	{
+		return m_lint_mapping == point->m_lint_mapping;
+	}
+
+	CDouble diff = m_double_mapping - point->m_double_mapping;
+	return diff.Absolute() <= CStatistics::Epsilon;
 }
 
 //---------------------------------------------------------------------------
@@ -75,8 +170,25 @@ BOOL
 CPoint::IsLessThan(const CPoint *point) const
 {
 	GPOS_ASSERT(NULL != point);
-	return m_datum->StatsAreComparable(point->m_datum) &&
-		   m_datum->StatsAreLessThan(point->m_datum);
+
+	if (!StatsAreComparable(point))
+	{
+		return false;
+	}
+
+	// nulls are less than everything else except nulls
+	if (m_is_null || point->m_is_null)
+	{
+		return m_is_null && !point->m_is_null;
+	}
+
+	if (m_is_lint_mappable && point->m_is_lint_mappable)
+	{
+		return m_lint_mapping < point->m_lint_mapping;
+	}
+
+	CDouble diff = point->m_double_mapping - m_double_mapping;
+	return diff > CStatistics::Epsilon;
 }
 
 //---------------------------------------------------------------------------
@@ -104,8 +216,8 @@ CPoint::IsLessThanOrEqual(const CPoint *point) const
 BOOL
 CPoint::IsGreaterThan(const CPoint *point) const
 {
-	return m_datum->StatsAreComparable(point->m_datum) &&
-		   m_datum->StatsAreGreaterThan(point->m_datum);
+	GPOS_ASSERT(NULL != point);
+	return point->IsLessThan(this);
 }
 
 //---------------------------------------------------------------------------
@@ -139,11 +251,28 @@ CPoint::Width(const CPoint *point, BOOL include_lower, BOOL include_upper) const
 	CDouble width = CDouble(1.0);
 	CDouble adjust = CDouble(0.0);
 	GPOS_ASSERT(NULL != point);
-	if (m_datum->StatsAreComparable(point->m_datum))
+	if (StatsAreComparable(point))
 	{
 		// default case [this, point) or (this, point]
-		width = CDouble(m_datum->GetStatsDistanceFrom(point->m_datum));
-		if (m_datum->IsDatumMappableToLINT())
+		if (m_is_null)
+		{
+			// nulls are equal from stats point of view
+			width = CDouble(point->m_is_null ? 1.0 : 0.0);
+		}
+		else if (point->m_is_null)
+		{
+			width = CDouble(0.0);
+		}
+		else if (m_is_lint_mappable && point->m_is_lint_mappable)
+		{
+			width = CDouble(m_lint_mapping - point->m_lint_mapping);
+		}
+		else
+		{
+			width = m_double_mapping - point->m_double_mapping;
+		}
+
+		if (m_is_lint_mappable)
 		{
 			adjust = CDouble(1.0);
 		}
@@ -152,7 +281,7 @@ CPoint::Width(const CPoint *point, BOOL include_lower, BOOL include_upper) const
 			// for the case of doubles, the distance could be any point along
 			// between the int values, so make a small adjust by a factor of
 			// 10 * Epsilon (as anything smaller than Epsilon is treated as 0)
-			GPOS_ASSERT(m_datum->IsDatumMappableToDouble());
+			GPOS_ASSERT(m_is_double_mappable);
 			adjust = CStatistics::Epsilon * 10;
 		}
 	}
@@ -0,0 +1,559 @@
+//---------------------------------------------------------------------------
+//	Greenplum Database
+//	Copyright (C) 2020 Pivotal Software, Inc.
+//
+//	@filename:
+//		main.cpp
+//
+//	@doc:
+//		Optimizer benchmark; replays minidumps, and compares the
+//		optimization time, peak memory and search effort with a baseline
+//
+//		Usage:
+//			gporca_bench -f <minidump list> [-n <iterations>]
+//				[-b <baseline file> [-w]] [-t <tolerance percent>]
+//
+//		With -w, the measurements are written to the baseline file instead
+//		of being compared with it. The exit status is non-zero when any
+//		measurement exceeds its baseline by more than the tolerance, or
+//		when the baseline file or the baseline of a minidump is missing.
+//---------------------------------------------------------------------------
+
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "gpos/_api.h"
+#include "gpos/common/CMainArgs.h"
+#include "gpos/common/CWallClock.h"
+#include "gpos/common/clibwrapper.h"
+#include "gpos/error/CAutoTrace.h"
+#include "gpos/memory/CAutoMemoryPool.h"
+#include "gpos/types.h"
+
+#include "gpopt/init.h"
+#include "gpopt/mdcache/CMDCache.h"
+#include "gpopt/minidump/CDXLMinidump.h"
+#include "gpopt/minidump/CMetadataAccessorFactory.h"
+#include "gpopt/minidump/CMinidumperUtils.h"
+#include "gpopt/optimizer/COptimizerConfig.h"
+#include "naucrates/init.h"
+
+#include "unittest/base.h"
+
+using namespace gpos;
+using namespace gpopt;
+using namespace gpdxl;
+
+// default number of times each minidump is optimized
+#define GPOPT_BENCH_ITERATIONS 5
+
+// default tolerance, in percent of the baseline
+#define GPOPT_BENCH_TOLERANCE 20
+
+// optimization time differences below this many ms are not regressions,
+// as they are within the noise of the timer
+#define GPOPT_BENCH_TIME_SLACK_MS 10
+
+// measurements of a minidump
+struct SBenchmarkResult
+{
+	// minidump file name
+	std::string m_file_name;
+
+	// shortest optimization time, in ms
+	ULLONG m_min_time;
+
+	// average optimization time, in ms
+	ULLONG m_avg_time;
+
+	// highest peak memory of the optimizations, in bytes
+	ULLONG m_peak_memory;
+
+	// number of memo groups
+	ULLONG m_memo_groups;
+
+	// number of optimization jobs
+	ULLONG m_jobs;
+
+	// ctor
+	SBenchmarkResult()
+		: m_min_time(0),
+		  m_avg_time(0),
+		  m_peak_memory(0),
+		  m_memo_groups(0),
+		  m_jobs(0)
+	{
+	}
+};
+
+typedef std::vector<SBenchmarkResult> BenchmarkResultArray;
+
+// benchmark options
+struct SBenchmarkOptions
+{
+	const CHAR *m_list_file_name;
+	const CHAR *m_baseline_file_name;
+	ULONG m_iterations;
+	ULONG m_tolerance;
+	BOOL m_write_baseline;
+};
+
+// number of regressions found by PvExec
+static ULONG regressions = 0;
+
+
+//---------------------------------------------------------------------------
+//	@function:
+//		ReadMinidumpList
+//
+//	@doc:
+//		Read the minidump file names of a list, one per line; empty lines
+//		and lines starting with '#' are skipped
+//
+//---------------------------------------------------------------------------
+static BOOL
+ReadMinidumpList(const CHAR *list_file_name,
+				 std::vector<std::string> *file_names)
+{
+	std::ifstream ifs(list_file_name);
+	if (!ifs.is_open())
+	{
+		return false;
+	}
+
+	std::string line;
+	while (std::getline(ifs, line))
+	{
+		if (!line.empty() && '#' != line[0])
+		{
+			file_names->push_back(line);
+		}
+	}
+
+	return true;
+}
+
+
+//---------------------------------------------------------------------------
+//	@function:
+//		ReadBaseline
+//
+//	@doc:
+//		Read a baseline file, as written by WriteBaseline; returns false if
+//		the file cannot be opened
+//
+//---------------------------------------------------------------------------
+static BOOL
+ReadBaseline(const CHAR *baseline_file_name, BenchmarkResultArray *baseline)
+{
+	std::ifstream ifs(baseline_file_name);
+	if (!ifs.is_open())
+	{
+		return false;
+	}
+
+	std::string line;
+	while (std::getline(ifs, line))
+	{
+		if (line.empty() || '#' == line[0])
+		{
+			continue;
+		}
+
+		std::istringstream iss(line);
+		SBenchmarkResult result;
+		if (iss >> result.m_file_name >> result.m_min_time >>
+			result.m_peak_memory >> result.m_memo_groups >> result.m_jobs)
+		{
+			baseline->push_back(result);
+		}
+	}
+
+	return true;
+}
+
+
+//---------------------------------------------------------------------------
+//	@function:
+//		WriteBaseline
+//
+//	@doc:
+//		Write the measurements to a baseline file
+//
+//---------------------------------------------------------------------------
+static BOOL
+WriteBaseline(const CHAR *baseline_file_name,
+			  const BenchmarkResultArray &results)
+{
+	std::ofstream ofs(baseline_file_name);
+	if (!ofs.is_open())
+	{
+		return false;
+	}
+
+	ofs << "# minidump min_time_ms peak_memory_bytes memo_groups jobs"
+		<< std::endl;
+	for (ULONG ul = 0; ul < results.size(); ul++)
+	{
+		const SBenchmarkResult &result = results[ul];
+		ofs << result.m_file_name << " " << result.m_min_time << " "
+			<< result.m_peak_memory << " " << result.m_memo_groups << " "
+			<< result.m_jobs << std::endl;
+	}
+
+	return ofs.good();
+}
+
+
+//---------------------------------------------------------------------------
+//	@function:
+//		UlSegments
+//
+//	@doc:
+//		Number of segments to optimize a minidump for, as in the plan
+//		correctness tests
+//
+//---------------------------------------------------------------------------
+static ULONG
+UlSegments(COptimizerConfig *optimizer_config)
+{
+	ULONG segments = GPOPT_TEST_SEGMENTS;
+	if (NULL != optimizer_config->GetCostModel() &&
+		segments < optimizer_config->GetCostModel()->UlHosts())
+	{
+		segments = optimizer_config->GetCostModel()->UlHosts();
+	}
+
+	return segments;
+}
+
+
+//---------------------------------------------------------------------------
+//	@function:
+//		RunMinidump
+//
+//	@doc:
+//		Optimize a minidump the given number of times, and record the
+//		measurements; each optimization starts with an empty metadata
+//		cache, and allocates from a memory pool of its own, whose peak
+//		size is its memory use
+//
+//---------------------------------------------------------------------------
+static void
+RunMinidump(const CHAR *file_name, ULONG iterations, SBenchmarkResult *result)
+{
+	ULLONG total_time = 0;
+	result->m_file_name = file_name;
+
+	for (ULONG ul = 0; ul < iterations; ul++)
+	{
+		CAutoMemoryPool amp;
+		CMemoryPool *mp = amp.Pmp();
+
+		CDXLMinidump *pdxlmd = CMinidumperUtils::PdxlmdLoad(mp, file_name);
+		GPOS_CHECK_ABORT;
+
+		COptimizerConfig *optimizer_config = pdxlmd->GetOptimizerConfig();
+		if (NULL == optimizer_config)
+		{
+			optimizer_config = COptimizerConfig::PoconfDefault(mp);
+		}
+		else
+		{
+			optimizer_config->AddRef();
+		}
+
+		CMDCache::Reset();
+		CMetadataAccessorFactory factory(mp, pdxlmd, file_name);
+
+		ULLONG time = 0;
+		ULLONG peak_memory = 0;
+		{
+			CAutoMemoryPool ampOptimization;
+			CMemoryPool *mpOptimization = ampOptimization.Pmp();
+
+			CWallClock clock;
+			CDXLNode *pdxlnPlan = CMinidumperUtils::PdxlnExecuteMinidump(
+				mpOptimization, factory.Pmda(), pdxlmd, file_name,
+				UlSegments(optimizer_config), 1 /*ulSessionId*/,
+				1 /*ulCmdId*/, optimizer_config, NULL /*pceeval*/);
+			time = clock.ElapsedMS();
+
+			pdxlnPlan->Release();
+			peak_memory = mpOptimization->PeakAllocatedSize();
+		}
+
+		total_time += time;
+		if (0 == ul || time < result->m_min_time)
+		{
+			result->m_min_time = time;
+		}
+		result->m_peak_memory = std::max(result->m_peak_memory, peak_memory);
+		result->m_memo_groups = optimizer_config->UlMemoGroups();
+		result->m_jobs = optimizer_config->UllJobs();
+
+		optimizer_config->Release();
+		GPOS_DELETE(pdxlmd);
+	}
+
+	result->m_avg_time = total_time / iterations;
+}
+
+
+//---------------------------------------------------------------------------
+//	@function:
+//		FExceeds
+//
+//	@doc:
+//		Does a measurement exceed its baseline by more than the tolerance?
+//
+//---------------------------------------------------------------------------
+static BOOL
+FExceeds(ULLONG value, ULLONG baseline_value, ULONG tolerance)
+{
+	return value * 100 > baseline_value * (100 + tolerance);
+}
+
+
+//---------------------------------------------------------------------------
+//	@function:
+//		UlCompare
+//
+//	@doc:
+//		Compare the measurements of a minidump with its baseline, report
+//		the regressions, and return their number
+//
+//---------------------------------------------------------------------------
+static ULONG
+UlCompare(CMemoryPool *mp, const SBenchmarkResult &result,
+		  const SBenchmarkResult &baseline, ULONG tolerance)
+{
+	ULONG regressed = 0;
+	CAutoTrace at(mp);
+
+	if (FExceeds(result.m_min_time, baseline.m_min_time, tolerance) &&
+		result.m_min_time > baseline.m_min_time + GPOPT_BENCH_TIME_SLACK_MS)
+	{
+		at.Os() << "REGRESSION " << result.m_file_name.c_str() << ": time ["
+				<< result.m_min_time << "] ms, baseline ["
+				<< baseline.m_min_time << "] ms" << std::endl;
+		regressed++;
+	}
+
+	if (FExceeds(result.m_peak_memory, baseline.m_peak_memory, tolerance))
+	{
+		at.Os() << "REGRESSION " << result.m_file_name.c_str()
+				<< ": peak memory [" << result.m_peak_memory
+				<< "] bytes, baseline [" << baseline.m_peak_memory
+				<< "] bytes" << std::endl;
+		regressed++;
+	}
+
+	if (FExceeds(result.m_memo_groups, baseline.m_memo_groups, tolerance))
+	{
+		at.Os() << "REGRESSION " << result.m_file_name.c_str()
+				<< ": memo groups [" << result.m_memo_groups
+				<< "], baseline [" << baseline.m_memo_groups << "]"
+				<< std::endl;
+		regressed++;
+	}
+
+	if (FExceeds(result.m_jobs, baseline.m_jobs, tolerance))
+	{
+		at.Os() << "REGRESSION " << result.m_file_name.c_str() << ": jobs ["
+				<< result.m_jobs << "], baseline [" << baseline.m_jobs << "]"
+				<< std::endl;
+		regressed++;
+	}
+
+	return regressed;
+}
+
+
+//---------------------------------------------------------------------------
+//	@function:
+//		PvExec
+//
+//	@doc:
+//		Function driving execution
+//
+//---------------------------------------------------------------------------
+static void *
+PvExec(void *pv)
+{
+	CMainArgs *pma = (CMainArgs *) pv;
+	CMemoryPool *mp = ITask::Self()->Pmp();
+
+	SBenchmarkOptions options;
+	options.m_list_file_name = NULL;
+	options.m_baseline_file_name = NULL;
+	options.m_iterations = GPOPT_BENCH_ITERATIONS;
+	options.m_tolerance = GPOPT_BENCH_TOLERANCE;
+	options.m_write_baseline = false;
+
+	CHAR ch = '\0';
+	while (pma->Getopt(&ch))
+	{
+		switch (ch)
+		{
+			case 'f':
+				options.m_list_file_name = optarg;
+				break;
+
+			case 'b':
+				options.m_baseline_file_name = optarg;
+				break;
+
+			case 'n':
+				options.m_iterations = (ULONG) std::max(
+					(LINT) 1, clib::Strtol(optarg, NULL, 10));
+				break;
+
+			case 't':
+				options.m_tolerance = (ULONG) std::max(
+					(LINT) 0, clib::Strtol(optarg, NULL, 10));
+				break;
+
+			case 'w':
+				options.m_write_baseline = true;
+				break;
+
+			default:
+				// ignore other parameters
+				break;
+		}
+	}
+
+	std::vector<std::string> file_names;
+	if (NULL == options.m_list_file_name ||
+		!ReadMinidumpList(options.m_list_file_name, &file_names))
+	{
+		GPOS_TRACE(GPOS_WSZ_LIT("Cannot read the minidump list given by -f"));
+		regressions = 1;
+		return NULL;
+	}
+
+	if (options.m_write_baseline && NULL == options.m_baseline_file_name)
+	{
+		GPOS_TRACE(GPOS_WSZ_LIT("Option -w needs a baseline file given by -b"));
+		regressions = 1;
+		return NULL;
+	}
+
+	BenchmarkResultArray baseline;
+	BOOL has_baseline = !options.m_write_baseline &&
+						NULL != options.m_baseline_file_name;
+	if (has_baseline &&
+		!ReadBaseline(options.m_baseline_file_name, &baseline))
+	{
+		GPOS_TRACE(GPOS_WSZ_LIT(
+			"Cannot read the baseline file given by -b; record one with -w"));
+		regressions = 1;
+		return NULL;
+	}
+
+	// initialize DXL support
+	InitDXL();
+
+	CMDCache::Init();
+
+	BenchmarkResultArray results;
+	for (ULONG ul = 0; ul < file_names.size(); ul++)
+	{
+		SBenchmarkResult result;
+		RunMinidump(file_names[ul].c_str(), options.m_iterations, &result);
+		results.push_back(result);
+
+		{
+			CAutoTrace at(mp);
+			at.Os() << result.m_file_name.c_str() << ": time min/avg ["
+					<< result.m_min_time << "/" << result.m_avg_time
+					<< "] ms, peak memory [" << result.m_peak_memory
+					<< "] bytes, memo groups [" << result.m_memo_groups
+					<< "], jobs [" << result.m_jobs << "]";
+		}
+
+		if (!has_baseline)
+		{
+			continue;
+		}
+
+		ULONG ulBaseline = 0;
+		while (ulBaseline < baseline.size() &&
+			   baseline[ulBaseline].m_file_name != result.m_file_name)
+		{
+			ulBaseline++;
+		}
+
+		if (ulBaseline < baseline.size())
+		{
+			regressions += UlCompare(mp, result, baseline[ulBaseline],
+									 options.m_tolerance);
+		}
+		else
+		{
+			CAutoTrace at(mp);
+			at.Os() << result.m_file_name.c_str()
+					<< ": no baseline; record one with -w";
+			regressions++;
+		}
+	}
+
+	CMDCache::Shutdown();
+
+	if (options.m_write_baseline &&
+		!WriteBaseline(options.m_baseline_file_name, results))
+	{
+		GPOS_TRACE(GPOS_WSZ_LIT("Cannot write the baseline file"));
+		regressions = 1;
+	}
+
+	return NULL;
+}
+
+
+//---------------------------------------------------------------------------
+//	@function:
+//		main
+//
+//	@doc:
+//		Entry point for the optimizer benchmark
+//
+//---------------------------------------------------------------------------
+INT
+main(INT iArgs, const CHAR **rgszArgs)
+{
+	// Use default allocator
+	struct gpos_init_params gpos_params = {NULL};
+
+	gpos_init(&gpos_params);
+	gpdxl_init();
+	gpopt_init();
+
+	GPOS_ASSERT(iArgs >= 0);
+
+	CMainArgs ma(iArgs, rgszArgs, "f:b:n:t:w");
+
+	gpos_exec_params params;
+	params.func = PvExec;
+	params.arg = &ma;
+	params.stack_start = &params;
+	params.error_buffer = NULL;
+	params.error_buffer_size = -1;
+	params.abort_requested = NULL;
+
+	if (gpos_exec(&params) || (regressions != 0))
+	{
+		return 1;
+	}
+	else
+	{
+		return 0;
+	}
+}
+
+
+// EOF
@@ -36,6 +36,8 @@ public:
 
 	static GPOS_RESULT EresUnittest_CPointBool();
 
+	static GPOS_RESULT EresUnittest_CPointNullAndDouble();
+
 };	// class CPointTest
 }  // namespace gpnaucrates
 
@@ -23,6 +23,7 @@
 #include "naucrates/statistics/CPoint.h"
 
 #include "unittest/base.h"
+#include "unittest/dxl/statistics/CCardinalityTestUtils.h"
 #include "unittest/gpopt/CTestUtils.h"
 
 using namespace gpopt;
@@ -35,6 +36,7 @@ CPointTest::EresUnittest()
 	CUnittest rgutSharedOptCtxt[] = {
 		GPOS_UNITTEST_FUNC(CPointTest::EresUnittest_CPointInt4),
 		GPOS_UNITTEST_FUNC(CPointTest::EresUnittest_CPointBool),
+		GPOS_UNITTEST_FUNC(CPointTest::EresUnittest_CPointNullAndDouble),
 	};
 
 	CAutoMemoryPool amp;
@@ -108,4 +110,73 @@ CPointTest::EresUnittest_CPointBool()
 	return GPOS_OK;
 }
 
+// null and double point tests, checking that the comparisons agree with
+// the ones of the datums
+GPOS_RESULT
+CPointTest::EresUnittest_CPointNullAndDouble()
+{
+	// create memory pool
+	CAutoMemoryPool amp;
+	CMemoryPool *mp = amp.Pmp();
+
+	CPoint *point_null = CTestUtils::PpointInt4NullVal(mp);
+	CPoint *point1 = CTestUtils::PpointInt4(mp, 1);
+
+	GPOS_RTL_ASSERT_MSG(point_null->Equals(point_null), "null == null");
+	GPOS_RTL_ASSERT_MSG(point_null->IsNotEqual(point1), "null != 1");
+	GPOS_RTL_ASSERT_MSG(point_null->IsLessThan(point1), "null < 1");
+	GPOS_RTL_ASSERT_MSG(!point1->IsLessThan(point_null), "!(1 < null)");
+	GPOS_RTL_ASSERT_MSG(point1->IsGreaterThan(point_null), "1 > null");
+
+	// values closer than epsilon are equal
+	CPoint *point2 =
+		CCardinalityTestUtils::PpointDouble(mp, GPDB_FLOAT8, CDouble(1.5));
+	CPoint *point3 = CCardinalityTestUtils::PpointDouble(
+		mp, GPDB_FLOAT8, CDouble(1.5) + CStatistics::Epsilon / 2);
+	CPoint *point4 =
+		CCardinalityTestUtils::PpointDouble(mp, GPDB_FLOAT8, CDouble(2.5));
+
+	GPOS_RTL_ASSERT_MSG(point2->Equals(point3), "1.5 == 1.5 + epsilon/2");
+	GPOS_RTL_ASSERT_MSG(!point2->IsLessThan(point3),
+						"!(1.5 < 1.5 + epsilon/2)");
+	GPOS_RTL_ASSERT_MSG(point2->IsLessThan(point4), "1.5 < 2.5");
+	GPOS_RTL_ASSERT_MSG(point4->IsGreaterThanOrEqual(point2), "2.5 >= 1.5");
+
+	CPoint *points[] = {point_null, point1, point2, point3, point4};
+	for (ULONG ul = 0; ul < GPOS_ARRAY_SIZE(points); ul++)
+	{
+		for (ULONG ulOther = 0; ulOther < GPOS_ARRAY_SIZE(points); ulOther++)
+		{
+			IDatum *datum = points[ul]->GetDatum();
+			IDatum *datum_other = points[ulOther]->GetDatum();
+			BOOL is_comparable = datum->StatsAreComparable(datum_other);
+
+			GPOS_RTL_ASSERT_MSG(
+				(is_comparable && datum->StatsAreLessThan(datum_other)) ==
+					points[ul]->IsLessThan(points[ulOther]),
+				"less than differs from datum comparison");
+			if (is_comparable)
+			{
+				GPOS_RTL_ASSERT_MSG(datum->StatsAreEqual(datum_other) ==
+										points[ul]->Equals(points[ulOther]),
+									"equality differs from datum comparison");
+			}
+		}
+	}
+
+	CDouble dDistance = point4->Distance(point2);
+
+	// should be 1.0
+	GPOS_RTL_ASSERT_MSG(0.99 < dDistance && dDistance < 1.01,
+						"incorrect distance calculation");
+
+	point_null->Release();
+	point1->Release();
+	point2->Release();
+	point3->Release();
+	point4->Release();
+
+	return GPOS_OK;
+}
+
 // EOF
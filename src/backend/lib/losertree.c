@@ -0,0 +1,244 @@
+/*-------------------------------------------------------------------------
+ *
+ * losertree.c
+ *	  A tournament tree of losers, for merging sorted streams
+ *
+ * A loser tree holds one node per input stream in its leaves.  Every
+ * internal node remembers the leaf that lost the match played there, and
+ * the overall winner is kept separately.  When the winner is replaced by the
+ * next node of the same stream, only the matches on the path from its leaf
+ * to the root are replayed, one comparison per level.  A binary heap needs
+ * two comparisons per level to sift the replacement down, so a loser tree
+ * halves the comparisons of a k-way merge.
+ *
+ * A stream that runs out is marked inactive and loses every match from then
+ * on; its leaf stays in the tree.
+ *
+ * Copyright (c) 2020-Present Pivotal Software, Inc.
+ *
+ *
+ * IDENTIFICATION
+ *	    src/backend/lib/losertree.c
+ *
+ *-------------------------------------------------------------------------
+ */
+
+#include "postgres.h"
+
+#include "lib/losertree.h"
+
+static void replay(losertree *tree, int leaf);
+
+/*
+ * Does leaf 'a' beat leaf 'b'?
+ */
+static inline bool
+leaf_beats(losertree *tree, int a, int b)
+{
+	if (!tree->lt_active[a])
+		return false;
+	if (!tree->lt_active[b])
+		return true;
+	return tree->lt_compare(tree->lt_leaves[a], tree->lt_leaves[b],
+							tree->lt_arg) > 0;
+}
+
+/*
+ * losertree_allocate
+ *
+ * Returns a pointer to a newly-allocated tree that can merge up to
+ * 'capacity' streams, picking the winner with the given comparator function,
+ * which will be invoked with the additional argument specified by 'arg'.
+ */
+losertree *
+losertree_allocate(int capacity, losertree_comparator compare, void *arg)
+{
+	losertree  *tree;
+
+	Assert(capacity > 0);
+
+	tree = (losertree *) palloc(sizeof(losertree));
+	tree->lt_space = capacity;
+	tree->lt_compare = compare;
+	tree->lt_arg = arg;
+	tree->lt_losers = (int *) palloc(sizeof(int) * capacity);
+	tree->lt_active = (bool *) palloc(sizeof(bool) * capacity);
+	tree->lt_leaves = (Datum *) palloc(sizeof(Datum) * capacity);
+
+	losertree_reset(tree);
+
+	return tree;
+}
+
+/*
+ * losertree_reset
+ *
+ * Resets the tree to an empty state, losing its data content but not the
+ * parameters passed at allocation.
+ */
+void
+losertree_reset(losertree *tree)
+{
+	tree->lt_nleaves = 0;
+	tree->lt_size = 0;
+	tree->lt_built = false;
+}
+
+/*
+ * losertree_free
+ *
+ * Releases memory used by the given losertree.
+ */
+void
+losertree_free(losertree *tree)
+{
+	pfree(tree->lt_losers);
+	pfree(tree->lt_active);
+	pfree(tree->lt_leaves);
+	pfree(tree);
+}
+
+/*
+ * losertree_add_unordered
+ *
+ * Adds the first node of a new stream.  All streams must be added before
+ * losertree_build() is called.
+ */
+void
+losertree_add_unordered(losertree *tree, Datum d)
+{
+	Assert(!tree->lt_built);
+
+	if (tree->lt_nleaves >= tree->lt_space)
+		elog(ERROR, "out of loser tree slots");
+
+	tree->lt_leaves[tree->lt_nleaves] = d;
+	tree->lt_active[tree->lt_nleaves] = true;
+	tree->lt_nleaves++;
+	tree->lt_size++;
+}
+
+/*
+ * losertree_build
+ *
+ * Plays all the matches of the tournament, in O(n) comparisons.
+ *
+ * With n leaves, internal nodes are numbered 1 .. n-1 and leaf i sits at
+ * position n + i, so the parent of position p is p / 2.
+ */
+void
+losertree_build(losertree *tree)
+{
+	int			n = tree->lt_nleaves;
+	int		   *winners;
+	int			p;
+
+	tree->lt_built = true;
+
+	if (n == 0)
+		return;
+	if (n == 1)
+	{
+		tree->lt_losers[0] = 0;
+		return;
+	}
+
+	winners = (int *) palloc(sizeof(int) * n);
+
+	for (p = n - 1; p >= 1; p--)
+	{
+		int			left = 2 * p;
+		int			right = 2 * p + 1;
+		int			l = (left >= n) ? left - n : winners[left];
+		int			r = (right >= n) ? right - n : winners[right];
+
+		if (leaf_beats(tree, r, l))
+		{
+			winners[p] = r;
+			tree->lt_losers[p] = l;
+		}
+		else
+		{
+			winners[p] = l;
+			tree->lt_losers[p] = r;
+		}
+	}
+	tree->lt_losers[0] = winners[1];
+
+	pfree(winners);
+}
+
+/*
+ * losertree_first
+ *
+ * Returns the winning node, without removing it.
+ */
+Datum
+losertree_first(losertree *tree)
+{
+	Assert(tree->lt_built && !losertree_empty(tree));
+
+	return tree->lt_leaves[tree->lt_losers[0]];
+}
+
+/*
+ * losertree_remove_first
+ *
+ * The stream of the winning node has run out.  Its leaf loses all further
+ * matches.
+ */
+void
+losertree_remove_first(losertree *tree)
+{
+	int			leaf;
+
+	Assert(tree->lt_built && !losertree_empty(tree));
+
+	leaf = tree->lt_losers[0];
+	tree->lt_active[leaf] = false;
+	tree->lt_size--;
+
+	replay(tree, leaf);
+}
+
+/*
+ * losertree_replace_first
+ *
+ * Replaces the winning node with the next node of the same stream, and
+ * finds the new winner.
+ */
+void
+losertree_replace_first(losertree *tree, Datum d)
+{
+	int			leaf;
+
+	Assert(tree->lt_built && !losertree_empty(tree));
+
+	leaf = tree->lt_losers[0];
+	tree->lt_leaves[leaf] = d;
+
+	replay(tree, leaf);
+}
+
+/*
+ * Replay the matches on the path from the given leaf, which has just been
+ * changed, up to the root.
+ */
+static void
+replay(losertree *tree, int leaf)
+{
+	int			winner = leaf;
+	int			p;
+
+	for (p = (tree->lt_nleaves + leaf) / 2; p >= 1; p /= 2)
+	{
+		int			loser = tree->lt_losers[p];
+
+		if (leaf_beats(tree, loser, winner))
+		{
+			tree->lt_losers[p] = winner;
+			winner = loser;
+		}
+	}
+	tree->lt_losers[0] = winner;
+}
@@ -138,6 +138,11 @@ _copyPlannedStmt(const PlannedStmt *from)
 	COPY_SCALAR_FIELD(total_memory_master);
 	COPY_SCALAR_FIELD(nsegments_master);
 
+	COPY_SCALAR_FIELD(optimizerSearchStage);
+	COPY_SCALAR_FIELD(optimizerSearchStages);
+	COPY_SCALAR_FIELD(optimizerSearchTime);
+	COPY_SCALAR_FIELD(optimizerSearchBudgetExceeded);
+
 	return newnode;
 }
 
@@ -32,6 +32,7 @@
 
 #include <ctype.h>
 
+#include "access/hash.h"
 #include "lib/stringinfo.h"
 #include "nodes/params.h"
 #include "nodes/parsenodes.h"
@@ -42,6 +43,7 @@
 #include "cdb/cdbgang.h"
 #include "utils/workfile_mgr.h"
 #include "parser/parsetree.h"
+#include "utils/hsearch.h"
 
 
 /*
@@ -385,6 +387,11 @@ _outPlannedStmt(StringInfo str, PlannedStmt *node)
 
 	WRITE_INT_FIELD(total_memory_master);
 	WRITE_INT_FIELD(nsegments_master);
+
+	WRITE_INT_FIELD(optimizerSearchStage);
+	WRITE_INT_FIELD(optimizerSearchStages);
+	WRITE_INT_FIELD(optimizerSearchTime);
+	WRITE_BOOL_FIELD(optimizerSearchBudgetExceeded);
 }
 
 static void
@@ -1252,6 +1259,149 @@ _outAlterTableSpaceOptionsStmt(StringInfo str, AlterTableSpaceOptionsStmt *node)
 	WRITE_BOOL_FIELD(isReset);
 }
 
+/*
+ * Subtree deduplication.
+ *
+ * Plans over tables with many partitions repeat the same subtrees over and
+ * over: every partition's range table entry carries the same column name
+ * list, and a long IN-list is pushed down as the same Const into every
+ * partition scan.  When a node of one of the types accepted by
+ * _outDedupCandidate() serializes to exactly the same bytes as an earlier
+ * one, we replace it with a back-reference to the earlier copy.  readfast.c
+ * re-reads the referenced bytes, so the reader still gets a separate copy of
+ * the subtree, just as if it had been written out in full.
+ *
+ * The back-reference is written as the BINARY_BACKREF_TAG pseudo node tag,
+ * followed by the offset of the earlier copy.  It must match readfast.c.
+ */
+#define BINARY_BACKREF_TAG		((int16) 0xBEEF)
+
+/* Smaller subtrees are not worth the lookup */
+#define DEDUP_MIN_LENGTH		32
+
+typedef struct OutDedupKey
+{
+	uint32		hash;
+	int			len;
+} OutDedupKey;
+
+typedef struct OutDedupEntry
+{
+	OutDedupKey key;			/* hash key, must be first */
+	int			offset;			/* where the first copy starts */
+} OutDedupEntry;
+
+typedef struct OutDedupState
+{
+	HTAB	   *htab;			/* created on first use */
+
+	/*
+	 * Keys of the entries in 'htab', in the order they were added.  An entry
+	 * is added once its subtree has been completely written, so entries of
+	 * subtrees nested in a node always come after any entry that starts
+	 * before the node.
+	 */
+	OutDedupKey *keys;
+	int			nkeys;
+	int			maxkeys;
+} OutDedupState;
+
+/* State of the nodeToBinaryStringFast() call in progress */
+static OutDedupState *out_dedup = NULL;
+
+static bool
+_outDedupCandidate(Node *obj)
+{
+	switch (nodeTag(obj))
+	{
+		case T_Alias:
+		case T_Const:
+		case T_RangeTblEntry:
+			return true;
+		default:
+			return false;
+	}
+}
+
+/*
+ * The subtree starting at 'start' has just been written out.  If the same
+ * bytes were written earlier, replace them with a back-reference; otherwise
+ * remember them for later nodes.
+ */
+static void
+_outDedupSubtree(StringInfo str, int start)
+{
+	OutDedupState *state = out_dedup;
+	OutDedupKey key;
+	OutDedupEntry *entry;
+	bool		found;
+
+	MemSet(&key, 0, sizeof(key));
+	key.len = str->len - start;
+	if (key.len < DEDUP_MIN_LENGTH)
+		return;
+	key.hash = DatumGetUInt32(hash_any((const unsigned char *) str->data + start,
+									   key.len));
+
+	if (state->htab == NULL)
+	{
+		HASHCTL		ctl;
+
+		MemSet(&ctl, 0, sizeof(ctl));
+		ctl.keysize = sizeof(OutDedupKey);
+		ctl.entrysize = sizeof(OutDedupEntry);
+		ctl.hash = tag_hash;
+		ctl.hcxt = CurrentMemoryContext;
+		state->htab = hash_create("serialization dedup table", 256, &ctl,
+								  HASH_ELEM | HASH_FUNCTION | HASH_CONTEXT);
+
+		state->maxkeys = 256;
+		state->keys = palloc(state->maxkeys * sizeof(OutDedupKey));
+		state->nkeys = 0;
+	}
+
+	entry = (OutDedupEntry *) hash_search(state->htab, &key, HASH_ENTER, &found);
+	if (!found)
+	{
+		entry->offset = start;
+
+		if (state->nkeys >= state->maxkeys)
+		{
+			state->maxkeys *= 2;
+			state->keys = repalloc(state->keys,
+								   state->maxkeys * sizeof(OutDedupKey));
+		}
+		state->keys[state->nkeys++] = key;
+		return;
+	}
+
+	/* A hash collision; just keep the subtree as is */
+	if (memcmp(str->data + entry->offset, str->data + start, key.len) != 0)
+		return;
+
+	/*
+	 * Forget the subtrees nested in this one before truncating them away.
+	 * They were all added after 'entry', so this can't remove it.
+	 */
+	while (state->nkeys > 0 &&
+		   ((OutDedupEntry *) hash_search(state->htab, &state->keys[state->nkeys - 1],
+										  HASH_FIND, NULL))->offset >= start)
+	{
+		hash_search(state->htab, &state->keys[state->nkeys - 1], HASH_REMOVE, NULL);
+		state->nkeys--;
+	}
+
+	str->len = start;
+	str->data[str->len] = '\0';
+
+	{
+		int16		tg = BINARY_BACKREF_TAG;
+
+		appendBinaryStringInfo(str, (const char *) &tg, sizeof(int16));
+		appendBinaryStringInfo(str, (const char *) &entry->offset, sizeof(int));
+	}
+}
+
 /*
  * _outNode -
  *	  converts a Node into binary string and append it to 'str'
@@ -1259,6 +1409,8 @@ _outAlterTableSpaceOptionsStmt(StringInfo str, AlterTableSpaceOptionsStmt *node)
 static void
 _outNode(StringInfo str, void *obj)
 {
+	int			start = str->len;
+
 	if (obj == NULL)
 	{
 		int16 tg = 0;
@@ -2207,6 +2359,9 @@ _outNode(StringInfo str, void *obj)
 						 (int) nodeTag(obj));
 				break;
 		}
+
+		if (out_dedup != NULL && _outDedupCandidate(obj))
+			_outDedupSubtree(str, start);
 	}
 }
 
@@ -2219,11 +2374,31 @@ nodeToBinaryStringFast(void *obj, int *length)
 {
 	StringInfoData str;
 	int16 tg = (int16) 0xDEAD;
+	OutDedupState dedup;
+	OutDedupState *save_dedup = out_dedup;
 
 	/* see stringinfo.h for an explanation of this maneuver */
 	initStringInfoOfSize(&str, 4096);
 
-	_outNode(&str, obj);
+	MemSet(&dedup, 0, sizeof(dedup));
+	out_dedup = &dedup;
+	PG_TRY();
+	{
+		_outNode(&str, obj);
+	}
+	PG_CATCH();
+	{
+		out_dedup = save_dedup;
+		PG_RE_THROW();
+	}
+	PG_END_TRY();
+	out_dedup = save_dedup;
+
+	if (dedup.htab)
+	{
+		hash_destroy(dedup.htab);
+		pfree(dedup.keys);
+	}
 
 	/* Add something special at the end that we can check in readfast.c */
 	appendBinaryStringInfo(&str, (const char *)&tg, sizeof(int16));
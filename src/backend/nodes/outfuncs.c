@@ -330,6 +330,11 @@ _outPlannedStmt(StringInfo str, const PlannedStmt *node)
 
 	WRITE_INT_FIELD(total_memory_master);
 	WRITE_INT_FIELD(nsegments_master);
+
+	WRITE_INT_FIELD(optimizerSearchStage);
+	WRITE_INT_FIELD(optimizerSearchStages);
+	WRITE_INT_FIELD(optimizerSearchTime);
+	WRITE_BOOL_FIELD(optimizerSearchBudgetExceeded);
 }
 #endif /* COMPILING_BINARY_FUNCS */
 
@@ -201,12 +201,20 @@ static void *readNodeBinary(void);
 static Datum readDatum(bool typbyval);
 
 /*
- * Current position in the message that we are processing. We can keep
- * this in a global variable because readNodeFromBinaryString() is not
- * re-entrant. This is similar to the current position that pg_strtok()
- * keeps, used by the normal stringToNode() function.
+ * Current position in the message that we are processing, and the start of
+ * the message, for resolving back-references. This is similar to the current
+ * position that pg_strtok() keeps, used by the normal stringToNode()
+ * function. readNodeFromBinaryString() saves and restores both, so that a
+ * nested call does not disturb the message being read.
  */
 static const char *read_str_ptr;
+static const char *read_str_base;
+
+/*
+ * Pseudo node tag of a back-reference to an identical subtree earlier in the
+ * message.  See the comments on subtree deduplication in outfast.c.
+ */
+#define BINARY_BACKREF_TAG		((int16) 0xBEEF)
 
 /*
  * For most structs, we reuse the definitions from readfuncs.c. See comment
@@ -1388,6 +1396,11 @@ _readPlannedStmt(void)
 	READ_INT_FIELD(total_memory_master);
 	READ_INT_FIELD(nsegments_master);
 
+	READ_INT_FIELD(optimizerSearchStage);
+	READ_INT_FIELD(optimizerSearchStages);
+	READ_INT_FIELD(optimizerSearchTime);
+	READ_BOOL_FIELD(optimizerSearchBudgetExceeded);
+
 	READ_DONE();
 }
 
@@ -2968,6 +2981,29 @@ readNodeBinary(void)
 
 	memcpy(&ntt, read_str_ptr,sizeof(int16));
 	read_str_ptr+=sizeof(int16);
+
+	if (ntt == BINARY_BACKREF_TAG)
+	{
+		const char *save_ptr;
+		int			offset;
+
+		memcpy(&offset, read_str_ptr, sizeof(int));
+		read_str_ptr += sizeof(int);
+
+		/* Back-references always point backwards */
+		if (offset < 0 ||
+			read_str_base + offset >= read_str_ptr - sizeof(int16) - sizeof(int))
+			elog(ERROR, "Deserialization lost sync.");
+
+		/* Read a fresh copy of the earlier subtree, then continue here */
+		save_ptr = read_str_ptr;
+		read_str_ptr = read_str_base + offset;
+		return_value = readNodeBinary();
+		read_str_ptr = save_ptr;
+
+		return return_value;
+	}
+
 	nt = (NodeTag) ntt;
 
 	if (nt==0)
@@ -3846,14 +3882,30 @@ readNodeFromBinaryString(const char *str_arg, int len __attribute__((unused)))
 {
 	Node	   *node;
 	int16		tg;
+	const char *save_ptr = read_str_ptr;
+	const char *save_base = read_str_base;
 
 	read_str_ptr = str_arg;
+	read_str_base = str_arg;
+
+	PG_TRY();
+	{
+		node = readNodeBinary();
 
-	node = readNodeBinary();
+		memcpy(&tg, read_str_ptr, sizeof(int16));
+		if (tg != (int16)0xDEAD)
+			elog(ERROR,"Deserialization lost sync.");
+	}
+	PG_CATCH();
+	{
+		read_str_ptr = save_ptr;
+		read_str_base = save_base;
+		PG_RE_THROW();
+	}
+	PG_END_TRY();
 
-	memcpy(&tg, read_str_ptr, sizeof(int16));
-	if (tg != (int16)0xDEAD)
-		elog(ERROR,"Deserialization lost sync.");
+	read_str_ptr = save_ptr;
+	read_str_base = save_base;
 
 	return node;
 
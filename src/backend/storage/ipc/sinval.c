@@ -21,6 +21,7 @@
 #include "storage/proc.h"
 #include "storage/sinvaladt.h"
 #include "utils/inval.h"
+#include "utils/shared_mdcache.h"
 
 #include "cdb/cdbtm.h"          /* DtxContext */
 #include "tcop/idle_resource_cleaner.h"
@@ -64,6 +65,9 @@ void
 SendSharedInvalidMessages(const SharedInvalidationMessage *msgs, int n)
 {
 	SIInsertDataEntries(msgs, n);
+
+	/* let the shared ORCA metadata cache know what changed */
+	SharedMDCacheSendInvalidations(msgs, n);
 }
 
 /*
@@ -90,6 +90,7 @@
 #include "cdb/cdbtm.h"
 #include "cdb/cdbdtxcontextinfo.h"
 #include "cdb/cdbdisp_query.h"
+#include "cdb/cdbdisp_plancache.h"
 #include "cdb/cdbdispatchresult.h"
 #include "cdb/cdbendpoint.h"
 #include "cdb/cdbgang.h"
@@ -5353,6 +5354,8 @@ PostgresMain(int argc, char *argv[],
 					int serializedParamslen = 0;
 					int serializedQueryDispatchDesclen = 0;
 					int resgroupInfoLen = 0;
+					uint64 planId;
+					int planSlot;
 					TimestampTz statementStart;
 					Oid suid;
 					Oid ouid;
@@ -5383,6 +5386,8 @@ PostgresMain(int argc, char *argv[],
 					serializedParamslen = pq_getmsgint(&input_message, 4);
 					serializedQueryDispatchDesclen = pq_getmsgint(&input_message, 4);
 					serializedDtxContextInfolen = pq_getmsgint(&input_message, 4);
+					planId = (uint64) pq_getmsgint64(&input_message);
+					planSlot = pq_getmsgint(&input_message, 4);
 
 					/* read in the DTX context info */
 					if (serializedDtxContextInfolen == 0)
@@ -5402,6 +5407,21 @@ PostgresMain(int argc, char *argv[],
 					if (serializedPlantreelen > 0)
 						serializedPlantree = pq_getmsgbytes(&input_message,serializedPlantreelen);
 
+					/*
+					 * A cacheable plan is either sent in full, to be stored,
+					 * or left out because we stored it earlier.
+					 */
+					if (planId != InvalidDispatchPlanId)
+					{
+						if (serializedPlantreelen > 0)
+							cdbdisp_storeCachedPlan(planSlot, planId,
+													serializedPlantree,
+													serializedPlantreelen);
+						else
+							serializedPlantree = cdbdisp_lookupCachedPlan(planSlot, planId,
+																		  &serializedPlantreelen);
+					}
+
 					if (serializedParamslen > 0)
 						serializedParams = pq_getmsgbytes(&input_message,serializedParamslen);
 
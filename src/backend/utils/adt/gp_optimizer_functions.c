@@ -8,6 +8,8 @@
  *
  * gp_opt_version: This function wraps LibraryVersion. 
  *
+ * gp_orca_plan_cache_stats: This function wraps PlanCacheStats.
+ *
  * Copyright(c) 2012 - present, EMC/Greenplum
  */
 
@@ -60,3 +62,21 @@ gp_opt_version(PG_FUNCTION_ARGS __attribute__((unused)))
 	return CStringGetTextDatum("Server has been compiled without ORCA");
 #endif
 }
+
+extern Datum PlanCacheStats(PG_FUNCTION_ARGS);
+
+/*
+* Returns the counters of the optimizer plan cache of this session.
+*/
+Datum
+gp_orca_plan_cache_stats(PG_FUNCTION_ARGS)
+{
+#ifdef USE_ORCA
+	return PlanCacheStats(fcinfo);
+#else
+	ereport(ERROR,
+			(errcode(ERRCODE_FEATURE_NOT_SUPPORTED),
+			 errmsg("server has been compiled without ORCA")));
+	PG_RETURN_NULL();
+#endif
+}
@@ -865,6 +865,31 @@ MakeSharedInvalidMessagesArray(const SharedInvalidationMessage *msgs, int n)
  *
  * see also xact_redo_commit() and xact_desc_commit()
  */
+/*
+ * TransactionHasPendingInvalidations
+ *		Has the current transaction, or any of its open subtransactions,
+ *		queued invalidation messages that are not sent yet?
+ *
+ * If so, the catalog contents this backend sees are not yet the ones other
+ * backends see.
+ */
+bool
+TransactionHasPendingInvalidations(void)
+{
+	TransInvalidationInfo *info;
+
+	for (info = transInvalInfo; info != NULL; info = info->parent)
+	{
+		if (info->CurrentCmdInvalidMsgs.cclist != NULL ||
+			info->CurrentCmdInvalidMsgs.rclist != NULL ||
+			info->PriorCmdInvalidMsgs.cclist != NULL ||
+			info->PriorCmdInvalidMsgs.rclist != NULL)
+			return true;
+	}
+
+	return false;
+}
+
 int
 xactGetCommittedInvalidationMessages(SharedInvalidationMessage **msgs,
 									 bool *RelcacheInitFileInval)
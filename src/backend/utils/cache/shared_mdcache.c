@@ -0,0 +1,691 @@
+/*-------------------------------------------------------------------------
+ *
+ * shared_mdcache.c
+ *	  Shared-memory cache of serialized ORCA metadata objects
+ *
+ * Every backend has its own ORCA metadata cache (MDCache), which it fills by
+ * translating relcache and syscache entries into DXL.  With many sessions,
+ * the same objects get translated over and over again.  When
+ * optimizer_shared_mdcache_size is set, the serialized DXL of the objects is
+ * also kept in shared memory, keyed by the database and the string form of
+ * their metadata id, so that a backend can parse the DXL of an object
+ * another backend has already translated, instead of building it again.
+ * Objects of shared catalogs and of partitioned tables are not shared.
+ *
+ * Validity of the entries is tracked with version stamps, rather than by
+ * removing entries on invalidation.  Shared memory holds a global counter
+ * and an array of counters, one per partition of the invalidation space,
+ * which is made of the database and the relation OID or syscache hash value
+ * of an invalidation.  The backend that commits a catalog change bumps the
+ * counter of the partition of each relcache and syscache invalidation it
+ * sends, or the global counter for a reset of a whole catalog, right after
+ * sending them, see SharedMDCacheSendInvalidations().  The version of an
+ * object is the sum of the global counter and the counters of the partitions
+ * its invalidations would fall into, so it changes whenever the object may
+ * have changed.
+ *
+ * A backend snapshots the counters when it starts to optimize a query, and
+ * then accepts the pending invalidation messages.  Whatever it translates
+ * afterwards is at least as new as the snapshot, so it is stamped with the
+ * version computed from the snapshot.  An entry is only used if its stamp
+ * matches the version computed from the snapshot of the reader.  If the
+ * backend processes any more invalidation messages, its snapshot is out of
+ * date, and the shared cache is not used until the next snapshot.
+ *
+ * The serialized objects live in an arena split into two halves, filled one
+ * at a time.  When the current half is full, all the entries of the other
+ * half are evicted and it becomes the current one.  That is cheaper than
+ * tracking the usage of entries, and still keeps the recently added ones.
+ *
+ *
+ * Copyright (c) 2020-Present Pivotal Software, Inc.
+ *
+ *
+ * IDENTIFICATION
+ *	    src/backend/utils/cache/shared_mdcache.c
+ *
+ *-------------------------------------------------------------------------
+ */
+
+#include "postgres.h"
+
+#include "access/hash.h"
+#include "access/htup_details.h"
+#include "access/xact.h"
+#include "catalog/catalog.h"
+#include "catalog/index.h"
+#include "catalog/pg_type.h"
+#include "cdb/cdbpartition.h"
+#include "funcapi.h"
+#include "miscadmin.h"
+#include "port/atomics.h"
+#include "storage/lwlock.h"
+#include "storage/shmem.h"
+#include "utils/builtins.h"
+#include "utils/guc.h"
+#include "utils/hsearch.h"
+#include "utils/inval.h"
+#include "utils/shared_mdcache.h"
+#include "utils/syscache.h"
+
+#define SharedMDCacheEnabled()	(optimizer_shared_mdcache_size > 0)
+
+/* number of version counters, must be a power of 2 */
+#define SHARED_MDCACHE_PARTITIONS	1024
+
+/* assumed average size of a serialized object, to size the hash table */
+#define SHARED_MDCACHE_AVG_OBJECT_SIZE	1024
+
+typedef struct SharedMDCacheKey
+{
+	Oid			dbid;			/* database of the object */
+	char		mdid[SHARED_MDCACHE_KEYLEN];	/* the metadata id */
+} SharedMDCacheKey;
+
+typedef struct SharedMDCacheEntry
+{
+	SharedMDCacheKey key;		/* hash key of the entry, must be first */
+	uint64		version;		/* version the object was built at */
+	int			half;			/* arena half holding the object */
+	Size		offset;			/* offset of the object in the arena */
+	Size		len;			/* length of the object */
+} SharedMDCacheEntry;
+
+typedef struct SharedMDCacheShmem
+{
+	pg_atomic_uint64 global_version;
+	pg_atomic_uint64 versions[SHARED_MDCACHE_PARTITIONS];
+
+	pg_atomic_uint64 hits;
+	pg_atomic_uint64 misses;
+
+	/* the fields below are protected by SharedMDCacheLock */
+	uint64		inserts;
+	uint64		evictions;
+	int			nentries;
+	int			cur_half;		/* the half new objects go to */
+	Size		used[2];		/* bytes used in each half */
+} SharedMDCacheShmem;
+
+static SharedMDCacheShmem *shared_mdcache = NULL;
+static HTAB *shared_mdcache_hash = NULL;
+static char *shared_mdcache_arena = NULL;
+
+/* size of each half of the arena, and maximum number of entries */
+static Size arena_half_size;
+static int	max_entries;
+
+/*
+ * Counters as of the last SharedMDCacheBeginOptimization(), and the number
+ * of invalidations this backend had processed then.
+ */
+static uint64 snapshot_global_version;
+static uint64 snapshot_versions[SHARED_MDCACHE_PARTITIONS];
+static uint64 snapshot_ninvals;
+static bool snapshot_taken = false;
+static uint64 ninvals = 0;
+
+/*
+ * The catalog caches that the MDCache depends on, the same as for the
+ * backend-local MDCache, see register_mdcache_invalidation_callbacks() in
+ * gpdbwrappers.cpp.
+ */
+static const int metadata_caches[] = {
+	AGGFNOID,
+	AMOPOPID,
+	CASTSOURCETARGET,
+	CONSTROID,
+	OPEROID,
+	OPFAMILYOID,
+	PARTOID,
+	PARTRULEOID,
+	STATRELATTINH,
+	TYPEOID,
+	PROCOID
+};
+
+/* the caches keyed by the OID of the object that the MDCache depends on */
+static const int oid_caches[] = {
+	AGGFNOID,
+	CONSTROID,
+	OPEROID,
+	PROCOID,
+	TYPEOID
+};
+
+static void
+compute_sizes(void)
+{
+	Size		arena_size = (Size) optimizer_shared_mdcache_size * 1024L;
+
+	arena_half_size = MAXALIGN_DOWN(arena_size / 2);
+	max_entries = Max(arena_size / SHARED_MDCACHE_AVG_OBJECT_SIZE, 64);
+}
+
+Size
+SharedMDCacheShmemSize(void)
+{
+	Size		size;
+
+	if (!SharedMDCacheEnabled())
+		return 0;
+
+	compute_sizes();
+
+	size = MAXALIGN(sizeof(SharedMDCacheShmem));
+	size = add_size(size, mul_size(arena_half_size, 2));
+	size = add_size(size, hash_estimate_size(max_entries,
+											 sizeof(SharedMDCacheEntry)));
+
+	return size;
+}
+
+void
+SharedMDCacheShmemInit(void)
+{
+	HASHCTL		info;
+	bool		found;
+	int			i;
+
+	if (!SharedMDCacheEnabled())
+		return;
+
+	compute_sizes();
+
+	shared_mdcache = ShmemInitStruct("Shared MDCache",
+									 MAXALIGN(sizeof(SharedMDCacheShmem)) +
+									 arena_half_size * 2,
+									 &found);
+	shared_mdcache_arena = (char *) shared_mdcache +
+		MAXALIGN(sizeof(SharedMDCacheShmem));
+
+	if (!found)
+	{
+		pg_atomic_init_u64(&shared_mdcache->global_version, 0);
+		for (i = 0; i < SHARED_MDCACHE_PARTITIONS; i++)
+			pg_atomic_init_u64(&shared_mdcache->versions[i], 0);
+		pg_atomic_init_u64(&shared_mdcache->hits, 0);
+		pg_atomic_init_u64(&shared_mdcache->misses, 0);
+		shared_mdcache->inserts = 0;
+		shared_mdcache->evictions = 0;
+		shared_mdcache->nentries = 0;
+		shared_mdcache->cur_half = 0;
+		shared_mdcache->used[0] = 0;
+		shared_mdcache->used[1] = 0;
+	}
+
+	MemSet(&info, 0, sizeof(info));
+	info.keysize = sizeof(SharedMDCacheKey);
+	info.entrysize = sizeof(SharedMDCacheEntry);
+	info.hash = tag_hash;
+
+	shared_mdcache_hash = ShmemInitHash("Shared MDCache hash",
+										max_entries, max_entries,
+										&info, HASH_ELEM | HASH_FUNCTION);
+}
+
+/*
+ * Partition of the invalidation of the given relation OID or syscache hash
+ * value, in the given database.
+ */
+static inline int
+partition_of(Oid dbid, uint32 hashvalue)
+{
+	hashvalue ^= DatumGetUInt32(hash_uint32((uint32) dbid));
+
+	return hashvalue & (SHARED_MDCACHE_PARTITIONS - 1);
+}
+
+static bool
+is_metadata_cache(int cacheid)
+{
+	int			i;
+
+	for (i = 0; i < lengthof(metadata_caches); i++)
+	{
+		if (metadata_caches[i] == cacheid)
+			return true;
+	}
+	return false;
+}
+
+/*
+ * Bump the versions of the objects affected by the invalidation messages
+ * that have just been sent to the other backends.
+ *
+ * Called by SendSharedInvalidMessages(), so the versions are bumped once
+ * for each change, by the backend that commits it, and only after the
+ * change is visible and the messages are queued.  A backend that takes its
+ * snapshot of the versions after the bump therefore also receives the
+ * messages, before it translates anything.
+ */
+void
+SharedMDCacheSendInvalidations(const SharedInvalidationMessage *msgs, int n)
+{
+	int			i;
+
+	if (!SharedMDCacheEnabled() || shared_mdcache == NULL)
+		return;
+
+	for (i = 0; i < n; i++)
+	{
+		const SharedInvalidationMessage *msg = &msgs[i];
+		pg_atomic_uint64 *counter = NULL;
+
+		if (msg->id >= 0)
+		{
+			if (!is_metadata_cache(msg->cc.id))
+				continue;
+
+			switch (msg->cc.id)
+			{
+				case AGGFNOID:
+				case CONSTROID:
+				case OPEROID:
+				case PROCOID:
+				case STATRELATTINH:
+				case TYPEOID:
+					counter = &shared_mdcache->versions[
+						partition_of(msg->cc.dbId, msg->cc.hashValue)];
+					break;
+
+				default:
+					counter = &shared_mdcache->global_version;
+					break;
+			}
+		}
+		else if (msg->id == SHAREDINVALRELCACHE_ID)
+		{
+			/* InvalidOid means all relations */
+			if (OidIsValid(msg->rc.relId))
+				counter = &shared_mdcache->versions[
+					partition_of(msg->rc.dbId,
+								 DatumGetUInt32(hash_uint32((uint32) msg->rc.relId)))];
+			else
+				counter = &shared_mdcache->global_version;
+		}
+		else if (msg->id == SHAREDINVALCATALOG_ID)
+			counter = &shared_mdcache->global_version;
+
+		if (counter != NULL)
+			pg_atomic_fetch_add_u64(counter, 1);
+	}
+}
+
+/*
+ * Every invalidation this backend processes may make what it translates
+ * newer than its snapshot of the versions, so count them.
+ */
+static void
+shared_mdcache_syscache_callback(Datum arg, int cacheid, uint32 hashvalue)
+{
+	ninvals++;
+}
+
+static void
+shared_mdcache_relcache_callback(Datum arg, Oid relid)
+{
+	ninvals++;
+}
+
+/*
+ * InitSharedMDCache: initialize module during InitPostgres.
+ *
+ * Every backend counts the invalidations it processes, even if it never
+ * uses ORCA, so the callbacks are registered at startup.
+ */
+void
+InitSharedMDCache(void)
+{
+	int			i;
+
+	if (!SharedMDCacheEnabled())
+		return;
+
+	for (i = 0; i < lengthof(metadata_caches); i++)
+		CacheRegisterSyscacheCallback(metadata_caches[i],
+									  shared_mdcache_syscache_callback,
+									  (Datum) 0);
+
+	CacheRegisterRelcacheCallback(shared_mdcache_relcache_callback,
+								  (Datum) 0);
+}
+
+/*
+ * Take a snapshot of the version counters, before ORCA starts to look up
+ * any metadata for a query.
+ *
+ * The pending invalidation messages are accepted after the snapshot is
+ * taken, so that everything translated with it is at least as new as the
+ * snapshot.  If that processed any invalidation, take the snapshot again.
+ */
+void
+SharedMDCacheBeginOptimization(void)
+{
+	int			i;
+
+	if (!SharedMDCacheEnabled())
+		return;
+
+	do
+	{
+		snapshot_ninvals = ninvals;
+		snapshot_global_version =
+			pg_atomic_read_u64(&shared_mdcache->global_version);
+		for (i = 0; i < SHARED_MDCACHE_PARTITIONS; i++)
+			snapshot_versions[i] =
+				pg_atomic_read_u64(&shared_mdcache->versions[i]);
+
+		AcceptInvalidationMessages();
+	} while (ninvals != snapshot_ninvals);
+
+	snapshot_taken = true;
+}
+
+/*
+ * Is the snapshot still good?  Not if this backend has processed any
+ * invalidation since it was taken.
+ *
+ * Nor if this transaction may have changed the catalogs.  The version
+ * counters only move when the invalidations are sent at commit, so metadata
+ * translated from uncommitted changes would be published under the versions
+ * of the committed catalogs, and would stay valid after a rollback.  For the
+ * same reason, such a transaction must not use the shared entries.
+ */
+static inline bool
+snapshot_is_valid(void)
+{
+	return SharedMDCacheEnabled() && snapshot_taken &&
+		ninvals == snapshot_ninvals &&
+		!TransactionIdIsValid(GetTopTransactionIdIfAny()) &&
+		!TransactionHasPendingInvalidations();
+}
+
+static uint64
+oid_version(Oid oid)
+{
+	uint64		version;
+	int			i;
+
+	version = snapshot_versions[partition_of(MyDatabaseId,
+		DatumGetUInt32(hash_uint32((uint32) oid)))];
+	for (i = 0; i < lengthof(oid_caches); i++)
+		version += snapshot_versions[partition_of(MyDatabaseId,
+			GetSysCacheHashValue1(oid_caches[i], ObjectIdGetDatum(oid)))];
+
+	return version;
+}
+
+/*
+ * Can the metadata of the given relation be shared?
+ *
+ * Shared catalogs are invalidated in all databases, and not worth the
+ * trouble.  The metadata of a partitioned table is gathered from its
+ * partitions, whose invalidations don't touch the partitioned table.
+ */
+static bool
+rel_is_shareable(Oid relid)
+{
+	return !IsSharedRelation(relid) && !rel_is_partitioned(relid);
+}
+
+/*
+ * Compute the version of an object identified by an OID: a type, operator,
+ * function, aggregate or constraint.
+ *
+ * Returns false if the shared cache can't be used at the moment.
+ */
+bool
+SharedMDCacheOidVersion(Oid oid, uint64 *version)
+{
+	if (!snapshot_is_valid())
+		return false;
+
+	*version = snapshot_global_version + oid_version(oid);
+	return true;
+}
+
+/*
+ * Compute the version of a relation, or of its statistics.
+ *
+ * Returns false if the shared cache can't be used at the moment, or not for
+ * this relation.
+ */
+bool
+SharedMDCacheRelVersion(Oid relid, uint64 *version)
+{
+	if (!snapshot_is_valid() || !rel_is_shareable(relid))
+		return false;
+
+	*version = snapshot_global_version + oid_version(relid);
+	return true;
+}
+
+/*
+ * Compute the version of an index.
+ *
+ * Returns false if the shared cache can't be used at the moment, or not for
+ * this index.
+ */
+bool
+SharedMDCacheIndexVersion(Oid indexid, uint64 *version)
+{
+	Oid			relid;
+
+	if (!snapshot_is_valid())
+		return false;
+
+	relid = IndexGetRelation(indexid, true);
+	if (!OidIsValid(relid) || !rel_is_shareable(relid))
+		return false;
+
+	*version = snapshot_global_version + oid_version(indexid);
+	return true;
+}
+
+/*
+ * Compute the version of the statistics of a column.
+ *
+ * Returns false if the shared cache can't be used at the moment, or not for
+ * this relation.
+ */
+bool
+SharedMDCacheColStatsVersion(Oid relid, int attno, uint64 *version)
+{
+	if (!snapshot_is_valid() || !rel_is_shareable(relid))
+		return false;
+
+	*version = snapshot_global_version + oid_version(relid) +
+		snapshot_versions[partition_of(MyDatabaseId,
+			GetSysCacheHashValue3(STATRELATTINH,
+								  ObjectIdGetDatum(relid),
+								  Int16GetDatum(attno),
+								  BoolGetDatum(false)))] +
+		snapshot_versions[partition_of(MyDatabaseId,
+			GetSysCacheHashValue3(STATRELATTINH,
+								  ObjectIdGetDatum(relid),
+								  Int16GetDatum(attno),
+								  BoolGetDatum(true)))];
+	return true;
+}
+
+static void
+make_key(SharedMDCacheKey *hkey, const char *key)
+{
+	MemSet(hkey, 0, sizeof(SharedMDCacheKey));
+	hkey->dbid = MyDatabaseId;
+	strlcpy(hkey->mdid, key, SHARED_MDCACHE_KEYLEN);
+}
+
+/*
+ * Look up the serialized object with the given key and version.
+ *
+ * Returns a palloc'd copy of it, or NULL if it's not in the cache.
+ */
+void *
+SharedMDCacheLookup(const char *key, uint64 version, Size *len)
+{
+	SharedMDCacheKey hkey;
+	SharedMDCacheEntry *entry;
+	void	   *result = NULL;
+
+	if (!snapshot_is_valid())
+		return NULL;
+
+	make_key(&hkey, key);
+
+	LWLockAcquire(SharedMDCacheLock, LW_SHARED);
+
+	entry = (SharedMDCacheEntry *) hash_search(shared_mdcache_hash, &hkey,
+											   HASH_FIND, NULL);
+	if (entry != NULL && entry->version == version)
+	{
+		result = palloc(entry->len);
+		memcpy(result, shared_mdcache_arena +
+			   entry->half * arena_half_size + entry->offset, entry->len);
+		*len = entry->len;
+	}
+
+	LWLockRelease(SharedMDCacheLock);
+
+	if (result != NULL)
+		pg_atomic_fetch_add_u64(&shared_mdcache->hits, 1);
+	else
+		pg_atomic_fetch_add_u64(&shared_mdcache->misses, 1);
+
+	return result;
+}
+
+/*
+ * Evict all the objects of the other half of the arena, and switch to it.
+ *
+ * Caller must hold SharedMDCacheLock in exclusive mode.
+ */
+static void
+switch_arena_half(void)
+{
+	HASH_SEQ_STATUS status;
+	SharedMDCacheEntry *entry;
+	int			other = 1 - shared_mdcache->cur_half;
+
+	hash_seq_init(&status, shared_mdcache_hash);
+	while ((entry = (SharedMDCacheEntry *) hash_seq_search(&status)) != NULL)
+	{
+		if (entry->half != other)
+			continue;
+
+		hash_search(shared_mdcache_hash, &entry->key, HASH_REMOVE, NULL);
+		shared_mdcache->nentries--;
+		shared_mdcache->evictions++;
+	}
+
+	shared_mdcache->cur_half = other;
+	shared_mdcache->used[other] = 0;
+}
+
+/*
+ * Add a serialized object to the cache, replacing any older version of it.
+ *
+ * Objects that don't fit are silently not cached.
+ */
+void
+SharedMDCacheInsert(const char *key, uint64 version, const void *data,
+					Size len)
+{
+	SharedMDCacheKey hkey;
+	SharedMDCacheEntry *entry;
+	bool		found;
+
+	if (!snapshot_is_valid() || MAXALIGN(len) > arena_half_size)
+		return;
+
+	make_key(&hkey, key);
+
+	LWLockAcquire(SharedMDCacheLock, LW_EXCLUSIVE);
+
+	entry = (SharedMDCacheEntry *) hash_search(shared_mdcache_hash, &hkey,
+											   HASH_FIND, NULL);
+	if (entry != NULL && entry->version == version)
+	{
+		/* another backend got here first */
+		LWLockRelease(SharedMDCacheLock);
+		return;
+	}
+
+	if (shared_mdcache->used[shared_mdcache->cur_half] + MAXALIGN(len) >
+		arena_half_size ||
+		(entry == NULL && shared_mdcache->nentries >= max_entries))
+	{
+		switch_arena_half();
+	}
+
+	entry = (SharedMDCacheEntry *) hash_search(shared_mdcache_hash, &hkey,
+											   HASH_FIND, NULL);
+	if (entry == NULL)
+	{
+		if (shared_mdcache->nentries >= max_entries)
+		{
+			LWLockRelease(SharedMDCacheLock);
+			return;
+		}
+
+		entry = (SharedMDCacheEntry *) hash_search(shared_mdcache_hash, &hkey,
+												   HASH_ENTER_NULL, &found);
+		if (entry == NULL)
+		{
+			LWLockRelease(SharedMDCacheLock);
+			return;
+		}
+		shared_mdcache->nentries++;
+	}
+
+	entry->version = version;
+	entry->half = shared_mdcache->cur_half;
+	entry->offset = shared_mdcache->used[entry->half];
+	entry->len = len;
+	memcpy(shared_mdcache_arena + entry->half * arena_half_size +
+		   entry->offset, data, len);
+
+	shared_mdcache->used[entry->half] += MAXALIGN(len);
+	shared_mdcache->inserts++;
+
+	LWLockRelease(SharedMDCacheLock);
+}
+
+/*
+ * SQL function to show the usage of the shared MDCache.
+ */
+Datum
+gp_orca_shared_mdcache_stats(PG_FUNCTION_ARGS)
+{
+	TupleDesc	tupdesc;
+	Datum		values[7];
+	bool		nulls[7];
+	HeapTuple	tuple;
+
+	if (get_call_result_type(fcinfo, NULL, &tupdesc) != TYPEFUNC_COMPOSITE)
+		elog(ERROR, "return type must be a row type");
+	tupdesc = BlessTupleDesc(tupdesc);
+
+	MemSet(values, 0, sizeof(values));
+	MemSet(nulls, false, sizeof(nulls));
+
+	if (shared_mdcache != NULL)
+	{
+		LWLockAcquire(SharedMDCacheLock, LW_SHARED);
+
+		values[0] = Int64GetDatum(pg_atomic_read_u64(&shared_mdcache->hits));
+		values[1] = Int64GetDatum(pg_atomic_read_u64(&shared_mdcache->misses));
+		values[2] = Int64GetDatum(shared_mdcache->inserts);
+		values[3] = Int64GetDatum(shared_mdcache->evictions);
+		values[4] = Int32GetDatum(shared_mdcache->nentries);
+		values[5] = Int64GetDatum(shared_mdcache->used[0] +
+								  shared_mdcache->used[1]);
+		values[6] = Int64GetDatum(arena_half_size * 2);
+
+		LWLockRelease(SharedMDCacheLock);
+	}
+
+	tuple = heap_form_tuple(tupdesc, values, nulls);
+	PG_RETURN_DATUM(HeapTupleGetDatum(tuple));
+}
@@ -304,7 +304,10 @@ int			optimizer_minidump;
 int			optimizer_cost_model;
 bool		optimizer_metadata_caching;
 int			optimizer_mdcache_size;
+int			optimizer_shared_mdcache_size;
+int			optimizer_plan_cache_size;
 bool		optimizer_use_gpdb_allocators;
+bool		optimizer_use_arena_allocator;
 
 /* Optimizer debugging GUCs */
 bool		optimizer_print_query;
@@ -398,6 +401,8 @@ int			optimizer_cte_inlining_bound;
 int			optimizer_push_group_by_below_setop_threshold;
 int			optimizer_xform_bind_threshold;
 int			optimizer_skew_factor;
+int			optimizer_search_time_budget;
+int			optimizer_search_memory_budget;
 bool		optimizer_force_multistage_agg;
 bool		optimizer_force_three_stage_scalar_dqa;
 bool		optimizer_force_expanded_distinct_aggs;
@@ -458,6 +463,9 @@ bool		gp_external_enable_filter_pushdown = true;
 /* Executor */
 bool		gp_enable_mk_sort = true;
 bool		gp_enable_motion_mk_sort = true;
+bool		gp_enable_mk_sort_radix = true;
+bool		gp_enable_mk_sort_abbrev_text = true;
+int			gp_mk_sort_max_workers = 1;
 
 /* Enable GDD */
 bool		gp_enable_global_deadlock_detector = false;
@@ -686,6 +694,18 @@ struct config_bool ConfigureNamesBool_gp[] =
 		false,
 		NULL, NULL, NULL
 	},
+	{
+		{"gp_enable_runtime_filter", PGC_USERSET, QUERY_TUNING_METHOD,
+			gettext_noop("Enable runtime join filters in hash joins."),
+			gettext_noop("A hash join builds a Bloom filter over the join keys "
+						 "of its inner input, and the scan of its outer input "
+						 "uses it to drop rows that cannot join. Only the TCP "
+						 "interconnect passes filters to scans in other slices.")
+		},
+		&gp_enable_runtime_filter,
+		false,
+		NULL, NULL, NULL
+	},
 	{
 		{"gp_enable_direct_dispatch", PGC_USERSET, QUERY_TUNING_METHOD,
 			gettext_noop("Enable dispatch for single-row-insert targeted mirror-pairs."),
@@ -695,6 +715,16 @@ struct config_bool ConfigureNamesBool_gp[] =
 		true,
 		NULL, NULL, NULL
 	},
+	{
+		{"gp_enable_qe_plan_cache", PGC_USERSET, QUERY_TUNING_METHOD,
+			gettext_noop("Enable caching of dispatched plans on the segments."),
+			gettext_noop("A plan that a segment process received recently is "
+						 "dispatched to it by id, without the serialized plan.")
+		},
+		&gp_enable_qe_plan_cache,
+		false,
+		NULL, NULL, NULL
+	},
 	{
 		{"gp_enable_predicate_propagation", PGC_USERSET, QUERY_TUNING_OTHER,
 			gettext_noop("When two expressions are equivalent (such as with "
@@ -910,6 +940,28 @@ struct config_bool ConfigureNamesBool_gp[] =
 		NULL, NULL, NULL
 	},
 
+	{
+		{"gp_enable_mk_sort_radix", PGC_USERSET, QUERY_TUNING_METHOD,
+			gettext_noop("Enable radix sort of fixed-width keys in multi-key sort."),
+			gettext_noop("Large in-memory sorts on keys of built-in integer, float, "
+						 "date and timestamp types are radix sorted.")
+		},
+		&gp_enable_mk_sort_radix,
+		true,
+		NULL, NULL, NULL
+	},
+
+	{
+		{"gp_enable_mk_sort_abbrev_text", PGC_USERSET, QUERY_TUNING_METHOD,
+			gettext_noop("Enable abbreviated keys for text in the C collation in multi-key sort."),
+			gettext_noop("Text values are compared on their leading bytes first, "
+						 "and in full only when those are equal.")
+		},
+		&gp_enable_mk_sort_abbrev_text,
+		true,
+		NULL, NULL, NULL
+	},
+
 
 #ifdef USE_ASSERT_CHECKING
 	{
@@ -1207,6 +1259,17 @@ struct config_bool ConfigureNamesBool_gp[] =
 		NULL, NULL, NULL
 	},
 
+	{
+		{"gp_interconnect_tcp_local_socket", PGC_USERSET, GP_ARRAY_TUNING,
+			gettext_noop("Use Unix-domain sockets for TCP interconnect routes between processes on the same host."),
+			gettext_noop("Peers on other hosts, or without a local listener, keep using TCP."),
+			GUC_NOT_IN_SAMPLE
+		},
+		&gp_interconnect_tcp_local_socket,
+		false,
+		NULL, NULL, NULL
+	},
+
 	{
 		{"gp_interconnect_cache_future_packets", PGC_USERSET, GP_ARRAY_TUNING,
 			gettext_noop("Control whether future packets are cached."),
@@ -2960,6 +3023,17 @@ struct config_bool ConfigureNamesBool_gp[] =
 		NULL, NULL, NULL
 	},
 
+	{
+		{"optimizer_use_arena_allocator", PGC_USERSET, RESOURCES_MEM,
+			gettext_noop("Allocate the objects of an optimization from large blocks, released at once at the end."),
+			gettext_noop("Makes allocations in GPORCA cheaper, at the cost of keeping freed memory until the optimization is done."),
+			GUC_NOT_IN_SAMPLE
+		},
+		&optimizer_use_arena_allocator,
+		false,
+		NULL, NULL, NULL
+	},
+
 	{
 		{"vmem_process_interrupt", PGC_USERSET, DEVELOPER_OPTIONS,
 			gettext_noop("Checks for interrupts before reserving VMEM"),
@@ -3411,6 +3485,18 @@ struct config_int ConfigureNamesInt_gp[] =
 		NULL, NULL, NULL
 	},
 
+	{
+		{"gp_plan_compress_cache_size", PGC_USERSET, RESOURCES_MEM,
+			gettext_noop("Sets the memory used to remember recently compressed plans for dispatch."),
+			gettext_noop("A plan dispatched again with the same serialized form "
+						 "reuses its compressed form. 0 disables the cache."),
+			GUC_UNIT_KB
+		},
+		&gp_plan_compress_cache_size,
+		16384, 0, MAX_KILOBYTES,
+		NULL, NULL, NULL
+	},
+
 	{
 		{"gp_max_plan_size", PGC_SUSET, RESOURCES_MEM,
 			gettext_noop("Sets the maximum size of a plan to be dispatched."),
@@ -3487,6 +3573,17 @@ struct config_int ConfigureNamesInt_gp[] =
 		NULL, NULL, NULL
 	},
 
+	{
+		{"gp_shareinput_shmem_max_size", PGC_SUSET, RESOURCES_MEM,
+			gettext_noop("Sets the largest cross-slice shared input passed to its readers in shared memory."),
+			gettext_noop("Larger inputs are written to workfiles. 0 always uses workfiles."),
+			GUC_UNIT_KB
+		},
+		&gp_shareinput_shmem_max_size,
+		4096, 0, 1024 * 1024,
+		NULL, NULL, NULL
+	},
+
 	{
 		{"gp_vmem_idle_resource_timeout", PGC_USERSET, CLIENT_CONN_OTHER,
 			gettext_noop("Sets the time a session can be idle (in milliseconds) before we release gangs on the segment DBs to free resources."),
@@ -4043,6 +4140,28 @@ struct config_int ConfigureNamesInt_gp[] =
 		NULL, NULL, NULL
 	},
 
+	{
+		{"gp_runtime_filter_wait_time", PGC_USERSET, QUERY_TUNING_METHOD,
+			gettext_noop("Sets the time a scan waits for a runtime join filter from another slice."),
+			gettext_noop("If the filter doesn't arrive in time, the scan goes on without it."),
+			GUC_UNIT_MS
+		},
+		&gp_runtime_filter_wait_time,
+		500, 0, 60000,
+		NULL, NULL, NULL
+	},
+
+	{
+		{"gp_mk_sort_max_workers", PGC_USERSET, QUERY_TUNING_METHOD,
+			gettext_noop("Sets the maximum number of threads of a multi-key sort."),
+			gettext_noop("Large in-memory sorts on pass-by-value keys of built-in "
+						 "types are split among this many threads.")
+		},
+		&gp_mk_sort_max_workers,
+		1, 1, 64,
+		NULL, NULL, NULL
+	},
+
 	{
 		{"gp_hashagg_groups_per_bucket", PGC_USERSET, GP_ARRAY_TUNING,
 			gettext_noop("Target density of hashtable used by Hashagg during execution"),
@@ -4054,6 +4173,16 @@ struct config_int ConfigureNamesInt_gp[] =
 		NULL, NULL, NULL
 	},
 
+	{
+		{"gp_hashagg_passthrough_sample", PGC_USERSET, QUERY_TUNING_METHOD,
+			gettext_noop("Sets how many input rows a streaming lower HashAgg groups before checking whether grouping pays off."),
+			gettext_noop("0 disables passing the input through without grouping.")
+		},
+		&gp_hashagg_passthrough_sample,
+		100000, 0, INT_MAX,
+		NULL, NULL, NULL
+	},
+
 	{
 		{"gp_hashagg_default_nbatches", PGC_USERSET, QUERY_TUNING_METHOD,
 			gettext_noop("Default number of batches for hashagg's (re-)spilling phases."),
@@ -4396,6 +4525,28 @@ struct config_int ConfigureNamesInt_gp[] =
             NULL, NULL, NULL
     },
 
+	{
+		{"optimizer_search_time_budget", PGC_USERSET, QUERY_TUNING_METHOD,
+			gettext_noop("Sets the time after which GPORCA stops exploring alternatives, and completes the best plan found so far."),
+			gettext_noop("Zero disables the limit."),
+			GUC_UNIT_MS
+		},
+		&optimizer_search_time_budget,
+		0, 0, INT_MAX,
+		NULL, NULL, NULL
+	},
+
+	{
+		{"optimizer_search_memory_budget", PGC_USERSET, QUERY_TUNING_METHOD,
+			gettext_noop("Sets the memory after which GPORCA stops exploring alternatives, and completes the best plan found so far."),
+			gettext_noop("Zero disables the limit."),
+			GUC_UNIT_KB
+		},
+		&optimizer_search_memory_budget,
+		0, 0, MAX_KILOBYTES,
+		NULL, NULL, NULL
+	},
+
 	{
 		{"optimizer_join_order_threshold", PGC_USERSET, QUERY_TUNING_METHOD,
 			gettext_noop("Maximum number of join children to use dynamic programming based join ordering algorithm."),
@@ -4439,6 +4590,28 @@ struct config_int ConfigureNamesInt_gp[] =
 		NULL, NULL, NULL
 	},
 
+	{
+		{"optimizer_shared_mdcache_size", PGC_POSTMASTER, RESOURCES_MEM,
+			gettext_noop("Sets the size of the MDCache shared by all sessions."),
+			gettext_noop("Zero disables the shared MDCache."),
+			GUC_UNIT_KB
+		},
+		&optimizer_shared_mdcache_size,
+		0, 0, MAX_KILOBYTES,
+		NULL, NULL, NULL
+	},
+
+	{
+		{"optimizer_plan_cache_size", PGC_USERSET, RESOURCES_MEM,
+			gettext_noop("Sets the size of the cache of plans produced by GPORCA."),
+			gettext_noop("Zero disables the plan cache."),
+			GUC_UNIT_KB
+		},
+		&optimizer_plan_cache_size,
+		0, 0, INT_MAX,
+		NULL, NULL, NULL
+	},
+
 	{
 		{"memory_profiler_dataset_size", PGC_USERSET, DEVELOPER_OPTIONS,
 			gettext_noop("Set the size in GB"),
@@ -4617,6 +4790,16 @@ struct config_real ConfigureNamesReal_gp[] =
 		NULL, NULL, NULL
 	},
 
+	{
+		{"gp_hashagg_passthrough_ratio", PGC_USERSET, QUERY_TUNING_METHOD,
+			gettext_noop("Sets the ratio of groups to input rows above which a streaming lower HashAgg stops grouping."),
+			NULL
+		},
+		&gp_hashagg_passthrough_ratio,
+		0.9, 0.0, 1.0,
+		NULL, NULL, NULL
+	},
+
 	{
 		{"gp_selectivity_damping_factor", PGC_USERSET, QUERY_TUNING_METHOD,
 			gettext_noop("Factor used in selectivity damping."),
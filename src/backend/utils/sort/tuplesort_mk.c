@@ -503,6 +503,7 @@ static void readtup_datum(Tuplesortstate_mk *state, TuplesortPos_mk *pos, MKEntr
 			  LogicalTape *lt, uint32 len);
 
 static void tupsort_prepare_char(MKEntry *a, bool isChar);
+static Datum tupsort_abbrev_text(Datum d);
 static int	tupsort_compare_char(MKEntry *v1, MKEntry *v2, MKLvContext *lvctxt, MKContext *mkContext);
 
 static Datum tupsort_fetch_datum_mtup(MKEntry *a, MKContext *mkctxt, MKLvContext *lvctxt, bool *isNullOut);
@@ -739,6 +740,10 @@ create_mksort_context(MKContext *mkctxt,
 
 			if (sinfo->scanKey.sk_func.fn_addr == btint4cmp)
 				sinfo->lvtype = MKLV_TYPE_INT32;
+			else if (gp_enable_mk_sort_abbrev_text &&
+					 sinfo->scanKey.sk_func.fn_addr == bttextcmp &&
+					 lc_collate_is_c(sinfo->scanKey.sk_collation))
+				sinfo->lvtype = MKLV_TYPE_TEXT_ABBREV;
 
 /*
 * Users who are certain that their glibc is not affected by strcoll() and strxfrm()
@@ -1388,9 +1393,21 @@ tuplesort_performsort_mk(Tuplesortstate_mk *state)
 			/*
 			 * We were able to accumulate all the tuples within the allowed
 			 * amount of memory.  Just qsort 'em and we're done.
+			 *
+			 * Keys of fixed-width built-in types are radix sorted instead,
+			 * if the memory it needs on top of the tuples is still within
+			 * the allowed amount.
 			 */
 			if (!state->mkctxt.bounded)
-				mk_qsort(state->entries, state->entry_count, &state->mkctxt);
+			{
+				Size		radixSpace = mk_radix_sort_space(&state->mkctxt, state->entry_count);
+
+				if (radixSpace > 0 &&
+					MemoryContextGetCurrentSpace(state->sortcontext) + radixSpace <= state->memAllowed)
+					mk_radix_sort(state->entries, state->entry_count, &state->mkctxt);
+				else
+					mk_qsort(state->entries, state->entry_count, &state->mkctxt);
+			}
 			else
 				tuplesort_limit_sort(state);
 
@@ -3166,6 +3183,28 @@ tupsort_compare_datum(MKEntry *v1, MKEntry *v2, MKLvContext *lvctxt, MKContext *
 
 				return ((lvctxt->scanKey.sk_flags & SK_BT_DESC) != 0) ? -result : result;
 			}
+		case MKLV_TYPE_TEXT_ABBREV:
+			{
+				int			result = (v1->d < v2->d) ? -1 : ((v1->d == v2->d) ? 0 : 1);
+				Datum		d1,
+							d2;
+				bool		isnull1,
+							isnull2;
+
+				if (result != 0)
+					return ((lvctxt->scanKey.sk_flags & SK_BT_DESC) != 0) ? -result : result;
+
+				/* The leading bytes are equal, compare the whole values */
+				d1 = (context->fetchForPrep) (v1, context, lvctxt, &isnull1);
+				d2 = (context->fetchForPrep) (v2, context, lvctxt, &isnull2);
+				Assert(!isnull1 && !isnull2);
+
+				return inlineApplySortFunction(&lvctxt->scanKey.sk_func,
+											   lvctxt->scanKey.sk_flags,
+											   lvctxt->scanKey.sk_collation,
+											   d1, false,
+											   d2, false);
+			}
 		default:
 			return tupsort_compare_char(v1, v2, lvctxt, context);
 	}
@@ -3201,7 +3240,7 @@ tupsort_cpfr(MKEntry *dst, MKEntry *src, MKLvContext *lvctxt)
 		{
 			if (mke_is_refc(src))
 				tupsort_refcnt(DatumGetPointer(dst->d), 1);
-			else if (!lvctxt->typByVal)
+			else if (!lvctxt->typByVal && lvctxt->lvtype != MKLV_TYPE_TEXT_ABBREV)
 			{
 				Assert(src->d != 0);
 				dst->d = datumCopy(src->d, lvctxt->typByVal, lvctxt->typLen);
@@ -3393,6 +3432,37 @@ tupsort_prepare(MKEntry *a, MKContext *mkctxt, int lv)
 		tupsort_prepare_char(a, true);
 	else if (lvctxt->lvtype == MKLV_TYPE_TEXT)
 		tupsort_prepare_char(a, false);
+	else if (lvctxt->lvtype == MKLV_TYPE_TEXT_ABBREV && !isnull)
+		a->d = tupsort_abbrev_text(a->d);
+}
+
+/*
+ * Abbreviate a text value in the C collation to its leading bytes, packed
+ * into a Datum so that comparing two Datums as unsigned integers orders the
+ * values like memcmp().  Shorter values are padded with zeros, which sorts
+ * them first, as varstr_cmp() does.  Values with the same leading bytes
+ * need to be compared in full.
+ */
+static Datum
+tupsort_abbrev_text(Datum d)
+{
+	text	   *t = DatumGetTextPP(d);
+	char	   *p = VARDATA_ANY(t);
+	int			len = Min(VARSIZE_ANY_EXHDR(t), sizeof(Datum));
+	Datum		res = 0;
+	int			i;
+
+	for (i = 0; i < sizeof(Datum); i++)
+	{
+		res <<= BITS_PER_BYTE;
+		if (i < len)
+			res |= (unsigned char) p[i];
+	}
+
+	if ((Pointer) t != DatumGetPointer(d))
+		pfree(t);
+
+	return res;
 }
 
 /* "True" length (not counting trailing blanks) of a BpChar */
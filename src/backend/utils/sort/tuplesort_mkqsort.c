@@ -20,16 +20,61 @@
 
 #include "postgres.h"
 #include "access/genam.h"
+#include "access/nbtree.h"
 #include "utils/tuplesort.h"
 #include "utils/tuplesort_mk.h"
 #include "utils/tuplesort_mk_details.h"
 
 #include "miscadmin.h"
+#include "cdb/cdbvars.h"
+#include "utils/builtins.h"
+#include "utils/date.h"
+#include "utils/memutils.h"
+#include "utils/timestamp.h"
+
+#include <pthread.h>
+#include <signal.h>
 
 #ifdef MKQSORT_VERIFY 
 extern void mkqsort_verify(MKEntry *a, int l, int r, MKContext *mkctxt);
 #endif
 
+/*
+ * Parallel sort.
+ *
+ * Sorting fewer entries than MKQSORT_PARALLEL_MIN_ENTRIES is not worth
+ * starting threads for.  The array is split into about
+ * MKQSORT_TASKS_PER_WORKER tasks per worker, so that a worker that got
+ * smaller tasks can pick up more of them.
+ */
+#define MKQSORT_PARALLEL_MIN_ENTRIES	(64 * 1024)
+#define MKQSORT_TASKS_PER_WORKER	4
+#define MKQSORT_MAX_WORKERS		64
+
+/* A range of entries sorted by one worker */
+typedef struct MKQSortTask
+{
+	int left;
+	int right;
+	int lv;
+	bool lvdown;
+	bool seenNull;
+} MKQSortTask;
+
+typedef struct MKQSortTaskList
+{
+	MKEntry *a;
+	MKContext *ctxt;
+
+	MKQSortTask *tasks;
+	int ntasks;
+	int maxtasks;
+	int maxTaskSize;	/* larger ranges are partitioned further */
+
+	pthread_mutex_t mutex;
+	int nextTask;		/* next task to take, protected by mutex */
+} MKQSortTaskList;
+
 /**
  * Given an array, swap the entries at a[i] and a[j]
  */
@@ -261,7 +306,13 @@ static void mk_qsort_part3(MKEntry *a, int left, int right, int lv, MKContext *m
 	*firstInHighOut = rightIndex;
 }
 
-void mk_qsort_impl(MKEntry *a, int left, int right, int lv, bool lvdown, MKContext *ctxt, bool seenNull)
+/*
+ * Sort a[left..right] at level lv and below.
+ *
+ * A worker thread of a parallel sort must not process interrupts, so it
+ * passes inWorker and the interrupts are checked once the workers are done.
+ */
+static void mk_qsort_recurse(MKEntry *a, int left, int right, int lv, bool lvdown, MKContext *ctxt, bool seenNull, bool inWorker)
 {
 	int lastInLow;
 	int firstInHigh;
@@ -269,7 +320,8 @@ void mk_qsort_impl(MKEntry *a, int left, int right, int lv, bool lvdown, MKConte
 	Assert(ctxt);
 	Assert(lv < ctxt->total_lv);
 
-	CHECK_FOR_INTERRUPTS();
+	if (!inWorker)
+		CHECK_FOR_INTERRUPTS();
 
 	if (QueryFinishPending)
 		return;
@@ -293,7 +345,7 @@ void mk_qsort_impl(MKEntry *a, int left, int right, int lv, bool lvdown, MKConte
 	mk_qsort_part3(a, left, right, lv, ctxt, &lastInLow, &firstInHigh);
 
 	/* recurse to left chunk */
-	mk_qsort_impl(a, left, lastInLow, lv, false, ctxt, seenNull);
+	mk_qsort_recurse(a, left, lastInLow, lv, false, ctxt, seenNull, inWorker);
 
 	/* recurse to middle (equal) chunk */
 	if(lv < ctxt->total_lv-1)
@@ -301,7 +353,7 @@ void mk_qsort_impl(MKEntry *a, int left, int right, int lv, bool lvdown, MKConte
 		/*
 		 * [lastInLow+1,firstInHigh-1] defines the pivot region which was all equal at level lv.  So increase the level and compare that region!
 		 */
-		mk_qsort_impl(a, lastInLow+1, firstInHigh-1, lv+1, true, ctxt, seenNull || mke_is_null(a+lastInLow+1)); /* a + lastInLow + 1 points to the pivot */
+		mk_qsort_recurse(a, lastInLow+1, firstInHigh-1, lv+1, true, ctxt, seenNull || mke_is_null(a+lastInLow+1), inWorker); /* a + lastInLow + 1 points to the pivot */
 	}
 	else
 	{
@@ -342,7 +394,216 @@ void mk_qsort_impl(MKEntry *a, int left, int right, int lv, bool lvdown, MKConte
 	}
 
 	/* recurse to right chunk */
-	mk_qsort_impl(a, firstInHigh, right, lv, false, ctxt, seenNull);
+	mk_qsort_recurse(a, firstInHigh, right, lv, false, ctxt, seenNull, inWorker);
+}
+
+/*
+ * Can the sort run in worker threads?
+ *
+ * The workers must not call anything that allocates memory, reports an
+ * error or touches other backend state.  This holds if every level compares
+ * pass-by-value datums with one of the built-in comparison functions below,
+ * which only look at their arguments, and if no duplicates have to be
+ * removed or reported.  Fetching a pass-by-value attribute of a memtuple is
+ * safe as well, but fetching one of an index tuple is not: index_getattr()
+ * may fill in attcacheoff in the shared tuple descriptor.  Index builds are
+ * the only sorts that fetch from index tuples.
+ */
+static bool mk_qsort_parallel_safe(MKContext *ctxt)
+{
+	int lv;
+
+	if (ctxt->unique || ctxt->enforceUnique)
+		return false;
+
+	if (ctxt->indexRel != NULL)
+		return false;
+
+	for (lv = 0; lv < ctxt->total_lv; lv++)
+	{
+		MKLvContext *lvctxt = ctxt->lvctxt + lv;
+		PGFunction cmpfn = lvctxt->scanKey.sk_func.fn_addr;
+
+		if (lvctxt->lvtype == MKLV_TYPE_INT32)
+			continue;
+
+		if (lvctxt->lvtype != MKLV_TYPE_NONE || !lvctxt->typByVal)
+			return false;
+
+		if (cmpfn != btint2cmp &&
+			cmpfn != btint4cmp &&
+			cmpfn != btint8cmp &&
+			cmpfn != btoidcmp &&
+			cmpfn != btfloat4cmp &&
+			cmpfn != btfloat8cmp &&
+			cmpfn != date_cmp &&
+			cmpfn != timestamp_cmp)
+			return false;
+	}
+
+	return true;
+}
+
+/*
+ * Split a[left..right] into independent tasks for the workers.
+ *
+ * Ranges larger than a task are partitioned here, in the calling backend,
+ * exactly as mk_qsort_recurse() would do it.  The pieces that come out of
+ * it are disjoint and already in their final order relative to each other,
+ * so sorting each of them completes the sort without a merge step.
+ */
+static void mk_qsort_split(MKQSortTaskList *tl, int left, int right, int lv, bool lvdown, bool seenNull)
+{
+	MKContext *ctxt = tl->ctxt;
+	MKQSortTask *task;
+	int lastInLow;
+	int firstInHigh;
+
+	CHECK_FOR_INTERRUPTS();
+
+	if (right <= left)
+		return;
+
+	if (right - left + 1 > tl->maxTaskSize)
+	{
+		if (lvdown)
+			mk_prepare_array(tl->a, left, right, lv, ctxt);
+
+		mk_qsort_part3(tl->a, left, right, lv, ctxt, &lastInLow, &firstInHigh);
+
+		mk_qsort_split(tl, left, lastInLow, lv, false, seenNull);
+		if (lv < ctxt->total_lv - 1)
+			mk_qsort_split(tl, lastInLow + 1, firstInHigh - 1, lv + 1, true,
+						   seenNull || mke_is_null(tl->a + lastInLow + 1));
+		mk_qsort_split(tl, firstInHigh, right, lv, false, seenNull);
+		return;
+	}
+
+	if (tl->ntasks == tl->maxtasks)
+	{
+		tl->maxtasks *= 2;
+		tl->tasks = (MKQSortTask *) repalloc(tl->tasks, tl->maxtasks * sizeof(MKQSortTask));
+	}
+
+	task = &tl->tasks[tl->ntasks++];
+	task->left = left;
+	task->right = right;
+	task->lv = lv;
+	task->lvdown = lvdown;
+	task->seenNull = seenNull;
+}
+
+/*
+ * qsort comparator to run the largest tasks first, for better balance.
+ */
+static int mk_qsort_task_cmp(const void *a, const void *b)
+{
+	const MKQSortTask *ta = (const MKQSortTask *) a;
+	const MKQSortTask *tb = (const MKQSortTask *) b;
+	int sa = ta->right - ta->left;
+	int sb = tb->right - tb->left;
+
+	return (sa > sb) ? -1 : ((sa < sb) ? 1 : 0);
+}
+
+/*
+ * Main loop of a worker, also run by the backend itself: take the next task
+ * until there are none left.
+ */
+static void *mk_qsort_worker(void *arg)
+{
+	MKQSortTaskList *tl = (MKQSortTaskList *) arg;
+
+	for (;;)
+	{
+		MKQSortTask *task;
+		int taskno;
+
+		pthread_mutex_lock(&tl->mutex);
+		taskno = tl->nextTask++;
+		pthread_mutex_unlock(&tl->mutex);
+
+		if (taskno >= tl->ntasks)
+			break;
+
+		task = &tl->tasks[taskno];
+		mk_qsort_recurse(tl->a, task->left, task->right, task->lv, task->lvdown,
+						 tl->ctxt, task->seenNull, true);
+	}
+
+	return NULL;
+}
+
+/*
+ * Sort with up to gp_mk_sort_max_workers threads.
+ *
+ * If a thread cannot be started, the backend and the threads that did start
+ * share the tasks among themselves.
+ */
+static void mk_qsort_parallel(MKEntry *a, int left, int right, MKContext *ctxt)
+{
+	MKQSortTaskList tl;
+	pthread_t threads[MKQSORT_MAX_WORKERS];
+	int nthreads = 0;
+	int nworkers = Min(gp_mk_sort_max_workers, MKQSORT_MAX_WORKERS);
+	int i;
+#ifndef WIN32
+	sigset_t sigs;
+	sigset_t old_sigs;
+#endif
+
+	tl.a = a;
+	tl.ctxt = ctxt;
+	tl.maxTaskSize = Max((right - left + 1) / (nworkers * MKQSORT_TASKS_PER_WORKER), 1);
+	tl.maxtasks = nworkers * MKQSORT_TASKS_PER_WORKER * 2;
+	tl.tasks = (MKQSortTask *) palloc(tl.maxtasks * sizeof(MKQSortTask));
+	tl.ntasks = 0;
+	tl.nextTask = 0;
+
+	mk_qsort_split(&tl, left, right, 0, true, false);
+
+	qsort(tl.tasks, tl.ntasks, sizeof(MKQSortTask), mk_qsort_task_cmp);
+
+	pthread_mutex_init(&tl.mutex, NULL);
+
+	/* The workers must not run our signal handlers */
+#ifndef WIN32
+	sigfillset(&sigs);
+	pthread_sigmask(SIG_BLOCK, &sigs, &old_sigs);
+#endif
+	for (i = 1; i < nworkers && i < tl.ntasks; i++)
+	{
+		if (pthread_create(&threads[nthreads], NULL, mk_qsort_worker, &tl) != 0)
+			break;
+		nthreads++;
+	}
+#ifndef WIN32
+	pthread_sigmask(SIG_SETMASK, &old_sigs, NULL);
+#endif
+
+	elog(DEBUG1, "mksort: sorting %d entries in %d tasks with %d threads",
+		 right - left + 1, tl.ntasks, nthreads + 1);
+
+	mk_qsort_worker(&tl);
+
+	for (i = 0; i < nthreads; i++)
+		pthread_join(threads[i], NULL);
+
+	pthread_mutex_destroy(&tl.mutex);
+	pfree(tl.tasks);
+
+	CHECK_FOR_INTERRUPTS();
+}
+
+void mk_qsort_impl(MKEntry *a, int left, int right, int lv, bool lvdown, MKContext *ctxt, bool seenNull)
+{
+	if (lv == 0 && lvdown &&
+		gp_mk_sort_max_workers > 1 &&
+		right - left + 1 >= MKQSORT_PARALLEL_MIN_ENTRIES &&
+		mk_qsort_parallel_safe(ctxt))
+		mk_qsort_parallel(a, left, right, ctxt);
+	else
+		mk_qsort_recurse(a, left, right, lv, lvdown, ctxt, seenNull, false);
 
 #ifdef MKQSORT_VERIFY 
 	if(lv == 0)
@@ -350,6 +611,272 @@ void mk_qsort_impl(MKEntry *a, int left, int right, int lv, bool lvdown, MKConte
 #endif
 }
 
+/*
+ * Radix sort.
+ *
+ * When every level is a pass-by-value key of a built-in type, the keys can
+ * be turned into unsigned 64-bit integers that sort in the same order, and
+ * the entries can be sorted by a least significant digit radix sort on
+ * their bytes, without any comparisons.  Each level contributes eight bytes
+ * of key and a byte that orders the NULLs.  A byte that is the same in all
+ * entries is skipped, so e.g. a key of small integers only takes a couple
+ * of passes.  gp_enable_mk_sort_radix turns it off.
+ */
+#define MKQSORT_RADIX_MIN_ENTRIES	4096
+#define MKQSORT_RADIX_BYTES		(sizeof(uint64) + 1)
+
+typedef uint64 (*MKRadixNormalize) (Datum d);
+
+static inline uint64 mk_radix_signed(int64 v)
+{
+	return ((uint64) v) ^ (UINT64CONST(1) << 63);
+}
+
+static inline uint64 mk_radix_double(double v)
+{
+	union
+	{
+		double f;
+		uint64 i;
+	} u;
+
+	/* All NaNs are equal and larger than any other value, -0 equals +0 */
+	if (isnan(v))
+		return PG_UINT64_MAX;
+	if (v == 0.0)
+		v = 0.0;
+
+	u.f = v;
+	return (u.i & (UINT64CONST(1) << 63)) ? ~u.i : u.i ^ (UINT64CONST(1) << 63);
+}
+
+static uint64 mk_radix_int2(Datum d) { return mk_radix_signed(DatumGetInt16(d)); }
+static uint64 mk_radix_int4(Datum d) { return mk_radix_signed(DatumGetInt32(d)); }
+static uint64 mk_radix_int8(Datum d) { return mk_radix_signed(DatumGetInt64(d)); }
+static uint64 mk_radix_oid(Datum d) { return (uint64) DatumGetObjectId(d); }
+static uint64 mk_radix_float4(Datum d) { return mk_radix_double(DatumGetFloat4(d)); }
+static uint64 mk_radix_float8(Datum d) { return mk_radix_double(DatumGetFloat8(d)); }
+static uint64 mk_radix_date(Datum d) { return mk_radix_signed(DatumGetDateADT(d)); }
+#ifdef HAVE_INT64_TIMESTAMP
+static uint64 mk_radix_timestamp(Datum d) { return mk_radix_signed(DatumGetTimestamp(d)); }
+#else
+static uint64 mk_radix_timestamp(Datum d) { return mk_radix_double(DatumGetTimestamp(d)); }
+#endif
+
+/*
+ * The normalization function of a level, or NULL if it cannot be radix
+ * sorted.
+ */
+static MKRadixNormalize mk_radix_normalizer(MKLvContext *lvctxt)
+{
+	PGFunction cmpfn = lvctxt->scanKey.sk_func.fn_addr;
+
+	if (!lvctxt->typByVal)
+		return NULL;
+
+	if (cmpfn == btint2cmp)
+		return mk_radix_int2;
+	if (cmpfn == btint4cmp)
+		return mk_radix_int4;
+	if (cmpfn == btint8cmp)
+		return mk_radix_int8;
+	if (cmpfn == btoidcmp)
+		return mk_radix_oid;
+	if (cmpfn == btfloat4cmp)
+		return mk_radix_float4;
+	if (cmpfn == btfloat8cmp)
+		return mk_radix_float8;
+	if (cmpfn == date_cmp)
+		return mk_radix_date;
+	if (cmpfn == timestamp_cmp)
+		return mk_radix_timestamp;
+
+	return NULL;
+}
+
+/*
+ * Return the memory needed to radix sort n entries, or 0 if the sort cannot
+ * be done by radix sort.
+ */
+Size mk_radix_sort_space(MKContext *ctxt, int n)
+{
+	int lv;
+	Size space;
+
+	if (!gp_enable_mk_sort_radix || n < MKQSORT_RADIX_MIN_ENTRIES)
+		return 0;
+
+	/* Duplicates must be compared to be removed or reported */
+	if (ctxt->unique || ctxt->enforceUnique)
+		return 0;
+
+	/* Only sorts of tuples, or of a single datum, are supported */
+	if (ctxt->fetchForPrep == NULL && ctxt->total_lv != 1)
+		return 0;
+
+	for (lv = 0; lv < ctxt->total_lv; lv++)
+	{
+		if (mk_radix_normalizer(ctxt->lvctxt + lv) == NULL)
+			return 0;
+	}
+
+	space = (Size) n * ctxt->total_lv * MKQSORT_RADIX_BYTES;
+	if (!AllocSizeIsValid(space))
+		return 0;
+
+	return space + 2 * (Size) n * sizeof(uint32);
+}
+
+/*
+ * Byte 'digit' of the key of entry i at level lv.  Byte sizeof(uint64) is
+ * the NULL ordering byte, the most significant one.
+ */
+static inline uint8 mk_radix_digit(uint64 *keys, uint8 *nullranks, int nlv,
+								   uint32 i, int lv, int digit)
+{
+	if (digit == sizeof(uint64))
+		return nullranks[(Size) i * nlv + lv];
+
+	return (uint8) (keys[(Size) i * nlv + lv] >> (digit * BITS_PER_BYTE));
+}
+
+/*
+ * Sort the n entries in a by radix sort.  mk_radix_sort_space() must have
+ * returned non-zero for the same context and number of entries.
+ */
+void mk_radix_sort(MKEntry *a, int n, MKContext *ctxt)
+{
+	int nlv = ctxt->total_lv;
+	uint64 *keys;
+	uint8 *nullranks;
+	uint32 *perm;
+	uint32 *tmp;
+	uint32 i;
+	int lv;
+
+	Assert(mk_radix_sort_space(ctxt, n) > 0);
+
+	keys = (uint64 *) palloc((Size) n * nlv * sizeof(uint64));
+	nullranks = (uint8 *) palloc((Size) n * nlv);
+	perm = (uint32 *) palloc((Size) n * sizeof(uint32));
+	tmp = (uint32 *) palloc((Size) n * sizeof(uint32));
+
+	/* Normalize the keys */
+	for (lv = 0; lv < nlv; lv++)
+	{
+		MKLvContext *lvctxt = ctxt->lvctxt + lv;
+		MKRadixNormalize normalize = mk_radix_normalizer(lvctxt);
+		bool desc = (lvctxt->scanKey.sk_flags & SK_BT_DESC) != 0;
+		uint8 nullrank = (lvctxt->scanKey.sk_flags & SK_BT_NULLS_FIRST) ? 0 : 2;
+
+		CHECK_FOR_INTERRUPTS();
+
+		for (i = 0; i < n; i++)
+		{
+			Datum d;
+			bool isnull;
+			Size k = (Size) i * nlv + lv;
+
+			if (ctxt->fetchForPrep)
+				d = (ctxt->fetchForPrep) (a + i, ctxt, lvctxt, &isnull);
+			else
+			{
+				d = a[i].d;
+				isnull = mke_is_null(a + i);
+			}
+
+			if (isnull)
+			{
+				keys[k] = 0;
+				nullranks[k] = nullrank;
+			}
+			else
+			{
+				keys[k] = desc ? ~normalize(d) : normalize(d);
+				nullranks[k] = 1;
+			}
+		}
+	}
+
+	for (i = 0; i < n; i++)
+		perm[i] = i;
+
+	/* One stable counting sort pass per byte, least significant first */
+	for (lv = nlv - 1; lv >= 0; lv--)
+	{
+		int digit;
+
+		for (digit = 0; digit <= sizeof(uint64); digit++)
+		{
+			uint32 count[256];
+			uint32 pos;
+			uint32 *swap;
+			int b;
+
+			CHECK_FOR_INTERRUPTS();
+
+			MemSet(count, 0, sizeof(count));
+			for (i = 0; i < n; i++)
+				count[mk_radix_digit(keys, nullranks, nlv, perm[i], lv, digit)]++;
+
+			/* Nothing to do if all entries have the same byte here */
+			if (count[mk_radix_digit(keys, nullranks, nlv, perm[0], lv, digit)] == n)
+				continue;
+
+			pos = 0;
+			for (b = 0; b < 256; b++)
+			{
+				uint32 c = count[b];
+
+				count[b] = pos;
+				pos += c;
+			}
+
+			for (i = 0; i < n; i++)
+				tmp[count[mk_radix_digit(keys, nullranks, nlv, perm[i], lv, digit)]++] = perm[i];
+
+			swap = perm;
+			perm = tmp;
+			tmp = swap;
+		}
+	}
+
+	/*
+	 * Move the entries into place, following the cycles of the permutation.
+	 * perm[i] is the entry that goes to position i; it is set to i once
+	 * position i has been filled.
+	 */
+	for (i = 0; i < n; i++)
+	{
+		MKEntry save;
+		uint32 j;
+
+		if (perm[i] == i)
+			continue;
+
+		save = a[i];
+		j = i;
+		for (;;)
+		{
+			uint32 k = perm[j];
+
+			perm[j] = j;
+			if (k == i)
+			{
+				a[j] = save;
+				break;
+			}
+			a[j] = a[k];
+			j = k;
+		}
+	}
+
+	pfree(keys);
+	pfree(nullranks);
+	pfree(perm);
+	pfree(tmp);
+}
+
 #ifdef MKQSORT_VERIFY 
 static int mkqsort_comp_entry_all_lv(MKEntry *a, MKEntry *b, MKContext *mkctxt)
 {
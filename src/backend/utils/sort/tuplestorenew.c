@@ -251,6 +251,9 @@ struct NTupleStore
 	BufFile *plobfile;  /* underlying backed file for lobs (entries does not fit one page) */
 	int64     lobbytes;  /* number of bytes written to lob file */
 
+	char	   *shm_pages;	/* pages of a reader in shared memory, or NULL */
+	int			shm_npages;	/* number of shm_pages, -1 if reading the file */
+
 	List *accessors;    /* all current accessors of the store */
 	bool fwacc; 		/* if I had already has a write acc */
 
@@ -393,15 +396,25 @@ static bool ntsReadBlock(NTupleStore *ts, int blockn, NTupleStorePage *page)
 {
 	long diskblockn = blockn - ts->first_ondisk_blockn;
 
-	if(!ts->pfile)
-		return false;
-	
-	Assert(ts->first_ondisk_blockn >= 0);
-	Assert(ts && diskblockn >= 0 && page);
-	if (BufFileSeek(ts->pfile, 0 /* fileno */, diskblockn * BLCKSZ, SEEK_SET) != 0 ||
-		BufFileRead(ts->pfile, page, BLCKSZ) != BLCKSZ)
+	if(ts->shm_npages >= 0)
 	{
+		/* The writer published the pages in shared memory */
+		if(blockn >= ts->shm_npages)
+			return false;
+
+		memcpy(page, ts->shm_pages + (Size) blockn * BLCKSZ, BLCKSZ);
+	}
+	else if(!ts->pfile)
 		return false;
+	else
+	{
+		Assert(ts->first_ondisk_blockn >= 0);
+		Assert(ts && diskblockn >= 0 && page);
+		if (BufFileSeek(ts->pfile, 0 /* fileno */, diskblockn * BLCKSZ, SEEK_SET) != 0 ||
+			BufFileRead(ts->pfile, page, BLCKSZ) != BLCKSZ)
+		{
+			return false;
+		}
 	}
 
 	Assert(nts_page_blockn(page) == blockn); 
@@ -710,6 +723,9 @@ ntuplestore_create_common(int64 maxBytes, char *operation_name)
 	store->plobfile = NULL;
 	store->lobbytes = 0;
 
+	store->shm_pages = NULL;
+	store->shm_npages = -1;
+
 	store->work_set = NULL;
 	store->operation_name = operation_name;
 
@@ -782,11 +798,40 @@ ntuplestore_create_readerwriter(const char *filename, int64 maxBytes, bool isWri
 		store->plobfile = BufFileOpenNamedTemp(filenamelob,
 											false /* interXact */);
 
+		store->shm_pages = NULL;
+		store->shm_npages = -1;
+
 		ntuplestore_init_reader(store, maxBytes);
 	}
 	return store;
 }
 
+/*
+ * Initialize the reader of a ntuplestore that is shared across slices, when
+ * the writer has published its pages in shared memory instead of the files
+ * (see ntuplestore_copy_pages()).
+ *
+ *   pages must stay mapped for the lifetime of the store.
+ */
+NTupleStore *
+ntuplestore_create_reader_shmem(char *pages, int npages, int64 maxBytes)
+{
+	NTupleStore *store = (NTupleStore *) palloc(sizeof(NTupleStore));
+
+	Assert(npages >= 0);
+
+	store->mcxt = CurrentMemoryContext;
+	store->work_set = NULL;
+	store->pfile = NULL;
+	store->plobfile = NULL;
+	store->shm_pages = pages;
+	store->shm_npages = npages;
+
+	ntuplestore_init_reader(store, maxBytes);
+
+	return store;
+}
+
 /*
  * Initializes a ntuplestore based on existing files.
  *
@@ -796,8 +841,8 @@ static void
 ntuplestore_init_reader(NTupleStore *store, int maxBytes)
 {
 	Assert(NULL != store);
-	Assert(NULL != store->pfile);
-	Assert(NULL != store->plobfile);
+	Assert(store->shm_npages >= 0 || NULL != store->pfile);
+	Assert(store->shm_npages >= 0 || NULL != store->plobfile);
 	
 	store->first_ondisk_blockn = 0;
 	store->rwflag = NTS_IS_READER;
@@ -875,6 +920,59 @@ ntuplestore_flush(NTupleStore *ts)
 	}
 }
 
+/*
+ * Number of pages the writer of a ntuplestore shared across slices would
+ * publish, or -1 if some of its tuples are only in the spill files.
+ */
+int
+ntuplestore_count_pages(NTupleStore *ts)
+{
+	NTupleStorePage *p;
+	int			npages = 0;
+
+	Assert(ts->rwflag == NTS_IS_WRITER);
+
+	if(ts->lobbytes > 0)
+		return -1;
+
+	for(p = ts->first_page; p != NULL; p = nts_page_next(p))
+	{
+		if(nts_page_slot_cnt(p) == 0)
+			continue;
+		if(nts_page_blockn(p) != npages)
+			return -1;
+		npages++;
+	}
+
+	return npages;
+}
+
+/*
+ * Copy the pages of the writer of a ntuplestore shared across slices to dest,
+ * which must have room for ntuplestore_count_pages() pages.  The readers can
+ * then read them with ntuplestore_create_reader_shmem(), and the files are
+ * never written.
+ */
+void
+ntuplestore_copy_pages(NTupleStore *ts, char *dest)
+{
+	NTupleStorePage *p;
+
+	Assert(ntuplestore_count_pages(ts) >= 0);
+
+	for(p = ts->first_page; p != NULL; p = nts_page_next(p))
+	{
+		NTupleStorePage *copy;
+
+		if(nts_page_slot_cnt(p) == 0)
+			continue;
+
+		copy = (NTupleStorePage *) (dest + (Size) nts_page_blockn(p) * BLCKSZ);
+		memcpy(copy, p, BLCKSZ);
+		nts_page_set_dirty(copy, false);
+	}
+}
+
 NTupleStoreAccessor* 
 ntuplestore_create_accessor(NTupleStore *ts, bool isWriter)
 {
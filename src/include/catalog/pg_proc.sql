@@ -72,6 +72,12 @@
 
  CREATE FUNCTION gp_dist_wait_status(OUT segid int4, OUT waiter_dxid xid, OUT holder_dxid xid, OUT holdTillEndXact bool, OUT waiter_lpid int4, OUT holder_lpid int4, OUT waiter_lockmode text, OUT waiter_locktype text, OUT waiter_sessionid int4, OUT holder_sessionid int4) RETURNS SETOF pg_catalog.record LANGUAGE internal VOLATILE AS 'gp_dist_wait_status' WITH (OID=6036, DESCRIPTION="waiting relation information");
 
+ CREATE FUNCTION gp_ic_proxy_route_stats(OUT segid int4, OUT peer_content int4, OUT peer_dbid int4, OUT sent_packets int8, OUT sent_bytes int8, OUT recv_packets int8, OUT recv_bytes int8, OUT write_time_us int8, OUT max_write_time_us int8) RETURNS SETOF pg_catalog.record LANGUAGE internal VOLATILE EXECUTE ON ALL SEGMENTS AS 'gp_ic_proxy_route_stats' WITH (OID=7070, DESCRIPTION="statistics: per-route traffic of the interconnect proxy");
+
+ CREATE FUNCTION gp_orca_shared_mdcache_stats(OUT hits int8, OUT misses int8, OUT inserts int8, OUT evictions int8, OUT entries int4, OUT used_bytes int8, OUT size_bytes int8) RETURNS pg_catalog.record LANGUAGE internal VOLATILE EXECUTE ON MASTER AS 'gp_orca_shared_mdcache_stats' WITH (OID=7071, DESCRIPTION="statistics: usage of the ORCA metadata cache shared by all sessions");
+
+ CREATE FUNCTION gp_orca_plan_cache_stats(OUT hits int8, OUT misses int8, OUT inserts int8, OUT verified int8, OUT rejected int8, OUT evictions int8, OUT entries int8, OUT size_bytes int8) RETURNS pg_catalog.record LANGUAGE internal VOLATILE EXECUTE ON MASTER AS 'gp_orca_plan_cache_stats' WITH (OID=7072, DESCRIPTION="statistics: usage of the ORCA plan cache of this session");
+
  CREATE FUNCTION pg_resqueue_status() RETURNS SETOF record LANGUAGE internal VOLATILE STRICT AS 'pg_resqueue_status' WITH (OID=6030, DESCRIPTION="Return resource queue information");
 
  CREATE FUNCTION pg_resqueue_status_kv() RETURNS SETOF record LANGUAGE internal VOLATILE STRICT AS 'pg_resqueue_status_kv' WITH (OID=6069, DESCRIPTION="Return resource queue information");
@@ -22,7 +22,7 @@
 
    WARNING: DO NOT MODIFY THE FOLLOWING SECTION: 
    Generated by catullus.pl version 8
-   on Wed May 29 10:02:27 2019
+   on Sun Oct 18 09:55:03 2026
 
    Please make your changes in pg_proc.sql
 */
@@ -150,7 +150,6 @@ DESCR("get replication error");
 DATA(insert OID = 7154 ( pg_terminate_backend  PGNSP PGUID 12 1 0 0 0 f f f f t f v 2 0 16 "23 25" _null_ _null_ _null_ _null_ pg_terminate_backend_msg _null_ _null_ _null_ n a ));
 DESCR("terminate a server process");
 
-
 /* pg_resgroup_get_status_kv(IN prop_in text, OUT rsgid oid, OUT prop text, OUT value text) => SETOF pg_catalog.record */
 DATA(insert OID = 6065 ( pg_resgroup_get_status_kv  PGNSP PGUID 12 1 1000 0 0 f f f f f t v 1 0 2249 "25" "{25,26,25,25}" "{i,o,o,o}" "{prop_in,rsgid,prop,value}" _null_ pg_resgroup_get_status_kv _null_ _null_ _null_ n a ));
 DESCR("statistics: information about resource groups in key-value style");
@@ -163,6 +162,18 @@ DESCR("statistics: information about resource groups");
 DATA(insert OID = 6036 ( gp_dist_wait_status  PGNSP PGUID 12 1 1000 0 0 f f f f f t v 0 0 2249 "" "{23,28,28,16,23,23,25,25,23,23}" "{o,o,o,o,o,o,o,o,o,o}" "{segid,waiter_dxid,holder_dxid,holdTillEndXact,waiter_lpid,holder_lpid,waiter_lockmode,waiter_locktype,waiter_sessionid,holder_sessionid}" _null_ gp_dist_wait_status _null_ _null_ _null_ n a ));
 DESCR("waiting relation information");
 
+/* gp_ic_proxy_route_stats(OUT segid int4, OUT peer_content int4, OUT peer_dbid int4, OUT sent_packets int8, OUT sent_bytes int8, OUT recv_packets int8, OUT recv_bytes int8, OUT write_time_us int8, OUT max_write_time_us int8) => SETOF pg_catalog.record */
+DATA(insert OID = 7070 ( gp_ic_proxy_route_stats  PGNSP PGUID 12 1 1000 0 0 f f f f f t v 0 0 2249 "" "{23,23,23,20,20,20,20,20,20}" "{o,o,o,o,o,o,o,o,o}" "{segid,peer_content,peer_dbid,sent_packets,sent_bytes,recv_packets,recv_bytes,write_time_us,max_write_time_us}" _null_ gp_ic_proxy_route_stats _null_ _null_ _null_ n s ));
+DESCR("statistics: per-route traffic of the interconnect proxy");
+
+/* gp_orca_shared_mdcache_stats(OUT hits int8, OUT misses int8, OUT inserts int8, OUT evictions int8, OUT entries int4, OUT used_bytes int8, OUT size_bytes int8) => pg_catalog.record */
+DATA(insert OID = 7071 ( gp_orca_shared_mdcache_stats  PGNSP PGUID 12 1 0 0 0 f f f f f f v 0 0 2249 "" "{20,20,20,20,23,20,20}" "{o,o,o,o,o,o,o}" "{hits,misses,inserts,evictions,entries,used_bytes,size_bytes}" _null_ gp_orca_shared_mdcache_stats _null_ _null_ _null_ n m ));
+DESCR("statistics: usage of the ORCA metadata cache shared by all sessions");
+
+/* gp_orca_plan_cache_stats(OUT hits int8, OUT misses int8, OUT inserts int8, OUT verified int8, OUT rejected int8, OUT evictions int8, OUT entries int8, OUT size_bytes int8) => pg_catalog.record */
+DATA(insert OID = 7072 ( gp_orca_plan_cache_stats  PGNSP PGUID 12 1 0 0 0 f f f f f f v 0 0 2249 "" "{20,20,20,20,20,20,20,20}" "{o,o,o,o,o,o,o,o}" "{hits,misses,inserts,verified,rejected,evictions,entries,size_bytes}" _null_ gp_orca_plan_cache_stats _null_ _null_ _null_ n m ));
+DESCR("statistics: usage of the ORCA plan cache of this session");
+
 /* pg_resqueue_status() => SETOF record */
 DATA(insert OID = 6030 ( pg_resqueue_status  PGNSP PGUID 12 1 1000 0 0 f f f f t t v 0 0 2249 "" _null_ _null_ _null_ _null_ pg_resqueue_status _null_ _null_ _null_ n a ));
 DESCR("Return resource queue information");
@@ -16,6 +16,7 @@
 #ifndef CDBCONN_H
 #define CDBCONN_H
 
+#include "cdb/cdbdisp_plancache.h"
 
 /* --------------------------------------------------------------------------------------------------
  * Structure for segment database definition and working values
@@ -55,6 +56,12 @@ typedef struct SegmentDatabaseDescriptor
 	int						identifier;		/* unique identifier in the cdbcomponent segment pool */
 	double					establishConnTime; /* the time of establish connection to the segment,
 												* -1 means this connection is cached */
+
+	/*
+	 * Ids of the plans this QE holds in its dispatched plan cache, by slot.
+	 * See cdbdisp_plancache.c.
+	 */
+	uint64					cachedPlanIds[DISPATCH_PLAN_CACHE_SIZE];
 } SegmentDatabaseDescriptor;
 
 SegmentDatabaseDescriptor *
@@ -47,6 +47,16 @@ typedef struct CdbDispatcherState
 	int rootGangSize;
 	bool forceDestroyGang;
 	bool isExtendedQuery;
+
+	/*
+	 * Dispatch message without the plan, sent instead of the full one to
+	 * QEs which already hold the plan in their dispatched plan cache.  NULL
+	 * if the plan is not cached, see cdbdisp_plancache.c.
+	 */
+	char *cachedPlanQueryText;
+	int cachedPlanQueryTextLen;
+	int cachedPlanSlot;
+	uint64 cachedPlanId;
 #ifdef USE_ASSERT_CHECKING
 	bool isGangDestroying;
 #endif
@@ -0,0 +1,51 @@
+/*-------------------------------------------------------------------------
+ *
+ * cdbdisp_plancache.h
+ *	  routines for caching dispatched plans on the QEs.
+ *
+ * Copyright (c) 2020-Present Pivotal Software, Inc.
+ *
+ *
+ * IDENTIFICATION
+ *	    src/include/cdb/cdbdisp_plancache.h
+ *
+ *-------------------------------------------------------------------------
+ */
+#ifndef CDBDISP_PLANCACHE_H
+#define CDBDISP_PLANCACHE_H
+
+struct SegmentDatabaseDescriptor;		/* #include "cdb/cdbconn.h" */
+struct CdbDispatcherState;				/* #include "cdb/cdbdisp.h" */
+
+/*
+ * Number of serialized plans each QE keeps.  The QD mirrors the contents of
+ * every QE's cache, so this must be the same on both sides.
+ */
+#define DISPATCH_PLAN_CACHE_SIZE	16
+
+/* Larger serialized plans are always dispatched in full. */
+#define DISPATCH_PLAN_CACHE_MAX_PLAN_SIZE	(4 * 1024 * 1024)
+
+/* Plan id 0 means "not cached" in the dispatch message. */
+#define InvalidDispatchPlanId		((uint64) 0)
+
+/* QD side */
+extern uint64 cdbdisp_getPlanId(const char *splan, int splan_len);
+extern int	cdbdisp_assignPlanCacheSlot(uint64 planId);
+extern bool cdbdisp_segdbHasCachedPlan(struct SegmentDatabaseDescriptor *segdbDesc,
+									   int slot, uint64 planId);
+extern void cdbdisp_segdbAddCachedPlan(struct SegmentDatabaseDescriptor *segdbDesc,
+									   int slot, uint64 planId);
+extern void cdbdisp_segdbForgetCachedPlans(struct SegmentDatabaseDescriptor *segdbDesc);
+extern const char *cdbdisp_selectPlanQueryText(struct CdbDispatcherState *ds,
+											   struct SegmentDatabaseDescriptor *segdbDesc,
+											   const char *queryText, int queryTextLen,
+											   int *len);
+
+/* QE side */
+extern void cdbdisp_storeCachedPlan(int slot, uint64 planId,
+									const char *splan, int splan_len);
+extern const char *cdbdisp_lookupCachedPlan(int slot, uint64 planId,
+											int *splan_len);
+
+#endif   /* CDBDISP_PLANCACHE_H */
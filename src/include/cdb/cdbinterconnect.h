@@ -273,6 +273,26 @@ struct MotionConn
     char        remoteHostAndPort[128];	/* Numeric IP addresses should never be longer than about 50 chars, but play it safe */
     char        localHostAndPort[128];
 
+	/*
+	 * used by the TCP sender.
+	 *
+	 * true means the receiver runs on this host, so connect to its
+	 * Unix-domain listener rather than going through the TCP/IP stack.
+	 */
+	bool		tryLocalSocket;
+
+	/*
+	 * used by the TCP sender.
+	 *
+	 * a runtime filter message sent back by the receiver: rfBuf holds rfRead
+	 * of its rfLen bytes.  rfReceived means the whole message has been
+	 * delivered, or the receiver will not send one.
+	 */
+	char	   *rfBuf;
+	int32		rfLen;
+	int32		rfRead;
+	bool		rfReceived;
+
 	struct sockaddr_storage peer;		/* Allow for IPv4 or IPv6 */
 	socklen_t peer_len;					/* And remember the actual length */
 
@@ -497,6 +517,11 @@ typedef struct MotionLayerState
 
 }	MotionLayerState;
 
+/*
+ * Called for each runtime filter message received by RecvRuntimeFilters().
+ */
+typedef void (*RuntimeFilterCallback) (void *arg, const char *data, int len);
+
 typedef struct ChunkTransportState
 {
 	/* array of per-motion-node chunk transport state */
@@ -528,6 +553,10 @@ typedef struct ChunkTransportState
 	void (*doSendStopMessage)(struct ChunkTransportState *transportStates, int16 motNodeID);
 	void (*SendEos)(struct ChunkTransportState *transportStates, int motNodeID, TupleChunkListItem tcItem);
 
+	/* Runtime filters sent back from receivers to senders, NULL if unsupported */
+	void (*doSendRuntimeFilter)(struct ChunkTransportState *transportStates, int16 motNodeID, const char *data, int len);
+	bool (*doRecvRuntimeFilters)(struct ChunkTransportState *transportStates, int16 motNodeID, int timeout_ms, RuntimeFilterCallback callback, void *arg);
+
 	/* ic_proxy backend context */
 	struct ICProxyBackendContext *proxyContext;
 } ChunkTransportState;
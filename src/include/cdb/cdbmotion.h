@@ -122,6 +122,17 @@ extern void SendStopMessage(MotionLayerState *mlStates,
 							ChunkTransportState *transportStates,
 							int16 motNodeID);
 
+/*
+ * Send a runtime filter to the senders of a motion node, and wait for the
+ * ones sent by all the receivers.  Only some interconnects support this.
+ */
+extern bool SendRuntimeFilter(ChunkTransportState *transportStates,
+							  int16 motNodeID,
+							  const char *data, int len);
+extern bool RecvRuntimeFilters(ChunkTransportState *transportStates,
+							   int16 motNodeID, int timeout_ms,
+							   RuntimeFilterCallback callback, void *arg);
+
 /* used by ml_ipc to set the number of receivers that the motion node is expecting.
  * This is used by cdbmotion to keep track of when its seen enough EndOfStream
  * messages.
@@ -437,6 +437,15 @@ extern int 	Gp_udp_bufsize_k;
  */
 extern bool gp_interconnect_aggressive_retry; /* fast-track app-level retry */
 
+/*
+ * Parameter gp_interconnect_tcp_local_socket
+ *
+ * With the TCP interconnect, route motion traffic between processes on the
+ * same host through Unix-domain sockets instead of the TCP/IP stack.
+ * Remote peers, and local peers without such a listener, still use TCP.
+ */
+extern bool gp_interconnect_tcp_local_socket;
+
 /*
  * Parameter gp_interconnect_full_crc
  *
@@ -505,6 +514,9 @@ extern bool gp_enable_fast_sri;
 /* Enable single-mirror pair dispatch. */
 extern bool gp_enable_direct_dispatch;
 
+/* Let QEs cache dispatched plans, so that repeated plans are not resent. */
+extern bool gp_enable_qe_plan_cache;
+
 /* Name of pseudo-function to access any table as if it was randomly distributed. */
 #define GP_DIST_RANDOM_NAME "GP_DIST_RANDOM"
 
@@ -600,8 +612,29 @@ extern bool gp_adjust_selectivity_for_outerjoins;
  * Target density for hash-node (HJ).
  */
 extern int gp_hashjoin_tuples_per_bucket;
+
+/*
+ * Let hash joins build a Bloom filter over the inner join keys, and apply it
+ * in the outer scan.
+ */
+extern bool gp_enable_runtime_filter;
+
+/*
+ * How long (in ms) the scan of a hash join's outer input in another slice
+ * waits for the runtime filter to be shipped to it.
+ */
+extern int gp_runtime_filter_wait_time;
 extern int gp_hashagg_groups_per_bucket;
 
+/*
+ * A streaming lower HashAgg checks every gp_hashagg_passthrough_sample input
+ * rows, and whenever its hash table fills up, whether the rows formed more
+ * than gp_hashagg_passthrough_ratio groups per row.  If so, it passes the
+ * rest of its input through without grouping.  0 rows disables this.
+ */
+extern int gp_hashagg_passthrough_sample;
+extern double gp_hashagg_passthrough_ratio;
+
 /*
  * Damping of selectivities of clauses which pertain to the same base
  * relation; compensates for undetected correlation
@@ -752,6 +785,13 @@ extern bool gp_enable_sort_distinct;
 extern bool gp_enable_mk_sort;
 extern bool gp_enable_motion_mk_sort;
 
+/* Radix sort fixed-width keys, and abbreviate C-collation text, in MK sort */
+extern bool gp_enable_mk_sort_radix;
+extern bool gp_enable_mk_sort_abbrev_text;
+
+/* Maximum number of threads of an in-memory MK sort */
+extern int gp_mk_sort_max_workers;
+
 /* Alter table add column inherits storage setting from the table */
 extern bool gp_add_column_inherits_table_setting;
 
@@ -793,6 +833,9 @@ extern int gp_segworker_relative_priority;
 /*  Max size of dispatched plans; 0 if no limit */
 extern int gp_max_plan_size;
 
+/* Memory for recently compressed plans, in kB; 0 disables the cache */
+extern int gp_plan_compress_cache_size;
+
 /* If we use two stage hashagg, we can stream the bottom half */
 extern bool gp_hashagg_streambottom;
 
@@ -840,6 +883,12 @@ extern int gp_workfile_caching_loglevel;
 extern int gp_sessionstate_loglevel;
 extern int gp_workfile_bytes_to_checksum;
 
+/*
+ * A cross-slice shared input that fits in this many kilobytes is handed to
+ * its readers in dynamic shared memory instead of workfiles.  0 disables it.
+ */
+extern int gp_shareinput_shmem_max_size;
+
 extern bool coredump_on_memerror;
 
 /* Greenplum resource group query_mem re-calculate on QE */
@@ -0,0 +1,50 @@
+/*-------------------------------------------------------------------------
+ *
+ * ic_proxy_stats.h
+ *	  Per-route statistics of the interconnect proxy.
+ *
+ *
+ * Copyright (c) 2020-Present Pivotal Software, Inc.
+ *
+ *
+ *-------------------------------------------------------------------------
+ */
+
+#ifndef IC_PROXY_STATS_H
+#define IC_PROXY_STATS_H
+
+#include "postgres.h"
+
+#include "fmgr.h"
+
+/* Routes to more peers than this are not tracked */
+#define IC_PROXY_STATS_MAX_ROUTES	1024
+
+/*
+ * Statistics of the route to a peer proxy.
+ *
+ * They live in shared memory, and are only written by the proxy bgworker, so
+ * no locking is needed.  Readers could see a slightly out-of-date snapshot.
+ */
+typedef struct ICProxyRouteStats
+{
+	int16		content;		/* content of the peer */
+	uint16		dbid;			/* dbid of the peer */
+
+	uint64		sentPkts;		/* packets written to the peer */
+	uint64		sentBytes;		/* bytes written to the peer */
+	uint64		recvPkts;		/* packets received from the peer */
+	uint64		recvBytes;		/* bytes received from the peer */
+
+	uint64		writeTimeUs;	/* total time for writes to complete */
+	uint64		maxWriteTimeUs;	/* longest time for a write to complete */
+} ICProxyRouteStats;
+
+extern Size ICProxyStatsShmemSize(void);
+extern void ICProxyStatsShmemInit(void);
+
+extern ICProxyRouteStats *ic_proxy_stats_get_route(int16 content, uint16 dbid);
+
+extern Datum gp_ic_proxy_route_stats(PG_FUNCTION_ARGS);
+
+#endif   /* IC_PROXY_STATS_H */
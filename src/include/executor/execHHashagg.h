@@ -187,6 +187,9 @@ typedef struct HashAggTable
 	/* buffer for calculating the hashkey */
 	HashKey *hashkey_buf;
 
+	/* can the i'th grouping key be compared as a plain Datum? */
+	bool *key_eq_bitwise;
+
 	/* GPDB: Statistics for EXPLAIN ANALYZE */
 	HashAggTableSizes   hats;
 
@@ -206,6 +209,10 @@ typedef struct HashAggTable
 	uint32 num_expansions; /* number of times hash table is expanded */
 
 	bool is_spilling; /* indicate that spilling happened for this batch. */
+	uint64 passthrough_window_start; /* streaming: num_tuples when the table was last emptied */
+	uint64 passthrough_next_check; /* streaming: num_tuples at which to check pass-through */
+	bool is_passthrough; /* streaming: every input tuple is output as a group */
+	uint64 passthrough_after; /* number of input tuples before passing through */
 	bool expandable;  /* hash table buckets still have space to grow */
 	struct TupleTableSlot *prev_slot; /* a slot that is read previously. */
 
@@ -139,6 +139,16 @@ typedef struct HashJoinTableStats
 } HashJoinTableStats;
 
 
+/*
+ * The bit of a hash value in the tag of its bucket.
+ *
+ * The tags live in an array of their own, much smaller than the tuples, so a
+ * probe can tell that a bucket holds no tuple with its hash value without
+ * touching the tuples, which are all over memory.  The low bits of the hash
+ * value pick the bucket and the next ones the batch, so use the top bits.
+ */
+#define HJ_BUCKET_TAG(hashvalue)	((uint16) (1 << ((hashvalue) >> 28)))
+
 /*
  * HashJoinTableData
  */
@@ -149,7 +159,9 @@ typedef struct HashJoinTableData
 
 	/* buckets[i] is head of list of tuples in i'th in-memory bucket */
 	struct HashJoinTupleData **buckets;
-	/* buckets array is per-batch storage, as are all the tuples */
+	/* bucketTags[i] has the HJ_BUCKET_TAG bit of each tuple in i'th bucket */
+	uint16	   *bucketTags;
+	/* buckets arrays are per-batch storage, as are all the tuples */
 
 	bool		keepNulls;		/* true to store unmatchable NULL tuples */
 
@@ -210,4 +222,84 @@ typedef struct HashJoinTableData
     bool first_pass; /* Is this the first pass (pre-rescan) */
 }	HashJoinTableData;
 
+
+/* ----------------------------------------------------------------
+ *				runtime join filter
+ *
+ * While the Hash node builds the hash table, it also sets bits in a Bloom
+ * filter for the hash value of every inner tuple.  The scan on the outer
+ * side of the join computes the hash value of its output tuples with the
+ * outer hash keys, and drops those whose bits are not all set: they cannot
+ * have a join partner.  This is only done for joins that don't emit
+ * unmatched outer tuples.
+ *
+ * The filter is blocked: both bits of a hash value are in the same 64-bit
+ * word, so a probe touches a single cache line.  The low bits of the hash
+ * value pick the word, and the high bits pick two bit positions in it.
+ *
+ * Until the hash table has been built, the filter passes every tuple.
+ *
+ * CDB: If the outer input of the join is a Motion with a scan right below
+ * it, the scan is in another slice.  Every receiver of the Motion then sends
+ * its filter over the interconnect to all the senders, which OR them
+ * together.  A sender waits up to gp_runtime_filter_wait_time for the
+ * filters before it starts to scan, and doesn't filter if they don't all
+ * arrive.  These filters are smaller, since a copy of each is sent to every
+ * sender: with N segments, N * N filters cross the interconnect, and their
+ * total size is capped at RUNTIME_FILTER_MAX_REMOTE_TOTAL_BITS.  Only the
+ * TCP interconnect can ship filters; with the UDP interconnect or the proxy,
+ * only joins whose outer scan is in their own slice get one.
+ * ----------------------------------------------------------------
+ */
+#define RUNTIME_FILTER_BITS_PER_ROW	10
+#define RUNTIME_FILTER_MIN_BITS		(1 << 13)
+#define RUNTIME_FILTER_MAX_BITS		(1 << 25)
+#define RUNTIME_FILTER_MAX_REMOTE_BITS	(1 << 19)
+#define RUNTIME_FILTER_MAX_REMOTE_TOTAL_BITS	(1 << 28)
+
+/*
+ * After this many probes, give up on a filter that removes too few rows to
+ * pay for computing the outer hash values twice.
+ */
+#define RUNTIME_FILTER_SAMPLE_ROWS	4096
+#define RUNTIME_FILTER_MIN_SELECTIVITY	0.05
+
+typedef struct HashRuntimeFilterData
+{
+	struct EState *estate;
+
+	/* to compute the hash values of outer tuples, like the hash join does */
+	List	   *hashkeys;		/* outer hash keys, list of ExprState nodes */
+	FmgrInfo   *hashfunctions;	/* outer hash functions */
+	bool	   *hashStrict;		/* is each hash join operator strict? */
+	bool		keepNulls;		/* are tuples with NULL keys kept? */
+	ExprContext *econtext;		/* to evaluate the outer hash keys */
+
+	uint64	   *words;			/* the bits */
+	uint32		nwords;			/* # of words (a power of 2!) */
+
+	bool		ready;			/* inner side is built; filter can be used */
+	bool		overflowed;		/* inner side was too big for the filter */
+	bool		disabled;		/* gave up on the filter */
+
+	/* CDB: cross-slice filters */
+	int16		motNodeID;		/* Motion to ship the filter over, or 0 */
+	bool		shipped;		/* receiver: sent the filter to the senders */
+	bool		waited;			/* sender: waited for the receivers' filters */
+	bool		timedout;		/* sender: some filters didn't arrive in time */
+
+	uint64		ninserted;		/* # inner hash values inserted */
+	uint64		nchecked;		/* # outer tuples probed */
+	uint64		nfiltered;		/* # outer tuples removed */
+}	HashRuntimeFilterData;
+
+/*
+ * A filter sent over the interconnect: this header, followed by the words.
+ */
+typedef struct HashRuntimeFilterMsg
+{
+	uint32		nwords;
+	bool		overflowed;
+}	HashRuntimeFilterMsg;
+
 #endif   /* HASHJOIN_H */
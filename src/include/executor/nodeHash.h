@@ -62,6 +62,16 @@ extern void ExecHashTableExplainInit(HashState *hashState, HashJoinState *hjstat
                                      HashJoinTable  hashtable);
 extern void ExecHashTableExplainBatchEnd(HashState *hashState, HashJoinTable hashtable);
 
+extern bool ExecHashJoinPushesRuntimeFilter(HashJoin *node);
+extern void ExecHashRuntimeFilterCreate(HashJoinState *hjstate);
+extern void ExecHashRuntimeFilterCreateSender(HashJoin *node, EState *estate,
+								  ScanState *outerScan, int16 motNodeID);
+extern void ExecHashRuntimeFilterReset(HashRuntimeFilter filter);
+extern void ExecHashRuntimeFilterInsert(HashRuntimeFilter filter, uint32 hashvalue);
+extern void ExecHashRuntimeFilterFinish(HashRuntimeFilter filter);
+extern bool ExecHashRuntimeFilterCheck(HashRuntimeFilter filter,
+						   struct TupleTableSlot *slot);
+
 static inline int
 ExecHashRowSize(int tupwidth)
 {
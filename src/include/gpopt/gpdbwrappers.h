@@ -686,6 +686,43 @@ gpos::ULONG CountLeafPartTables(Oid oidRelation);
 // table has been changed?)
 bool MDCacheNeedsReset(void);
 
+// have catalog tables changed since the invalidations were cleared?
+bool MDCacheHasInvalidations(void);
+
+// forget the invalidations, once the metadata cache has been purged
+void MDCacheClearInvalidations(void);
+
+// has the catalog entry of the object with the given oid changed?
+bool MDCacheOidInvalidated(Oid oid);
+
+// have the statistics of the column at the given position changed?
+bool MDCacheColStatsInvalidated(Oid rel_oid, int pos);
+
+// snapshot the versions of the shared metadata cache for a new query
+void SharedMDCacheBeginOptimization(void);
+
+// version of a type, operator, function, aggregate or constraint in the
+// shared metadata cache, returns false if the shared metadata cache can't be
+// used
+bool SharedMDCacheOidVersion(Oid oid, uint64 *version);
+
+// version of a relation or of its statistics in the shared metadata cache
+bool SharedMDCacheRelVersion(Oid rel_oid, uint64 *version);
+
+// version of an index in the shared metadata cache
+bool SharedMDCacheIndexVersion(Oid index_oid, uint64 *version);
+
+// version of the statistics of the column at the given position in the
+// shared metadata cache
+bool SharedMDCacheColStatsVersion(Oid rel_oid, int pos, uint64 *version);
+
+// look up a serialized object in the shared metadata cache
+void *SharedMDCacheLookup(const char *key, uint64 version, Size *len);
+
+// add a serialized object to the shared metadata cache
+void SharedMDCacheInsert(const char *key, uint64 version, const void *data,
+						 Size len);
+
 // returns true if a query cancel is requested in GPDB
 bool IsAbortRequested(void);
 
@@ -52,6 +52,12 @@ private:
 	// private copy ctor
 	CMDProviderRelcache(const CMDProviderRelcache &);
 
+	// key and version of the object in the shared metadata cache, returns
+	// false if the object is not shared
+	static BOOL GetSharedMDCacheKey(IMDId *md_id,
+									IMDCacheObject::Emdtype mdtype, CHAR *key,
+									uint64 *version);
+
 public:
 	// ctor/dtor
 	explicit CMDProviderRelcache(CMemoryPool *mp);
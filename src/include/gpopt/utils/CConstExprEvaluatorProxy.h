@@ -77,13 +77,17 @@ private:
 	// translator for the DXL input -> GPDB Expr
 	CTranslatorDXLToScalar m_dxl2scalar_translator;
 
+	// has any expression been evaluated?
+	BOOL m_has_evaluated_expr;
+
 public:
 	// ctor
 	CConstExprEvaluatorProxy(CMemoryPool *mp, CMDAccessor *md_accessor)
 		: m_mp(mp),
 		  m_emptymapcidvar(m_mp),
 		  m_md_accessor(md_accessor),
-		  m_dxl2scalar_translator(m_mp, m_md_accessor, 0)
+		  m_dxl2scalar_translator(m_mp, m_md_accessor, 0),
+		  m_has_evaluated_expr(false)
 	{
 	}
 
@@ -103,6 +107,14 @@ public:
 	{
 		return true;
 	}
+
+	// has any expression been evaluated? if so, the plan may depend on
+	// the values of stable functions at the time of optimization
+	BOOL
+	HasEvaluatedExpr() const
+	{
+		return m_has_evaluated_expr;
+	}
 };
 }  // namespace gpdxl
 
@@ -25,6 +25,10 @@ class CMemoryPoolPalloc : public CMemoryPool
 private:
 	MemoryContext m_cxt;
 
+	// number of allocations; frees are not counted, as they do not know
+	// their pool
+	ULLONG m_num_allocations;
+
 	// When destroying arrays, we need to call the destructor of each element
 	// To do this, we need the size of the allocation, which we then divide by the
 	// the size of the element to get number of elements to iterate through.
@@ -51,6 +55,13 @@ public:
 	// return total allocated size include management overhead
 	ULLONG TotalAllocatedSize() const;
 
+	// return number of allocations
+	ULLONG
+	NumAllocations() const
+	{
+		return m_num_allocations;
+	}
+
 	// get user requested size of allocation
 	static ULONG UserSizeOfAlloc(const void *ptr);
 };
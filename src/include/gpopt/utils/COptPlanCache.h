@@ -0,0 +1,320 @@
+//---------------------------------------------------------------------------
+//	Greenplum Database
+//	Copyright (C) 2020 Pivotal Software, Inc.
+//
+//	@filename:
+//		COptPlanCache.h
+//
+//	@doc:
+//		Cache of the plans produced by the optimizer, for queries of the
+//		same shape
+//
+//	@test:
+//
+//---------------------------------------------------------------------------
+
+#ifndef GPOPT_COptPlanCache_H
+#define GPOPT_COptPlanCache_H
+
+#include "gpos/base.h"
+#include "gpos/common/CBitSet.h"
+#include "gpos/common/CRefCount.h"
+#include "gpos/memory/CCache.h"
+#include "gpos/string/CWStringDynamic.h"
+
+#include "naucrates/dxl/operators/CDXLDatum.h"
+#include "naucrates/dxl/operators/CDXLNode.h"
+#include "naucrates/md/IMDId.h"
+
+namespace gpopt
+{
+class CMDAccessor;
+class COptimizerConfig;
+}  // namespace gpopt
+
+namespace gpopt
+{
+using namespace gpos;
+using namespace gpdxl;
+using namespace gpmd;
+
+//---------------------------------------------------------------------------
+//	@class:
+//		COptPlanCache
+//
+//	@doc:
+//		A per-backend cache of plan DXL, keyed by a fingerprint of the query
+//		DXL and of the optimizer settings.
+//
+//		Literals that are compared to a column with a histogram are taken
+//		out of the fingerprint, and replaced by the histogram bucket they
+//		fall into. So queries that only differ in such literals, and whose
+//		literals select the same buckets, share a cache entry. The entry
+//		keeps the plan of the first of these queries as a template, with
+//		that query's literals in it.
+//
+//		The first time the template is looked up with other literals, the
+//		query is optimized anyway, and the new plan is compared with the
+//		template with the literals substituted. If they are the same, and
+//		their row estimates are close, the template is reused for later
+//		queries of that shape; otherwise it is only reused for the exact
+//		same literals. A reused template is verified again every few
+//		reuses, so that it does not keep the cardinalities of the first
+//		query for good.
+//
+//		The optimizer may merge several comparisons of a column into one,
+//		keeping only the literal that is the most selective for the given
+//		values. So the template is never reused with other literals if a
+//		column is compared to several literals, or if any literal does not
+//		appear as such in the plan.
+//
+//		A plan is evicted when any of the metadata objects it was optimized
+//		with is invalidated.
+//
+//---------------------------------------------------------------------------
+class COptPlanCache
+{
+public:
+	// can a cached plan be reused with other literals?
+	enum EPlanState
+	{
+		EpsUnverified,		  // not tried with other literals yet
+		EpsVerified,		  // optimizing with other literals gave the same plan
+		EpsLiteralSensitive,  // optimizing with other literals gave another plan
+	};
+
+	// outcome of a lookup
+	enum ELookupResult
+	{
+		ElrMiss,	// no plan for the query; optimize and insert it
+		ElrHit,		// reuse the returned plan
+		ElrVerify,	// optimize, and verify the returned expected plan
+		ElrSkip		// the cached plan cannot be used; just optimize
+	};
+
+	// a catalog object a cached plan depends on
+	struct SDependency
+	{
+		// OID of the object, or of the relation for column statistics
+		OID m_oid;
+
+		// position of the column for column statistics, or -1; this is
+		// the position among all the columns of the relation's metadata,
+		// dropped ones included, as in CMDIdColStats
+		INT m_pos;
+	};
+
+	// a cached plan
+	class CPlanEntry : public CRefCount
+	{
+	public:
+		// memory pool of the entry
+		CMemoryPool *m_mp;
+
+		// fingerprint of the query
+		CWStringDynamic *m_key;
+
+		// plan DXL, with the literals of the first query
+		CWStringDynamic *m_plan;
+
+		// abstracted literals of the first query
+		StringPtrArray *m_literals;
+
+		// can the plan be reused with other literals?
+		EPlanState m_state;
+
+		// number of times the plan was reused with other literals
+		ULONG m_num_reuses;
+
+		// catalog objects the plan depends on
+		SDependency *m_deps;
+
+		// number of dependencies
+		ULONG m_num_deps;
+
+		// does the plan depend on objects that cannot be tracked, so that
+		// any catalog change evicts it?
+		BOOL m_depends_on_all;
+
+		// ctor
+		explicit CPlanEntry(CMemoryPool *mp)
+			: m_mp(mp),
+			  m_key(NULL),
+			  m_plan(NULL),
+			  m_literals(NULL),
+			  m_state(EpsUnverified),
+			  m_num_reuses(0),
+			  m_deps(NULL),
+			  m_num_deps(0),
+			  m_depends_on_all(false)
+		{
+		}
+
+		// dtor
+		virtual ~CPlanEntry();
+	};
+
+	typedef CCache<CPlanEntry *, CWStringDynamic *> PlanCache;
+
+private:
+	// pointer to the underlying cache
+	static PlanCache *m_pcache;
+
+	// the maximum size of the cache
+	static ULLONG m_cache_quota;
+
+	// counters
+	static ULLONG m_num_hits;
+	static ULLONG m_num_misses;
+	static ULLONG m_num_inserts;
+	static ULLONG m_num_verified;
+	static ULLONG m_num_rejected;
+
+	// private ctor
+	COptPlanCache(){};
+
+	// no copy ctor
+	COptPlanCache(const COptPlanCache &);
+
+	// private dtor
+	~COptPlanCache(){};
+
+	// hash function for the cache keys
+	static ULONG HashKey(CWStringDynamic *const &key);
+
+	// equality function for the cache keys
+	static BOOL EqualKeys(CWStringDynamic *const &left,
+						  CWStringDynamic *const &right);
+
+	// filter for Invalidate, selecting the plans affected by catalog changes
+	static BOOL IsPlanStale(CWStringDynamic *const &key,
+							CPlanEntry *const &entry, void *arg);
+
+	// collect the literals to abstract, and the buckets they fall into
+	static void CollectLiterals(CMemoryPool *mp, CMDAccessor *md_accessor,
+								const CDXLNode *root, const CDXLNode *node,
+								StringPtrArray *literals,
+								CWStringDynamic *buckets, CBitSet *colids,
+								BOOL *is_generalizable);
+
+	// find the table descriptor of the base table column with the given id
+	static const CDXLNode *FindGet(const CDXLNode *node, ULONG colid,
+								   INT *attno);
+
+	// histogram bucket of the column that a datum falls into, or -1
+	static INT GetBucket(CMemoryPool *mp, CMDAccessor *md_accessor,
+						 IMDId *rel_mdid, INT attno,
+						 const CDXLDatum *dxl_datum);
+
+	// append characters of a buffer to a string
+	static void AppendChars(CMemoryPool *mp, CWStringDynamic *str,
+							const WCHAR *buffer, ULONG length);
+
+	// string of the attributes of a datum, as serialized in DXL
+	static CWStringDynamic *GetLiteralStr(CMemoryPool *mp,
+										  const CDXLNode *const_node);
+
+	// does a string contain another one?
+	static BOOL Contains(const CWStringBase *str, const CWStringBase *substr);
+
+	// replace all occurrences of the literals by their replacements
+	static CWStringDynamic *ReplaceLiterals(CMemoryPool *mp,
+											const CWStringBase *str,
+											const StringPtrArray *literals,
+											const StringPtrArray *replacements);
+
+	// copy plan DXL, leaving out the header and the costs
+	static CWStringDynamic *StripPlanForCompare(CMemoryPool *mp,
+												const CWStringBase *plan);
+
+	// find the next row estimate in plan DXL
+	static BOOL NextRowEstimate(const CWStringBase *plan, ULONG *pos,
+								DOUBLE *rows);
+
+	// do the row estimates of two plans of the same shape differ much?
+	static BOOL RowEstimatesDiffer(const CWStringBase *plan,
+								   const CWStringBase *other_plan);
+
+	// parse plan DXL
+	static CDXLNode *ParsePlan(CMemoryPool *mp, const CWStringBase *plan);
+
+	// serialize plan DXL
+	static CWStringDynamic *SerializePlan(CMemoryPool *mp,
+										  const CDXLNode *plan_dxl,
+										  COptimizerConfig *optimizer_config);
+
+	// compute the dependencies of a plan
+	static void SetDependencies(CMemoryPool *mp, CMDAccessor *md_accessor,
+								CPlanEntry *entry);
+
+public:
+	// initialize underlying cache
+	static void Init();
+
+	// has cache been initialized?
+	static BOOL
+	FInitialized()
+	{
+		return (NULL != m_pcache);
+	}
+
+	// destroy global instance
+	static void Shutdown();
+
+	// reset global instance
+	static void Reset();
+
+	// set the maximum size of the cache
+	static void SetCacheQuota(ULLONG cache_quota);
+
+	// get the maximum size of the cache
+	static ULLONG GetCacheQuota();
+
+	// evict the plans affected by the catalog changes since the last
+	// optimization, return how many were evicted
+	static ULONG Invalidate();
+
+	// build the key of a query, collect its abstracted literals, and tell
+	// whether its plan may be reused with other literals
+	static CWStringDynamic *BuildKey(
+		CMemoryPool *mp, CMDAccessor *md_accessor, const CDXLNode *query_dxl,
+		const CDXLNodeArray *query_output_dxlnode_array,
+		const CDXLNodeArray *cte_dxlnode_array,
+		COptimizerConfig *optimizer_config, ULONG num_segments,
+		StringPtrArray *literals, BOOL *is_generalizable);
+
+	// look up the plan of a query
+	static ELookupResult Lookup(CMemoryPool *mp, CWStringDynamic *key,
+								const StringPtrArray *literals,
+								CDXLNode **plan_dxl,
+								CWStringDynamic **expected_plan);
+
+	// insert the plan of a query that was not found in the cache
+	static void Insert(CMemoryPool *mp, CMDAccessor *md_accessor,
+					   CWStringDynamic *key, const StringPtrArray *literals,
+					   BOOL is_generalizable, const CDXLNode *plan_dxl,
+					   COptimizerConfig *optimizer_config);
+
+	// compare the plan of a query with the expected plan returned by the
+	// lookup, and record whether the cached plan can be reused
+	static void Verify(CMemoryPool *mp, CWStringDynamic *key,
+					   const CDXLNode *plan_dxl,
+					   COptimizerConfig *optimizer_config,
+					   const CWStringDynamic *expected_plan);
+
+	// record that the plan of a query cannot be reused with other literals
+	static void Reject(CWStringDynamic *key);
+
+	// get the counters of the cache
+	static void GetStats(ULLONG *num_hits, ULLONG *num_misses,
+						 ULLONG *num_inserts, ULLONG *num_verified,
+						 ULLONG *num_rejected, ULLONG *num_evictions,
+						 ULLONG *num_entries, ULLONG *size);
+
+};	// class COptPlanCache
+
+}  // namespace gpopt
+
+#endif	// !GPOPT_COptPlanCache_H
+
+// EOF
@@ -35,10 +35,16 @@ namespace gpdxl
 class CDXLNode;
 }
 
+namespace gpmd
+{
+class IMDCacheObject;
+}
+
 namespace gpopt
 {
 class CExpression;
 class CMDAccessor;
+class CMDKey;
 class CQueryContext;
 class COptimizerConfig;
 class ICostModel;
@@ -51,6 +57,7 @@ struct MemoryContextData;
 
 using namespace gpos;
 using namespace gpdxl;
+using namespace gpmd;
 using namespace gpopt;
 
 // context of optimizer input and output objects
@@ -130,6 +137,10 @@ private:
 	// optimize a query to a physical DXL
 	static void *OptimizeTask(void *ptr);
 
+	// filter selecting the metadata cache objects affected by catalog changes
+	static BOOL IsMDCacheObjectStale(CMDKey *const &key,
+									 IMDCacheObject *const &obj, void *arg);
+
 	// translate a DXL tree into a planned statement
 	static PlannedStmt *ConvertToPlanStmtFromDXL(
 		CMemoryPool *mp, CMDAccessor *md_accessor, const CDXLNode *dxlnode,
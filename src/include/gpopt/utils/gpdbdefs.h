@@ -65,6 +65,7 @@ extern "C" {
 #include "utils/numeric.h"
 #include "utils/rel.h"
 #include "utils/selfuncs.h"
+#include "utils/shared_mdcache.h"
 #include "utils/syscache.h"
 #include "utils/typcache.h"
 #include "utils/uri.h"
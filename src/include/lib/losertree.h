@@ -0,0 +1,60 @@
+/*
+ * losertree.h
+ *
+ * A tournament tree of losers, for merging sorted streams
+ *
+ * Copyright (c) 2020-Present Pivotal Software, Inc.
+ *
+ * src/include/lib/losertree.h
+ */
+
+#ifndef LOSERTREE_H
+#define LOSERTREE_H
+
+/*
+ * Same convention as binaryheap_comparator: the comparator must return <0
+ * iff a < b, 0 iff a == b, and >0 iff a > b, and the largest node wins.
+ */
+typedef int (*losertree_comparator) (Datum a, Datum b, void *arg);
+
+/*
+ * losertree
+ *
+ *		lt_nleaves		how many leaves the tree was built over
+ *		lt_space		how many leaves can be stored
+ *		lt_size			how many leaves still hold a node
+ *		lt_built		losertree_build() has been called
+ *		lt_compare		comparison function to pick the winner
+ *		lt_arg			user data for comparison function
+ *		lt_losers		lt_losers[0] is the overall winner, lt_losers[i] the
+ *						leaf that lost the match at internal node i
+ *		lt_active		does the leaf still hold a node?
+ *		lt_leaves		the nodes
+ */
+typedef struct losertree
+{
+	int			lt_nleaves;
+	int			lt_space;
+	int			lt_size;
+	bool		lt_built;
+	losertree_comparator lt_compare;
+	void	   *lt_arg;
+	int		   *lt_losers;
+	bool	   *lt_active;
+	Datum	   *lt_leaves;
+} losertree;
+
+extern losertree *losertree_allocate(int capacity,
+				   losertree_comparator compare,
+				   void *arg);
+extern void losertree_reset(losertree *tree);
+extern void losertree_free(losertree *tree);
+extern void losertree_add_unordered(losertree *tree, Datum d);
+extern void losertree_build(losertree *tree);
+extern Datum losertree_first(losertree *tree);
+extern void losertree_remove_first(losertree *tree);
+extern void losertree_replace_first(losertree *tree, Datum d);
+
+#define losertree_empty(t)			((t)->lt_size == 0)
+
+#endif   /* LOSERTREE_H */
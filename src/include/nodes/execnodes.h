@@ -1678,6 +1678,8 @@ typedef enum
  *
  *		currentRelation    relation being scanned (NULL if none)
  *		ScanTupleSlot	   pointer to slot in tuple table holding scan tuple
+ *		runtimeFilter	   runtime join filter pushed down by a parent hash
+ *						   join (NULL if none)
  * ----------------
  */
 typedef struct ScanState
@@ -1685,6 +1687,7 @@ typedef struct ScanState
 	PlanState	ps;				/* its first field is NodeTag */
 	Relation	ss_currentRelation;
 	TupleTableSlot *ss_ScanTupleSlot;
+	struct HashRuntimeFilterData *ss_runtimeFilter;
 } ScanState;
 
 /*
@@ -2403,6 +2406,7 @@ typedef struct MergeJoinState
 /* these structs are defined in executor/hashjoin.h: */
 typedef struct HashJoinTupleData *HashJoinTuple;
 typedef struct HashJoinTableData *HashJoinTable;
+typedef struct HashRuntimeFilterData *HashRuntimeFilter;
 
 typedef struct HashJoinState
 {
@@ -2434,6 +2438,8 @@ typedef struct HashJoinState
 	/* set if the operator created workfiles */
 	bool workfiles_created;
 	bool reuse_hashtable; /* Do we need to preserve hash table to support rescan */
+
+	HashRuntimeFilter hj_RuntimeFilter;	/* filter pushed to the outer scan */
 } HashJoinState;
 
 
@@ -2495,6 +2501,8 @@ typedef struct ShareInputScanState
 /* XXX Should move into buf file */
 extern void *shareinput_init_lk_ctxt(int share_id);
 extern void shareinput_reader_waitready(void *, int share_id, PlanGenerator planGen);
+extern void shareinput_writer_publish(void *, struct NTupleStore *ts);
+extern bool shareinput_reader_shmem_pages(void *, char **pages, int *npages);
 extern void shareinput_writer_notifyready(void *, int share_id, int nsharer_xslice_notify_ready, PlanGenerator planGen);
 extern void shareinput_reader_notifydone(void *, int share_id);
 extern void shareinput_writer_waitdone(void *, int share_id, int nsharer_xslice_wait_done);
@@ -2731,6 +2739,7 @@ typedef struct HashState
 	bool		hs_quit_if_hashkeys_null;	/* quit building hash table if hashkeys are all null */
 	bool		hs_hashkeys_null;	/* found an instance wherein hashkeys are all null */
 	/* hashkeys is same as parent's hj_InnerHashKeys */
+	struct HashRuntimeFilterData *hs_runtimeFilter;	/* filter to build, if any */
 } HashState;
 
 /* ----------------
@@ -2902,11 +2911,14 @@ typedef struct MotionState
 								 * the routeId last returned ) */
 	bool		tupleheapReady; /* for a sorted motion node, false until we have a tuple from
 								 * each source segindex */
+	bool		bounded;		/* is the parent only interested in 'bound' tuples? */
+	int64		bound;			/* if bounded, how many tuples are needed */
+	int64		numTuplesBounded;	/* tuples returned while bounded */
 
 	/* For sorted Motion recv */
 	struct MotionMKHeapContext *tupleheap_mk;		/* data structure for match merge in sorted motion node */
 
-	struct binaryheap *tupleheap;
+	struct losertree *tupleheap;	/* merge tree of sender route ids */
 	struct CdbTupleHeapInfo *tupleheap_entries;
 	struct CdbMergeComparatorContext *tupleheap_cxt;
 
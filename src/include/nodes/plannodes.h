@@ -153,6 +153,16 @@ typedef struct PlannedStmt
 
 	int			total_memory_master;	/* GPDB: The total usable virtual memory on master node in MB */
 	int			nsegments_master;		/* GPDB: The number of primary segments on master node  */
+
+	/*
+	 * GPDB: outcome of the GPORCA search, for EXPLAIN. Only filled in when
+	 * optimizer_search_time_budget or optimizer_search_memory_budget is set,
+	 * otherwise optimizerSearchStages is 0.
+	 */
+	int			optimizerSearchStage;	/* search stages completed */
+	int			optimizerSearchStages;	/* search stages of the strategy */
+	int			optimizerSearchTime;	/* duration of the search, in ms */
+	bool		optimizerSearchBudgetExceeded;	/* search stopped exploring? */
 } PlannedStmt;
 
 /*
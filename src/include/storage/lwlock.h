@@ -143,7 +143,10 @@ extern PGDLLIMPORT LWLockPadded *MainLWLockArray;
 #define FTSReplicationStatusLock	(&MainLWLockArray[PG_NUM_INDIVIDUAL_LWLOCKS + 11].lock)
 #define TwophaseCommitLock			(&MainLWLockArray[PG_NUM_INDIVIDUAL_LWLOCKS + 12].lock)
 #define ParallelCursorEndpointLock	(&MainLWLockArray[PG_NUM_INDIVIDUAL_LWLOCKS + 13].lock)
-#define GP_NUM_INDIVIDUAL_LWLOCKS		13
+#define ShareInputScanLock			(&MainLWLockArray[PG_NUM_INDIVIDUAL_LWLOCKS + 14].lock)
+#define SharedMDCacheLock			(&MainLWLockArray[PG_NUM_INDIVIDUAL_LWLOCKS + 15].lock)
+/* the locks above are numbered from 1, so count the unused slot 0 too */
+#define GP_NUM_INDIVIDUAL_LWLOCKS		16
 
 /*
  * It would probably be better to allocate separate LWLock tranches
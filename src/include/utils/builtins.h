@@ -1318,6 +1318,12 @@ extern Datum pg_resgroup_get_status_kv(PG_FUNCTION_ARGS);
 /* utils/gdd/gddfuncs.c */
 extern Datum gp_dist_wait_status(PG_FUNCTION_ARGS);
 
+/* cdb/motion/ic_proxy_stats.c */
+extern Datum gp_ic_proxy_route_stats(PG_FUNCTION_ARGS);
+
+/* utils/cache/shared_mdcache.c */
+extern Datum gp_orca_shared_mdcache_stats(PG_FUNCTION_ARGS);
+
 /* utils/adt/matrix.c */
 extern Datum matrix_add(PG_FUNCTION_ARGS);
 
@@ -1387,6 +1393,7 @@ extern Datum enable_xform(PG_FUNCTION_ARGS);
 
 /* Optimizer's version */
 extern Datum gp_opt_version(PG_FUNCTION_ARGS);
+extern Datum gp_orca_plan_cache_stats(PG_FUNCTION_ARGS);
 
 /* query_metrics.c */
 extern Datum gp_instrument_shmem_summary(PG_FUNCTION_ARGS);
@@ -0,0 +1,40 @@
+/*-------------------------------------------------------------------------
+ *
+ * shared_mdcache.h
+ *	  Shared-memory cache of serialized ORCA metadata objects.
+ *
+ *
+ * Copyright (c) 2020-Present Pivotal Software, Inc.
+ *
+ *
+ *-------------------------------------------------------------------------
+ */
+
+#ifndef SHARED_MDCACHE_H
+#define SHARED_MDCACHE_H
+
+#include "fmgr.h"
+#include "storage/sinval.h"
+
+/* Metadata ids longer than this, as strings, are not shared */
+#define SHARED_MDCACHE_KEYLEN	64
+
+extern Size SharedMDCacheShmemSize(void);
+extern void SharedMDCacheShmemInit(void);
+extern void InitSharedMDCache(void);
+
+extern void SharedMDCacheSendInvalidations(const SharedInvalidationMessage *msgs,
+							  int n);
+
+extern void SharedMDCacheBeginOptimization(void);
+extern bool SharedMDCacheOidVersion(Oid oid, uint64 *version);
+extern bool SharedMDCacheRelVersion(Oid relid, uint64 *version);
+extern bool SharedMDCacheIndexVersion(Oid indexid, uint64 *version);
+extern bool SharedMDCacheColStatsVersion(Oid relid, int attno, uint64 *version);
+extern void *SharedMDCacheLookup(const char *key, uint64 version, Size *len);
+extern void SharedMDCacheInsert(const char *key, uint64 version,
+					const void *data, Size len);
+
+extern Datum gp_orca_shared_mdcache_stats(PG_FUNCTION_ARGS);
+
+#endif   /* SHARED_MDCACHE_H */
@@ -20,12 +20,17 @@
 		"gp_default_storage_options",
 		"gp_disable_tuple_hints",
 		"gp_enable_mk_sort",
+		"gp_enable_mk_sort_abbrev_text",
+		"gp_enable_mk_sort_radix",
 		"gp_enable_motion_mk_sort",
+		"gp_enable_runtime_filter",
 		"gp_enable_segment_copy_checking",
 		"gp_external_enable_filter_pushdown",
 		"gp_gpperfmon_send_interval",
 		"gp_hashagg_default_nbatches",
 		"gp_hashagg_groups_per_bucket",
+		"gp_hashagg_passthrough_ratio",
+		"gp_hashagg_passthrough_sample",
 		"gp_hashjoin_tuples_per_bucket",
 		"gp_ignore_error_table",
 		"gp_indexcheck_insert",
@@ -43,6 +48,7 @@
 		"gp_interconnect_setup_timeout",
 		"gp_interconnect_snd_queue_depth",
 		"gp_interconnect_tcp_listener_backlog",
+		"gp_interconnect_tcp_local_socket",
 		"gp_interconnect_timer_checking_period",
 		"gp_interconnect_timer_period",
 		"gp_interconnect_transmit_timeout",
@@ -58,6 +64,7 @@
 		"gp_max_partition_level",
 		"gp_max_slices",
 		"gp_mk_sort_check",
+		"gp_mk_sort_max_workers",
 		"gp_motion_slice_noop",
 		"gp_partitioning_dynamic_selection_log",
 		"gp_perfmon_print_packet_info",
@@ -65,8 +72,10 @@
 		"gp_resgroup_print_operator_memory_limits",
 		"gp_resqueue_memory_policy_auto_fixed_mem",
 		"gp_resqueue_print_operator_memory_limits",
+		"gp_runtime_filter_wait_time",
 		"gp_select_invisible",
 		"gp_sessionstate_loglevel",
+		"gp_shareinput_shmem_max_size",
 		"gp_snapshotadd_timeout",
 		"gp_udp_bufsize_k",
 		"gp_udpic_dropacks_percent",
@@ -99,8 +108,12 @@
 		"optimizer_cte_inlining_bound",
 		"optimizer_mdcache_size",
 		"optimizer_partition_selection_log",
+		"optimizer_plan_cache_size",
 		"optimizer_plan_id",
 		"optimizer_push_group_by_below_setop_threshold",
+		"optimizer_search_memory_budget",
+		"optimizer_search_time_budget",
+		"optimizer_use_arena_allocator",
 		"optimizer_xform_bind_threshold",
 		"optimizer_samples_number",
 		"planner_work_mem",
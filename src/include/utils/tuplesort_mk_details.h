@@ -221,6 +221,7 @@ typedef enum MKLvType
     MKLV_TYPE_INT32, /* this level contains int32 values */
     MKLV_TYPE_CHAR,  /* this level contains char (blank padded) values */
     MKLV_TYPE_TEXT,  /* this level contains text values */
+    MKLV_TYPE_TEXT_ABBREV, /* this level contains text values in the C collation, prepared as their leading bytes */
 } MKLvType;
 
 typedef struct MKLvContext
@@ -333,6 +334,10 @@ static inline void mk_qsort(MKEntry* a, int n, MKContext *ctxt)
     mk_qsort_impl(a, 0, n-1, 0, true, ctxt, false);
 }
 
+/* MK radix sort, for keys of fixed-width built-in types */
+extern Size mk_radix_sort_space(MKContext *ctxt, int n);
+extern void mk_radix_sort(MKEntry *a, int n, MKContext *ctxt);
+
 /* MK Heap stuff */
 typedef bool (*MKFlagPtrReader) (void *ctxt, MKEntry *e);
 typedef struct MKHeapReader
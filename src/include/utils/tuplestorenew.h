@@ -27,8 +27,11 @@ void ntuplestore_setinstrument(NTupleStore* ts, struct Instrumentation *ins);
 /* Tuple store method */
 extern NTupleStore *ntuplestore_create(int64 maxBytes, char *operation_name);
 extern NTupleStore *ntuplestore_create_readerwriter(const char* filename, int64 maxBytes, bool isWriter);
+extern NTupleStore *ntuplestore_create_reader_shmem(char *pages, int npages, int64 maxBytes);
 extern bool ntuplestore_is_readerwriter_reader(NTupleStore* nts);
 extern void ntuplestore_flush(NTupleStore *ts);
+extern int ntuplestore_count_pages(NTupleStore *ts);
+extern void ntuplestore_copy_pages(NTupleStore *ts, char *dest);
 extern void ntuplestore_destroy(NTupleStore *ts);
 
 /* Tuple store accessor method 
@@ -186,6 +186,7 @@
 		"gp_enable_multiphase_agg",
 		"gp_enable_predicate_propagation",
 		"gp_enable_preunique",
+		"gp_enable_qe_plan_cache",
 		"gp_enable_query_metrics",
 		"gp_enable_relsize_collection",
 		"gp_enable_slow_writer_testmode",
@@ -221,6 +222,7 @@
 		"gp_max_plan_size",
 		"gp_motion_cost_per_row",
 		"gp_perfmon_segment_interval",
+		"gp_plan_compress_cache_size",
 		"gp_print_create_gang_time",
 		"gp_qd_hostname",
 		"gp_qd_port",
@@ -438,6 +440,7 @@
 		"optimizer_sample_plans",
 		"optimizer_search_strategy_path",
 		"optimizer_segments",
+		"optimizer_shared_mdcache_size",
 		"optimizer_sort_factor",
 		"optimizer_trace_fallback",
 		"optimizer_skew_factor",
@@ -0,0 +1,10 @@
+-- gp_ic_proxy_route_stats() reports the traffic of every route of the
+-- interconnect proxy of each segment.
+CREATE TABLE ic_proxy_route_stats(i int);
+INSERT INTO ic_proxy_route_stats SELECT generate_series(1, 100);
+-- Send some tuples through the proxies.
+SELECT count(*) FROM ic_proxy_route_stats;
+
+SELECT count(DISTINCT segid) = (SELECT count(*) FROM gp_segment_configuration WHERE role = 'p' AND content >= 0) AS all_segments, sum(sent_packets) > 0 AS sent, sum(recv_packets) > 0 AS received, bool_and(peer_content >= -1 AND peer_dbid > 0) AS peers, bool_and(sent_bytes >= sent_packets AND recv_bytes >= recv_packets) AS bytes, bool_and(max_write_time_us <= write_time_us) AS write_time FROM gp_ic_proxy_route_stats();
+
+DROP TABLE ic_proxy_route_stats;
@@ -0,0 +1,27 @@
+-- Test gp_interconnect_tcp_local_socket: with the TCP interconnect, motions
+-- between processes on this host go through Unix-domain sockets.  The sockets
+-- live in a directory that only the OS user running the cluster can enter.
+-- All segments of the test cluster run on one host, so every route is local.
+
+CREATE TABLE ic_tcp_local_socket(a int, b int) DISTRIBUTED BY (a);
+INSERT INTO ic_tcp_local_socket SELECT i, i % 7 FROM generate_series(1, 10000) i;
+
+-- Redistribute on b and gather the result.  The senders report connecting
+-- through the local socket directory, and the rows all arrive.
+!\retcode PGOPTIONS='-c gp_interconnect_type=tcp -c gp_interconnect_tcp_local_socket=on -c gp_log_interconnect=debug -c client_min_messages=debug1' psql -d isolation2test -Atc "SELECT sum(c) FROM (SELECT b, count(*) c FROM ic_tcp_local_socket GROUP BY b) s;" > /tmp/ic_tcp_local_socket.out 2>&1;
+!\retcode grep -q "through /tmp/.s.PGSQL.ic_tcp.$(id -u)/" /tmp/ic_tcp_local_socket.out;
+!\retcode grep -qx 10000 /tmp/ic_tcp_local_socket.out;
+
+-- The socket directory is private to the current user.
+!\retcode test "$(stat -c '%a %u' /tmp/.s.PGSQL.ic_tcp.$(id -u))" = "700 $(id -u)";
+
+-- A socket directory that others can enter is not used, motions fall back
+-- to TCP.
+!\retcode chmod 0755 /tmp/.s.PGSQL.ic_tcp.$(id -u);
+!\retcode PGOPTIONS='-c gp_interconnect_type=tcp -c gp_interconnect_tcp_local_socket=on -c gp_log_interconnect=debug -c client_min_messages=debug1' psql -d isolation2test -Atc "SELECT sum(c) FROM (SELECT b, count(*) c FROM ic_tcp_local_socket GROUP BY b) s;" > /tmp/ic_tcp_local_socket.out 2>&1;
+!\retcode grep -q "through /tmp/.s.PGSQL.ic_tcp" /tmp/ic_tcp_local_socket.out;
+!\retcode grep -qx 10000 /tmp/ic_tcp_local_socket.out;
+!\retcode chmod 0700 /tmp/.s.PGSQL.ic_tcp.$(id -u);
+
+!\retcode rm -f /tmp/ic_tcp_local_socket.out;
+DROP TABLE ic_tcp_local_socket;
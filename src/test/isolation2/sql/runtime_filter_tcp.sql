@@ -0,0 +1,33 @@
+-- Test runtime join filters shipped across slices.  When the outer input of
+-- a hash join is a Motion right above a scan, the join sends its filter to
+-- the senders of the Motion, whose scan then drops the rows that cannot
+-- join.  Only the TCP interconnect carries the filters, and the interconnect
+-- type can only be chosen at connection start, so the queries run in psql
+-- sessions started with the settings they need.
+
+CREATE TABLE rtf_tcp_outer (a int, b int) DISTRIBUTED BY (a);
+CREATE TABLE rtf_tcp_inner (a int, b int) DISTRIBUTED BY (a);
+INSERT INTO rtf_tcp_outer SELECT i, i FROM generate_series(1, 100000) i;
+INSERT INTO rtf_tcp_inner SELECT i * 100, i FROM generate_series(1, 10000) i;
+ANALYZE rtf_tcp_outer;
+ANALYZE rtf_tcp_inner;
+
+-- The join on o.b redistributes the outer side.  A high
+-- gp_segments_for_planner keeps the planner from broadcasting the inner side
+-- instead.
+!\retcode PGOPTIONS='-c gp_interconnect_type=tcp -c gp_enable_runtime_filter=on -c gp_runtime_filter_wait_time=10000 -c optimizer=off -c gp_segments_for_planner=100' psql -d isolation2test -Atc "EXPLAIN ANALYZE SELECT count(*) FROM rtf_tcp_outer o JOIN rtf_tcp_inner i ON o.b = i.a;" > /tmp/runtime_filter_tcp.out 2>&1;
+!\retcode grep -q "Redistribute Motion" /tmp/runtime_filter_tcp.out;
+!\retcode grep -Eq "Rows Removed by Runtime Filter: [1-9]" /tmp/runtime_filter_tcp.out;
+
+-- The shipped filter does not change the result.
+!\retcode PGOPTIONS='-c gp_interconnect_type=tcp -c gp_enable_runtime_filter=on -c gp_runtime_filter_wait_time=10000 -c optimizer=off -c gp_segments_for_planner=100' psql -d isolation2test -Atc "SELECT count(*) FROM rtf_tcp_outer o JOIN rtf_tcp_inner i ON o.b = i.a;" | grep -qx 1000;
+
+-- The UDP interconnect does not ship filters, the scan below the Motion
+-- returns every row.
+!\retcode PGOPTIONS='-c gp_interconnect_type=udpifc -c gp_enable_runtime_filter=on -c optimizer=off -c gp_segments_for_planner=100' psql -d isolation2test -Atc "EXPLAIN ANALYZE SELECT count(*) FROM rtf_tcp_outer o JOIN rtf_tcp_inner i ON o.b = i.a;" > /tmp/runtime_filter_tcp.out 2>&1;
+!\retcode grep -q "Redistribute Motion" /tmp/runtime_filter_tcp.out;
+!\retcode grep -q "Rows Removed by Runtime Filter" /tmp/runtime_filter_tcp.out;
+
+!\retcode rm -f /tmp/runtime_filter_tcp.out;
+DROP TABLE rtf_tcp_outer;
+DROP TABLE rtf_tcp_inner;
@@ -0,0 +1,29 @@
+-- Tests for the shared ORCA metadata cache (optimizer_shared_mdcache_size).
+-- The cache is sized at postmaster start, so turn it on and restart.
+!\retcode gpconfig -c optimizer_shared_mdcache_size -v 8192 --masteronly;
+!\retcode gpstop -ari;
+
+1: create table shared_mdcache_t (a int, b int) distributed by (a);
+1: insert into shared_mdcache_t values (1, 2);
+1: select * from shared_mdcache_t;
+
+-- The cache is allocated, and its counters are sane.
+1: select size_bytes > 0 as allocated, used_bytes <= size_bytes as fits, hits >= 0 and misses >= 0 and inserts >= 0 and evictions >= 0 and entries >= 0 as counters from gp_orca_shared_mdcache_stats();
+
+-- Metadata of an uncommitted catalog change must not be published to other
+-- backends: after the rollback, session 2 must still see two columns.
+1: begin;
+1: alter table shared_mdcache_t add column c int;
+1: select * from shared_mdcache_t;
+2&: select * from shared_mdcache_t;
+1: rollback;
+2<:
+1: select * from shared_mdcache_t;
+2: select * from shared_mdcache_t;
+
+1: drop table shared_mdcache_t;
+1q:
+2q:
+
+!\retcode gpconfig -r optimizer_shared_mdcache_size --masteronly;
+!\retcode gpstop -ari;
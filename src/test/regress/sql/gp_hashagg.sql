@@ -145,3 +145,52 @@ HAVING max(c) = '31'
 $$ AS qry \gset
 EXPLAIN (COSTS OFF, VERBOSE) :qry;
 :qry;
+
+-- A streaming lower HashAgg stops grouping when its input forms about as many
+-- groups as rows, and EXPLAIN ANALYZE reports it.
+create table hashagg_passthrough (a int, b int) distributed by (a);
+insert into hashagg_passthrough select g, g from generate_series(1, 30000) g;
+create function hashagg_passes_through(query text) returns bool as $$
+declare
+	ln text;
+begin
+	for ln in execute 'explain analyze ' || query loop
+		if ln ~ 'Grouping passed through after [0-9]+ input rows' then
+			return true;
+		end if;
+	end loop;
+	return false;
+end;
+$$ language plpgsql;
+set optimizer to off;
+set gp_eager_two_phase_agg to on;
+set gp_hashagg_passthrough_sample to 1000;
+-- every row is a group of its own
+select hashagg_passes_through('select b, count(*) from hashagg_passthrough group by b');
+select count(*), sum(c) from (select b, count(*) c from hashagg_passthrough group by b) s;
+-- ten groups
+select hashagg_passes_through('select b % 10, count(*) from hashagg_passthrough group by b % 10');
+select count(*), sum(c) from (select b % 10, count(*) c from hashagg_passthrough group by b % 10) s;
+set gp_hashagg_passthrough_sample to 0;
+select hashagg_passes_through('select b, count(*) from hashagg_passthrough group by b');
+reset gp_hashagg_passthrough_sample;
+reset gp_eager_two_phase_agg;
+reset optimizer;
+drop function hashagg_passes_through(text);
+drop table hashagg_passthrough;
+
+-- The inlined transition functions and the bitwise key comparison must fall
+-- back to the real functions: sums beyond the int8 range, and float and
+-- numeric keys that are equal without being identical.
+create table hashagg_fastpath (g int, i8 int8, f8 float8, n numeric) distributed by (g);
+insert into hashagg_fastpath select g, 9223372036854775807, case when i % 2 = 0 then 0.0::float8 else -0.0::float8 end, case i % 3 when 0 then 0 when 1 then 0.00 else -0.0 end from generate_series(1, 3) g, generate_series(1, 6) i;
+set optimizer to off;
+set enable_groupagg to off;
+select g, sum(i8), count(*) from hashagg_fastpath group by g order by g;
+select i8, sum(i8) from hashagg_fastpath group by i8;
+select f8 = 0 as zero, count(*) from hashagg_fastpath group by f8;
+select n = 0 as zero, count(*) from hashagg_fastpath group by n;
+select g, count(distinct f8), count(distinct n) from hashagg_fastpath group by g order by g;
+reset enable_groupagg;
+reset optimizer;
+drop table hashagg_fastpath;
@@ -0,0 +1,48 @@
+--
+-- Test the cache of the plans produced by GPORCA. Queries that only differ
+-- in literals falling into the same histogram bucket share a cache entry.
+-- With the Postgres planner, the cache is not used, and all the counters
+-- stay at zero.
+--
+create table plancache_t (a int, c int) distributed by (a);
+insert into plancache_t select i, i from generate_series(1, 10000) i;
+analyze plancache_t;
+
+set optimizer_plan_cache_size = 1024;
+
+-- The counters are read with the planner, so that reading them does not
+-- go through the cache itself.
+create view plancache_stats as
+  select hits, misses, inserts, verified, rejected, entries
+  from gp_orca_plan_cache_stats();
+
+-- The first query is inserted, and the same query is a hit. Other literals
+-- are optimized once more to verify the cached plan, which is then reused
+-- with its literals replaced.
+explain (costs off) select * from plancache_t where c < 5;
+explain (costs off) select * from plancache_t where c < 5;
+explain (costs off) select * from plancache_t where c < 6;
+explain (costs off) select * from plancache_t where c < 7;
+
+set optimizer = off;
+select * from plancache_stats;
+reset optimizer;
+
+-- A column compared to several literals may have its comparisons merged,
+-- so the plan is only reused for the exact same literals.
+select count(*) from plancache_t where c > 5 and c > 7;
+select count(*) from plancache_t where c > 6 and c > 8;
+
+-- Literals in the same bucket, whose row estimates are too far apart,
+-- reject the cached plan.
+select count(*) from plancache_t where c <= 2;
+select count(*) from plancache_t where c <= 30;
+select count(*) from plancache_t where c <= 20;
+
+set optimizer = off;
+select * from plancache_stats;
+reset optimizer;
+
+reset optimizer_plan_cache_size;
+drop view plancache_stats;
+drop table plancache_t;
@@ -0,0 +1,55 @@
+--
+-- Test the time and memory budget of the GPORCA search. Once the budget is
+-- used up, no more alternatives are explored, but the operators that have
+-- no implementation of their own, like n-ary joins and subqueries, are
+-- still transformed into ones that do, so that GPORCA still produces a
+-- plan. With the Postgres planner, the budget has no effect.
+--
+create table search_budget_t (a int, b int) distributed by (a);
+insert into search_budget_t select i, i % 10 from generate_series(1, 100) i;
+analyze search_budget_t;
+
+-- Show the lines of the EXPLAIN output about the optimizer, with the
+-- search time masked out.
+create function explain_search_outcome(query text) returns setof text
+language plpgsql as
+$$
+declare
+  ln text;
+begin
+  for ln in execute 'explain (costs off) ' || query loop
+    if ln like 'Optimizer%' then
+      return next regexp_replace(ln, '\d+ ms', 'N ms');
+    end if;
+  end loop;
+end;
+$$;
+
+-- A budget of 1 kB is used up before the search starts.
+set optimizer_search_memory_budget = 1;
+
+select explain_search_outcome($q$
+  select count(*) from search_budget_t t1
+    join search_budget_t t2 on t1.a = t2.b
+    join search_budget_t t3 on t2.a = t3.b
+    join search_budget_t t4 on t3.a = t4.b
+$q$);
+select count(*) from search_budget_t t1
+  join search_budget_t t2 on t1.a = t2.b
+  join search_budget_t t3 on t2.a = t3.b
+  join search_budget_t t4 on t3.a = t4.b;
+
+select explain_search_outcome($q$
+  select count(*) from (select a from search_budget_t
+                        union
+                        select b from search_budget_t) u
+  where a in (select b from search_budget_t)
+$q$);
+select count(*) from (select a from search_budget_t
+                      union
+                      select b from search_budget_t) u
+where a in (select b from search_budget_t);
+
+reset optimizer_search_memory_budget;
+drop function explain_search_outcome(text);
+drop table search_budget_t;
@@ -712,3 +712,70 @@ where x.a + 1 in (select b from t2_dedupsemi_indexonly);
 
 drop table t1_dedupsemi_indexonly;
 drop table t2_dedupsemi_indexonly;
+
+--
+-- Runtime join filters must not change the result of joins
+--
+create table rtf_outer (a int, b int) distributed by (a);
+create table rtf_inner (a int, b int) distributed by (a);
+insert into rtf_outer select i, i from generate_series(1, 10000) i;
+insert into rtf_inner select i * 100, i from generate_series(1, 50) i;
+insert into rtf_inner values (null, 0);
+analyze rtf_outer;
+analyze rtf_inner;
+set gp_enable_runtime_filter to on;
+select count(*) from rtf_outer o join rtf_inner i on o.a = i.a;
+select count(*) from rtf_outer o join rtf_inner i on o.a = i.a where o.b % 200 = 0;
+select count(*) from rtf_outer o where o.a in (select a from rtf_inner);
+select count(*) from rtf_outer o right join rtf_inner i on o.a = i.a;
+select count(*) from rtf_outer o left join rtf_inner i on o.a = i.a;
+-- the join is not colocated.  Only the TCP interconnect ships a filter to a
+-- scan in another slice, see the isolation2 test runtime_filter_tcp.
+select count(*) from rtf_outer o join rtf_inner i on o.b = i.a;
+select count(*) from rtf_outer o where o.b in (select a from rtf_inner);
+-- The scan drops the outer rows that fail the filter, and EXPLAIN ANALYZE
+-- reports how many on each segment.  The plan shapes checked here are those
+-- of the Postgres planner.
+create function rtf_removes_rows(query text) returns bool as $$
+declare
+	ln text;
+	removed bigint := 0;
+begin
+	for ln in execute 'explain analyze ' || query loop
+		if ln ~ 'Rows Removed by Runtime Filter: [0-9]+' then
+			removed := removed + substring(ln from 'Rows Removed by Runtime Filter: ([0-9]+)')::bigint;
+		end if;
+	end loop;
+	return removed > 0;
+end;
+$$ language plpgsql;
+set optimizer to off;
+select rtf_removes_rows('select count(*) from rtf_outer o join rtf_inner i on o.a = i.a');
+select rtf_removes_rows('select count(*) from rtf_outer o join rtf_inner i on o.a = i.a where o.b % 200 = 0');
+-- no filter for a join that emits unmatched outer rows
+select rtf_removes_rows('select count(*) from rtf_outer o left join rtf_inner i on o.a = i.a');
+set gp_enable_runtime_filter to off;
+select rtf_removes_rows('select count(*) from rtf_outer o join rtf_inner i on o.a = i.a');
+reset optimizer;
+reset gp_enable_runtime_filter;
+drop function rtf_removes_rows(text);
+drop table rtf_outer;
+drop table rtf_inner;
+
+-- Hash join bucket tags.  Many keys per bucket, half of the probes without a
+-- match, a hash table that grows from one batch to several while it is
+-- built because the inner side has no statistics, and rescans of the hash
+-- join in a subplan.
+set gp_autostats_mode = none;
+create table hjtag_outer (a int, b int) distributed by (a);
+create table hjtag_inner (a int, b int) distributed by (a);
+insert into hjtag_outer select i, i % 2000 from generate_series(1, 20000) i;
+insert into hjtag_inner select i, i % 1000 from generate_series(1, 200000) i;
+set statement_mem = '1000kB';
+select count(*), count(distinct o.b) from hjtag_outer o join hjtag_inner i on o.b = i.b;
+select g, (select count(*) from hjtag_outer o join hjtag_inner i on o.b = i.b where o.b % 5 = g) from generate_series(0, 2) g order by g;
+reset statement_mem;
+select count(*), count(distinct o.b) from hjtag_outer o join hjtag_inner i on o.b = i.b;
+reset gp_autostats_mode;
+drop table hjtag_outer;
+drop table hjtag_inner;
@@ -66,3 +66,30 @@ select array(select b from t_limit_all order by b asc limit all) t;
 select array(select b from t_limit_all order by b asc limit all) t;
 
 drop table t_limit_all;
+
+-- A Limit passes its bound down to the Gather Motion below it, which stops
+-- its senders as soon as it has returned the last tuple the Limit needs.
+create table t_limit_motion (a int, b int) distributed by (a);
+insert into t_limit_motion select i, i % 7 from generate_series(1, 1000) i;
+select a from t_limit_motion order by a limit 5;
+select a from t_limit_motion order by a limit 3 offset 4;
+select b, a from t_limit_motion order by b desc, a limit 4;
+set gp_enable_motion_mk_sort = off;
+select a from t_limit_motion order by a limit 5;
+select b, a from t_limit_motion order by b desc, a limit 4;
+reset gp_enable_motion_mk_sort;
+
+-- A cursor that fetches past the end of the LIMIT
+begin;
+declare c_limit_motion cursor for select a from t_limit_motion order by a limit 3;
+fetch 2 from c_limit_motion;
+fetch 2 from c_limit_motion;
+fetch 2 from c_limit_motion;
+close c_limit_motion;
+commit;
+
+-- LIMIT in a correlated subplan, run again for each outer row
+select g, (select a from t_limit_motion where b = g order by a limit 1 offset 1) from generate_series(0, 3) g order by g;
+select g, (select sum(a) from (select a from t_limit_motion where b = g order by a desc limit 2) s) from generate_series(0, 2) g order by g;
+
+drop table t_limit_motion;
@@ -0,0 +1,32 @@
+--
+-- Round-trip plans with repeated subtrees through dispatch.
+--
+-- Every partition scan of a table with many partitions carries the same
+-- column aliases and the same pushed-down IN-list.  The dispatcher writes
+-- each of them once and back-references the later copies; the segments
+-- must still read a complete copy for every partition.
+--
+set client_min_messages = warning;
+create table plan_srlz (a int, b int, c text) distributed by (a)
+partition by range (b) (start (0) end (40) every (1));
+reset client_min_messages;
+insert into plan_srlz select i, i % 40, 'row ' || i from generate_series(1, 4000) i;
+
+select count(*), sum(a), count(distinct c) from plan_srlz
+where a in (1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16, 17, 18, 19, 20, 21, 22, 23, 24, 25, 26, 27, 28, 29, 30, 31, 32, 33, 34, 35, 36, 37, 38, 39, 40, 41, 42, 43, 44, 45, 46, 47, 48, 49, 50, 51, 52, 53, 54, 55, 56, 57, 58, 59, 60, 61, 62, 63, 64, 65, 66, 67, 68, 69, 70, 71, 72, 73, 74, 75, 76, 77, 78, 79, 80, 81, 82, 83, 84, 85, 86, 87, 88, 89, 90, 91, 92, 93, 94, 95, 96, 97, 98, 99, 100);
+
+-- A prepared statement dispatches the same plan every time, and reuses its
+-- compressed form if gp_plan_compress_cache_size allows.
+prepare plan_srlz_q(int) as
+select count(*), sum(a) from plan_srlz
+where a in (1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16, 17, 18, 19, 20, 21, 22, 23, 24, 25, 26, 27, 28, 29, 30, 31, 32, 33, 34, 35, 36, 37, 38, 39, 40, 41, 42, 43, 44, 45, 46, 47, 48, 49, 50, 51, 52, 53, 54, 55, 56, 57, 58, 59, 60, 61, 62, 63, 64, 65, 66, 67, 68, 69, 70, 71, 72, 73, 74, 75, 76, 77, 78, 79, 80, 81, 82, 83, 84, 85, 86, 87, 88, 89, 90, 91, 92, 93, 94, 95, 96, 97, 98, 99, 100) and b >= $1;
+execute plan_srlz_q(0);
+execute plan_srlz_q(0);
+set gp_plan_compress_cache_size = 0;
+execute plan_srlz_q(0);
+execute plan_srlz_q(20);
+reset gp_plan_compress_cache_size;
+execute plan_srlz_q(20);
+deallocate plan_srlz_q;
+
+drop table plan_srlz;
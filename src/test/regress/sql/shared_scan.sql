@@ -125,15 +125,15 @@ where
 	and (stat.schema_name || '.' ||stat.table_name not in (select table_nm_onl_act from tbls_w_onl_actl_data))
 	or (stat.schema_name || '.' ||stat.table_name in (select table_nm_onl_act from tbls_w_onl_actl_data));
 
--- Test the scenario which already opened many fds
+-- Test a query that shares its input across slices
 -- start_ignore
 RESET search_path;
 -- end_ignore
-\! mkdir -p /tmp/_gpdb_fault_inject_tmp_dir/
 
-select gp_inject_fault('inject_many_fds_for_shareinputscan', 'skip', dbid) from gp_segment_configuration where role = 'p' and content = 0;
 -- borrow the test query in gp_aggregates
 select case when ten < 5 then ten else ten * 2 end, count(distinct two), count(distinct four) from tenk1 group by 1;
-select gp_inject_fault('inject_many_fds_for_shareinputscan', 'reset', dbid) from gp_segment_configuration where role = 'p' and content = 0;
 
-\! rm -rf /tmp/_gpdb_fault_inject_tmp_dir/
+-- The same, reading the shared input from workfiles instead of shared memory
+set gp_shareinput_shmem_max_size = 0;
+select case when ten < 5 then ten else ten * 2 end, count(distinct two), count(distinct four) from tenk1 group by 1;
+reset gp_shareinput_shmem_max_size;
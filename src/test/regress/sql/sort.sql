@@ -142,3 +142,112 @@ select count(*) from t;
 
 reset gp_enable_mk_sort;
 reset enable_hashjoin;
+
+--
+-- Test multi-key sort split among several threads
+--
+set gp_enable_mk_sort = on;
+set gp_mk_sort_max_workers = 4;
+
+select count(*) from (
+  select i, lag(i) over (order by i desc) as prev
+  from generate_series(1, 300000) i
+) s where prev < i;
+
+select count(*) from (
+  select a, b, lag(a) over w as prev_a, lag(b) over w as prev_b
+  from (select i % 1000 as a, (i::int8 * 7919 % 300007)::float8 as b
+        from generate_series(1, 300000) i) t
+  window w as (order by a, b desc)
+) s where (prev_a, -prev_b) > (a, -b);
+
+reset gp_mk_sort_max_workers;
+reset gp_enable_mk_sort;
+
+--
+-- Test radix sort of fixed-width keys, and abbreviated text keys
+--
+create table radixsort (i int4, f float8, t timestamp, s text);
+insert into radixsort
+  select i % 97 - 48,
+         case when i % 13 = 0 then null else (i * 7919 % 10007) / 7.0 end,
+         '2000-01-01'::timestamp + (i % 1000) * interval '1 hour',
+         'common prefix ' || (i % 577)
+  from generate_series(1, 20000) i;
+
+select count(*) from (
+  select i, f, lag(i) over w as prev_i, lag(f) over w as prev_f
+  from radixsort
+  window w as (order by i desc, f nulls first)
+) s where prev_i < i or
+          (prev_i = i and (prev_f > f or (prev_f is not null and f is null)));
+
+select count(*) from (
+  select t, lag(t) over (order by t desc) as prev_t from radixsort
+) s where prev_t < t;
+
+select count(*) from (
+  select s, lag(s) over (order by s collate "C") as prev_s from radixsort
+) s where prev_s > s collate "C";
+
+select count(*) from (
+  select s, lag(s) over (order by s collate "C" desc) as prev_s from radixsort
+) s where prev_s < s collate "C";
+
+-- float4 keys with NULLs, NaNs and signed zeros, in both directions, with and
+-- without radix sort
+create table radixsort4 (r float4) distributed randomly;
+insert into radixsort4
+  select case when i % 11 = 0 then null
+              when i % 101 = 0 then 'NaN'::float4
+              when i % 103 = 0 then '-0'::float4
+              else ((i * 7919 % 10007 - 5000) / 3.0)::float4 end
+  from generate_series(1, 20000) i;
+
+select count(*) from (
+  select r, lag(r) over (order by r desc) as prev_r from radixsort4
+) s where prev_r < r or (prev_r is not null and r is null);
+
+select count(*) from (
+  select r, lag(r) over (order by r nulls first) as prev_r from radixsort4
+) s where prev_r > r or (prev_r is not null and r is null);
+
+select count(*) from (
+  select r, lag(r) over (order by r desc nulls last) as prev_r from radixsort4
+) s where prev_r < r or (prev_r is null and r is not null);
+
+set gp_enable_mk_sort_radix = off;
+
+select count(*) from (
+  select r, lag(r) over (order by r desc) as prev_r from radixsort4
+) s where prev_r < r or (prev_r is not null and r is null);
+
+select count(*) from (
+  select r, lag(r) over (order by r desc nulls last) as prev_r from radixsort4
+) s where prev_r < r or (prev_r is null and r is not null);
+
+reset gp_enable_mk_sort_radix;
+
+-- C-collation text without abbreviated keys
+set gp_enable_mk_sort_abbrev_text = off;
+
+select count(*) from (
+  select s, lag(s) over (order by s collate "C" desc) as prev_s from radixsort
+) s where prev_s < s collate "C";
+
+reset gp_enable_mk_sort_abbrev_text;
+
+drop table radixsort4;
+
+drop table radixsort;
+
+-- Sorted Gather Motion merged with the loser tree instead of the mk heap.
+-- Some senders run out of tuples early in the last query.
+create table motionsort (a int, b int, t text) distributed by (a);
+insert into motionsort select i, i % 3, case when i % 4 = 0 then null else (20 - i)::text end from generate_series(1, 20) i;
+set gp_enable_motion_mk_sort = off;
+select * from motionsort order by b, a desc;
+select * from motionsort order by t nulls first, a;
+select b, a from motionsort where a > 15 order by b desc, a;
+reset gp_enable_motion_mk_sort;
+drop table motionsort;
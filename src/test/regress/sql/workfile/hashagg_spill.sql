@@ -96,6 +96,12 @@ select count(*) from (select i, count(*) from aggspill group by i,j,t having cou
 
 select count(*) from (select i, count(*) from aggspill group by i,j,t having count(*) = 3) g;
 
+-- Every group is written to the batch files many times.  Reloading a batch
+-- file is sized by the estimated number of groups in it, not by the number
+-- of entries, and must still produce each group once.
+select count(*), sum(c) from (select i % 100000 as g, count(*) as c from aggspill group by 1) g;
+select count(*), sum(c) from (select i % 100000 as g, t, count(*) as c from aggspill group by 1, 2) g;
+
 reset optimizer_force_multistage_agg;
 
 -- Test the spilling of aggstates